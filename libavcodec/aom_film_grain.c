@@ -29,6 +29,7 @@
 #include "libavutil/imgutils.h"
 
 #include "aom_film_grain.h"
+#include "avcodec.h"
 #include "get_bits.h"
 
 // Common/shared helpers (not dependent on BIT_DEPTH)
@@ -54,6 +55,16 @@ enum {
 
 static const int16_t gaussian_sequence[2048];
 
+typedef struct FilmGrainThreadData {
+    AVFrame *out;
+    const AVFrame *in;
+    const AVFilmGrainParams *params;
+    const void *scaling;
+    const void *grain_lut;
+    int subx, suby;
+    int bit_depth;
+} FilmGrainThreadData;
+
 #define BIT_DEPTH 16
 #include "aom_film_grain_template.c"
 #undef BIT_DEPTH
@@ -63,7 +74,8 @@ static const int16_t gaussian_sequence[2048];
 #undef BIT_DEPTH
 
 
-int ff_aom_apply_film_grain(AVFrame *out, const AVFrame *in,
+int ff_aom_apply_film_grain(AVCodecContext *avctx,
+                            AVFrame *out, const AVFrame *in,
                             const AVFilmGrainParams *params)
 {
     const AVFilmGrainAOMParams *const data = &params->codec.aom;
@@ -97,22 +109,22 @@ int ff_aom_apply_film_grain(AVFrame *out, const AVFrame *in,
     case AV_PIX_FMT_YUVJ420P:
     case AV_PIX_FMT_YUVJ422P:
     case AV_PIX_FMT_YUVJ444P:
-        return apply_film_grain_8(out, in, params);
+        return apply_film_grain_8(avctx, out, in, params);
     case AV_PIX_FMT_GRAY9:
     case AV_PIX_FMT_YUV420P9:
     case AV_PIX_FMT_YUV422P9:
     case AV_PIX_FMT_YUV444P9:
-        return apply_film_grain_16(out, in, params, 9);
+        return apply_film_grain_16(avctx, out, in, params, 9);
     case AV_PIX_FMT_GRAY10:
     case AV_PIX_FMT_YUV420P10:
     case AV_PIX_FMT_YUV422P10:
     case AV_PIX_FMT_YUV444P10:
-        return apply_film_grain_16(out, in, params, 10);
+        return apply_film_grain_16(avctx, out, in, params, 10);
     case AV_PIX_FMT_GRAY12:
     case AV_PIX_FMT_YUV420P12:
     case AV_PIX_FMT_YUV422P12:
     case AV_PIX_FMT_YUV444P12:
-        return apply_film_grain_16(out, in, params, 12);
+        return apply_film_grain_16(avctx, out, in, params, 12);
     }
 
     /* The AV1 spec only defines film grain synthesis for these formats */
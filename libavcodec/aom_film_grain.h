@@ -30,6 +30,8 @@
 
 #include "libavutil/film_grain_params.h"
 
+struct AVCodecContext;
+
 typedef struct AVFilmGrainAFGS1Params {
     int enable;
     AVFilmGrainParams sets[8];
@@ -37,7 +39,9 @@ typedef struct AVFilmGrainAFGS1Params {
 
 // Synthesizes film grain on top of `in` and stores the result to `out`. `out`
 // must already have been allocated and set to the same size and format as `in`.
-int ff_aom_apply_film_grain(AVFrame *out, const AVFrame *in,
+// Rows of 32x32 blocks are synthesized in parallel through avctx->execute2().
+int ff_aom_apply_film_grain(struct AVCodecContext *avctx,
+                            AVFrame *out, const AVFrame *in,
                             const AVFilmGrainParams *params);
 
 // Parse AFGS1 parameter sets from an ITU-T T.35 payload. Returns 0 on success,
@@ -542,7 +542,22 @@ FUNC(apply_grain_row)(AVFrame *out, const AVFrame *in,
     }
 }
 
-static int FUNC(apply_film_grain)(AVFrame *out_frame, const AVFrame *in_frame,
+static int FUNC(apply_grain_rows)(AVCodecContext *avctx, void *arg,
+                                  int jobnr, int threadnr)
+{
+    const FilmGrainThreadData *td = arg;
+#if BIT_DEPTH > 8
+    const int bitdepth = td->bit_depth;
+#endif
+
+    FUNC(apply_grain_row)(td->out, td->in, td->subx, td->suby, td->scaling,
+                          td->grain_lut, td->params, jobnr HBD_CALL);
+
+    return 0;
+}
+
+static int FUNC(apply_film_grain)(AVCodecContext *avctx,
+                                  AVFrame *out_frame, const AVFrame *in_frame,
                                   const AVFilmGrainParams *params HBD_DECL)
 {
     entry grain_lut[3][GRAIN_HEIGHT + 1][GRAIN_WIDTH];
@@ -552,6 +567,7 @@ static int FUNC(apply_film_grain)(AVFrame *out_frame, const AVFrame *in_frame,
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(out_frame->format);
     const int rows = AV_CEIL_RSHIFT(out_frame->height, 5); /* log2(FG_BLOCK_SIZE) */
     const int subx = desc->log2_chroma_w, suby = desc->log2_chroma_h;
+    FilmGrainThreadData td;
 
     // Generate grain LUTs as needed
     FUNC(generate_grain_y_c)(grain_lut[0], params HBD_CALL);
@@ -568,10 +584,17 @@ static int FUNC(apply_film_grain)(AVFrame *out_frame, const AVFrame *in_frame,
     if (data->num_uv_points[1])
         FUNC(generate_scaling)(data->uv_points[1], data->num_uv_points[1], scaling[2] HBD_CALL);
 
-    for (int row = 0; row < rows; row++) {
-        FUNC(apply_grain_row)(out_frame, in_frame, subx, suby, scaling, grain_lut,
-                              params, row HBD_CALL);
-    }
+    // Rows of blocks only share the (read-only) LUTs, so they can be
+    // synthesized in parallel
+    td.out       = out_frame;
+    td.in        = in_frame;
+    td.params    = params;
+    td.scaling   = scaling;
+    td.grain_lut = grain_lut;
+    td.subx      = subx;
+    td.suby      = suby;
+    td.bit_depth = bitdepth;
+    avctx->execute2(avctx, FUNC(apply_grain_rows), &td, NULL, rows);
 
     return 0;
 }
@@ -2076,6 +2076,21 @@ typedef struct AVCodecContext {
      */
     AVFrameSideData  **decoded_side_data;
     int             nb_decoded_side_data;
+
+    /**
+     * Thread pool to run the slice threading jobs of this context on, see
+     * av_thread_pool_alloc(). If NULL, the process-wide pool set up with
+     * av_thread_pool_init() is used if there is one, otherwise the context
+     * spawns threads of its own. thread_count then limits how many pool
+     * threads may work on this context at the same time.
+     *
+     * Frame threading is not affected.
+     *
+     * - encoding/decoding: may be set by the caller before avcodec_open2().
+     *                      The pool is kept alive as long as the context
+     *                      uses it.
+     */
+    struct AVThreadPool *thread_pool;
 } AVCodecContext;
 
 /**
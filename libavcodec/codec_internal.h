@@ -87,6 +87,12 @@
  * encoders do.
  */
 #define FF_CODEC_CAP_EOF_FLUSH              (1 << 10)
+/**
+ * The encoder supports frame threading only when every frame is coded
+ * independently of the others, i.e. for gop_size <= 1 outside of a first
+ * pass. Otherwise the frame thread encoder falls back to slice threading.
+ */
+#define FF_CODEC_CAP_FRAME_THREADS_INTRA_ONLY (1 << 11)
 
 /**
  * FFCodec.codec_tags termination value
@@ -0,0 +1,50 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/intreadwrite.h"
+#include "dpxdsp.h"
+
+#define UNPACK_RGB10(name, read)                                             \
+static void unpack_rgb10_ ## name ## _c(uint16_t *dst0, uint16_t *dst1,     \
+                                        uint16_t *dst2, const uint8_t *src, \
+                                        int width, int shift)               \
+{                                                                            \
+    for (int x = 0; x < width; x++) {                                        \
+        uint32_t w = read(src + 4 * x);                                      \
+        /* like read10in32(), fold the pad bits of method B into B */        \
+        w |= w >> shift >> 10;                                               \
+        dst2[x] = w >>  shift       & 0x3FF;                                 \
+        dst0[x] = w >> (shift - 10) & 0x3FF;                                 \
+        dst1[x] = w >> (shift - 20) & 0x3FF;                                 \
+    }                                                                        \
+}
+
+UNPACK_RGB10(le, AV_RL32)
+UNPACK_RGB10(be, AV_RB32)
+
+av_cold void ff_dpxdsp_init(DPXDSPContext *c)
+{
+    c->unpack_rgb10[0] = unpack_rgb10_le_c;
+    c->unpack_rgb10[1] = unpack_rgb10_be_c;
+
+#if ARCH_X86
+    ff_dpxdsp_init_x86(c);
+#endif
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_DPXDSP_H
+#define AVCODEC_DPXDSP_H
+
+#include <stdint.h>
+
+typedef struct DPXDSPContext {
+    /**
+     * Unpack a row of 10-bit RGB pixels, each stored in one 32-bit word
+     * with R at bit shift, G at bit shift - 10 and B at bit shift - 20.
+     * With shift 20 the two pad bits above R are ORed into the low bits
+     * of B, matching the scalar reader.
+     * Indexed by endianness (1 for big-endian).
+     *
+     * @param dst0  G plane
+     * @param dst1  B plane
+     * @param dst2  R plane
+     * @param width number of pixels, a multiple of 8, may be 0
+     * @param shift 22 (method A filling) or 20 (method B filling)
+     */
+    void (*unpack_rgb10[2])(uint16_t *dst0, uint16_t *dst1, uint16_t *dst2,
+                            const uint8_t *src, int width, int shift);
+} DPXDSPContext;
+
+void ff_dpxdsp_init(DPXDSPContext *c);
+void ff_dpxdsp_init_x86(DPXDSPContext *c);
+
+#endif /* AVCODEC_DPXDSP_H */
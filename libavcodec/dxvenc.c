@@ -119,6 +119,7 @@ typedef struct DXVEncContext {
     TextureDSPThreadContext enc;
 
     DXVTextureFormat tex_fmt;
+    int fast;
     int (*compress_tex)(AVCodecContext *avctx);
 
     const AVCRC *crc_ctx;
@@ -283,7 +284,7 @@ static av_cold int dxv_init(AVCodecContext *avctx)
         return AVERROR_INVALIDDATA;
     }
 
-    ff_texturedspenc_init(&texdsp);
+    ff_texturedspenc_init(&texdsp, ctx->fast);
 
     switch (ctx->tex_fmt) {
     case DXV_FMT_DXT1:
@@ -329,6 +330,9 @@ static av_cold int dxv_close(AVCodecContext *avctx)
 static const AVOption options[] = {
     { "format", NULL, OFFSET(tex_fmt), AV_OPT_TYPE_INT, { .i64 = DXV_FMT_DXT1 }, DXV_FMT_DXT1, DXV_FMT_DXT1, FLAGS, .unit = "format" },
         { "dxt1", "DXT1 (Normal Quality, No Alpha)", 0, AV_OPT_TYPE_CONST, { .i64 = DXV_FMT_DXT1   }, 0, 0, FLAGS, .unit = "format" },
+    { "quality", "texture compression quality", OFFSET(fast), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, FLAGS, .unit = "quality" },
+        { "high", "Principal axis fit with refinement", 0, AV_OPT_TYPE_CONST, { .i64 = 0 }, 0, 0, FLAGS, .unit = "quality" },
+        { "fast", "Bounding box fit", 0, AV_OPT_TYPE_CONST, { .i64 = 1 }, 0, 0, FLAGS, .unit = "quality" },
     { NULL },
 };
 
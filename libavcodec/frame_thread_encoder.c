@@ -29,6 +29,7 @@
 #include "libavutil/thread.h"
 #include "avcodec.h"
 #include "avcodec_internal.h"
+#include "codec_internal.h"
 #include "codec_par.h"
 #include "encode.h"
 #include "internal.h"
@@ -129,6 +130,15 @@ av_cold int ff_frame_thread_encoder_init(AVCodecContext *avctx)
        || !(avctx->codec->capabilities & AV_CODEC_CAP_FRAME_THREADS))
         return 0;
 
+    if (ffcodec(avctx->codec)->caps_internal & FF_CODEC_CAP_FRAME_THREADS_INTRA_ONLY &&
+        (avctx->gop_size > 1 || avctx->flags & AV_CODEC_FLAG_PASS1)) {
+        av_log(avctx, AV_LOG_DEBUG,
+               "Disabling frame threading, the encoder needs gop_size <= 1 "
+               "and no first pass for it\n");
+        avctx->thread_type &= ~FF_THREAD_FRAME;
+        return 0;
+    }
+
     if(   !avctx->thread_count
        && avctx->codec_id == AV_CODEC_ID_MJPEG
        && !(avctx->flags & AV_CODEC_FLAG_QSCALE)) {
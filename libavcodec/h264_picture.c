@@ -213,8 +213,8 @@ int ff_h264_field_end(H264Context *h, H264SliceContext *sl, int in_setup)
 
         err = AVERROR_INVALIDDATA;
         if (sd) // a decoding error may have happened before the side data could be allocated
-            err = ff_h274_apply_film_grain(cur->f_grain, cur->f, &h->h274db,
-                                           (AVFilmGrainParams *) sd->data);
+            err = ff_h274_apply_film_grain(avctx, cur->f_grain, cur->f, &h->h274db,
+                                           &h->h274dsp, (AVFilmGrainParams *) sd->data);
         if (err < 0) {
             av_log(h->avctx, AV_LOG_WARNING, "Failed synthesizing film "
                    "grain, ignoring: %s\n", av_err2str(err));
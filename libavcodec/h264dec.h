@@ -337,6 +337,7 @@ typedef struct H264Context {
     H264ChromaContext h264chroma;
     H264QpelContext h264qpel;
     H274FilmGrainDatabase h274db;
+    H274FilmGrainDSPContext h274dsp;
 
     H264Picture DPB[H264_MAX_PICTURE_COUNT];
     H264Picture *cur_pic_ptr;
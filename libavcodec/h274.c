@@ -25,9 +25,13 @@
  * @author Niklas Haas <ffmpeg@haasn.xyz>
  */
 
+#include "libavutil/attributes.h"
 #include "libavutil/avassert.h"
 #include "libavutil/imgutils.h"
 
+#include "config.h"
+
+#include "avcodec.h"
 #include "h274.h"
 
 static const int8_t Gaussian_LUT[2048+4];
@@ -110,8 +114,20 @@ static void init_slice(H274FilmGrainDatabase *database, uint8_t h, uint8_t v)
     init_slice_c(database->db[h][v], h, v, database->slice_tmp);
 }
 
+// Pre-computes the patterns of all intensity intervals of a component, so
+// that the database is only read from while synthesizing grain
+static void init_slices(H274FilmGrainDatabase *database,
+                        const AVFilmGrainH274Params *h274, int c)
+{
+    for (int i = 0; i < h274->num_intensity_intervals[c]; i++) {
+        const uint8_t h = av_clip(h274->comp_model_value[c][i][1], 2, 14) - 2;
+        const uint8_t v = av_clip(h274->comp_model_value[c][i][2], 2, 14) - 2;
+        init_slice(database, h, v);
+    }
+}
+
 // Computes the average of an 8x8 block
-static uint16_t avg_8x8_c(const uint8_t *in, int in_stride)
+static uint16_t avg_8x8_c(const uint8_t *in, ptrdiff_t in_stride)
 {
     uint16_t avg[8] = {0}; // summing over an array vectorizes better
 
@@ -126,9 +142,8 @@ static uint16_t avg_8x8_c(const uint8_t *in, int in_stride)
 }
 
 // Synthesize an 8x8 block of film grain by copying the pattern from `db`
-static void synth_grain_8x8_c(int8_t *out, const int out_stride,
-                              const int16_t scale, const uint8_t shift,
-                              const int8_t *db)
+static void synth_grain_8x8_c(int8_t *out, ptrdiff_t out_stride,
+                              int scale, int shift, const int8_t *db)
 {
     for (int y = 0; y < 8; y++) {
         for (int x = 0; x < 8; x++)
@@ -155,13 +170,14 @@ static void deblock_8x8_c(int8_t *out, const int out_stride)
 // deblocking step (note that this implies writing to the previous block).
 static av_always_inline void generate(int8_t *out, int out_stride,
                                       const uint8_t *in, int in_stride,
-                                      H274FilmGrainDatabase *database,
+                                      const H274FilmGrainDatabase *database,
+                                      const H274FilmGrainDSPContext *dsp,
                                       const AVFilmGrainH274Params *h274,
                                       int c, int invert, int deblock,
                                       int y_offset, int x_offset)
 {
     const uint8_t shift = h274->log2_scale_factor + 6;
-    const uint16_t avg = avg_8x8_c(in, in_stride);
+    const uint16_t avg = dsp->avg_8x8(in, in_stride);
     int16_t scale;
     uint8_t h, v;
     int8_t s = -1;
@@ -191,16 +207,17 @@ static av_always_inline void generate(int8_t *out, int out_stride,
         return;
     }
 
+    // The pattern was already computed by init_slices()
     h = av_clip(h274->comp_model_value[c][s][1], 2, 14) - 2;
     v = av_clip(h274->comp_model_value[c][s][2], 2, 14) - 2;
-    init_slice(database, h, v);
+    av_assert2(database->residency[h] & (1 << v));
 
     scale = h274->comp_model_value[c][s][0];
     if (invert)
         scale = -scale;
 
-    synth_grain_8x8_c(out, out_stride, scale, shift,
-                      &database->db[h][v][y_offset][x_offset]);
+    dsp->synth_grain_8x8(out, out_stride, scale, shift,
+                         &database->db[h][v][y_offset][x_offset]);
 
     if (deblock)
         deblock_8x8_c(out, out_stride);
@@ -208,17 +225,102 @@ static av_always_inline void generate(int8_t *out, int out_stride,
 
 // Saturating 8-bit sum of a+b
 static void add_8x8_clip_c(uint8_t *out, const uint8_t *a, const int8_t *b,
-                           int n)
+                           ptrdiff_t n)
 {
     for (int i = 0; i < n; i++)
         out[i] = av_clip_uint8(a[i] + b[i]);
 }
 
-int ff_h274_apply_film_grain(AVFrame *out_frame, const AVFrame *in_frame,
+av_cold void ff_h274_film_grain_dsp_init(H274FilmGrainDSPContext *c)
+{
+    c->avg_8x8         = avg_8x8_c;
+    c->synth_grain_8x8 = synth_grain_8x8_c;
+    c->blend_row       = add_8x8_clip_c;
+
+#if ARCH_X86
+    ff_h274_film_grain_dsp_init_x86(c);
+#endif
+}
+
+// Number of rows of 16x16 blocks handled per execute2() call; bounds the
+// size of the PRNG state array below
+#define MAX_BANDS 64
+
+typedef struct H274ThreadData {
+    AVFrame *out_frame;
+    const AVFrame *in_frame;
+    const H274FilmGrainDatabase *database;
+    const H274FilmGrainDSPContext *dsp;
+    const AVFilmGrainH274Params *h274;
+    int c, width, height;
+    int band_start;
+    // PRNG state at the start of each row of 16x16 blocks
+    uint32_t seeds[MAX_BANDS];
+} H274ThreadData;
+
+// Synthesizes and blends the grain of one row of 16x16 blocks. Rows are
+// independent of each other since deblocking only crosses vertical edges.
+static int apply_grain_band(AVCodecContext *avctx, void *arg,
+                            int jobnr, int threadnr)
+{
+    const H274ThreadData *td = arg;
+    const H274FilmGrainDSPContext *dsp = td->dsp;
+    const int c = td->c, width = td->width;
+    const int y = (td->band_start + jobnr) * 16;
+    const int h = FFMIN(td->height - y, 16);
+    const int blend_width = width & ~31;
+    uint32_t seed = td->seeds[jobnr];
+
+    uint8_t * const out = td->out_frame->data[c] + y * td->out_frame->linesize[c];
+    const int out_stride = td->out_frame->linesize[c];
+    int8_t * const grain = (int8_t *) out; // re-use output buffer for grain
+    const int grain_stride = out_stride;
+    const uint8_t * const in = td->in_frame->data[c] + y * td->in_frame->linesize[c];
+    const int in_stride = td->in_frame->linesize[c];
+
+    // Film grain synthesis is done in 8x8 blocks, but the PRNG state is
+    // only advanced in 16x16 blocks, so use a nested loop
+    for (int x = 0; x < width; x += 16) {
+        uint16_t x_offset = (seed >> 16) % 52;
+        uint16_t y_offset = (seed & 0xFFFF) % 56;
+        const int invert = (seed & 0x1);
+        x_offset &= 0xFFFC;
+        y_offset &= 0xFFF8;
+        prng_shift(&seed);
+
+        for (int yy = 0; yy < h; yy += 8) {
+            for (int xx = 0; xx < 16 && x+xx < width; xx += 8) {
+                generate(grain + yy * grain_stride + (x+xx), grain_stride,
+                         in + yy * in_stride + (x+xx), in_stride,
+                         td->database, dsp, td->h274, c, invert, (x+xx) > 0,
+                         y_offset + yy, x_offset + xx);
+            }
+        }
+    }
+
+    // Final output blend pass, done after grain synthesis is complete
+    // because deblocking depends on previous grain values
+    for (int yy = 0; yy < h; yy++) {
+        uint8_t *dst = out + yy * out_stride;
+        const uint8_t *src = in + yy * in_stride;
+        const int8_t *g = grain + yy * grain_stride;
+        dsp->blend_row(dst, src, g, blend_width);
+        add_8x8_clip_c(dst + blend_width, src + blend_width,
+                       g + blend_width, width - blend_width);
+    }
+
+    return 0;
+}
+
+int ff_h274_apply_film_grain(AVCodecContext *avctx,
+                             AVFrame *out_frame, const AVFrame *in_frame,
                              H274FilmGrainDatabase *database,
+                             const H274FilmGrainDSPContext *dsp,
                              const AVFilmGrainParams *params)
 {
     AVFilmGrainH274Params h274 = params->codec.h274;
+    H274ThreadData td;
+
     av_assert1(params->type == AV_FILM_GRAIN_PARAMS_H274);
     if (h274.model_id != 0)
         return AVERROR_PATCHWELCOME;
@@ -227,21 +329,23 @@ int ff_h274_apply_film_grain(AVFrame *out_frame, const AVFrame *in_frame,
     if (in_frame->format != AV_PIX_FMT_YUV420P)
         return AVERROR_PATCHWELCOME;
 
+    td.out_frame = out_frame;
+    td.in_frame  = in_frame;
+    td.database  = database;
+    td.dsp       = dsp;
+    td.h274      = &h274;
+
     for (int c = 0; c < 3; c++) {
         static const uint8_t color_offset[3] = { 0, 85, 170 };
         uint32_t seed = Seed_LUT[(params->seed + color_offset[c]) % 256];
         const int width = c > 0 ? AV_CEIL_RSHIFT(out_frame->width, 1) : out_frame->width;
         const int height = c > 0 ? AV_CEIL_RSHIFT(out_frame->height, 1) : out_frame->height;
-
-        uint8_t * const out = out_frame->data[c];
-        const int out_stride = out_frame->linesize[c];
-        int8_t * const grain = out_frame->data[c]; // re-use output buffer for grain
-        const int grain_stride = out_stride;
-        const uint8_t * const in = in_frame->data[c];
-        const int in_stride = in_frame->linesize[c];
+        const int blocks_per_band = (width + 15) >> 4;
+        const int nb_bands = (height + 15) >> 4;
 
         if (!h274.component_model_present[c]) {
-            av_image_copy_plane(out, out_stride, in, in_stride,
+            av_image_copy_plane(out_frame->data[c], out_frame->linesize[c],
+                                in_frame->data[c], in_frame->linesize[c],
                                 width * sizeof(uint8_t), height);
             continue;
         }
@@ -255,33 +359,25 @@ int ff_h274_apply_film_grain(AVFrame *out_frame, const AVFrame *in_frame,
             }
         }
 
-        // Film grain synthesis is done in 8x8 blocks, but the PRNG state is
-        // only advanced in 16x16 blocks, so use a nested loop
-        for (int y = 0; y < height; y += 16) {
-            for (int x = 0; x < width; x += 16) {
-                uint16_t x_offset = (seed >> 16) % 52;
-                uint16_t y_offset = (seed & 0xFFFF) % 56;
-                const int invert = (seed & 0x1);
-                x_offset &= 0xFFFC;
-                y_offset &= 0xFFF8;
-                prng_shift(&seed);
-
-                for (int yy = 0; yy < 16 && y+yy < height; yy += 8) {
-                    for (int xx = 0; xx < 16 && x+xx < width; xx += 8) {
-                        generate(grain + (y+yy) * grain_stride + (x+xx), grain_stride,
-                                 in + (y+yy) * in_stride + (x+xx), in_stride,
-                                 database, &h274, c, invert, (x+xx) > 0,
-                                 y_offset + yy, x_offset + xx);
-                    }
-                }
+        init_slices(database, &h274, c);
+
+        td.c      = c;
+        td.width  = width;
+        td.height = height;
+
+        for (int band = 0; band < nb_bands; band += MAX_BANDS) {
+            const int count = FFMIN(nb_bands - band, MAX_BANDS);
+
+            // The PRNG is advanced once per 16x16 block in raster order, so
+            // record its state at the start of each band beforehand
+            for (int i = 0; i < count; i++) {
+                td.seeds[i] = seed;
+                for (int x = 0; x < blocks_per_band; x++)
+                    prng_shift(&seed);
             }
-        }
 
-        // Final output blend pass, done after grain synthesis is complete
-        // because deblocking depends on previous grain values
-        for (int y = 0; y < height; y++) {
-            add_8x8_clip_c(out + y * out_stride, in + y * in_stride,
-                           grain + y * grain_stride, width);
+            td.band_start = band;
+            avctx->execute2(avctx, apply_grain_band, &td, NULL, count);
         }
     }
 
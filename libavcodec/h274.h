@@ -28,8 +28,13 @@
 #ifndef AVCODEC_H274_H
 #define AVCODEC_H274_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "libavutil/film_grain_params.h"
 
+struct AVCodecContext;
+
 // Must be initialized to {0} prior to first usage
 typedef struct H274FilmGrainDatabase {
     // Database of film grain patterns, lazily computed as-needed
@@ -40,6 +45,34 @@ typedef struct H274FilmGrainDatabase {
     int16_t slice_tmp[64][64];
 } H274FilmGrainDatabase;
 
+typedef struct H274FilmGrainDSPContext {
+    /**
+     * Average of an 8x8 block of pixels, i.e. the sum of all pixels >> 6.
+     */
+    uint16_t (*avg_8x8)(const uint8_t *in, ptrdiff_t in_stride);
+
+    /**
+     * Synthesize an 8x8 block of grain from a 64x64 database pattern:
+     * out[x] = (scale * db[x]) >> shift, truncated to 8 bits.
+     *
+     * @param db pointer into the pattern, with a stride of 64
+     */
+    void (*synth_grain_8x8)(int8_t *out, ptrdiff_t out_stride,
+                            int scale, int shift, const int8_t *db);
+
+    /**
+     * Blend a row of grain onto a row of pixels with unsigned saturation.
+     * out may alias grain.
+     *
+     * @param n number of pixels, a multiple of 32
+     */
+    void (*blend_row)(uint8_t *out, const uint8_t *in, const int8_t *grain,
+                      ptrdiff_t n);
+} H274FilmGrainDSPContext;
+
+void ff_h274_film_grain_dsp_init(H274FilmGrainDSPContext *c);
+void ff_h274_film_grain_dsp_init_x86(H274FilmGrainDSPContext *c);
+
 /**
  * Check whether ff_h274_apply_film_grain() supports the given parameter combination.
  *
@@ -55,13 +88,21 @@ static inline int ff_h274_film_grain_params_supported(int model_id, enum AVPixel
 // must already have been allocated and set to the same size and format as
 // `in`.
 //
+// Grain synthesis is split into horizontal bands which are run through
+// avctx->execute2(), so it makes use of slice threads if the caller has any.
+//
+// `dsp` must have been initialized with ff_h274_film_grain_dsp_init(), which
+// callers do once along with `db`.
+//
 // Returns a negative error code on error, such as invalid params.
 // If ff_h274_film_grain_params_supported() indicated that the parameters
 // are supported, no error will be returned if the arguments given to
 // ff_h274_film_grain_params_supported() coincide with actual values
 // from the frames and params.
-int ff_h274_apply_film_grain(AVFrame *out, const AVFrame *in,
+int ff_h274_apply_film_grain(struct AVCodecContext *avctx,
+                             AVFrame *out, const AVFrame *in,
                              H274FilmGrainDatabase *db,
+                             const H274FilmGrainDSPContext *dsp,
                              const AVFilmGrainParams *params);
 
 #endif /* AVCODEC_H274_H */
@@ -250,7 +250,7 @@ static av_cold int hap_init(AVCodecContext *avctx)
         return AVERROR_INVALIDDATA;
     }
 
-    ff_texturedspenc_init(&dxtc);
+    ff_texturedspenc_init(&dxtc, ctx->opt_fast);
 
     switch (ctx->opt_tex_fmt) {
     case HAP_FMT_RGBDXT1:
@@ -339,6 +339,9 @@ static const AVOption options[] = {
     { "compressor", "second-stage compressor", OFFSET(opt_compressor), AV_OPT_TYPE_INT, { .i64 = HAP_COMP_SNAPPY }, HAP_COMP_NONE, HAP_COMP_SNAPPY, FLAGS, .unit = "compressor" },
         { "none",       "None", 0, AV_OPT_TYPE_CONST, { .i64 = HAP_COMP_NONE }, 0, 0, FLAGS, .unit = "compressor" },
         { "snappy",     "Snappy", 0, AV_OPT_TYPE_CONST, { .i64 = HAP_COMP_SNAPPY }, 0, 0, FLAGS, .unit = "compressor" },
+    { "quality", "texture compression quality", OFFSET(opt_fast), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, FLAGS, .unit = "quality" },
+        { "high", "Principal axis fit with refinement", 0, AV_OPT_TYPE_CONST, { .i64 = 0 }, 0, 0, FLAGS, .unit = "quality" },
+        { "fast", "Bounding box fit", 0, AV_OPT_TYPE_CONST, { .i64 = 1 }, 0, 0, FLAGS, .unit = "quality" },
     { NULL },
 };
 
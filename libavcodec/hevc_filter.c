@@ -739,7 +739,8 @@ void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
         ((!s->sh.slice_loop_filter_across_slices_enabled_flag &&
           lc->boundary_flags & BOUNDARY_UPPER_SLICE &&
           (y0 % (1 << s->ps.sps->log2_ctb_size)) == 0) ||
-         (!s->ps.pps->loop_filter_across_tiles_enabled_flag &&
+         ((!s->ps.pps->loop_filter_across_tiles_enabled_flag ||
+           s->enable_parallel_tiles) &&
           lc->boundary_flags & BOUNDARY_UPPER_TILE &&
           (y0 % (1 << s->ps.sps->log2_ctb_size)) == 0)))
         boundary_upper = 0;
@@ -777,7 +778,8 @@ void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
         ((!s->sh.slice_loop_filter_across_slices_enabled_flag &&
           lc->boundary_flags & BOUNDARY_LEFT_SLICE &&
           (x0 % (1 << s->ps.sps->log2_ctb_size)) == 0) ||
-         (!s->ps.pps->loop_filter_across_tiles_enabled_flag &&
+         ((!s->ps.pps->loop_filter_across_tiles_enabled_flag ||
+           s->enable_parallel_tiles) &&
           lc->boundary_flags & BOUNDARY_LEFT_TILE &&
           (x0 % (1 << s->ps.sps->log2_ctb_size)) == 0)))
         boundary_left = 0;
@@ -844,6 +846,91 @@ void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
     }
 }
 
+void ff_hevc_deblocking_boundary_strengths_tiles(const HEVCContext *s,
+                                                 int x_ctb, int y_ctb)
+{
+    const HEVCSPS *sps   = s->ps.sps;
+    const HEVCPPS *pps   = s->ps.pps;
+    const MvField *tab_mvf = s->ref->tab_mvf;
+    int log2_min_pu_size = sps->log2_min_pu_size;
+    int log2_min_tu_size = sps->log2_min_tb_size;
+    int min_pu_width     = sps->min_pu_width;
+    int min_tu_width     = sps->min_tb_width;
+    int ctb_size         = 1 << sps->log2_ctb_size;
+    int ctb_addr_rs      = (y_ctb >> sps->log2_ctb_size) * sps->ctb_width +
+                           (x_ctb >> sps->log2_ctb_size);
+    int tile             = pps->tile_id[pps->ctb_addr_rs_to_ts[ctb_addr_rs]];
+    int i, bs;
+
+    if (y_ctb > 0 &&
+        pps->tile_id[pps->ctb_addr_rs_to_ts[ctb_addr_rs - sps->ctb_width]] != tile) {
+        int slice_edge = s->tab_slice_address[ctb_addr_rs] !=
+                         s->tab_slice_address[ctb_addr_rs - sps->ctb_width];
+
+        if (!slice_edge || s->sh.slice_loop_filter_across_slices_enabled_flag) {
+            const RefPicList *rpl_top = slice_edge ?
+                                        ff_hevc_get_ref_list(s, s->ref, x_ctb, y_ctb - 1) :
+                                        s->ref->refPicList;
+            int width = FFMIN(ctb_size, sps->width - x_ctb);
+            int yp_pu = (y_ctb - 1) >> log2_min_pu_size;
+            int yq_pu =  y_ctb      >> log2_min_pu_size;
+            int yp_tu = (y_ctb - 1) >> log2_min_tu_size;
+            int yq_tu =  y_ctb      >> log2_min_tu_size;
+
+            for (i = 0; i < width; i += 4) {
+                int x_pu = (x_ctb + i) >> log2_min_pu_size;
+                int x_tu = (x_ctb + i) >> log2_min_tu_size;
+                const MvField *top  = &tab_mvf[yp_pu * min_pu_width + x_pu];
+                const MvField *curr = &tab_mvf[yq_pu * min_pu_width + x_pu];
+                uint8_t top_cbf_luma  = s->cbf_luma[yp_tu * min_tu_width + x_tu];
+                uint8_t curr_cbf_luma = s->cbf_luma[yq_tu * min_tu_width + x_tu];
+
+                if (curr->pred_flag == PF_INTRA || top->pred_flag == PF_INTRA)
+                    bs = 2;
+                else if (curr_cbf_luma || top_cbf_luma)
+                    bs = 1;
+                else
+                    bs = boundary_strength(s, curr, top, rpl_top);
+                s->horizontal_bs[((x_ctb + i) + y_ctb * s->bs_width) >> 2] = bs;
+            }
+        }
+    }
+
+    if (x_ctb > 0 &&
+        pps->tile_id[pps->ctb_addr_rs_to_ts[ctb_addr_rs - 1]] != tile) {
+        int slice_edge = s->tab_slice_address[ctb_addr_rs] !=
+                         s->tab_slice_address[ctb_addr_rs - 1];
+
+        if (!slice_edge || s->sh.slice_loop_filter_across_slices_enabled_flag) {
+            const RefPicList *rpl_left = slice_edge ?
+                                         ff_hevc_get_ref_list(s, s->ref, x_ctb - 1, y_ctb) :
+                                         s->ref->refPicList;
+            int height = FFMIN(ctb_size, sps->height - y_ctb);
+            int xp_pu = (x_ctb - 1) >> log2_min_pu_size;
+            int xq_pu =  x_ctb      >> log2_min_pu_size;
+            int xp_tu = (x_ctb - 1) >> log2_min_tu_size;
+            int xq_tu =  x_ctb      >> log2_min_tu_size;
+
+            for (i = 0; i < height; i += 4) {
+                int y_pu      = (y_ctb + i) >> log2_min_pu_size;
+                int y_tu      = (y_ctb + i) >> log2_min_tu_size;
+                const MvField *left = &tab_mvf[y_pu * min_pu_width + xp_pu];
+                const MvField *curr = &tab_mvf[y_pu * min_pu_width + xq_pu];
+                uint8_t left_cbf_luma = s->cbf_luma[y_tu * min_tu_width + xp_tu];
+                uint8_t curr_cbf_luma = s->cbf_luma[y_tu * min_tu_width + xq_tu];
+
+                if (curr->pred_flag == PF_INTRA || left->pred_flag == PF_INTRA)
+                    bs = 2;
+                else if (curr_cbf_luma || left_cbf_luma)
+                    bs = 1;
+                else
+                    bs = boundary_strength(s, curr, left, rpl_left);
+                s->vertical_bs[(x_ctb + (y_ctb + i) * s->bs_width) >> 2] = bs;
+            }
+        }
+    }
+}
+
 #undef LUMA
 #undef CB
 #undef CR
@@ -953,6 +953,7 @@ static int hls_slice_header(HEVCContext *s)
     }
 
     sh->num_entry_point_offsets = 0;
+    s->enable_parallel_tiles = 0;
     if (s->ps.pps->tiles_enabled_flag || s->ps.pps->entropy_coding_sync_enabled_flag) {
         unsigned num_entry_point_offsets = get_ue_golomb_long(gb);
         // It would be possible to bound this tighter but this here is simpler
@@ -987,8 +988,11 @@ static int hls_slice_header(HEVCContext *s)
                 sh->entry_point_offset[i] = val + 1; // +1; // +1 to get the size
             }
             if (s->threads_number > 1 && (s->ps.pps->num_tile_rows > 1 || s->ps.pps->num_tile_columns > 1)) {
-                s->enable_parallel_tiles = 0; // TODO: you can enable tiles in parallel here
-                s->threads_number = 1;
+                if (s->ps.pps->entropy_coding_sync_enabled_flag) {
+                    s->enable_parallel_tiles = 0;
+                    s->threads_number = 1;
+                } else
+                    s->enable_parallel_tiles = 1;
             } else
                 s->enable_parallel_tiles = 0;
         } else
@@ -2678,6 +2682,138 @@ error:
     return ret;
 }
 
+static int hls_decode_entry_tiles(AVCodecContext *avctxt, void *hevc_lclist,
+                                  int job, int self_id)
+{
+    HEVCLocalContext *lc = ((HEVCLocalContext**)hevc_lclist)[self_id];
+    const HEVCContext *const s = lc->parent;
+    const HEVCPPS *const pps = s->ps.pps;
+    int more_data   = 1;
+    int ctb_addr_ts = pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs];
+    int tile        = pps->tile_id[ctb_addr_ts] + job;
+    int ctb_addr_rs = s->sh.slice_ctb_addr_rs;
+    int ret;
+
+    if (job) {
+        ctb_addr_rs = pps->tile_pos_rs[tile];
+        ctb_addr_ts = pps->ctb_addr_rs_to_ts[ctb_addr_rs];
+        ret = init_get_bits8(&lc->gb, s->data + s->sh.offset[job - 1], s->sh.size[job - 1]);
+        if (ret < 0)
+            goto error;
+        ff_init_cabac_decoder(&lc->cc, s->data + s->sh.offset[job - 1], s->sh.size[job - 1]);
+    }
+
+    while (more_data && ctb_addr_ts < s->ps.sps->ctb_size &&
+           pps->tile_id[ctb_addr_ts] == tile) {
+        int x_ctb = (ctb_addr_rs % s->ps.sps->ctb_width) << s->ps.sps->log2_ctb_size;
+        int y_ctb = (ctb_addr_rs / s->ps.sps->ctb_width) << s->ps.sps->log2_ctb_size;
+
+        hls_decode_neighbour(lc, x_ctb, y_ctb, ctb_addr_ts);
+
+        /* Casting const away here is safe, because it is an atomic operation. */
+        if (atomic_load((atomic_int*)&s->wpp_err))
+            return 0;
+
+        ret = ff_hevc_cabac_init(lc, ctb_addr_ts);
+        if (ret < 0)
+            goto error;
+        hls_sao_param(lc, x_ctb >> s->ps.sps->log2_ctb_size, y_ctb >> s->ps.sps->log2_ctb_size);
+
+        s->deblock[ctb_addr_rs].beta_offset = s->sh.beta_offset;
+        s->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
+        s->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
+
+        more_data = hls_coding_quadtree(lc, x_ctb, y_ctb, s->ps.sps->log2_ctb_size, 0);
+        if (more_data < 0) {
+            ret = more_data;
+            goto error;
+        }
+
+        ctb_addr_ts++;
+        ff_hevc_save_states(lc, ctb_addr_ts);
+        if (ctb_addr_ts < s->ps.sps->ctb_size)
+            ctb_addr_rs = pps->ctb_addr_ts_to_rs[ctb_addr_ts];
+    }
+
+    /* A slice segment spanning several tiles contains each of them entirely,
+     * only the last one ends the slice segment. */
+    if ((ctb_addr_ts < s->ps.sps->ctb_size && pps->tile_id[ctb_addr_ts] == tile) ||
+        more_data != (job < s->sh.num_entry_point_offsets)) {
+        atomic_store((atomic_int*)&s->wpp_err, 1);
+        return 0;
+    }
+
+    return ctb_addr_ts >= s->ps.sps->ctb_size ? ctb_addr_ts : 0;
+error:
+    s->tab_slice_address[ctb_addr_rs] = -1;
+    /* Casting const away here is safe, because it is an atomic operation. */
+    atomic_store((atomic_int*)&s->wpp_err, 1);
+    return ret;
+}
+
+static int hls_filter_entry_tiles(AVCodecContext *avctxt, void *hevc_lclist,
+                                  int job, int self_id)
+{
+    HEVCLocalContext *lc = ((HEVCLocalContext**)hevc_lclist)[self_id];
+    const HEVCContext *const s = lc->parent;
+    const HEVCSPS *const sps = s->ps.sps;
+    const HEVCPPS *const pps = s->ps.pps;
+    int ctb_size     = 1 << sps->log2_ctb_size;
+    int ctb_addr_ts  = pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs];
+    int tile_end     = pps->tile_id[ctb_addr_ts] + s->sh.num_entry_point_offsets + 1;
+    int ctb_addr_end = tile_end < pps->num_tile_columns * pps->num_tile_rows ?
+                       pps->ctb_addr_rs_to_ts[pps->tile_pos_rs[tile_end]] :
+                       sps->ctb_size;
+    int ctb_row      = pps->ctb_addr_ts_to_rs[ctb_addr_ts] / sps->ctb_width + job;
+    int y_ctb        = ctb_row << sps->log2_ctb_size;
+    int thread       = ctb_row % s->threads_number;
+
+    /* Each job filters one CTB row of the slice segment, lagging behind the
+     * row above like the WPP decoder does. */
+    for (int x = 0; x < sps->ctb_width; x++) {
+        int ts    = pps->ctb_addr_rs_to_ts[ctb_row * sps->ctb_width + x];
+        int x_ctb = x << sps->log2_ctb_size;
+
+        if (ts >= ctb_addr_ts && ts < ctb_addr_end) {
+            ff_thread_await_progress2(s->avctx, job, thread, SHIFT_CTB_WPP);
+            ff_hevc_hls_filters(lc, x_ctb, y_ctb, ctb_size);
+            if (x_ctb + ctb_size >= sps->width && y_ctb + ctb_size >= sps->height)
+                ff_hevc_hls_filter(lc, x_ctb, y_ctb, ctb_size);
+        }
+        ff_thread_report_progress2(s->avctx, job, thread, 1);
+    }
+    ff_thread_report_progress2(s->avctx, job, thread, SHIFT_CTB_WPP);
+
+    return 0;
+}
+
+static int hls_filter_tiles(HEVCContext *s, int ctb_addr_ts, int ctb_addr_end)
+{
+    const HEVCSPS *const sps = s->ps.sps;
+    const HEVCPPS *const pps = s->ps.pps;
+    int first_row = pps->ctb_addr_ts_to_rs[ctb_addr_ts]    / sps->ctb_width;
+    int last_row  = pps->ctb_addr_ts_to_rs[ctb_addr_end - 1] / sps->ctb_width;
+    int ret;
+
+    if (pps->loop_filter_across_tiles_enabled_flag) {
+        for (int ts = ctb_addr_ts; ts < ctb_addr_end; ts++) {
+            int ctb_addr_rs = pps->ctb_addr_ts_to_rs[ts];
+            ff_hevc_deblocking_boundary_strengths_tiles(s,
+                (ctb_addr_rs % sps->ctb_width) << sps->log2_ctb_size,
+                (ctb_addr_rs / sps->ctb_width) << sps->log2_ctb_size);
+        }
+    }
+
+    ret = ff_slice_thread_allocz_entries(s->avctx, last_row - first_row + 1);
+    if (ret < 0)
+        return ret;
+
+    s->avctx->execute2(s->avctx, hls_filter_entry_tiles, s->HEVClcList, NULL,
+                       last_row - first_row + 1);
+
+    return 0;
+}
+
 static int hls_slice_data_wpp(HEVCContext *s, const H2645NAL *nal)
 {
     const uint8_t *data = nal->data;
@@ -2688,7 +2824,28 @@ static int hls_slice_data_wpp(HEVCContext *s, const H2645NAL *nal)
     int64_t startheader, cmpt = 0;
     int i, j, res = 0;
 
-    if (s->sh.slice_ctb_addr_rs + s->sh.num_entry_point_offsets * s->ps.sps->ctb_width >= s->ps.sps->ctb_width * s->ps.sps->ctb_height) {
+    if (s->enable_parallel_tiles) {
+        const HEVCPPS *const pps = s->ps.pps;
+        int ctb_addr_ts = pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs];
+
+        if (pps->tile_id[ctb_addr_ts] + s->sh.num_entry_point_offsets >=
+            pps->num_tile_columns * pps->num_tile_rows) {
+            av_log(s->avctx, AV_LOG_ERROR, "Tile entry points are wrong (%d %d %d)\n",
+                   pps->tile_id[ctb_addr_ts], s->sh.num_entry_point_offsets,
+                   pps->num_tile_columns * pps->num_tile_rows);
+            return AVERROR_INVALIDDATA;
+        }
+        if (s->sh.dependent_slice_segment_flag) {
+            if (!ctb_addr_ts) {
+                av_log(s->avctx, AV_LOG_ERROR, "Impossible initial tile.\n");
+                return AVERROR_INVALIDDATA;
+            }
+            if (s->tab_slice_address[pps->ctb_addr_ts_to_rs[ctb_addr_ts - 1]] != s->sh.slice_addr) {
+                av_log(s->avctx, AV_LOG_ERROR, "Previous slice segment missing\n");
+                return AVERROR_INVALIDDATA;
+            }
+        }
+    } else if (s->sh.slice_ctb_addr_rs + s->sh.num_entry_point_offsets * s->ps.sps->ctb_width >= s->ps.sps->ctb_width * s->ps.sps->ctb_height) {
         av_log(s->avctx, AV_LOG_ERROR, "WPP ctb addresses are wrong (%d %d %d %d)\n",
             s->sh.slice_ctb_addr_rs, s->sh.num_entry_point_offsets,
             s->ps.sps->ctb_width, s->ps.sps->ctb_height
@@ -2747,16 +2904,43 @@ static int hls_slice_data_wpp(HEVCContext *s, const H2645NAL *nal)
     }
 
     atomic_store(&s->wpp_err, 0);
-    res = ff_slice_thread_allocz_entries(s->avctx, s->sh.num_entry_point_offsets + 1);
-    if (res < 0)
-        return res;
+    if (s->ps.pps->entropy_coding_sync_enabled_flag) {
+        res = ff_slice_thread_allocz_entries(s->avctx, s->sh.num_entry_point_offsets + 1);
+        if (res < 0)
+            return res;
+    }
 
     ret = av_calloc(s->sh.num_entry_point_offsets + 1, sizeof(*ret));
     if (!ret)
         return AVERROR(ENOMEM);
 
-    if (s->ps.pps->entropy_coding_sync_enabled_flag)
+    if (s->ps.pps->entropy_coding_sync_enabled_flag) {
         s->avctx->execute2(s->avctx, hls_decode_entry_wpp, s->HEVClcList, ret, s->sh.num_entry_point_offsets + 1);
+    } else if (s->enable_parallel_tiles) {
+        const HEVCPPS *const pps = s->ps.pps;
+        int ctb_addr_ts  = pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs];
+        int tile_end     = pps->tile_id[ctb_addr_ts] + s->sh.num_entry_point_offsets + 1;
+        int ctb_addr_end = tile_end < pps->num_tile_columns * pps->num_tile_rows ?
+                           pps->ctb_addr_rs_to_ts[pps->tile_pos_rs[tile_end]] :
+                           s->ps.sps->ctb_size;
+
+        /* Tiles are decoded out of order, so mark the whole slice segment
+         * beforehand for the neighbour checks done across tile boundaries. */
+        for (i = ctb_addr_ts; i < ctb_addr_end; i++)
+            s->tab_slice_address[pps->ctb_addr_ts_to_rs[i]] = s->sh.slice_addr;
+
+        s->avctx->execute2(s->avctx, hls_decode_entry_tiles, s->HEVClcList, ret, s->sh.num_entry_point_offsets + 1);
+
+        /* The in-loop filters need the neighbouring tiles, so they run once
+         * all tiles of the slice segment are reconstructed. */
+        if (!atomic_load(&s->wpp_err)) {
+            res = hls_filter_tiles(s, ctb_addr_ts, ctb_addr_end);
+            if (res < 0) {
+                av_free(ret);
+                return res;
+            }
+        }
+    }
 
     for (i = 0; i <= s->sh.num_entry_point_offsets; i++)
         res += ret[i];
@@ -2951,11 +3135,11 @@ static int hevc_frame_end(HEVCContext *s)
             av_assert0(0);
             return AVERROR_BUG;
         case AV_FILM_GRAIN_PARAMS_H274:
-            ret = ff_h274_apply_film_grain(out->frame_grain, out->frame,
-                                           &s->h274db, fgp);
+            ret = ff_h274_apply_film_grain(s->avctx, out->frame_grain, out->frame,
+                                           &s->h274db, &s->h274dsp, fgp);
             break;
         case AV_FILM_GRAIN_PARAMS_AV1:
-            ret = ff_aom_apply_film_grain(out->frame_grain, out->frame, fgp);
+            ret = ff_aom_apply_film_grain(s->avctx, out->frame_grain, out->frame, fgp);
             break;
         }
         av_assert1(ret >= 0);
@@ -3520,6 +3704,7 @@ static av_cold int hevc_init_context(AVCodecContext *avctx)
         return AVERROR(ENOMEM);
 
     ff_bswapdsp_init(&s->bdsp);
+    ff_h274_film_grain_dsp_init(&s->h274dsp);
 
     s->dovi_ctx.logctx = avctx;
     s->eos = 0;
@@ -498,6 +498,7 @@ typedef struct HEVCContext {
     VideoDSPContext vdsp;
     BswapDSPContext bdsp;
     H274FilmGrainDatabase h274db;
+    H274FilmGrainDSPContext h274dsp;
     int8_t *qp_y_tab;
     uint8_t *horizontal_bs;
     uint8_t *vertical_bs;
@@ -657,6 +658,13 @@ void ff_hevc_set_qPy(HEVCLocalContext *lc, int xBase, int yBase,
                      int log2_cb_size);
 void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
                                            int log2_trafo_size);
+/**
+ * Compute the boundary strengths of the left and upper edges of a CTB
+ * that lie on tile boundaries. Used when tiles are decoded in parallel,
+ * as those edges can only be handled once the neighbouring tile is done.
+ */
+void ff_hevc_deblocking_boundary_strengths_tiles(const HEVCContext *s,
+                                                 int x_ctb, int y_ctb);
 int ff_hevc_cu_qp_delta_sign_flag(HEVCLocalContext *lc);
 int ff_hevc_cu_qp_delta_abs(HEVCLocalContext *lc);
 int ff_hevc_cu_chroma_qp_offset_flag(HEVCLocalContext *lc);
@@ -77,5 +77,7 @@ void ff_hevc_pred_init(HEVCPredContext *hpc, int bit_depth)
 
 #if ARCH_MIPS
     ff_hevc_pred_init_mips(hpc, bit_depth);
+#elif ARCH_X86
+    ff_hevc_pred_init_x86(hpc, bit_depth);
 #endif
 }
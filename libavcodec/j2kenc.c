@@ -109,6 +109,14 @@ typedef struct {
    double *layer_rates;
 } Jpeg2000Tile;
 
+typedef struct {
+    Jpeg2000Component *comp;
+    Jpeg2000Band *band;
+    Jpeg2000Cblk *cblk;
+    int xx0, yy0, xx1, yy1; ///< code-block position in the transformed component
+    int bandpos, lev;
+} Jpeg2000CblkJob;
+
 typedef struct {
     AVClass *class;
     AVCodecContext *avctx;
@@ -144,6 +152,10 @@ typedef struct {
     int prog;
     int nlayers;
     char *lr_str;
+
+    Jpeg2000T1Context *t1;     ///< one tier-1 context per slice thread
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned cblk_jobs_size;
 } Jpeg2000EncoderContext;
 
 
@@ -704,7 +716,7 @@ static void encode_clnpass(Jpeg2000T1Context *t1, int width, int height, int ban
         }
 }
 
-static void encode_cblk(Jpeg2000EncoderContext *s, Jpeg2000T1Context *t1, Jpeg2000Cblk *cblk, Jpeg2000Tile *tile,
+static void encode_cblk(Jpeg2000EncoderContext *s, Jpeg2000T1Context *t1, Jpeg2000Cblk *cblk,
                         int width, int height, int bandpos, int lev)
 {
     int pass_t = 2, passno, x, y, max=0, nmsedec, bpno;
@@ -1401,20 +1413,82 @@ static void truncpasses(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
     }
 }
 
+static int dwt_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000Tile *tile = arg;
+    Jpeg2000Component *comp = tile->comp + jobnr;
+
+    return ff_dwt_encode(&comp->dwt, comp->i_data);
+}
+
+static int encode_cblk_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000EncoderContext *s = avctx->priv_data;
+    Jpeg2000CblkJob *job = (Jpeg2000CblkJob *)arg + jobnr;
+    Jpeg2000Component *comp = job->comp;
+    Jpeg2000T1Context *t1 = s->t1 + threadnr;
+    int w = comp->coord[0][1] - comp->coord[0][0];
+    int x, y;
+
+    t1->stride = (1<<s->codsty.log2_cblk_width) + 2;
+
+    if (s->codsty.transform == FF_DWT53){
+        for (y = job->yy0; y < job->yy1; y++){
+            int *ptr = t1->data + (y-job->yy0)*t1->stride;
+            for (x = job->xx0; x < job->xx1; x++){
+                *ptr++ = comp->i_data[w * y + x] * (1 << NMSEDEC_FRACBITS);
+            }
+        }
+    } else{
+        int64_t scale = 16384 * 65536 / job->band->i_stepsize;
+        for (y = job->yy0; y < job->yy1; y++){
+            int *ptr = t1->data + (y-job->yy0)*t1->stride;
+            for (x = job->xx0; x < job->xx1; x++){
+                *ptr = (comp->i_data[w * y + x]);
+                *ptr = (int64_t)*ptr * scale >> 15 - NMSEDEC_FRACBITS;
+                ptr++;
+            }
+        }
+    }
+    encode_cblk(s, t1, job->cblk, job->xx1 - job->xx0, job->yy1 - job->yy0,
+                job->bandpos, job->lev);
+    return 0;
+}
+
 static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno)
 {
-    int compno, reslevelno, bandno, ret;
-    Jpeg2000T1Context t1;
+    int compno, reslevelno, bandno, ret, nb_jobs = 0;
+    int dwt_ret[FF_ARRAY_ELEMS(s->cbps)];
     Jpeg2000CodingStyle *codsty = &s->codsty;
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = s->tile[tileno].comp + compno;
+    Jpeg2000CblkJob *job;
 
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
+    av_assert0(s->ncomponents <= FF_ARRAY_ELEMS(dwt_ret));
+    av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
+    s->avctx->execute2(s->avctx, dwt_job, tile, dwt_ret, s->ncomponents);
+    for (compno = 0; compno < s->ncomponents; compno++)
+        if (dwt_ret[compno] < 0)
+            return dwt_ret[compno];
+    av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
 
-        av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
-        if ((ret = ff_dwt_encode(&comp->dwt, comp->i_data)) < 0)
-            return ret;
-        av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = tile->comp + compno;
+        for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
+            Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
+            for (bandno = 0; bandno < reslevel->nbands ; bandno++){
+                Jpeg2000Prec *prec = reslevel->band[bandno].prec;
+                nb_jobs += prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+            }
+        }
+    }
+    av_fast_malloc(&s->cblk_jobs, &s->cblk_jobs_size, nb_jobs * sizeof(*s->cblk_jobs));
+    if (!s->cblk_jobs)
+        return AVERROR(ENOMEM);
+    job = s->cblk_jobs;
+
+    // the code-blocks are coded independently, collect them here and
+    // run tier-1 on them in parallel
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = tile->comp + compno;
 
         for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
             Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
@@ -1443,32 +1517,23 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                                 band->coord[0][1]) - band->coord[0][0] + xx0;
 
                     for (cblkx = 0; cblkx < prec->nb_codeblocks_width; cblkx++, cblkno++){
-                        int y, x;
-                        if (codsty->transform == FF_DWT53){
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr++ = comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x] * (1 << NMSEDEC_FRACBITS);
-                                }
-                            }
-                        } else{
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr = (comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x]);
-                                    *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
-                                    ptr++;
-                                }
-                            }
-                        }
                         if (!prec->cblk[cblkno].data)
                             prec->cblk[cblkno].data = av_malloc(1 + 8192);
                         if (!prec->cblk[cblkno].passes)
                             prec->cblk[cblkno].passes = av_malloc_array(JPEG2000_MAX_PASSES, sizeof (*prec->cblk[cblkno].passes));
                         if (!prec->cblk[cblkno].data || !prec->cblk[cblkno].passes)
                             return AVERROR(ENOMEM);
-                        encode_cblk(s, &t1, prec->cblk + cblkno, tile, xx1 - xx0, yy1 - yy0,
-                                    bandpos, codsty->nreslevels - reslevelno - 1);
+                        *job++ = (Jpeg2000CblkJob) {
+                            .comp    = comp,
+                            .band    = band,
+                            .cblk    = prec->cblk + cblkno,
+                            .xx0     = xx0,
+                            .yy0     = yy0,
+                            .xx1     = xx1,
+                            .yy1     = yy1,
+                            .bandpos = bandpos,
+                            .lev     = codsty->nreslevels - reslevelno - 1,
+                        };
                         xx0 = xx1;
                         xx1 = FFMIN(xx1 + (1 << band->log2_cblk_width), band->coord[0][1] - band->coord[0][0] + x0);
                     }
@@ -1477,9 +1542,11 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                 }
             }
         }
-        av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
     }
 
+    s->avctx->execute2(s->avctx, encode_cblk_job, s->cblk_jobs, NULL, job - s->cblk_jobs);
+    av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
+
     av_log(s->avctx, AV_LOG_DEBUG, "rate control\n");
     if (s->compression_rate_enc)
         makelayers(s, tile);
@@ -1784,6 +1851,11 @@ static av_cold int j2kenc_init(AVCodecContext *avctx)
 
     ff_thread_once(&init_static_once, init_luts);
 
+    s->t1 = av_calloc((avctx->active_thread_type & FF_THREAD_SLICE) ? avctx->thread_count : 1,
+                      sizeof(*s->t1));
+    if (!s->t1)
+        return AVERROR(ENOMEM);
+
     init_quantization(s);
     if ((ret=init_tiles(s)) < 0)
         return ret;
@@ -1798,6 +1870,8 @@ static int j2kenc_destroy(AVCodecContext *avctx)
     Jpeg2000EncoderContext *s = avctx->priv_data;
 
     cleanup(s);
+    av_freep(&s->t1);
+    av_freep(&s->cblk_jobs);
     return 0;
 }
 
@@ -1839,7 +1913,7 @@ const FFCodec ff_jpeg2000_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_JPEG2000,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
-                      AV_CODEC_CAP_FRAME_THREADS,
+                      AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(Jpeg2000EncoderContext),
     .init           = j2kenc_init,
     FF_CODEC_ENCODE_CB(encode_frame),
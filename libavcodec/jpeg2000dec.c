@@ -1571,34 +1571,43 @@ static int jpeg2000_decode_packets(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile
 }
 
 /* TIER-1 routines */
+
+/* Neighbourhood flags ignored for the last row of a stripe with
+ * vertically causal context formation. */
+#define VSC_MASK ~(JPEG2000_T1_SIG_S | JPEG2000_T1_SIG_SW | JPEG2000_T1_SIG_SE | JPEG2000_T1_SGN_S)
+
 static void decode_sigpass(Jpeg2000T1Context *t1, int width, int height,
                            int bpno, int bandno,
                            int vert_causal_ctx_csty_symbol)
 {
     int mask = 3 << (bpno - 1), y0, x, y;
+    const int stride    = t1->stride;
+    const int last_mask = vert_causal_ctx_csty_symbol ? VSC_MASK : -1;
 
-    for (y0 = 0; y0 < height; y0 += 4)
-        for (x = 0; x < width; x++)
-            for (y = y0; y < height && y < y0 + 4; y++) {
-                int flags_mask = -1;
-                if (vert_causal_ctx_csty_symbol && y == y0 + 3)
-                    flags_mask &= ~(JPEG2000_T1_SIG_S | JPEG2000_T1_SIG_SW | JPEG2000_T1_SIG_SE | JPEG2000_T1_SGN_S);
-                if ((t1->flags[(y+1) * t1->stride + x+1] & JPEG2000_T1_SIG_NB & flags_mask)
-                && !(t1->flags[(y+1) * t1->stride + x+1] & (JPEG2000_T1_SIG | JPEG2000_T1_VIS))) {
-                    if (ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + ff_jpeg2000_getsigctxno(t1->flags[(y+1) * t1->stride + x+1] & flags_mask, bandno))) {
-                        int xorbit, ctxno = ff_jpeg2000_getsgnctxno(t1->flags[(y+1) * t1->stride + x+1] & flags_mask, &xorbit);
+    for (y0 = 0; y0 < height; y0 += 4) {
+        int y1 = FFMIN(y0 + 4, height);
+        for (x = 0; x < width; x++) {
+            uint16_t *flags = t1->flags + (y0 + 1) * stride + x + 1;
+            int      *data  = t1->data  +  y0      * stride + x;
+            for (y = y0; y < y1; y++, flags += stride, data += stride) {
+                int flags_mask = y == y0 + 3 ? last_mask : -1;
+                if ((*flags & JPEG2000_T1_SIG_NB & flags_mask)
+                && !(*flags & (JPEG2000_T1_SIG | JPEG2000_T1_VIS))) {
+                    if (ff_mqc_decode_fast(&t1->mqc, t1->mqc.cx_states + ff_jpeg2000_getsigctxno(*flags & flags_mask, bandno))) {
+                        int xorbit, ctxno = ff_jpeg2000_getsgnctxno(*flags & flags_mask, &xorbit);
                         if (t1->mqc.raw)
-                             t1->data[(y) * t1->stride + x] = ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + ctxno) ? -mask : mask;
+                             *data = ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + ctxno) ? -mask : mask;
                         else
-                             t1->data[(y) * t1->stride + x] = (ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + ctxno) ^ xorbit) ?
-                                               -mask : mask;
+                             *data = (ff_mqc_decode_fast(&t1->mqc, t1->mqc.cx_states + ctxno) ^ xorbit) ?
+                                     -mask : mask;
 
-                        ff_jpeg2000_set_significance(t1, x, y,
-                                                     t1->data[(y) * t1->stride + x] < 0);
+                        ff_jpeg2000_set_significance(t1, x, y, *data < 0);
                     }
-                    t1->flags[(y + 1) * t1->stride + x + 1] |= JPEG2000_T1_VIS;
+                    *flags |= JPEG2000_T1_VIS;
                 }
             }
+        }
+    }
 }
 
 static void decode_refpass(Jpeg2000T1Context *t1, int width, int height,
@@ -1606,23 +1615,29 @@ static void decode_refpass(Jpeg2000T1Context *t1, int width, int height,
 {
     int phalf, nhalf;
     int y0, x, y;
+    const int stride    = t1->stride;
+    const int last_mask = vert_causal_ctx_csty_symbol ? VSC_MASK : -1;
 
     phalf = 1 << (bpno - 1);
     nhalf = -phalf;
 
-    for (y0 = 0; y0 < height; y0 += 4)
-        for (x = 0; x < width; x++)
-            for (y = y0; y < height && y < y0 + 4; y++)
-                if ((t1->flags[(y + 1) * t1->stride + x + 1] & (JPEG2000_T1_SIG | JPEG2000_T1_VIS)) == JPEG2000_T1_SIG) {
-                    int flags_mask = (vert_causal_ctx_csty_symbol && y == y0 + 3) ?
-                        ~(JPEG2000_T1_SIG_S | JPEG2000_T1_SIG_SW | JPEG2000_T1_SIG_SE | JPEG2000_T1_SGN_S) : -1;
-                    int ctxno = ff_jpeg2000_getrefctxno(t1->flags[(y + 1) * t1->stride + x + 1] & flags_mask);
-                    int r     = ff_mqc_decode(&t1->mqc,
-                                              t1->mqc.cx_states + ctxno)
+    for (y0 = 0; y0 < height; y0 += 4) {
+        int y1 = FFMIN(y0 + 4, height);
+        for (x = 0; x < width; x++) {
+            uint16_t *flags = t1->flags + (y0 + 1) * stride + x + 1;
+            int      *data  = t1->data  +  y0      * stride + x;
+            for (y = y0; y < y1; y++, flags += stride, data += stride)
+                if ((*flags & (JPEG2000_T1_SIG | JPEG2000_T1_VIS)) == JPEG2000_T1_SIG) {
+                    int flags_mask = y == y0 + 3 ? last_mask : -1;
+                    int ctxno = ff_jpeg2000_getrefctxno(*flags & flags_mask);
+                    int r     = ff_mqc_decode_fast(&t1->mqc,
+                                                   t1->mqc.cx_states + ctxno)
                                 ? phalf : nhalf;
-                    t1->data[(y) * t1->stride + x]          += t1->data[(y) * t1->stride + x] < 0 ? -r : r;
-                    t1->flags[(y + 1) * t1->stride + x + 1] |= JPEG2000_T1_REF;
+                    *data  += *data < 0 ? -r : r;
+                    *flags |= JPEG2000_T1_REF;
                 }
+        }
+    }
 }
 
 static void decode_clnpass(const Jpeg2000DecoderContext *s, Jpeg2000T1Context *t1,
@@ -1630,52 +1645,55 @@ static void decode_clnpass(const Jpeg2000DecoderContext *s, Jpeg2000T1Context *t
                            int seg_symbols, int vert_causal_ctx_csty_symbol)
 {
     int mask = 3 << (bpno - 1), y0, x, y, runlen, dec;
+    const int stride    = t1->stride;
+    const int last_mask = vert_causal_ctx_csty_symbol ? VSC_MASK : -1;
 
     for (y0 = 0; y0 < height; y0 += 4) {
+        int y1 = FFMIN(y0 + 4, height);
         for (x = 0; x < width; x++) {
-            int flags_mask = -1;
-            if (vert_causal_ctx_csty_symbol)
-                flags_mask &= ~(JPEG2000_T1_SIG_S | JPEG2000_T1_SIG_SW | JPEG2000_T1_SIG_SE | JPEG2000_T1_SGN_S);
-            if (y0 + 3 < height &&
-                !((t1->flags[(y0 + 1) * t1->stride + x + 1] & (JPEG2000_T1_SIG_NB | JPEG2000_T1_VIS | JPEG2000_T1_SIG)) ||
-                  (t1->flags[(y0 + 2) * t1->stride + x + 1] & (JPEG2000_T1_SIG_NB | JPEG2000_T1_VIS | JPEG2000_T1_SIG)) ||
-                  (t1->flags[(y0 + 3) * t1->stride + x + 1] & (JPEG2000_T1_SIG_NB | JPEG2000_T1_VIS | JPEG2000_T1_SIG)) ||
-                  (t1->flags[(y0 + 4) * t1->stride + x + 1] & (JPEG2000_T1_SIG_NB | JPEG2000_T1_VIS | JPEG2000_T1_SIG) & flags_mask))) {
-                if (!ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + MQC_CX_RL))
+            uint16_t *flags = t1->flags + (y0 + 1) * stride + x + 1;
+            int      *data  = t1->data  +  y0      * stride + x;
+            if (y1 == y0 + 4 &&
+                !((flags[0]          |
+                   flags[stride]     |
+                   flags[2 * stride] |
+                   (flags[3 * stride] & last_mask)) &
+                  (JPEG2000_T1_SIG_NB | JPEG2000_T1_VIS | JPEG2000_T1_SIG))) {
+                if (!ff_mqc_decode_fast(&t1->mqc, t1->mqc.cx_states + MQC_CX_RL))
                     continue;
-                runlen = ff_mqc_decode(&t1->mqc,
-                                       t1->mqc.cx_states + MQC_CX_UNI);
-                runlen = (runlen << 1) | ff_mqc_decode(&t1->mqc,
-                                                       t1->mqc.cx_states +
-                                                       MQC_CX_UNI);
+                runlen = ff_mqc_decode_fast(&t1->mqc,
+                                            t1->mqc.cx_states + MQC_CX_UNI);
+                runlen = (runlen << 1) | ff_mqc_decode_fast(&t1->mqc,
+                                                            t1->mqc.cx_states +
+                                                            MQC_CX_UNI);
                 dec = 1;
             } else {
                 runlen = 0;
                 dec    = 0;
             }
 
-            for (y = y0 + runlen; y < y0 + 4 && y < height; y++) {
-                int flags_mask = -1;
-                if (vert_causal_ctx_csty_symbol && y == y0 + 3)
-                    flags_mask &= ~(JPEG2000_T1_SIG_S | JPEG2000_T1_SIG_SW | JPEG2000_T1_SIG_SE | JPEG2000_T1_SGN_S);
+            flags += runlen * stride;
+            data  += runlen * stride;
+            for (y = y0 + runlen; y < y1; y++, flags += stride, data += stride) {
+                int flags_mask = y == y0 + 3 ? last_mask : -1;
                 if (!dec) {
-                    if (!(t1->flags[(y+1) * t1->stride + x+1] & (JPEG2000_T1_SIG | JPEG2000_T1_VIS))) {
-                        dec = ff_mqc_decode(&t1->mqc, t1->mqc.cx_states + ff_jpeg2000_getsigctxno(t1->flags[(y+1) * t1->stride + x+1] & flags_mask,
-                                                                                             bandno));
+                    if (!(*flags & (JPEG2000_T1_SIG | JPEG2000_T1_VIS))) {
+                        dec = ff_mqc_decode_fast(&t1->mqc, t1->mqc.cx_states + ff_jpeg2000_getsigctxno(*flags & flags_mask,
+                                                                                                  bandno));
                     }
                 }
                 if (dec) {
                     int xorbit;
-                    int ctxno = ff_jpeg2000_getsgnctxno(t1->flags[(y + 1) * t1->stride + x + 1] & flags_mask,
+                    int ctxno = ff_jpeg2000_getsgnctxno(*flags & flags_mask,
                                                         &xorbit);
-                    t1->data[(y) * t1->stride + x] = (ff_mqc_decode(&t1->mqc,
-                                                    t1->mqc.cx_states + ctxno) ^
-                                      xorbit)
-                                     ? -mask : mask;
-                    ff_jpeg2000_set_significance(t1, x, y, t1->data[(y) * t1->stride + x] < 0);
+                    *data = (ff_mqc_decode_fast(&t1->mqc,
+                                                t1->mqc.cx_states + ctxno) ^
+                             xorbit)
+                            ? -mask : mask;
+                    ff_jpeg2000_set_significance(t1, x, y, *data < 0);
                 }
                 dec = 0;
-                t1->flags[(y + 1) * t1->stride + x + 1] &= ~JPEG2000_T1_VIS;
+                *flags &= ~JPEG2000_T1_VIS;
             }
         }
     }
@@ -25,6 +25,10 @@
  * Discrete wavelet transform
  */
 
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
 #include "libavutil/error.h"
 #include "libavutil/macros.h"
 #include "libavutil/mem.h"
@@ -47,6 +51,97 @@
 #define I_LFTG_X       53274ll
 #define I_PRESHIFT 8
 
+static void lift_int_add_c(int32_t *dst, const int32_t *a, const int32_t *b,
+                           int w, int rnd, int shift)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] += (int)((unsigned)a[i] + b[i] + rnd) >> shift;
+}
+
+static void lift_int_sub_c(int32_t *dst, const int32_t *a, const int32_t *b,
+                           int w, int rnd, int shift)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] -= (int)((unsigned)a[i] + b[i] + rnd) >> shift;
+}
+
+static void lift97_int_add_c(int32_t *dst, const int32_t *a, const int32_t *b,
+                             int w, int coef)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] += (coef * ((int64_t)a[i] + b[i]) + (1 << 15)) >> 16;
+}
+
+static void lift97_int_sub_c(int32_t *dst, const int32_t *a, const int32_t *b,
+                             int w, int coef)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] -= (coef * ((int64_t)a[i] + b[i]) + (1 << 15)) >> 16;
+}
+
+static void lift97_float_c(float *dst, const float *a, const float *b,
+                           int w, float coef)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] += coef * (a[i] + b[i]);
+}
+
+static av_always_inline int mirror(int k, int n)
+{
+    if (k < 0)
+        return -k;
+    if (k >= n)
+        return 2 * (n - 1) - k;
+    return k;
+}
+
+/* row k of the lh x lv block at t, with whole-sample symmetric extension */
+#define ROW(k) (t + w * mirror(k, lv))
+
+/* Deinterleave the rows of the lh x lv block at t: low-pass rows
+ * (those with k % 2 == mv) first, followed by the high-pass rows. */
+static void deinterleave_rows(DWTContext *s, int32_t *t, int w,
+                              int lh, int lv, int mv)
+{
+    int32_t *buf = s->i_rowbuf;
+    int j, k, nb_high = 0;
+
+    for (k = 1 - mv; k < lv; k += 2)
+        memcpy(buf + lh * nb_high++, t + w * k, lh * sizeof(*t));
+    for (j = 0, k = mv; k < lv; k += 2, j++)
+        if (j != k)
+            memcpy(t + w * j, t + w * k, lh * sizeof(*t));
+    for (k = 0; k < nb_high; k++)
+        memcpy(t + w * (j + k), buf + lh * k, lh * sizeof(*t));
+}
+
+/* Inverse of deinterleave_rows(). */
+static void interleave_rows(void *rowbuf, void *t, int w,
+                            int lh, int lv, int mv)
+{
+    int32_t *buf = rowbuf, *t32 = t;
+    int nb_low = (lv - mv + 1) >> 1, nb_high = lv - nb_low;
+    int j;
+
+    for (j = 0; j < nb_high; j++)
+        memcpy(buf + lh * j, t32 + w * (nb_low + j), lh * sizeof(*t32));
+    for (j = nb_low - 1; j >= 0; j--)
+        if (mv + 2 * j != j)
+            memcpy(t32 + w * (mv + 2 * j), t32 + w * j, lh * sizeof(*t32));
+    for (j = 0; j < nb_high; j++)
+        memcpy(t32 + w * (1 - mv + 2 * j), buf + lh * j, lh * sizeof(*t32));
+}
+
 static inline void extend53(int *p, int i0, int i1)
 {
     p[i0 - 1] = p[i0 + 1];
@@ -93,6 +188,27 @@ static void sd_1d53(int *p, int i0, int i1)
         p[2*i] += (p[2*i-1] + p[2*i+1] + 2) >> 2;
 }
 
+/* Row-wise counterpart of sd_1d53(), filtering whole rows of the
+ * lh x lv block at t at once. */
+static void ver_sd53(DWTContext *s, int *t, int w, int lh, int lv, int mv)
+{
+    int k;
+
+    if (lv == 1) {
+        if (mv)
+            for (k = 0; k < lh; k++)
+                t[k] *= 2;
+        return;
+    }
+
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, 0, 1);
+    for (k = mv; k < lv; k += 2)
+        s->lift_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, 2, 2);
+
+    deinterleave_rows(s, t, w, lh, lv, mv);
+}
+
 static void dwt_encode53(DWTContext *s, int *t)
 {
     int lev,
@@ -109,21 +225,7 @@ static void dwt_encode53(DWTContext *s, int *t)
         int *l;
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-
-            for (i = 0; i < lv; i++)
-                l[i] = t[w*i + lp];
-
-            sd_1d53(line, mv, mv + lv);
-
-            // copy back and deinterleave
-            for (i =   mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
-            for (i = 1-mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
-        }
+        ver_sd53(s, t, w, lh, lv, mv);
 
         // HOR_SD
         l = line + mh;
@@ -244,6 +346,37 @@ static void sd_1d97_int(int *p, int i0, int i1)
         p[2 * i]     += (I_LFTG_DELTA * (p[2 * i - 1] + p[2 * i + 1]) + (1 << 15)) >> 16;
 }
 
+/* Row-wise counterpart of sd_1d97_int() including the final scaling
+ * of the low-pass rows. */
+static void ver_sd97_int(DWTContext *s, int *t, int w, int lh, int lv, int mv)
+{
+    int k, j;
+
+    if (lv == 1) {
+        for (k = 0; k < lh; k++)
+            if (mv)
+                t[k] = (t[k] * I_LFTG_X + (1<<14)) >> 15;
+            else
+                t[k] = (((t[k] * I_LFTG_K + (1<<15)) >> 16) * I_LFTG_X + (1<<15)) >> 16;
+        return;
+    }
+
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_ALPHA);
+    for (k = mv; k < lv; k += 2)
+        s->lift97_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_BETA);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_GAMMA);
+    for (k = mv; k < lv; k += 2)
+        s->lift97_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_DELTA);
+
+    deinterleave_rows(s, t, w, lh, lv, mv);
+
+    for (j = 0; j < (lv - mv + 1) >> 1; j++)
+        for (k = 0; k < lh; k++)
+            t[w*j + k] = ((t[w*j + k] * I_LFTG_X) + (1 << 15)) >> 16;
+}
+
 static void dwt_encode97_int(DWTContext *s, int *t)
 {
     int lev;
@@ -265,21 +398,7 @@ static void dwt_encode97_int(DWTContext *s, int *t)
         int *l;
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-
-            for (i = 0; i < lv; i++)
-                l[i] = t[w*i + lp];
-
-            sd_1d97_int(line, mv, mv + lv);
-
-            // copy back and deinterleave
-            for (i =   mv; i < lv; i+=2, j++)
-                t[w*j + lp] = ((l[i] * I_LFTG_X) + (1 << 15)) >> 16;
-            for (i = 1-mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
-        }
+        ver_sd97_int(s, t, w, lh, lv, mv);
 
         // HOR_SD
         l = line + mh;
@@ -322,6 +441,26 @@ static void sr_1d53(unsigned *p, int i0, int i1)
         p[2 * i + 1] += (int)(p[2 * i] + p[2 * i + 2]) >> 1;
 }
 
+/* Row-wise counterpart of sr_1d53(). */
+static void ver_sr53(DWTContext *s, int *t, int w, int lh, int lv, int mv)
+{
+    int k;
+
+    if (lv == 1) {
+        if (mv)
+            for (k = 0; k < lh; k++)
+                t[k] >>= 1;
+        return;
+    }
+
+    interleave_rows(s->i_rowbuf, t, w, lh, lv, mv);
+
+    for (k = mv; k < lv; k += 2)
+        s->lift_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, 2, 2);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, 0, 1);
+}
+
 static void dwt_decode53(DWTContext *s, int *t)
 {
     int lev;
@@ -354,20 +493,7 @@ static void dwt_decode53(DWTContext *s, int *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-            // copy with interleaving
-            for (i = mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
-            for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
-
-            sr_1d53(line, mv, mv + lv);
-
-            for (i = 0; i < lv; i++)
-                t[w * i + lp] = l[i];
-        }
+        ver_sr53(s, t, w, lh, lv, mv);
     }
 }
 
@@ -398,6 +524,29 @@ static void sr_1d97_float(float *p, int i0, int i1)
         p[2 * i + 1] += F_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]);
 }
 
+/* Row-wise counterpart of sr_1d97_float(). */
+static void ver_sr97_float(DWTContext *s, float *t, int w, int lh, int lv, int mv)
+{
+    int k;
+
+    if (lv == 1) {
+        for (k = 0; k < lh; k++)
+            t[k] *= mv ? F_LFTG_K/2 : F_LFTG_X;
+        return;
+    }
+
+    interleave_rows(s->i_rowbuf, t, w, lh, lv, mv);
+
+    for (k = mv; k < lv; k += 2)
+        s->lift97_float(ROW(k), ROW(k - 1), ROW(k + 1), lh, -F_LFTG_DELTA);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_float(ROW(k), ROW(k - 1), ROW(k + 1), lh, -F_LFTG_GAMMA);
+    for (k = mv; k < lv; k += 2)
+        s->lift97_float(ROW(k), ROW(k - 1), ROW(k + 1), lh,  F_LFTG_BETA);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_float(ROW(k), ROW(k - 1), ROW(k + 1), lh,  F_LFTG_ALPHA);
+}
+
 static void dwt_decode97_float(DWTContext *s, float *t)
 {
     int lev;
@@ -431,20 +580,7 @@ static void dwt_decode97_float(DWTContext *s, float *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-            // copy with interleaving
-            for (i = mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
-            for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
-
-            sr_1d97_float(line, mv, mv + lv);
-
-            for (i = 0; i < lv; i++)
-                data[w * i + lp] = l[i];
-        }
+        ver_sr97_float(s, data, w, lh, lv, mv);
     }
 }
 
@@ -475,6 +611,37 @@ static void sr_1d97_int(int32_t *p, int i0, int i1)
         p[2 * i + 1] += (I_LFTG_ALPHA * (p[2 * i]     + (int64_t)p[2 * i + 2]) + (1 << 15)) >> 16;
 }
 
+/* Row-wise counterpart of sr_1d97_int() including the initial scaling
+ * of the low-pass rows. */
+static void ver_sr97_int(DWTContext *s, int32_t *t, int w, int lh, int lv, int mv)
+{
+    int j, k;
+
+    if (lv == 1) {
+        for (k = 0; k < lh; k++)
+            if (mv)
+                t[k] = (t[k] * I_LFTG_K + (1<<16)) >> 17;
+            else
+                t[k] = ((((t[k] * I_LFTG_K) + (1 << 15)) >> 16) * I_LFTG_X + (1<<15)) >> 16;
+        return;
+    }
+
+    for (j = 0; j < (lv - mv + 1) >> 1; j++)
+        for (k = 0; k < lh; k++)
+            t[w*j + k] = ((t[w*j + k] * I_LFTG_K) + (1 << 15)) >> 16;
+
+    interleave_rows(s->i_rowbuf, t, w, lh, lv, mv);
+
+    for (k = mv; k < lv; k += 2)
+        s->lift97_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_DELTA);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_int[1](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_GAMMA);
+    for (k = mv; k < lv; k += 2)
+        s->lift97_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_BETA);
+    for (k = 1 - mv; k < lv; k += 2)
+        s->lift97_int[0](ROW(k), ROW(k - 1), ROW(k + 1), lh, I_LFTG_ALPHA);
+}
+
 static void dwt_decode97_int(DWTContext *s, int32_t *t)
 {
     int lev;
@@ -513,20 +680,7 @@ static void dwt_decode97_int(DWTContext *s, int32_t *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-            // rescale with interleaving
-            for (i = mv; i < lv; i += 2, j++)
-                l[i] = ((data[w * j + lp] * I_LFTG_K) + (1 << 15)) >> 16;
-            for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
-
-            sr_1d97_int(line, mv, mv + lv);
-
-            for (i = 0; i < lv; i++)
-                data[w * i + lp] = l[i];
-        }
+        ver_sr97_int(s, data, w, lh, lv, mv);
     }
 
     for (i = 0; i < w * h; i++)
@@ -542,6 +696,15 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
     s->ndeclevels = decomp_levels;
     s->type       = type;
 
+    s->lift_int[0]   = lift_int_add_c;
+    s->lift_int[1]   = lift_int_sub_c;
+    s->lift97_int[0] = lift97_int_add_c;
+    s->lift97_int[1] = lift97_int_sub_c;
+    s->lift97_float  = lift97_float_c;
+#if ARCH_X86
+    ff_jpeg2000dwt_init_x86(s);
+#endif
+
     for (i = 0; i < 2; i++)
         for (j = 0; j < 2; j++)
             b[i][j] = border[i][j];
@@ -577,11 +740,26 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
     return 0;
 }
 
+static int alloc_rowbuf(DWTContext *s)
+{
+    int w = s->linelen[s->ndeclevels-1][0];
+    int h = s->linelen[s->ndeclevels-1][1];
+
+    av_fast_malloc(&s->i_rowbuf, &s->i_rowbuf_size,
+                   (size_t)((h + 1) >> 1) * w * sizeof(*s->i_rowbuf));
+    return s->i_rowbuf ? 0 : AVERROR(ENOMEM);
+}
+
 int ff_dwt_encode(DWTContext *s, void *t)
 {
+    int ret;
+
     if (s->ndeclevels == 0)
         return 0;
 
+    if (s->type != FF_DWT97 && (ret = alloc_rowbuf(s)) < 0)
+        return ret;
+
     switch(s->type){
         case FF_DWT97:
             dwt_encode97_float(s, t); break;
@@ -597,9 +775,14 @@ int ff_dwt_encode(DWTContext *s, void *t)
 
 int ff_dwt_decode(DWTContext *s, void *t)
 {
+    int ret;
+
     if (s->ndeclevels == 0)
         return 0;
 
+    if ((ret = alloc_rowbuf(s)) < 0)
+        return ret;
+
     switch (s->type) {
     case FF_DWT97:
         dwt_decode97_float(s, t);
@@ -620,4 +803,6 @@ void ff_dwt_destroy(DWTContext *s)
 {
     av_freep(&s->f_linebuf);
     av_freep(&s->i_linebuf);
+    av_freep(&s->i_rowbuf);
+    s->i_rowbuf_size = 0;
 }
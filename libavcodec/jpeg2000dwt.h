@@ -48,6 +48,27 @@ typedef struct DWTContext {
     uint8_t type;                        ///< 0 for 9/7; 1 for 5/3
     int32_t *i_linebuf;                  ///< int buffer used by transform
     float   *f_linebuf;                  ///< float buffer used by transform
+    int32_t *i_rowbuf;                   ///< row buffer used by the vertical transforms
+    unsigned i_rowbuf_size;
+
+    /**
+     * Lifting step on whole rows: dst[i] +/-= (a[i] + b[i] + rnd) >> shift,
+     * adding for index 0 and subtracting for index 1.
+     */
+    void (*lift_int[2])(int32_t *dst, const int32_t *a, const int32_t *b,
+                        int w, int rnd, int shift);
+    /**
+     * Integer 9/7 lifting step on whole rows:
+     * dst[i] +/-= (coef * ((int64_t)a[i] + b[i]) + (1 << 15)) >> 16,
+     * adding for index 0 and subtracting for index 1.
+     */
+    void (*lift97_int[2])(int32_t *dst, const int32_t *a, const int32_t *b,
+                          int w, int coef);
+    /**
+     * Float 9/7 lifting step on whole rows: dst[i] += coef * (a[i] + b[i]).
+     */
+    void (*lift97_float)(float *dst, const float *a, const float *b,
+                         int w, float coef);
 } DWTContext;
 
 /**
@@ -65,4 +86,6 @@ int ff_dwt_decode(DWTContext *s, void *t);
 
 void ff_dwt_destroy(DWTContext *s);
 
+void ff_jpeg2000dwt_init_x86(DWTContext *s);
+
 #endif /* AVCODEC_JPEG2000DWT_H */
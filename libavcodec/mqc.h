@@ -30,6 +30,8 @@
 
 #include <stdint.h>
 
+#include "libavutil/attributes.h"
+
 #define MQC_CX_UNI 17
 #define MQC_CX_RL  18
 
@@ -76,6 +78,21 @@ void ff_mqc_initdec(MqcState *mqc, uint8_t *bp, int raw, int reset);
  */
 int ff_mqc_decode(MqcState *mqc, uint8_t *cxstate);
 
+/**
+ * MQ decoder with the most probable symbol path inlined; decisions
+ * requiring an exchange or renormalization fall back to ff_mqc_decode().
+ */
+static av_always_inline int ff_mqc_decode_fast(MqcState *mqc, uint8_t *cxstate)
+{
+    unsigned a = mqc->a - ff_mqc_qe[*cxstate];
+
+    if (!mqc->raw && (a & 0x8000) && (mqc->c >> 16) < a) {
+        mqc->a = a;
+        return *cxstate & 1;
+    }
+    return ff_mqc_decode(mqc, cxstate);
+}
+
 /* common */
 
 /**
@@ -62,6 +62,15 @@ typedef struct PNGEncContext {
 
     FFZStream zstream;
     uint8_t buf[IOBUF_SIZE];
+
+    // slice threaded compression of the whole image
+    FFZParallel zparallel;
+    uint8_t *filtered_buf;
+    unsigned int filtered_buf_size;
+    uint8_t *crow_bufs;         ///< filter scratch, one per job
+    int crow_buf_size;
+    int nb_filter_jobs;
+
     int dpi;                     ///< Physical pixel density, in dots per inch, if set
     int dpm;                     ///< Physical pixel density, in dots per meter, if set
 
@@ -505,6 +514,70 @@ static int encode_headers(AVCodecContext *avctx, const AVFrame *pict)
     return 0;
 }
 
+static int png_filter_rows(AVCodecContext *avctx, void *arg,
+                           int jobnr, int threadnr)
+{
+    PNGEncContext *s       = avctx->priv_data;
+    const AVFrame *const p = arg;
+    const int row_size     = (p->width * s->bits_per_pixel + 7) >> 3;
+    const int y_start      = (int64_t)p->height *  jobnr      / s->nb_filter_jobs;
+    const int y_end        = (int64_t)p->height * (jobnr + 1) / s->nb_filter_jobs;
+    // pixel data should be aligned, but there's a control byte before it
+    uint8_t *crow_buf      = s->crow_bufs + jobnr * s->crow_buf_size + 15;
+
+    for (int y = y_start; y < y_end; y++) {
+        const uint8_t *ptr = p->data[0] + y * p->linesize[0];
+        const uint8_t *top = y ? ptr - p->linesize[0] : NULL;
+        const uint8_t *crow = png_choose_filter(s, crow_buf, ptr, top,
+                                                row_size, s->bits_per_pixel >> 3);
+        memcpy(s->filtered_buf + (size_t)y * (row_size + 1), crow, row_size + 1);
+    }
+    return 0;
+}
+
+/**
+ * Filter the rows and compress them into a single IDAT chunk, both in
+ * slice threads. Only used for non-interlaced PNG.
+ */
+static int encode_frame_parallel(AVCodecContext *avctx, const AVFrame *pict)
+{
+    PNGEncContext *s   = avctx->priv_data;
+    const int row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
+    const size_t size  = (size_t)pict->height * (row_size + 1);
+    uint8_t *start     = s->bytestream;
+    size_t len;
+    uint32_t crc;
+    int ret;
+
+    if (size > INT_MAX || s->bytestream_end - start < 12)
+        return AVERROR(EINVAL);
+    av_fast_malloc(&s->filtered_buf, &s->filtered_buf_size, size);
+    if (!s->filtered_buf)
+        return AVERROR(ENOMEM);
+
+    s->nb_filter_jobs = FFMIN(avctx->thread_count, pict->height);
+    s->crow_buf_size  = (row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED);
+    s->crow_bufs      = av_malloc_array(s->nb_filter_jobs, s->crow_buf_size);
+    if (!s->crow_bufs)
+        return AVERROR(ENOMEM);
+    avctx->execute2(avctx, png_filter_rows, (void *)pict, NULL, s->nb_filter_jobs);
+    av_freep(&s->crow_bufs);
+
+    len = s->bytestream_end - start - 12;
+    ret = ff_deflate_parallel(&s->zparallel, avctx, start + 8, &len,
+                              s->filtered_buf, size);
+    if (ret < 0)
+        return ret;
+
+    bytestream_put_be32(&s->bytestream, len);
+    bytestream_put_be32(&s->bytestream, MKBETAG('I', 'D', 'A', 'T'));
+    crc = av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), ~0U, start + 4, len + 4);
+    s->bytestream += len;
+    bytestream_put_be32(&s->bytestream, ~crc);
+
+    return 0;
+}
+
 static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
 {
     PNGEncContext *s       = avctx->priv_data;
@@ -643,6 +716,13 @@ static int encode_png(AVCodecContext *avctx, AVPacket *pkt,
             enc_row_size +
             12 * (((int64_t)enc_row_size + IOBUF_SIZE - 1) / IOBUF_SIZE) // IDAT * ceil(enc_row_size / IOBUF_SIZE)
         );
+    if (s->zparallel.nb_streams > 1 && !s->is_progressive) {
+        size_t size = (size_t)avctx->height *
+                      (((avctx->width * s->bits_per_pixel + 7) >> 3) + 1);
+        max_packet_size = FFMAX(max_packet_size,
+                                FF_INPUT_BUFFER_MIN_SIZE + 12 +
+                                ff_deflate_parallel_bound(size));
+    }
     if ((ret = add_icc_profile_size(avctx, pict, &max_packet_size)))
         return ret;
     ret = ff_alloc_packet(avctx, pkt, max_packet_size);
@@ -660,7 +740,10 @@ static int encode_png(AVCodecContext *avctx, AVPacket *pkt,
     if (ret < 0)
         return ret;
 
-    ret = encode_frame(avctx, pict);
+    if (s->zparallel.nb_streams > 1 && !s->is_progressive)
+        ret = encode_frame_parallel(avctx, pict);
+    else
+        ret = encode_frame(avctx, pict);
     if (ret < 0)
         return ret;
 
@@ -1183,6 +1266,11 @@ static av_cold int png_enc_init(AVCodecContext *avctx)
     compression_level = avctx->compression_level == FF_COMPRESSION_DEFAULT
                       ? Z_DEFAULT_COMPRESSION
                       : av_clip(avctx->compression_level, 0, 9);
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        int ret = ff_deflate_parallel_init(&s->zparallel, compression_level, avctx);
+        if (ret < 0)
+            return ret;
+    }
     return ff_deflate_init(&s->zstream, compression_level, avctx);
 }
 
@@ -1191,6 +1279,9 @@ static av_cold int png_enc_close(AVCodecContext *avctx)
     PNGEncContext *s = avctx->priv_data;
 
     ff_deflate_end(&s->zstream);
+    ff_deflate_parallel_end(&s->zparallel);
+    av_freep(&s->filtered_buf);
+    av_freep(&s->crow_bufs);
     av_frame_free(&s->last_frame);
     av_frame_free(&s->prev_frame);
     av_freep(&s->last_frame_packet);
@@ -1227,6 +1318,7 @@ const FFCodec ff_png_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_PNG,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(PNGEncContext),
     .init           = png_enc_init,
@@ -25,6 +25,7 @@
 #include "libavutil/mem_internal.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
+#include "libavutil/thread.h"
 #include "avcodec.h"
 #include "codec_internal.h"
 #include "encode.h"
@@ -33,6 +34,7 @@
 #include "profiles.h"
 #include "bytestream.h"
 #include "proresdata.h"
+#include "proresencdsp.h"
 
 #define CFACTOR_Y422 2
 #define CFACTOR_Y444 3
@@ -221,6 +223,7 @@ struct TrellisNode {
 
 typedef struct ProresThreadData {
     DECLARE_ALIGNED(16, int16_t, blocks)[MAX_PLANES][64 * 4 * MAX_MBS_PER_SLICE];
+    DECLARE_ALIGNED(32, int16_t, levels)[64 * 4 * MAX_MBS_PER_SLICE];
     DECLARE_ALIGNED(16, uint16_t, emu_buf)[16 * 16];
     int16_t custom_q[64];
     int16_t custom_chroma_q[64];
@@ -230,6 +233,7 @@ typedef struct ProresThreadData {
 typedef struct ProresContext {
     AVClass *class;
     DECLARE_ALIGNED(16, int16_t, blocks)[MAX_PLANES][64 * 4 * MAX_MBS_PER_SLICE];
+    DECLARE_ALIGNED(32, int16_t, levels)[64 * 4 * MAX_MBS_PER_SLICE];
     DECLARE_ALIGNED(16, uint16_t, emu_buf)[16*16];
     int16_t quants[MAX_STORED_Q][64];
     int16_t quants_chroma[MAX_STORED_Q][64];
@@ -242,6 +246,7 @@ typedef struct ProresContext {
     void (*fdct)(FDCTDSPContext *fdsp, const uint16_t *src,
                  ptrdiff_t linesize, int16_t *block);
     FDCTDSPContext fdsp;
+    ProresEncDSPContext dsp;
 
     const AVFrame *pic;
     int mb_width, mb_height;
@@ -404,6 +409,74 @@ static inline void encode_vlc_codeword(PutBitContext *pb, unsigned codebook, int
 #define GET_SIGN(x)  ((x) >> 31)
 #define MAKE_CODE(x) (((x) * 2) ^ GET_SIGN(x))
 
+#define VLC_LUT_SIZE 128
+
+typedef struct ProresVLC {
+    uint16_t code;
+    uint8_t  len;
+} ProresVLC;
+
+/* codewords for the small values of the run and level codebooks,
+ * indexed by the coding context */
+static ProresVLC run_vlc[16][VLC_LUT_SIZE];
+static ProresVLC level_vlc[10][VLC_LUT_SIZE];
+
+static av_cold void make_vlc_lut(ProresVLC *vlc, unsigned codebook)
+{
+    unsigned int rice_order, exp_order, switch_bits, switch_val;
+    int val, exponent;
+
+    switch_bits = (codebook & 3) + 1;
+    rice_order  =  codebook >> 5;
+    exp_order   = (codebook >> 2) & 7;
+    switch_val  = switch_bits << rice_order;
+
+    for (val = 0; val < VLC_LUT_SIZE; val++) {
+        if (val >= switch_val) {
+            int v    = val - (switch_val - (1 << exp_order));
+            exponent = av_log2(v);
+            vlc[val].code = v;
+            vlc[val].len  = exponent * 2 - exp_order + switch_bits + 1;
+        } else {
+            exponent = val >> rice_order;
+            vlc[val].code = (1 << rice_order) | (val & ((1 << rice_order) - 1));
+            vlc[val].len  = exponent + rice_order + 1;
+        }
+    }
+}
+
+static av_cold void init_vlc_luts(void)
+{
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(run_vlc); i++)
+        make_vlc_lut(run_vlc[i], ff_prores_run_to_cb[i]);
+    for (i = 0; i < FF_ARRAY_ELEMS(level_vlc); i++)
+        make_vlc_lut(level_vlc[i], ff_prores_level_to_cb[i]);
+}
+
+static av_always_inline void encode_run(PutBitContext *pb, int prev_run, int run)
+{
+    if (run < VLC_LUT_SIZE)
+        put_bits(pb, run_vlc[prev_run][run].len, run_vlc[prev_run][run].code);
+    else
+        encode_vlc_codeword(pb, ff_prores_run_to_cb[prev_run], run);
+}
+
+/* write the magnitude and the sign of a non-zero level */
+static av_always_inline void encode_level(PutBitContext *pb, int prev_level, int level)
+{
+    int abs_level = FFABS(level);
+
+    if (abs_level <= VLC_LUT_SIZE) {
+        const ProresVLC *vlc = &level_vlc[prev_level][abs_level - 1];
+        put_bits(pb, vlc->len + 1, vlc->code << 1 | (level < 0));
+    } else {
+        encode_vlc_codeword(pb, ff_prores_level_to_cb[prev_level], abs_level - 1);
+        put_sbits(pb, 1, GET_SIGN(level));
+    }
+}
+
 static void encode_dcs(PutBitContext *pb, int16_t *blocks,
                        int blocks_per_slice, int scale)
 {
@@ -428,9 +501,8 @@ static void encode_dcs(PutBitContext *pb, int16_t *blocks,
     }
 }
 
-static void encode_acs(PutBitContext *pb, int16_t *blocks,
-                       int blocks_per_slice,
-                       const uint8_t *scan, const int16_t *qmat)
+static void encode_acs(PutBitContext *pb, const int16_t *levels,
+                       int blocks_per_slice, const uint8_t *scan)
 {
     int idx, i;
     int prev_run = 4;
@@ -442,12 +514,11 @@ static void encode_acs(PutBitContext *pb, int16_t *blocks,
 
     for (i = 1; i < 64; i++) {
         for (idx = scan[i]; idx < max_coeffs; idx += 64) {
-            level = blocks[idx] / qmat[scan[i]];
+            level = levels[idx];
             if (level) {
                 abs_level = FFABS(level);
-                encode_vlc_codeword(pb, ff_prores_run_to_cb[prev_run], run);
-                encode_vlc_codeword(pb, ff_prores_level_to_cb[prev_level], abs_level - 1);
-                put_sbits(pb, 1, GET_SIGN(level));
+                encode_run(pb, prev_run, run);
+                encode_level(pb, prev_level, level);
 
                 prev_run   = FFMIN(run, 15);
                 prev_level = FFMIN(abs_level, 9);
@@ -467,8 +538,9 @@ static void encode_slice_plane(ProresContext *ctx, PutBitContext *pb,
 {
     int blocks_per_slice = mbs_per_slice * blocks_per_mb;
 
+    ctx->dsp.quantize(ctx->levels, blocks, qmat, blocks_per_slice);
     encode_dcs(pb, blocks, blocks_per_slice, qmat[0]);
-    encode_acs(pb, blocks, blocks_per_slice, ctx->scantable, qmat);
+    encode_acs(pb, ctx->levels, blocks_per_slice, ctx->scantable);
 }
 
 static void put_alpha_diff(PutBitContext *pb, int cur, int prev, int abits)
@@ -663,8 +735,23 @@ static int estimate_dcs(int *error, int16_t *blocks, int blocks_per_slice,
     return bits;
 }
 
-static int estimate_acs(int *error, int16_t *blocks, int blocks_per_slice,
-                        const uint8_t *scan, const int16_t *qmat)
+static av_always_inline int estimate_run(int prev_run, int run)
+{
+    if (run < VLC_LUT_SIZE)
+        return run_vlc[prev_run][run].len;
+    return estimate_vlc(ff_prores_run_to_cb[prev_run], run);
+}
+
+/* bits for the magnitude and the sign of a non-zero level */
+static av_always_inline int estimate_level(int prev_level, int abs_level)
+{
+    if (abs_level <= VLC_LUT_SIZE)
+        return level_vlc[prev_level][abs_level - 1].len + 1;
+    return estimate_vlc(ff_prores_level_to_cb[prev_level], abs_level - 1) + 1;
+}
+
+static int estimate_acs(const int16_t *levels, int blocks_per_slice,
+                        const uint8_t *scan)
 {
     int idx, i;
     int prev_run = 4;
@@ -678,13 +765,11 @@ static int estimate_acs(int *error, int16_t *blocks, int blocks_per_slice,
 
     for (i = 1; i < 64; i++) {
         for (idx = scan[i]; idx < max_coeffs; idx += 64) {
-            level   = blocks[idx] / qmat[scan[i]];
-            *error += FFABS(blocks[idx]) % qmat[scan[i]];
+            level = levels[idx];
             if (level) {
                 abs_level = FFABS(level);
-                bits += estimate_vlc(ff_prores_run_to_cb[prev_run], run);
-                bits += estimate_vlc(ff_prores_level_to_cb[prev_level],
-                                     abs_level - 1) + 1;
+                bits += estimate_run(prev_run, run);
+                bits += estimate_level(prev_level, abs_level);
 
                 prev_run   = FFMIN(run, 15);
                 prev_level = FFMIN(abs_level, 9);
@@ -709,8 +794,9 @@ static int estimate_slice_plane(ProresContext *ctx, int *error, int plane,
 
     blocks_per_slice = mbs_per_slice * blocks_per_mb;
 
+    *error += ctx->dsp.quantize(td->levels, td->blocks[plane], qmat, blocks_per_slice);
     bits  = estimate_dcs(error, td->blocks[plane], blocks_per_slice, qmat[0]);
-    bits += estimate_acs(error, td->blocks[plane], blocks_per_slice, ctx->scantable, qmat);
+    bits += estimate_acs(td->levels, blocks_per_slice, ctx->scantable);
 
     return FFALIGN(bits, 8);
 }
@@ -1148,6 +1234,7 @@ static void prores_fdct(FDCTDSPContext *fdsp, const uint16_t *src,
 
 static av_cold int encode_init(AVCodecContext *avctx)
 {
+    static AVOnce init_static_once = AV_ONCE_INIT;
     ProresContext *ctx = avctx->priv_data;
     int mps;
     int i, j;
@@ -1160,6 +1247,8 @@ static av_cold int encode_init(AVCodecContext *avctx)
     ctx->scantable = interlaced ? ff_prores_interlaced_scan
                                 : ff_prores_progressive_scan;
     ff_fdctdsp_init(&ctx->fdsp, avctx);
+    ff_proresencdsp_init(&ctx->dsp);
+    ff_thread_once(&init_static_once, init_vlc_luts);
 
     mps = ctx->mbs_per_slice;
     if (mps & (mps - 1)) {
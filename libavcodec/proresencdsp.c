@@ -0,0 +1,52 @@
+/*
+ * Apple ProRes encoder DSP functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+#include "proresencdsp.h"
+
+static int prores_quantize_c(int16_t *levels, const int16_t *blocks,
+                             const int16_t *qmat, int nb_blocks)
+{
+    int error = 0;
+    int b, i;
+
+    for (b = 0; b < nb_blocks; b++) {
+        levels[0] = blocks[0] / qmat[0];
+        for (i = 1; i < 64; i++) {
+            levels[i] = blocks[i] / qmat[i];
+            error    += FFABS(blocks[i]) % qmat[i];
+        }
+        levels += 64;
+        blocks += 64;
+    }
+
+    return error;
+}
+
+av_cold void ff_proresencdsp_init(ProresEncDSPContext *c)
+{
+    c->quantize = prores_quantize_c;
+
+#if ARCH_X86
+    ff_proresencdsp_init_x86(c);
+#endif
+}
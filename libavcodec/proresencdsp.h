@@ -0,0 +1,40 @@
+/*
+ * Apple ProRes encoder DSP functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_PRORESENCDSP_H
+#define AVCODEC_PRORESENCDSP_H
+
+#include <stdint.h>
+
+typedef struct ProresEncDSPContext {
+    /**
+     * Quantise nb_blocks blocks of 64 coefficients,
+     * levels[i] = blocks[i] / qmat[i & 63] rounded towards zero.
+     * The qmat entries must be in the range [1, 16384].
+     * @return sum of |blocks[i]| % qmat[i & 63] over all AC coefficients
+     */
+    int (*quantize)(int16_t *levels, const int16_t *blocks,
+                    const int16_t *qmat, int nb_blocks);
+} ProresEncDSPContext;
+
+void ff_proresencdsp_init(ProresEncDSPContext *c);
+void ff_proresencdsp_init_x86(ProresEncDSPContext *c);
+
+#endif /* AVCODEC_PRORESENCDSP_H */
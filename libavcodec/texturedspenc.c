@@ -26,6 +26,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config.h"
 #include "libavutil/attributes.h"
 #include "libavutil/common.h"
 #include "libavutil/intreadwrite.h"
@@ -495,6 +496,125 @@ static void compress_color(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
     AV_WL32(dst + 4, mask);
 }
 
+/* Fast color compression function.
+ * Endpoints are the corners of the color bounding box, inset by 1/16 of its
+ * extent, on the diagonal that follows the signs of the covariances with the
+ * widest channel. Each pixel then picks the nearest palette entry in L1
+ * distance. There is no principal axis search nor refinement, which makes
+ * it trivially vectorizable at the cost of some quality.
+ * J.M.P. van Waveren, "Real-Time DXT Compression", 2006 */
+static void compress_color_fast(uint8_t *dst, ptrdiff_t stride,
+                                const uint8_t *block)
+{
+    uint8_t color[4][4];
+    int mn[3], mx[3], center[3], range[3];
+    int cov_rg = 0, cov_bg = 0, cov_rb = 0;
+    int swap_r, swap_g, swap_b;
+    uint32_t mask = 0;
+    uint16_t max16, min16;
+    int x, y, ch;
+
+    for (ch = 0; ch < 3; ch++) {
+        mn[ch] = mx[ch] = block[ch];
+        for (y = 0; y < 4; y++) {
+            for (x = 0; x < 4; x++) {
+                int v = block[ch + x * 4 + y * stride];
+                mn[ch] = FFMIN(mn[ch], v);
+                mx[ch] = FFMAX(mx[ch], v);
+            }
+        }
+        center[ch] = (mn[ch] + mx[ch] + 1) >> 1;
+        range[ch]  =  mx[ch] - mn[ch];
+    }
+
+    /* Flat block, every pixel would map to the first entry anyway */
+    if (!(range[0] | range[1] | range[2])) {
+        max16 = rgb2rgb565(mx[0], mx[1], mx[2]);
+        AV_WL16(dst + 0, max16);
+        AV_WL16(dst + 2, max16);
+        AV_WL32(dst + 4, 0);
+        return;
+    }
+
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 4; x++) {
+            const uint8_t *p = block + x * 4 + y * stride;
+            int dr = p[0] - center[0];
+            int dg = p[1] - center[1];
+            int db = p[2] - center[2];
+            cov_rg += dr * dg;
+            cov_bg += db * dg;
+            cov_rb += dr * db;
+        }
+    }
+
+    /* Orient the other channels along the one with the widest extent */
+    if (range[1] >= range[0] && range[1] >= range[2]) {
+        swap_r = cov_rg < 0;
+        swap_g = 0;
+        swap_b = cov_bg < 0;
+    } else if (range[0] >= range[2]) {
+        swap_r = 0;
+        swap_g = cov_rg < 0;
+        swap_b = cov_rb < 0;
+    } else {
+        swap_r = cov_rb < 0;
+        swap_g = cov_bg < 0;
+        swap_b = 0;
+    }
+
+    for (ch = 0; ch < 3; ch++) {
+        /* Shrink the bounding box slightly to reduce the quantization error */
+        int inset = range[ch] >> 4;
+        mx[ch] -= inset;
+        mn[ch] += inset;
+    }
+    if (swap_r)
+        FFSWAP(int, mn[0], mx[0]);
+    if (swap_g)
+        FFSWAP(int, mn[1], mx[1]);
+    if (swap_b)
+        FFSWAP(int, mn[2], mx[2]);
+
+    max16 = rgb2rgb565(mx[0], mx[1], mx[2]);
+    min16 = rgb2rgb565(mn[0], mn[1], mn[2]);
+    rgb5652rgb(color[0], max16);
+    rgb5652rgb(color[1], min16);
+    lerp13rgb(color[2], color[0], color[1]);
+    lerp13rgb(color[3], color[1], color[0]);
+
+    for (y = 3; y >= 0; y--) {
+        for (x = 3; x >= 0; x--) {
+            const uint8_t *p = block + x * 4 + y * stride;
+            int d[4], k, b0, b1, b2, b3, b4;
+
+            for (k = 0; k < 4; k++)
+                d[k] = FFABS(p[0] - color[k][0]) +
+                       FFABS(p[1] - color[k][1]) +
+                       FFABS(p[2] - color[k][2]);
+
+            /* Branchless selection of the closest entry, in DXT index order */
+            b0 = d[0] > d[3];
+            b1 = d[1] > d[2];
+            b2 = d[0] > d[2];
+            b3 = d[1] > d[3];
+            b4 = d[2] > d[3];
+
+            mask = mask << 2 | (b0 & b4) | ((b1 & b2) | (b0 & b3)) << 1;
+        }
+    }
+
+    /* Keep the 4-color mode; equal endpoints imply an all zero mask */
+    if (max16 < min16) {
+        FFSWAP(uint16_t, min16, max16);
+        mask ^= 0x55555555;
+    }
+
+    AV_WL16(dst + 0, max16);
+    AV_WL16(dst + 2, min16);
+    AV_WL32(dst + 4, mask);
+}
+
 /* Alpha compression function */
 static void compress_alpha(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
 {
@@ -647,11 +767,53 @@ static int dxt5ys_block(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
     return 16;
 }
 
-av_cold void ff_texturedspenc_init(TextureDSPEncContext *c)
+static int dxt1_block_fast(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+{
+    compress_color_fast(dst, stride, block);
+
+    return 8;
+}
+
+static int dxt5_block_fast(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+{
+    compress_alpha(dst, stride, block);
+    compress_color_fast(dst + 8, stride, block);
+
+    return 16;
+}
+
+static int dxt5ys_block_fast(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
 {
-    c->dxt1_block         = dxt1_block;
-    c->dxt5_block         = dxt5_block;
-    c->dxt5ys_block       = dxt5ys_block;
+    int x, y;
+    uint8_t reorder[64];
+
+    for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+            rgba2ycocg(reorder + x * 4 + y * 16, block + x * 4 + y * stride);
+
+    compress_alpha(dst + 0, 16, reorder);
+    compress_color_fast(dst + 8, 16, reorder);
+
+    return 16;
+}
+
+av_cold void ff_texturedspenc_init(TextureDSPEncContext *c, int fast)
+{
+    if (fast) {
+        c->dxt1_block     = dxt1_block_fast;
+        c->dxt5_block     = dxt5_block_fast;
+        c->dxt5ys_block   = dxt5ys_block_fast;
+
+        /* only the bounding box compressors have SIMD versions, the
+         * default principal axis path always runs the C code */
+#if ARCH_X86
+        ff_texturedspenc_fast_init_x86(c);
+#endif
+    } else {
+        c->dxt1_block     = dxt1_block;
+        c->dxt5_block     = dxt5_block;
+        c->dxt5ys_block   = dxt5ys_block;
+    }
 }
 
 #define TEXTUREDSP_FUNC_NAME ff_texturedsp_exec_compress_threads
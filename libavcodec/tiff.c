@@ -55,6 +55,25 @@
 #include "thread.h"
 #include "get_bits.h"
 
+/* per-thread state for decoding strips */
+typedef struct TiffSliceContext {
+    GetByteContext gb;
+    LZWState *lzw;
+
+    uint8_t *deinvert_buf;
+    int deinvert_buf_size;
+    uint8_t *yuv_line;
+    unsigned int yuv_line_size;
+} TiffSliceContext;
+
+typedef struct TiffStrip {
+    const uint8_t *data;
+    int size;
+    int start;  ///< first line of the strip
+    int lines;
+    int ret;
+} TiffStrip;
+
 typedef struct TiffContext {
     AVClass *class;
     AVCodecContext *avctx;
@@ -107,7 +126,6 @@ typedef struct TiffContext {
     int strips, rps, sstype;
     int sot;
     int stripsizesoff, stripsize, stripoff, strippos;
-    LZWState *lzw;
 
     /* Tile support */
     int is_tiled;
@@ -116,10 +134,14 @@ typedef struct TiffContext {
 
     int is_jpeg;
 
-    uint8_t *deinvert_buf;
-    int deinvert_buf_size;
-    uint8_t *yuv_line;
-    unsigned int yuv_line_size;
+    TiffSliceContext *slice_ctx;
+    int nb_slice_ctx;
+
+    /* strips of the plane being decoded, unpacked in parallel */
+    TiffStrip *strip_list;
+    unsigned int strip_list_size;
+    uint8_t *strip_dst;
+    int strip_stride;
 
     int geotag_count;
     TiffGeoTag *geotags;
@@ -437,15 +459,15 @@ static void av_always_inline horizontal_fill(TiffContext *s,
     }
 }
 
-static int deinvert_buffer(TiffContext *s, const uint8_t *src, int size)
+static int deinvert_buffer(TiffSliceContext *sc, const uint8_t *src, int size)
 {
     int i;
 
-    av_fast_padded_malloc(&s->deinvert_buf, &s->deinvert_buf_size, size);
-    if (!s->deinvert_buf)
+    av_fast_padded_malloc(&sc->deinvert_buf, &sc->deinvert_buf_size, size);
+    if (!sc->deinvert_buf)
         return AVERROR(ENOMEM);
     for (i = 0; i < size; i++)
-        s->deinvert_buf[i] = ff_reverse[src[i]];
+        sc->deinvert_buf[i] = ff_reverse[src[i]];
 
     return 0;
 }
@@ -513,7 +535,8 @@ static int tiff_uncompress(uint8_t *dst, unsigned long *len, const uint8_t *src,
     return zret == Z_STREAM_END ? Z_OK : zret;
 }
 
-static int tiff_unpack_zlib(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
+static int tiff_unpack_zlib(TiffContext *s, TiffSliceContext *sc, AVFrame *p,
+                            uint8_t *dst, int stride,
                             const uint8_t *src, int size, int width, int lines,
                             int strip_start, int is_yuv)
 {
@@ -525,11 +548,11 @@ static int tiff_unpack_zlib(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
     if (!zbuf)
         return AVERROR(ENOMEM);
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0) {
+        if ((ret = deinvert_buffer(sc, src, size)) < 0) {
             av_free(zbuf);
             return ret;
         }
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = tiff_uncompress(zbuf, &outlen, src, size);
     if (ret != Z_OK) {
@@ -580,7 +603,8 @@ static int tiff_uncompress_lzma(uint8_t *dst, uint64_t *len, const uint8_t *src,
     return ret == LZMA_STREAM_END ? LZMA_OK : ret;
 }
 
-static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
+static int tiff_unpack_lzma(TiffContext *s, TiffSliceContext *sc, AVFrame *p,
+                            uint8_t *dst, int stride,
                             const uint8_t *src, int size, int width, int lines,
                             int strip_start, int is_yuv)
 {
@@ -590,11 +614,11 @@ static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
     if (!buf)
         return AVERROR(ENOMEM);
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0) {
+        if ((ret = deinvert_buffer(sc, src, size)) < 0) {
             av_free(buf);
             return ret;
         }
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = tiff_uncompress_lzma(buf, &outlen, src, size);
     if (ret != LZMA_OK) {
@@ -623,16 +647,16 @@ static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
 }
 #endif
 
-static int tiff_unpack_fax(TiffContext *s, uint8_t *dst, int stride,
+static int tiff_unpack_fax(TiffContext *s, TiffSliceContext *sc, uint8_t *dst, int stride,
                            const uint8_t *src, int size, int width, int lines)
 {
     int line;
     int ret;
 
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0)
+        if ((ret = deinvert_buffer(sc, src, size)) < 0)
             return ret;
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = ff_ccitt_unpack(s->avctx, src, size, dst, lines, stride,
                           s->compr, s->fax_opts);
@@ -734,7 +758,8 @@ static int dng_decode_jpeg(AVCodecContext *avctx, AVFrame *frame,
     return 0;
 }
 
-static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
+static int tiff_unpack_strip(TiffContext *s, TiffSliceContext *sc, AVFrame *p,
+                             uint8_t *dst, int stride,
                              const uint8_t *src, int size, int strip_start, int lines)
 {
     PutByteContext pb;
@@ -756,12 +781,12 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     if (is_yuv) {
         int bytes_per_row = (((s->width - 1) / s->subsampling[0] + 1) * s->bpp *
                             s->subsampling[0] * s->subsampling[1] + 7) >> 3;
-        av_fast_padded_malloc(&s->yuv_line, &s->yuv_line_size, bytes_per_row);
-        if (s->yuv_line == NULL) {
+        av_fast_padded_malloc(&sc->yuv_line, &sc->yuv_line_size, bytes_per_row);
+        if (sc->yuv_line == NULL) {
             av_log(s->avctx, AV_LOG_ERROR, "Not enough memory\n");
             return AVERROR(ENOMEM);
         }
-        dst = s->yuv_line;
+        dst = sc->yuv_line;
         stride = 0;
 
         width = (s->width - 1) / s->subsampling[0] + 1;
@@ -774,18 +799,18 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     av_assert0(!(s->is_bayer && is_yuv));
     if (p->format == AV_PIX_FMT_GRAY12) {
-        av_fast_padded_malloc(&s->yuv_line, &s->yuv_line_size, width);
-        if (s->yuv_line == NULL) {
+        av_fast_padded_malloc(&sc->yuv_line, &sc->yuv_line_size, width);
+        if (sc->yuv_line == NULL) {
             av_log(s->avctx, AV_LOG_ERROR, "Not enough memory\n");
             return AVERROR(ENOMEM);
         }
-        dst = s->yuv_line;
+        dst = sc->yuv_line;
         stride = 0;
     }
 
     if (s->compr == TIFF_DEFLATE || s->compr == TIFF_ADOBE_DEFLATE) {
 #if CONFIG_ZLIB
-        return tiff_unpack_zlib(s, p, dst, stride, src, size, width, lines,
+        return tiff_unpack_zlib(s, sc, p, dst, stride, src, size, width, lines,
                                 strip_start, is_yuv);
 #else
         av_log(s->avctx, AV_LOG_ERROR,
@@ -796,7 +821,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     if (s->compr == TIFF_LZMA) {
 #if CONFIG_LZMA
-        return tiff_unpack_lzma(s, p, dst, stride, src, size, width, lines,
+        return tiff_unpack_lzma(s, sc, p, dst, stride, src, size, width, lines,
                                 strip_start, is_yuv);
 #else
         av_log(s->avctx, AV_LOG_ERROR,
@@ -806,19 +831,19 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     if (s->compr == TIFF_LZW) {
         if (s->fill_order) {
-            if ((ret = deinvert_buffer(s, src, size)) < 0)
+            if ((ret = deinvert_buffer(sc, src, size)) < 0)
                 return ret;
-            ssrc = src = s->deinvert_buf;
+            ssrc = src = sc->deinvert_buf;
         }
         if (size > 1 && !src[0] && (src[1]&1)) {
             av_log(s->avctx, AV_LOG_ERROR, "Old style LZW is unsupported\n");
         }
-        if ((ret = ff_lzw_decode_init(s->lzw, 8, src, size, FF_LZW_TIFF)) < 0) {
+        if ((ret = ff_lzw_decode_init(sc->lzw, 8, src, size, FF_LZW_TIFF)) < 0) {
             av_log(s->avctx, AV_LOG_ERROR, "Error initializing LZW decoder\n");
             return ret;
         }
         for (line = 0; line < lines; line++) {
-            pixels = ff_lzw_decode(s->lzw, dst, width);
+            pixels = ff_lzw_decode(sc->lzw, dst, width);
             if (pixels < width) {
                 av_log(s->avctx, AV_LOG_ERROR, "Decoded only %i bytes of %i\n",
                        pixels, width);
@@ -842,11 +867,11 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
         if (is_yuv || p->format == AV_PIX_FMT_GRAY12)
             return AVERROR_INVALIDDATA;
 
-        return tiff_unpack_fax(s, dst, stride, src, size, width, lines);
+        return tiff_unpack_fax(s, sc, dst, stride, src, size, width, lines);
     }
 
-    bytestream2_init(&s->gb, src, size);
-    bytestream2_init_writer(&pb, dst, is_yuv ? s->yuv_line_size : (stride * lines));
+    bytestream2_init(&sc->gb, src, size);
+    bytestream2_init_writer(&pb, dst, is_yuv ? sc->yuv_line_size : (stride * lines));
 
     is_dng = (s->tiff_type == TIFF_TYPE_DNG || s->tiff_type == TIFF_TYPE_CINEMADNG);
 
@@ -858,6 +883,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
         }
         if (!s->is_bayer)
             return AVERROR_PATCHWELCOME;
+        bytestream2_init(&s->gb, src, size);
         if ((ret = dng_decode_jpeg(s->avctx, p, s->stripsize, 0, 0, s->width, s->height)) < 0)
             return ret;
         return 0;
@@ -872,7 +898,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
             return AVERROR_INVALIDDATA;
         }
 
-        if (bytestream2_get_bytes_left(&s->gb) == 0 || bytestream2_get_eof(&pb))
+        if (bytestream2_get_bytes_left(&sc->gb) == 0 || bytestream2_get_eof(&pb))
             break;
         bytestream2_seek_p(&pb, stride * line, SEEK_SET);
         switch (s->compr) {
@@ -963,6 +989,19 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     return 0;
 }
 
+static int tiff_unpack_strip_job(AVCodecContext *avctx, void *arg,
+                                 int jobnr, int threadnr)
+{
+    TiffContext *s   = avctx->priv_data;
+    TiffStrip *strip = &s->strip_list[jobnr];
+
+    strip->ret = tiff_unpack_strip(s, &s->slice_ctx[threadnr], arg,
+                                   s->strip_dst + strip->start * s->strip_stride,
+                                   s->strip_stride, strip->data, strip->size,
+                                   strip->start, strip->lines);
+    return 0;
+}
+
 static int dng_decode_tiles(AVCodecContext *avctx, AVFrame *frame,
                             const AVPacket *avpkt)
 {
@@ -1909,7 +1948,7 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *p,
     TiffContext *const s = avctx->priv_data;
     unsigned off, last_off = 0;
     int le, ret, plane, planes;
-    int i, j, entries, stride;
+    int i, j, entries, stride, nb_strips;
     unsigned soff, ssize;
     uint8_t *dst;
     GetByteContext stripsizes;
@@ -2177,9 +2216,17 @@ again:
             if (!dst)
                 return AVERROR(ENOMEM);
         }
-        for (i = 0; i < s->height; i += s->rps) {
-            if (i)
-                dst += s->rps * stride;
+        nb_strips = (s->height + s->rps - 1) / s->rps;
+        av_fast_malloc(&s->strip_list, &s->strip_list_size,
+                       nb_strips * sizeof(*s->strip_list));
+        if (!s->strip_list) {
+            s->strip_list_size = 0;
+            av_freep(&five_planes);
+            return AVERROR(ENOMEM);
+        }
+        for (i = 0, j = 0; i < s->height; i += s->rps, j++) {
+            TiffStrip *strip = &s->strip_list[j];
+
             if (s->stripsizesoff)
                 ssize = ff_tget(&stripsizes, s->sstype, le);
             else
@@ -2196,16 +2243,34 @@ again:
                 return AVERROR_INVALIDDATA;
             }
             remaining -= ssize;
-            if ((ret = tiff_unpack_strip(s, p, dst, stride, avpkt->data + soff, ssize, i,
-                                         FFMIN(s->rps, s->height - i))) < 0) {
+            strip->data  = avpkt->data + soff;
+            strip->size  = ssize;
+            strip->start = i;
+            strip->lines = FFMIN(s->rps, s->height - i);
+        }
+
+        /* the strips are independent, decode them in parallel and stop at
+         * the first broken one afterwards; DNG JPEG strips all go through
+         * the shared s->gb and MJPEG decoder, so those run one at a time */
+        s->strip_dst    = dst;
+        s->strip_stride = stride;
+        if (s->compr == TIFF_NEWJPEG) {
+            for (j = 0; j < nb_strips; j++)
+                tiff_unpack_strip_job(avctx, p, j, 0);
+        } else
+            avctx->execute2(avctx, tiff_unpack_strip_job, p, NULL, nb_strips);
+
+        decoded_height = s->height;
+        for (j = 0; j < nb_strips; j++) {
+            if ((ret = s->strip_list[j].ret) < 0) {
                 if (avctx->err_recognition & AV_EF_EXPLODE) {
                     av_freep(&five_planes);
                     return ret;
                 }
+                decoded_height = s->strip_list[j].start;
                 break;
             }
         }
-        decoded_height = FFMIN(i, s->height);
 
         if (s->predictor == 2) {
             if (s->photometric == TIFF_PHOTOMETRIC_YCBCR) {
@@ -2399,9 +2464,16 @@ static av_cold int tiff_init(AVCodecContext *avctx)
     s->subsampling[0] =
     s->subsampling[1] = 1;
     s->avctx  = avctx;
-    ff_lzw_decode_open(&s->lzw);
-    if (!s->lzw)
+
+    s->nb_slice_ctx = (avctx->active_thread_type & FF_THREAD_SLICE) ? avctx->thread_count : 1;
+    s->slice_ctx    = av_calloc(s->nb_slice_ctx, sizeof(*s->slice_ctx));
+    if (!s->slice_ctx)
         return AVERROR(ENOMEM);
+    for (int i = 0; i < s->nb_slice_ctx; i++) {
+        ff_lzw_decode_open(&s->slice_ctx[i].lzw);
+        if (!s->slice_ctx[i].lzw)
+            return AVERROR(ENOMEM);
+    }
     ff_ccitt_unpack_init();
 
     /* Allocate JPEG frame */
@@ -2435,11 +2507,19 @@ static av_cold int tiff_end(AVCodecContext *avctx)
 
     free_geotags(s);
 
-    ff_lzw_decode_close(&s->lzw);
-    av_freep(&s->deinvert_buf);
-    s->deinvert_buf_size = 0;
-    av_freep(&s->yuv_line);
-    s->yuv_line_size = 0;
+    for (int i = 0; i < s->nb_slice_ctx; i++) {
+        TiffSliceContext *sc = &s->slice_ctx[i];
+
+        ff_lzw_decode_close(&sc->lzw);
+        av_freep(&sc->deinvert_buf);
+        sc->deinvert_buf_size = 0;
+        av_freep(&sc->yuv_line);
+        sc->yuv_line_size = 0;
+    }
+    av_freep(&s->slice_ctx);
+    s->nb_slice_ctx = 0;
+    av_freep(&s->strip_list);
+    s->strip_list_size = 0;
     av_frame_free(&s->jpgframe);
     av_packet_free(&s->jpkt);
     avcodec_free_context(&s->avctx_mjpeg);
@@ -2470,7 +2550,8 @@ const FFCodec ff_tiff_decoder = {
     .init           = tiff_init,
     .close          = tiff_end,
     FF_CODEC_DECODE_CB(decode_frame),
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_ICC_PROFILES |
                       FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
     .p.priv_class   = &tiff_decoder_class,
@@ -43,6 +43,9 @@
 #include "tiff.h"
 #include "tiff_common.h"
 #include "version.h"
+#if CONFIG_DEFLATE_WRAPPER
+#include "zlib_wrapper.h"
+#endif
 
 #define TIFF_MAX_ENTRY 32
 
@@ -77,6 +80,9 @@ typedef struct TiffEncoderContext {
     uint16_t subsampling[2];                ///< YUV subsampling factors
     struct LZWEncodeState *lzws;            ///< LZW encode state
     uint32_t dpi;                           ///< image resolution in DPI
+#if CONFIG_DEFLATE_WRAPPER
+    FFZParallel zparallel;                  ///< slice threaded deflate
+#endif
 } TiffEncoderContext;
 
 /**
@@ -178,6 +184,14 @@ static int encode_strip(TiffEncoderContext *s, const int8_t *src,
     case TIFF_ADOBE_DEFLATE:
     {
         unsigned long zlen = s->buf_size - (*s->buf - s->buf_start);
+#if CONFIG_DEFLATE_WRAPPER
+        if (s->zparallel.nb_streams > 1) {
+            size_t len = zlen;
+            int ret = ff_deflate_parallel(&s->zparallel, s->avctx,
+                                          dst, &len, src, n);
+            return ret < 0 ? ret : len;
+        }
+#endif
         if (compress(dst, &zlen, src, n) != Z_OK) {
             av_log(s->avctx, AV_LOG_ERROR, "Compressing failed\n");
             return AVERROR_EXTERNAL;
@@ -536,6 +550,16 @@ static av_cold int encode_init(AVCodecContext *avctx)
 
     s->avctx = avctx;
 
+#if CONFIG_DEFLATE_WRAPPER
+    if ((s->compr == TIFF_DEFLATE || s->compr == TIFF_ADOBE_DEFLATE) &&
+        avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        int ret = ff_deflate_parallel_init(&s->zparallel, Z_DEFAULT_COMPRESSION,
+                                           avctx);
+        if (ret < 0)
+            return ret;
+    }
+#endif
+
     return 0;
 }
 
@@ -546,6 +570,9 @@ static av_cold int encode_close(AVCodecContext *avctx)
     av_freep(&s->strip_sizes);
     av_freep(&s->strip_offsets);
     av_freep(&s->yuv_line);
+#if CONFIG_DEFLATE_WRAPPER
+    ff_deflate_parallel_end(&s->zparallel);
+#endif
 
     return 0;
 }
@@ -575,6 +602,7 @@ const FFCodec ff_tiff_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_TIFF,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(TiffEncoderContext),
     .init           = encode_init,
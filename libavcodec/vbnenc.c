@@ -129,7 +129,7 @@ static int vbn_encode(AVCodecContext *avctx, AVPacket *pkt,
 static av_cold int vbn_init(AVCodecContext *avctx)
 {
     VBNContext *ctx = avctx->priv_data;
-    ff_texturedspenc_init(&ctx->dxtc);
+    ff_texturedspenc_init(&ctx->dxtc, 0);
     return 0;
 }
 
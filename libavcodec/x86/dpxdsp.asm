@@ -0,0 +1,108 @@
+;******************************************************************************
+;* SIMD-optimized DPX unpacking functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pb_bswap32: times 2 db 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+
+SECTION .text
+
+; extract the 10-bit sample at bit %2 of the 8 words in m0 (and m1 for xmm)
+; and store it to the row at %1
+%macro UNPACK_CHANNEL 2 ; dst, shift
+%if mmsize == 32
+    psrld                m2, m0, %2
+    pand                 m2, m4
+    packssdw             m2, m2
+    vpermq               m2, m2, q3120
+    movu   [%1q + wq * 2], xm2
+%else
+    psrld                m2, m0, %2
+    psrld                m3, m1, %2
+    pand                 m2, m4
+    pand                 m3, m4
+    packssdw             m2, m3
+    movu   [%1q + wq * 2], m2
+%endif
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_dpx_unpack_rgb10_{le,be}(uint16_t *dst0, uint16_t *dst1, uint16_t *dst2,
+;                                  const uint8_t *src, int width, int shift)
+; width is a multiple of 8, 0 is allowed
+;------------------------------------------------------------------------------
+%macro UNPACK_RGB10 1 ; endianness
+cglobal dpx_unpack_rgb10_%1, 6, 6, 8, dst0, dst1, dst2, src, w, rshift
+    movsxdifnidn         wq, wd
+    test                 wq, wq
+    jz .end
+    movd                xm5, rshiftd
+    sub             rshiftd, 10
+    movd                xm6, rshiftd
+    sub             rshiftd, 10
+    movd                xm7, rshiftd
+    pcmpeqd              m4, m4
+    psrld                m4, 22
+
+    lea                srcq, [srcq + wq * 4]
+    lea               dst0q, [dst0q + wq * 2]
+    lea               dst1q, [dst1q + wq * 2]
+    lea               dst2q, [dst2q + wq * 2]
+    neg                  wq
+.loop:
+    movu                 m0, [srcq + wq * 4]
+%if mmsize == 16
+    movu                 m1, [srcq + wq * 4 + 16]
+%endif
+%ifidn %1, be
+    pshufb               m0, [pb_bswap32]
+%if mmsize == 16
+    pshufb               m1, [pb_bswap32]
+%endif
+%endif
+    ; like read10in32(), fold the two pad bits of method B into B
+    psrld                m2, m0, xm5
+    psrld                m2, 10
+    por                  m0, m2
+%if mmsize == 16
+    psrld                m3, m1, xm5
+    psrld                m3, 10
+    por                  m1, m3
+%endif
+    UNPACK_CHANNEL     dst2, xm5
+    UNPACK_CHANNEL     dst0, xm6
+    UNPACK_CHANNEL     dst1, xm7
+    add                  wq, 8
+    jl .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM ssse3
+UNPACK_RGB10 le
+UNPACK_RGB10 be
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+UNPACK_RGB10 le
+UNPACK_RGB10 be
+%endif
@@ -0,0 +1,47 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/dpxdsp.h"
+
+#define UNPACK_RGB10_PROTO(endian, opt)                                        \
+void ff_dpx_unpack_rgb10_ ## endian ## _ ## opt(uint16_t *dst0, uint16_t *dst1, \
+                                                uint16_t *dst2, const uint8_t *src, \
+                                                int width, int shift)
+
+UNPACK_RGB10_PROTO(le, ssse3);
+UNPACK_RGB10_PROTO(be, ssse3);
+UNPACK_RGB10_PROTO(le, avx2);
+UNPACK_RGB10_PROTO(be, avx2);
+
+av_cold void ff_dpxdsp_init_x86(DPXDSPContext *c)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSSE3(cpu_flags)) {
+        c->unpack_rgb10[0] = ff_dpx_unpack_rgb10_le_ssse3;
+        c->unpack_rgb10[1] = ff_dpx_unpack_rgb10_be_ssse3;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        c->unpack_rgb10[0] = ff_dpx_unpack_rgb10_le_avx2;
+        c->unpack_rgb10[1] = ff_dpx_unpack_rgb10_be_avx2;
+    }
+}
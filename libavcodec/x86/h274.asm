@@ -0,0 +1,126 @@
+;******************************************************************************
+;* SIMD-optimized H.274 film grain synthesis
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+cextern pb_80
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; uint16_t ff_h274_avg_8x8(const uint8_t *in, ptrdiff_t in_stride);
+;------------------------------------------------------------------------------
+
+INIT_XMM sse2
+cglobal h274_avg_8x8, 2, 3, 5, in, stride, stride3
+    lea       stride3q, [strideq*3]
+    movq            m0, [inq]
+    movhps          m0, [inq+strideq]
+    movq            m1, [inq+strideq*2]
+    movhps          m1, [inq+stride3q]
+    lea            inq, [inq+strideq*4]
+    movq            m2, [inq]
+    movhps          m2, [inq+strideq]
+    movq            m3, [inq+strideq*2]
+    movhps          m3, [inq+stride3q]
+    pxor            m4, m4
+    psadbw          m0, m4
+    psadbw          m1, m4
+    psadbw          m2, m4
+    psadbw          m3, m4
+    paddw           m0, m1
+    paddw           m2, m3
+    paddw           m0, m2
+    movhlps         m1, m0
+    paddw           m0, m1
+    movd           eax, m0
+    shr            eax, 6
+    RET
+
+;------------------------------------------------------------------------------
+; void ff_h274_synth_grain_8x8(int8_t *out, ptrdiff_t out_stride,
+;                              int scale, int shift, const int8_t *db);
+;------------------------------------------------------------------------------
+
+INIT_XMM sse2
+cglobal h274_synth_grain_8x8, 5, 6, 8, out, stride, scale, shift, db, cnt
+    movd            m6, scaled
+    pshuflw         m6, m6, q0000
+    punpcklqdq      m6, m6
+    movd            m7, shiftd
+    mov           cntd, 8
+.loop:
+    movq            m0, [dbq]
+    punpcklbw       m0, m0
+    psraw           m0, 8
+    ; full 32-bit products, the result is truncated to 8 bits like in C
+    pmulhw          m1, m0, m6
+    pmullw          m0, m6
+    punpckhwd       m2, m0, m1
+    punpcklwd       m0, m1
+    psrad           m0, m7
+    psrad           m2, m7
+    pslld           m0, 24
+    pslld           m2, 24
+    psrad           m0, 24
+    psrad           m2, 24
+    packssdw        m0, m2
+    packsswb        m0, m0
+    movq        [outq], m0
+    add           outq, strideq
+    add            dbq, 64
+    dec           cntd
+    jg .loop
+    RET
+
+;------------------------------------------------------------------------------
+; void ff_h274_blend_row(uint8_t *out, const uint8_t *in, const int8_t *grain,
+;                        ptrdiff_t n);
+;------------------------------------------------------------------------------
+
+%macro BLEND_ROW 0
+cglobal h274_blend_row, 4, 4, 3, out, in, grain, n
+    add           outq, nq
+    add            inq, nq
+    add         grainq, nq
+    neg             nq
+    jge .end
+    mova            m2, [pb_80]
+.loop:
+    ; unsigned + signed with unsigned saturation, done in the signed domain
+    movu            m0, [inq+nq]
+    movu            m1, [grainq+nq]
+    pxor            m0, m2
+    paddsb          m0, m1
+    pxor            m0, m2
+    movu     [outq+nq], m0
+    add             nq, mmsize
+    jl .loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse2
+BLEND_ROW
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+BLEND_ROW
+%endif
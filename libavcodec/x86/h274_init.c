@@ -0,0 +1,49 @@
+/*
+ * H.274 film grain synthesis
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/h274.h"
+
+uint16_t ff_h274_avg_8x8_sse2(const uint8_t *in, ptrdiff_t in_stride);
+void ff_h274_synth_grain_8x8_sse2(int8_t *out, ptrdiff_t out_stride,
+                                  int scale, int shift, const int8_t *db);
+void ff_h274_blend_row_sse2(uint8_t *out, const uint8_t *in,
+                            const int8_t *grain, ptrdiff_t n);
+void ff_h274_blend_row_avx2(uint8_t *out, const uint8_t *in,
+                            const int8_t *grain, ptrdiff_t n);
+
+av_cold void ff_h274_film_grain_dsp_init_x86(H274FilmGrainDSPContext *c)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        c->avg_8x8         = ff_h274_avg_8x8_sse2;
+        c->synth_grain_8x8 = ff_h274_synth_grain_8x8_sse2;
+        c->blend_row       = ff_h274_blend_row_sse2;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        c->blend_row       = ff_h274_blend_row_avx2;
+    }
+}
@@ -0,0 +1,896 @@
+;******************************************************************************
+;* SIMD-optimized HEVC intra prediction
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+; (size - 1 - x, x + 1) word pairs for the high bit depth planar prediction
+%macro PLANAR_WEIGHTS 1
+pw_planar_weights_%1:
+%assign %%x 0
+%rep %1
+    dw %1 - 1 - %%x, %%x + 1
+%assign %%x %%x + 1
+%endrep
+%endmacro
+
+PLANAR_WEIGHTS 32
+PLANAR_WEIGHTS 16
+PLANAR_WEIGHTS 8
+PLANAR_WEIGHTS 4
+
+pw_planar_x1: dw  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16
+              dw 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32
+pw_planar_w:  dw 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16
+              dw 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0
+pw_m1_1:      times 8 dw -1, 1
+pb_transpose_4x4:  db 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+
+angular_angle:     db  32,  26,  21,  17,  13,   9,   5,   2,   0,  -2,  -5
+                   db  -9, -13, -17, -21, -26, -32, -26, -21, -17, -13,  -9
+                   db  -5,  -2,   0,   2,   5,   9,  13,  17,  21,  26,  32
+angular_inv_angle: dw -4096, -1638, -910, -630, -482, -390, -315, -256
+                   dw  -315,  -390, -482, -630, -910, -1638, -4096
+
+cextern pw_1
+cextern pw_1024
+cextern pd_16
+
+SECTION .text
+
+%macro BCASTD 2 ; dst, src
+%if cpuflag(avx2)
+    vpbroadcastd    %1, %2
+%else
+    pshufd          %1, %2, 0
+%endif
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_hevc_pred_planar_<size>_8(uint8_t *src, const uint8_t *top,
+;                                   const uint8_t *left, ptrdiff_t stride)
+;------------------------------------------------------------------------------
+; Row y of the prediction is R(x) + (size - 1 - x) * left[y], with
+; R(x) = (size - 1 - y) * top[x] + (y + 1) * left[size] + (x + 1) * top[size]
+;        + size
+; being updated by left[size] - top[x] from one row to the next.
+; All of it fits in 16 bits for 8-bit samples.
+
+%macro PLANAR_8_INIT 3 ; R, D, chunk
+    pmovzxbw        %1, [topq + %3 * mmsize / 2]
+    psubw           %2, m6, %1                      ; left[size] - top[x]
+    pmullw          %1, m5
+    paddw           %1, %2                          ; (size - 1) * top[x] + left[size]
+    pmullw          m4, m7, [pw_planar_x1 + %3 * mmsize]
+    paddw           %1, m4
+    paddw           %1, m5
+%endmacro
+
+%macro PLANAR_8_ROW 5 ; dst, R, D, weights, shift
+    pmullw          %1, m6, %4
+    paddw           %1, %2
+    psrlw           %1, %5
+    paddw           %2, %3
+%endmacro
+
+%macro PRED_PLANAR_8 2 ; size, log2 size
+%assign %%chunks (%1 * 2 + mmsize - 1) / mmsize
+cglobal hevc_pred_planar_%1_8, 4, 5, 8, src, top, left, stride, y
+    movzx           yd, byte [topq + %1]
+    movd           xm7, yd
+    SPLATW          m7, xm7                         ; top[size]
+    movzx           yd, byte [leftq + %1]
+    movd           xm6, yd
+    SPLATW          m6, xm6                         ; left[size]
+    mov             yd, %1
+    movd           xm5, yd
+    SPLATW          m5, xm5                         ; size
+    PLANAR_8_INIT   m0, m1, 0
+%if %%chunks == 2
+    PLANAR_8_INIT   m2, m3, 1
+%elif %1 == 4
+    movq           xm7, [pw_planar_w + (32 - %1) * 2]
+%else
+    movu            m7, [pw_planar_w + (32 - %1) * 2]
+%endif
+    xor             yd, yd
+.loop:
+    movzx         topd, byte [leftq + yq]
+    movd           xm6, topd
+    SPLATW          m6, xm6                         ; left[y]
+%if %%chunks == 2
+    PLANAR_8_ROW    m4, m0, m1, [pw_planar_w + (32 - %1) * 2], %2 + 1
+    PLANAR_8_ROW    m5, m2, m3, [pw_planar_w + (32 - %1) * 2 + mmsize], %2 + 1
+    packuswb        m4, m5
+%if mmsize == 32
+    vpermq          m4, m4, q3120
+%endif
+    movu        [srcq], m4
+%else
+    PLANAR_8_ROW    m4, m0, m1, m7, %2 + 1
+%if mmsize == 32
+    vextracti128   xm5, m4, 1
+    packuswb       xm4, xm5
+    movu        [srcq], xm4
+%else
+    packuswb        m4, m4
+%if %1 == 4
+    movd        [srcq], m4
+%else
+    movq        [srcq], m4
+%endif
+%endif
+%endif
+    add           srcq, strideq
+    inc             yd
+    cmp             yd, %1
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_hevc_pred_planar_<size>_16(uint8_t *src, const uint8_t *top,
+;                                    const uint8_t *left, ptrdiff_t stride)
+;------------------------------------------------------------------------------
+; Used for all bit depths above 8, the sums are done in 32 bits with
+; pmaddwd on (left[y], top[size]) and (top[x], left[size]) pairs.
+
+%macro PLANAR_16_CHUNK 5 ; dst, tmp, chunk, size, shift
+    pmaddwd         %1, m4, [pw_planar_weights_%4 + %3 * mmsize]
+    pmovzxwd        %2, [topq + %3 * mmsize / 2]
+    por             %2, m7
+    pmaddwd         %2, m6
+    paddd           %1, %2
+    paddd           %1, m5
+    psrld           %1, %5
+%endmacro
+
+%macro PRED_PLANAR_16 2 ; size, log2 size
+%assign %%chunks (%1 * 4 + mmsize - 1) / mmsize
+cglobal hevc_pred_planar_%1_16, 4, 7, 8, src, top, left, stride, y, tn, tmp
+    add        strideq, strideq
+    movzx          tnd, word [topq + %1 * 2]
+    shl            tnd, 16                          ; top[size] << 16
+    movzx           yd, word [leftq + %1 * 2]
+    shl             yd, 16
+    movd           xm7, yd
+    BCASTD          m7, xm7                         ; left[size] << 16
+    mov             yd, (1 << 16) | (%1 - 1)
+    movd           xm6, yd
+    BCASTD          m6, xm6                         ; size - 1 - y, y + 1
+    mov             yd, %1
+    movd           xm5, yd
+    BCASTD          m5, xm5                         ; size
+    xor             yd, yd
+.loop:
+    movzx         tmpd, word [leftq + yq * 2]
+    or            tmpd, tnd
+    movd           xm4, tmpd
+    BCASTD          m4, xm4                         ; left[y], top[size]
+%if %%chunks == 1
+    PLANAR_16_CHUNK m0, m1, 0, %1, %2 + 1
+%if mmsize == 32
+    vextracti128   xm1, m0, 1
+    packusdw       xm0, xm1
+    movu        [srcq], xm0
+%else
+    packusdw        m0, m0
+    movq        [srcq], m0
+%endif
+%else
+%assign %%i 0
+%rep %%chunks / 2
+    PLANAR_16_CHUNK m0, m1, %%i, %1, %2 + 1
+    PLANAR_16_CHUNK m2, m3, %%i + 1, %1, %2 + 1
+    packusdw        m0, m2
+%if mmsize == 32
+    vpermq          m0, m0, q3120
+%endif
+    movu [srcq + %%i * mmsize / 2], m0
+%assign %%i %%i + 2
+%endrep
+%endif
+    paddw           m6, [pw_m1_1]
+    add           srcq, strideq
+    inc             yd
+    cmp             yd, %1
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_hevc_pred_dc_<bits>(uint8_t *src, const uint8_t *top,
+;                             const uint8_t *left, ptrdiff_t stride,
+;                             int log2_size, int c_idx)
+;------------------------------------------------------------------------------
+; The block size is dispatched to in the function itself, the edges are
+; filtered for luma blocks smaller than 32x32.
+
+%macro PRED_DC_8_BODY 2 ; size, log2 size
+    pxor            m3, m3
+%if %1 == 4
+    movd            m0, [topq]
+    movd            m1, [leftq]
+    punpckldq       m0, m1
+    psadbw          m0, m3
+%elif %1 == 8
+    movq            m0, [topq]
+    movhps          m0, [leftq]
+    psadbw          m0, m3
+%else
+    movu            m0, [topq]
+    movu            m1, [leftq]
+    psadbw          m0, m3
+    psadbw          m1, m3
+    paddw           m0, m1
+%if %1 == 32
+    movu            m1, [topq + 16]
+    movu            m2, [leftq + 16]
+    psadbw          m1, m3
+    psadbw          m2, m3
+    paddw           m0, m1
+    paddw           m0, m2
+%endif
+%endif
+%if %1 > 4
+    movhlps         m1, m0
+    paddw           m0, m1
+%endif
+    movd           dcd, m0
+    add            dcd, %1
+    shr            dcd, %2 + 1
+    movd            m0, dcd
+    pshufb          m0, m3                          ; dc
+    mov           cntd, %1
+%%loop:
+%if %1 == 4
+    movd        [srcq], m0
+%elif %1 == 8
+    movq        [srcq], m0
+%else
+    movu        [srcq], m0
+%if %1 == 32
+    movu   [srcq + 16], m0
+%endif
+%endif
+    add           srcq, strideq
+    dec           cntd
+    jg %%loop
+    imul          cntq, strideq, %1
+    sub           srcq, cntq
+
+%if %1 < 32
+    test         cidxd, cidxd
+    jnz %%end
+    lea           cntd, [dcq * 3 + 2]
+    movd            m4, cntd
+    SPLATW          m4, m4                          ; 3 * dc + 2
+    pmovzxbw        m1, [topq]
+    pmovzxbw        m2, [leftq]
+    paddw           m1, m4
+    paddw           m2, m4
+    psrlw           m1, 2
+    psrlw           m2, 2
+%if %1 == 16
+    pmovzxbw        m3, [topq + 8]
+    pmovzxbw        m5, [leftq + 8]
+    paddw           m3, m4
+    paddw           m5, m4
+    psrlw           m3, 2
+    psrlw           m5, 2
+    packuswb        m1, m3
+    packuswb        m2, m5
+    movu        [srcq], m1
+%else
+    packuswb        m1, m1
+    packuswb        m2, m2
+%if %1 == 4
+    movd        [srcq], m1
+%else
+    movq        [srcq], m1
+%endif
+%endif
+    ; (left[0] + 2 * dc + top[0] + 2) >> 2
+    movzx        cidxd, byte [leftq]
+    movzx         cntd, byte [topq]
+    add          cidxd, cntd
+    lea          cidxd, [cidxq + dcq * 2 + 2]
+    shr          cidxd, 2
+    movd            m0, cidxd
+    pextrb      [srcq], m0, 0
+%assign %%y 1
+%rep %1 - 1
+    add           srcq, strideq
+    pextrb      [srcq], m2, %%y
+%assign %%y %%y + 1
+%endrep
+%%end:
+%endif
+    RET
+%endmacro
+
+; Used for all bit depths above 8.
+%macro PRED_DC_16_BODY 2 ; size, log2 size
+    mova            m3, [pw_1]
+%if %1 == 4
+    movq            m0, [topq]
+    movhps          m0, [leftq]
+    pmaddwd         m0, m3
+%else
+    pxor            m0, m0
+%assign %%i 0
+%rep %1 / 8
+    movu            m1, [topq  + %%i * 16]
+    movu            m2, [leftq + %%i * 16]
+    pmaddwd         m1, m3
+    pmaddwd         m2, m3
+    paddd           m0, m1
+    paddd           m0, m2
+%assign %%i %%i + 1
+%endrep
+%endif
+    HADDD           m0, m1
+    movd           dcd, m0
+    add            dcd, %1
+    shr            dcd, %2 + 1
+    movd            m0, dcd
+    SPLATW          m0, m0                          ; dc
+    mov           cntd, %1
+%%loop:
+%if %1 == 4
+    movq        [srcq], m0
+%else
+%assign %%i 0
+%rep %1 / 8
+    movu [srcq + %%i * 16], m0
+%assign %%i %%i + 1
+%endrep
+%endif
+    add           srcq, strideq
+    dec           cntd
+    jg %%loop
+    imul          cntq, strideq, %1
+    sub           srcq, cntq
+
+%if %1 < 32
+    test         cidxd, cidxd
+    jnz %%end
+    lea           cntd, [dcq * 3 + 2]
+    movd            m4, cntd
+    SPLATW          m4, m4                          ; 3 * dc + 2
+%if %1 == 4
+    movq            m1, [topq]
+    movq            m2, [leftq]
+%else
+    movu            m1, [topq]
+    movu            m2, [leftq]
+%endif
+    paddw           m1, m4
+    paddw           m2, m4
+    psrlw           m1, 2
+    psrlw           m2, 2
+%if %1 == 4
+    movq        [srcq], m1
+%else
+    movu        [srcq], m1
+%endif
+%if %1 == 16
+    movu            m1, [topq + 16]
+    movu            m5, [leftq + 16]
+    paddw           m1, m4
+    paddw           m5, m4
+    psrlw           m1, 2
+    psrlw           m5, 2
+    movu   [srcq + 16], m1
+%endif
+    ; (left[0] + 2 * dc + top[0] + 2) >> 2
+    movzx        cidxd, word [leftq]
+    movzx         cntd, word [topq]
+    add          cidxd, cntd
+    lea          cidxd, [cidxq + dcq * 2 + 2]
+    shr          cidxd, 2
+    mov         [srcq], cidxw
+%assign %%y 1
+%rep %1 - 1
+    add           srcq, strideq
+%if %%y < 8
+    pextrw      [srcq], m2, %%y
+%else
+    pextrw      [srcq], m5, %%y - 8
+%endif
+%assign %%y %%y + 1
+%endrep
+%%end:
+%endif
+    RET
+%endmacro
+
+%macro PRED_DC 1 ; bits
+cglobal hevc_pred_dc_%1, 6, 7, 6, src, top, left, stride, dc, cidx, cnt
+%if %1 > 8
+    add        strideq, strideq
+%endif
+    cmp            dcd, 3                           ; log2_size
+    jl .dc4
+    je .dc8
+    cmp            dcd, 4
+    je .dc16
+    PRED_DC_%1_BODY 32, 5
+.dc4:
+    PRED_DC_%1_BODY  4, 2
+.dc8:
+    PRED_DC_%1_BODY  8, 3
+.dc16:
+    PRED_DC_%1_BODY 16, 4
+%endmacro
+
+%if ARCH_X86_64
+;------------------------------------------------------------------------------
+; void ff_hevc_pred_angular_<size>_<bits>(uint8_t *src, const uint8_t *top,
+;                                         const uint8_t *left,
+;                                         ptrdiff_t stride, int c_idx,
+;                                         int mode)
+;------------------------------------------------------------------------------
+; The main reference (top for the vertical modes 18-34, left for the
+; horizontal modes 2-17) is copied to the stack, extended to the left by
+; projecting the side reference for negative angles. Vertical modes are
+; interpolated row by row into src. Horizontal modes are interpolated the
+; same way into a transposed block on the stack, which is then transposed
+; into src 8x8 (4x4) at a time.
+
+; Build the reference row in refq and set up dstq/dstrideq for the
+; interpolation; leaves the angle in angled.
+%macro ANGULAR_REF 2 ; size, pixel size
+%if %2 == 2
+    add        strideq, strideq
+%endif
+    movsxd        modeq, moded
+    lea           idxq, [angular_angle]
+    movsx        angled, byte [idxq + modeq - 2]
+    mov           dstq, srcq
+    mov       dstrideq, strideq
+    cmp          moded, 18
+    jge .vertical
+    xchg         mainq, sideq
+    mov           dstq, rsp
+    mov       dstrided, %1 * %2
+.vertical:
+    lea           refq, [rsp + (%1 * %1 + %1) * %2] ; ref[0] is main[-1]
+    pxor           xm0, xm0
+    movu [refq + (2 * %1 + 1) * %2], xm0           ; the SIMD loads go past the reference
+%if 2 * %1 * %2 == 8
+    movq           xm0, [mainq - %2]
+    movq        [refq], xm0
+%else
+%assign %%i 0
+%rep 2 * %1 * %2 / 16
+    movu           xm0, [mainq - %2 + %%i]
+    movu [refq + %%i], xm0
+%assign %%i %%i + 16
+%endrep
+%endif
+%if %2 == 1
+    movzx         idxd, byte [mainq + 2 * %1 - 1]
+    mov [refq + 2 * %1], idxb
+%else
+    movzx         idxd, word [mainq + 4 * %1 - 2]
+    mov [refq + 4 * %1], idxw
+%endif
+
+    ; ref[x] = side[-1 + ((x * inv_angle + 128) >> 8)] for x in [last, -1]
+    test         angled, angled
+    jns .interp
+    imul          cntd, angled, %1
+    sar           cntd, 5                           ; last
+    cmp           cntd, -1
+    jge .interp
+    movsxd        cntq, cntd
+    lea           idxq, [angular_inv_angle]
+    movsx         moded, word [idxq + modeq * 2 - 22]
+.project:
+    mov           idxd, cntd
+    imul          idxd, moded
+    add           idxd, 128
+    sar           idxd, 8
+    movsxd        idxq, idxd
+%if %2 == 1
+    movzx         idxd, byte [sideq + idxq - 1]
+    mov  [refq + cntq], idxb
+%else
+    movzx         idxd, word [sideq + idxq * 2 - 2]
+    mov [refq + cntq * 2], idxw
+%endif
+    inc           cntq
+    jnz .project
+.interp:
+%endmacro
+
+; Transpose the 8x8 block at %5 (line size %6) into %1 (line size %2,
+; %3 = 3 * %2, %4 = temporary).
+%macro TRANSPOSE_8X8_8 6 ; dst, stride, stride3, tmp, src, src stride
+%assign %%i 0
+%rep 8
+    movq     xm %+ %%i, [%5 + %%i * %6]
+%assign %%i %%i + 1
+%endrep
+    punpcklbw      xm0, xm1                         ; rows 0-1
+    punpcklbw      xm2, xm3
+    punpcklbw      xm4, xm5
+    punpcklbw      xm6, xm7
+    punpckhwd      xm1, xm0, xm2
+    punpcklwd      xm0, xm2                         ; rows 0-3, columns 0-3
+    punpckhwd      xm3, xm4, xm6
+    punpcklwd      xm4, xm6                         ; rows 4-7, columns 0-3
+    punpckhdq      xm2, xm0, xm4                    ; columns 2-3
+    punpckldq      xm0, xm4                         ; columns 0-1
+    punpckhdq      xm5, xm1, xm3                    ; columns 6-7
+    punpckldq      xm1, xm3                         ; columns 4-5
+    lea             %4, [%1 + %2 * 4]
+    movq          [%1], xm0
+    movhps   [%1 + %2], xm0
+    movq [%1 + %2 * 2], xm2
+    movhps   [%1 + %3], xm2
+    movq          [%4], xm1
+    movhps   [%4 + %2], xm1
+    movq [%4 + %2 * 2], xm5
+    movhps   [%4 + %3], xm5
+%endmacro
+
+%macro TRANSPOSE_8X8_16 6 ; dst, stride, stride3, tmp, src, src stride
+%assign %%i 0
+%rep 8
+    movu     xm %+ %%i, [%5 + %%i * %6]
+%assign %%i %%i + 1
+%endrep
+    punpckhwd      xm8, xm0, xm1                    ; rows 0-1
+    punpcklwd      xm0, xm1
+    punpckhwd      xm1, xm2, xm3
+    punpcklwd      xm2, xm3
+    punpckhwd      xm3, xm4, xm5
+    punpcklwd      xm4, xm5
+    punpckhwd      xm5, xm6, xm7
+    punpcklwd      xm6, xm7
+    punpckhdq      xm7, xm0, xm2                    ; rows 0-3, columns 2-3
+    punpckldq      xm0, xm2
+    punpckhdq      xm2, xm4, xm6                    ; rows 4-7, columns 2-3
+    punpckldq      xm4, xm6
+    punpckhdq      xm6, xm8, xm1                    ; rows 0-3, columns 6-7
+    punpckldq      xm8, xm1
+    punpckhdq      xm1, xm3, xm5                    ; rows 4-7, columns 6-7
+    punpckldq      xm3, xm5
+    punpcklqdq     xm5, xm0, xm4                    ; column 0
+    punpckhqdq     xm0, xm4
+    punpcklqdq     xm4, xm7, xm2                    ; column 2
+    punpckhqdq     xm7, xm2
+    punpcklqdq     xm2, xm8, xm3                    ; column 4
+    punpckhqdq     xm8, xm3
+    punpcklqdq     xm3, xm6, xm1                    ; column 6
+    punpckhqdq     xm6, xm1
+    lea             %4, [%1 + %2 * 4]
+    movu          [%1], xm5
+    movu     [%1 + %2], xm0
+    movu [%1 + %2 * 2], xm4
+    movu     [%1 + %3], xm7
+    movu          [%4], xm2
+    movu     [%4 + %2], xm8
+    movu [%4 + %2 * 2], xm3
+    movu     [%4 + %3], xm6
+%endmacro
+
+; Transpose the size x size block on the stack into src, for horizontal modes.
+%macro ANGULAR_TRANSPOSE 2 ; size, pixel size
+    cmp           dstq, rsp
+    jne .end
+    lea       dstrideq, [strideq * 3]
+%if %1 == 4 && %2 == 1
+    movu           xm0, [rsp]
+    pshufb         xm0, [pb_transpose_4x4]
+    movd        [srcq], xm0
+    psrldq         xm0, 4
+    movd [srcq + strideq], xm0
+    psrldq         xm0, 4
+    movd [srcq + strideq * 2], xm0
+    psrldq         xm0, 4
+    movd [srcq + dstrideq], xm0
+%elif %1 == 4
+    movq           xm0, [rsp]
+    movq           xm1, [rsp + 8]
+    movq           xm2, [rsp + 16]
+    movq           xm3, [rsp + 24]
+    punpcklwd      xm0, xm1
+    punpcklwd      xm2, xm3
+    punpckhdq      xm1, xm0, xm2
+    punpckldq      xm0, xm2
+    movq        [srcq], xm0
+    movhps [srcq + strideq], xm0
+    movq [srcq + strideq * 2], xm1
+    movhps [srcq + dstrideq], xm1
+%else
+    mov           refq, rsp                         ; tmp + 8 * j
+    mov         angled, %1 / 8
+.transpose_j:
+    mov           posq, refq                        ; tmp + 8 * (i * size + j)
+    mov           idxq, srcq                        ; src + 8 * (j * stride + i)
+    mov           cntd, %1 / 8
+.transpose_i:
+%if %2 == 1
+    TRANSPOSE_8X8_8  idxq, strideq, dstrideq, mainq, posq, %1
+%else
+    TRANSPOSE_8X8_16 idxq, strideq, dstrideq, mainq, posq, %1 * 2
+%endif
+    add           posq, 8 * %1 * %2
+    add           idxq, 8 * %2
+    dec           cntd
+    jg .transpose_i
+    add           refq, 8 * %2
+    lea           srcq, [srcq + strideq * 8]
+    dec         angled
+    jg .transpose_j
+%endif
+.end:
+%endmacro
+
+%macro PRED_ANGULAR_8 1 ; size
+cglobal hevc_pred_angular_%1_8, 6, 13, 8, %1 * %1 + 4 * %1 + 64, src, main, side, stride, cidx, mode, angle, ref, dst, dstride, idx, cnt
+    ANGULAR_REF     %1, 1
+    DEFINE_ARGS src, main, side, stride, cidx, pos, angle, ref, dst, dstride, idx, cnt
+
+    mova            m5, [pw_1024]
+    mov           posd, angled
+    mov           cntd, %1
+.loop:
+    mov           idxd, posd
+    and           idxd, 31
+    imul          idxd, 255
+    add           idxd, 32
+    movd           xm4, idxd
+    SPLATW          m4, xm4                         ; 32 - fact, fact
+    mov           idxd, posd
+    sar           idxd, 5
+    movsxd        idxq, idxd
+%if %1 <= 8
+    movq            m0, [refq + idxq + 1]
+    movq            m1, [refq + idxq + 2]
+    punpcklbw       m0, m1
+    pmaddubsw       m0, m4
+    pmulhrsw        m0, m5
+    packuswb        m0, m0
+%if %1 == 4
+    movd        [dstq], m0
+%else
+    movq        [dstq], m0
+%endif
+%else
+%assign %%i 0
+%rep %1 / mmsize
+    movu            m0, [refq + idxq + 1 + %%i * mmsize]
+    movu            m1, [refq + idxq + 2 + %%i * mmsize]
+    punpckhbw       m2, m0, m1
+    punpcklbw       m0, m1
+    pmaddubsw       m0, m4
+    pmaddubsw       m2, m4
+    pmulhrsw        m0, m5
+    pmulhrsw        m2, m5
+    packuswb        m0, m2
+    movu [dstq + %%i * mmsize], m0
+%assign %%i %%i + 1
+%endrep
+%endif
+    add           dstq, dstrideq
+    add           posd, angled
+    dec           cntd
+    jg .loop
+    imul          cntq, dstrideq, %1
+    sub           dstq, cntq
+
+%if %1 < 32
+    ; modes 10 and 26 (angle 0): dst[y * dstride] =
+    ; clip(main[0] + ((side[y] - side[-1]) >> 1)) for luma
+    test        angled, angled
+    jnz .filtered
+    test         cidxd, cidxd
+    jnz .filtered
+    movzx         idxd, byte [sideq - 1]
+    movd           xm2, idxd
+    SPLATW         xm2, xm2                         ; side[-1]
+    movzx         idxd, byte [mainq]
+    movd           xm3, idxd
+    SPLATW         xm3, xm3                         ; main[0]
+    pxor           xm4, xm4
+%if %1 == 4
+    movd           xm0, [sideq]
+%else
+    movq           xm0, [sideq]
+%endif
+    punpcklbw      xm0, xm4
+    psubw          xm0, xm2
+    psraw          xm0, 1
+    paddw          xm0, xm3
+%if %1 == 16
+    movq           xm1, [sideq + 8]
+    punpcklbw      xm1, xm4
+    psubw          xm1, xm2
+    psraw          xm1, 1
+    paddw          xm1, xm3
+    packuswb       xm0, xm1
+%else
+    packuswb       xm0, xm0
+%endif
+    mov           cntq, dstq
+%rep %1
+    movd          idxd, xm0
+    mov         [cntq], idxb
+    psrldq         xm0, 1
+    add           cntq, dstrideq
+%endrep
+.filtered:
+%endif
+    ANGULAR_TRANSPOSE %1, 1
+    RET
+%endmacro
+
+%macro PRED_ANGULAR_16 2 ; size, bit depth
+cglobal hevc_pred_angular_%1_%2, 6, 13, 9, 2 * %1 * %1 + 8 * %1 + 64, src, main, side, stride, cidx, mode, angle, ref, dst, dstride, idx, cnt
+    ANGULAR_REF     %1, 2
+    DEFINE_ARGS src, main, side, stride, cidx, pos, angle, ref, dst, dstride, idx, cnt
+
+    mova            m5, [pd_16]
+    mov           posd, angled
+    mov           cntd, %1
+.loop:
+    mov           idxd, posd
+    and           idxd, 31
+    imul          idxd, 65535
+    add           idxd, 32
+    movd           xm4, idxd
+    BCASTD          m4, xm4                         ; 32 - fact, fact
+    mov           idxd, posd
+    sar           idxd, 5
+    movsxd        idxq, idxd
+%if %1 == 4
+    movq            m0, [refq + idxq * 2 + 2]
+    movq            m1, [refq + idxq * 2 + 4]
+    punpcklwd       m0, m1
+    pmaddwd         m0, m4
+    paddd           m0, m5
+    psrld           m0, 5
+    packusdw        m0, m0
+    movq        [dstq], m0
+%else
+%assign %%i 0
+%rep %1 * 2 / mmsize
+    movu            m0, [refq + idxq * 2 + 2 + %%i * mmsize]
+    movu            m1, [refq + idxq * 2 + 4 + %%i * mmsize]
+    punpckhwd       m2, m0, m1
+    punpcklwd       m0, m1
+    pmaddwd         m0, m4
+    pmaddwd         m2, m4
+    paddd           m0, m5
+    paddd           m2, m5
+    psrld           m0, 5
+    psrld           m2, 5
+    packusdw        m0, m2
+    movu [dstq + %%i * mmsize], m0
+%assign %%i %%i + 1
+%endrep
+%endif
+    add           dstq, dstrideq
+    add           posd, angled
+    dec           cntd
+    jg .loop
+    imul          cntq, dstrideq, %1
+    sub           dstq, cntq
+
+%if %1 < 32
+    ; modes 10 and 26 (angle 0): dst[y * dstride] =
+    ; clip(main[0] + ((side[y] - side[-1]) >> 1)) for luma
+    test        angled, angled
+    jnz .filtered
+    test         cidxd, cidxd
+    jnz .filtered
+    movzx         idxd, word [sideq - 2]
+    movd           xm2, idxd
+    SPLATW         xm2, xm2                         ; side[-1]
+    movzx         idxd, word [mainq]
+    movd           xm3, idxd
+    SPLATW         xm3, xm3                         ; main[0]
+    mov           idxd, (1 << %2) - 1
+    movd           xm5, idxd
+    SPLATW         xm5, xm5                         ; pixel max
+    pxor           xm4, xm4
+%if %1 == 4
+    movq           xm0, [sideq]
+%else
+    movu           xm0, [sideq]
+%endif
+    psubw          xm0, xm2
+    psraw          xm0, 1
+    paddw          xm0, xm3
+    pmaxsw         xm0, xm4
+    pminsw         xm0, xm5
+%if %1 == 16
+    movu           xm1, [sideq + 16]
+    psubw          xm1, xm2
+    psraw          xm1, 1
+    paddw          xm1, xm3
+    pmaxsw         xm1, xm4
+    pminsw         xm1, xm5
+%endif
+    mov           cntq, dstq
+%assign %%y 0
+%rep %1
+%if %%y < 8
+    pextrw      [cntq], xm0, %%y
+%else
+    pextrw      [cntq], xm1, %%y - 8
+%endif
+    add           cntq, dstrideq
+%assign %%y %%y + 1
+%endrep
+.filtered:
+%endif
+    ANGULAR_TRANSPOSE %1, 2
+    RET
+%endmacro
+
+%macro PRED_ANGULAR_16_DEPTHS 1 ; size
+PRED_ANGULAR_16 %1,  9
+PRED_ANGULAR_16 %1, 10
+PRED_ANGULAR_16 %1, 12
+%endmacro
+
+INIT_XMM ssse3
+PRED_ANGULAR_8   4
+PRED_ANGULAR_8   8
+PRED_ANGULAR_8  16
+PRED_ANGULAR_8  32
+%endif ; ARCH_X86_64
+
+INIT_XMM sse4
+PRED_PLANAR_8    4, 2
+PRED_PLANAR_8    8, 3
+PRED_PLANAR_8   16, 4
+PRED_PLANAR_16   4, 2
+PRED_PLANAR_16   8, 3
+PRED_PLANAR_16  16, 4
+PRED_PLANAR_16  32, 5
+PRED_DC          8
+PRED_DC         16
+%if ARCH_X86_64
+PRED_ANGULAR_16_DEPTHS  4
+PRED_ANGULAR_16_DEPTHS  8
+PRED_ANGULAR_16_DEPTHS 16
+PRED_ANGULAR_16_DEPTHS 32
+%endif
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+PRED_PLANAR_8   16, 4
+PRED_PLANAR_8   32, 5
+PRED_PLANAR_16   8, 3
+PRED_PLANAR_16  16, 4
+PRED_PLANAR_16  32, 5
+%if ARCH_X86_64
+PRED_ANGULAR_8  32
+PRED_ANGULAR_16_DEPTHS 16
+PRED_ANGULAR_16_DEPTHS 32
+%endif
+%endif
@@ -0,0 +1,133 @@
+/*
+ * HEVC intra prediction
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/hevcpred.h"
+
+#define PLANAR_PROTO(size, bits, opt)                                          \
+void ff_hevc_pred_planar_ ## size ## _ ## bits ## _ ## opt(uint8_t *src,       \
+        const uint8_t *top, const uint8_t *left, ptrdiff_t stride)
+#define DC_PROTO(bits, opt)                                                    \
+void ff_hevc_pred_dc_ ## bits ## _ ## opt(uint8_t *src, const uint8_t *top,    \
+        const uint8_t *left, ptrdiff_t stride, int log2_size, int c_idx)
+#define ANGULAR_PROTO(size, depth, opt)                                        \
+void ff_hevc_pred_angular_ ## size ## _ ## depth ## _ ## opt(uint8_t *src,     \
+        const uint8_t *top, const uint8_t *left, ptrdiff_t stride,             \
+        int c_idx, int mode)
+#define ANGULAR_PROTOS(depth, opt)                                             \
+ANGULAR_PROTO( 4, depth, opt);                                                 \
+ANGULAR_PROTO( 8, depth, opt);                                                 \
+ANGULAR_PROTO(16, depth, opt);                                                 \
+ANGULAR_PROTO(32, depth, opt)
+
+PLANAR_PROTO( 4,  8, sse4);
+PLANAR_PROTO( 8,  8, sse4);
+PLANAR_PROTO(16,  8, sse4);
+PLANAR_PROTO(16,  8, avx2);
+PLANAR_PROTO(32,  8, avx2);
+PLANAR_PROTO( 4, 16, sse4);
+PLANAR_PROTO( 8, 16, sse4);
+PLANAR_PROTO(16, 16, sse4);
+PLANAR_PROTO(32, 16, sse4);
+PLANAR_PROTO( 8, 16, avx2);
+PLANAR_PROTO(16, 16, avx2);
+PLANAR_PROTO(32, 16, avx2);
+
+DC_PROTO( 8, sse4);
+DC_PROTO(16, sse4);
+
+ANGULAR_PROTOS( 8, ssse3);
+ANGULAR_PROTO(32,  8, avx2);
+ANGULAR_PROTOS( 9, sse4);
+ANGULAR_PROTOS(10, sse4);
+ANGULAR_PROTOS(12, sse4);
+ANGULAR_PROTO(16,  9, avx2);
+ANGULAR_PROTO(32,  9, avx2);
+ANGULAR_PROTO(16, 10, avx2);
+ANGULAR_PROTO(32, 10, avx2);
+ANGULAR_PROTO(16, 12, avx2);
+ANGULAR_PROTO(32, 12, avx2);
+
+#define PRED_INIT_HIGH(depth)                                                  \
+    if (EXTERNAL_SSE4(cpu_flags)) {                                            \
+        hpc->pred_planar[0]  = ff_hevc_pred_planar_4_16_sse4;                  \
+        hpc->pred_planar[1]  = ff_hevc_pred_planar_8_16_sse4;                  \
+        hpc->pred_planar[2]  = ff_hevc_pred_planar_16_16_sse4;                 \
+        hpc->pred_planar[3]  = ff_hevc_pred_planar_32_16_sse4;                 \
+        hpc->pred_dc         = ff_hevc_pred_dc_16_sse4;                        \
+    }                                                                          \
+    if (ARCH_X86_64 && EXTERNAL_SSE4(cpu_flags)) {                             \
+        hpc->pred_angular[0] = ff_hevc_pred_angular_4_  ## depth ## _sse4;     \
+        hpc->pred_angular[1] = ff_hevc_pred_angular_8_  ## depth ## _sse4;     \
+        hpc->pred_angular[2] = ff_hevc_pred_angular_16_ ## depth ## _sse4;     \
+        hpc->pred_angular[3] = ff_hevc_pred_angular_32_ ## depth ## _sse4;     \
+    }                                                                          \
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {                                       \
+        hpc->pred_planar[1]  = ff_hevc_pred_planar_8_16_avx2;                  \
+        hpc->pred_planar[2]  = ff_hevc_pred_planar_16_16_avx2;                 \
+        hpc->pred_planar[3]  = ff_hevc_pred_planar_32_16_avx2;                 \
+    }                                                                          \
+    if (ARCH_X86_64 && EXTERNAL_AVX2_FAST(cpu_flags)) {                        \
+        hpc->pred_angular[2] = ff_hevc_pred_angular_16_ ## depth ## _avx2;     \
+        hpc->pred_angular[3] = ff_hevc_pred_angular_32_ ## depth ## _avx2;     \
+    }
+
+av_cold void ff_hevc_pred_init_x86(HEVCPredContext *hpc, int bit_depth)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    switch (bit_depth) {
+    case 8:
+        if (ARCH_X86_64 && EXTERNAL_SSSE3(cpu_flags)) {
+            hpc->pred_angular[0] = ff_hevc_pred_angular_4_8_ssse3;
+            hpc->pred_angular[1] = ff_hevc_pred_angular_8_8_ssse3;
+            hpc->pred_angular[2] = ff_hevc_pred_angular_16_8_ssse3;
+            hpc->pred_angular[3] = ff_hevc_pred_angular_32_8_ssse3;
+        }
+        if (EXTERNAL_SSE4(cpu_flags)) {
+            hpc->pred_planar[0]  = ff_hevc_pred_planar_4_8_sse4;
+            hpc->pred_planar[1]  = ff_hevc_pred_planar_8_8_sse4;
+            hpc->pred_planar[2]  = ff_hevc_pred_planar_16_8_sse4;
+            hpc->pred_dc         = ff_hevc_pred_dc_8_sse4;
+        }
+        if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+            hpc->pred_planar[2]  = ff_hevc_pred_planar_16_8_avx2;
+            hpc->pred_planar[3]  = ff_hevc_pred_planar_32_8_avx2;
+        }
+        if (ARCH_X86_64 && EXTERNAL_AVX2_FAST(cpu_flags))
+            hpc->pred_angular[3] = ff_hevc_pred_angular_32_8_avx2;
+        break;
+    case 9:
+        PRED_INIT_HIGH(9)
+        break;
+    case 10:
+        PRED_INIT_HIGH(10)
+        break;
+    case 12:
+        PRED_INIT_HIGH(12)
+        break;
+    }
+}
@@ -0,0 +1,199 @@
+;******************************************************************************
+;* SIMD-optimized JPEG 2000 DWT lifting steps
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pq_32768: times 4 dq 0x8000
+
+SECTION .text
+
+; Set up dst, a and b to point past the end of the rows and w to minus the
+; row length in bytes, less one vector, so that the main loop can handle
+; whole vectors and the remaining elements are done one at a time.
+%macro LIFT_PROLOGUE 0
+    movsxdifnidn wq, wd
+    shl          wq, 2
+    add        dstq, wq
+    add          aq, wq
+    add          bq, wq
+    neg          wq
+    add          wq, mmsize
+    jg .tail
+%endmacro
+
+;***********************************************************************
+; void ff_lift_int_<add|sub>_<opt>(int32_t *dst, const int32_t *a,
+;                                  const int32_t *b, int w, int rnd, int shift)
+;***********************************************************************
+%macro LIFT_INT 1 ; add/sub
+cglobal lift_int_%1, 4, 4, 4, dst, a, b, w, rnd, shift
+    movd        xm2, rndm
+    movd        xm3, shiftm
+%if cpuflag(avx2)
+    vpbroadcastd m2, xm2
+%else
+    pshufd       m2, m2, 0
+%endif
+    LIFT_PROLOGUE
+.loop:
+    movu         m0, [aq+wq-mmsize]
+    movu         m1, [bq+wq-mmsize]
+    paddd        m0, m1
+    paddd        m0, m2
+    psrad        m0, xm3
+    movu         m1, [dstq+wq-mmsize]
+    p%1d         m1, m0
+    movu [dstq+wq-mmsize], m1
+    add          wq, mmsize
+    jle .loop
+.tail:
+    sub          wq, mmsize
+    jge .end
+.tail_loop:
+    movd        xm0, [aq+wq]
+    movd        xm1, [bq+wq]
+    paddd       xm0, xm1
+    paddd       xm0, xm2
+    psrad       xm0, xm3
+    movd        xm1, [dstq+wq]
+    p%1d        xm1, xm0
+    movd  [dstq+wq], xm1
+    add          wq, 4
+    jl .tail_loop
+.end:
+    RET
+%endmacro
+
+; m0 = (m2 * m0 + (1 << 15)) >> 16 on signed dwords with 64-bit intermediates;
+; clobbers m1, expects the rounding constant in m3
+%macro MUL_RND16 0
+    psrlq        m1, m0, 32
+    pmuldq       m0, m2
+    pmuldq       m1, m2
+    paddq        m0, m3
+    paddq        m1, m3
+    psrlq        m0, 16
+    psllq        m1, 16
+%if cpuflag(avx2)
+    vpblendd     m0, m0, m1, 0xAA
+%else
+    pblendw      m0, m1, 0xCC
+%endif
+%endmacro
+
+;***********************************************************************
+; void ff_lift97_int_<add|sub>_<opt>(int32_t *dst, const int32_t *a,
+;                                    const int32_t *b, int w, int coef)
+;***********************************************************************
+%macro LIFT97_INT 1 ; add/sub
+cglobal lift97_int_%1, 4, 4, 4, dst, a, b, w, coef
+    movd        xm2, coefm
+%if cpuflag(avx2)
+    vpbroadcastd m2, xm2
+%else
+    pshufd       m2, m2, 0
+%endif
+    mova         m3, [pq_32768]
+    LIFT_PROLOGUE
+.loop:
+    movu         m0, [aq+wq-mmsize]
+    movu         m1, [bq+wq-mmsize]
+    paddd        m0, m1
+    MUL_RND16
+    movu         m1, [dstq+wq-mmsize]
+    p%1d         m1, m0
+    movu [dstq+wq-mmsize], m1
+    add          wq, mmsize
+    jle .loop
+.tail:
+    sub          wq, mmsize
+    jge .end
+.tail_loop:
+    movd        xm0, [aq+wq]
+    movd        xm1, [bq+wq]
+    paddd       xm0, xm1
+    MUL_RND16
+    movd        xm1, [dstq+wq]
+    p%1d        xm1, xm0
+    movd  [dstq+wq], xm1
+    add          wq, 4
+    jl .tail_loop
+.end:
+    RET
+%endmacro
+
+;***********************************************************************
+; void ff_lift97_float_<opt>(float *dst, const float *a, const float *b,
+;                            int w, float coef)
+;***********************************************************************
+%macro LIFT97_FLOAT 0
+cglobal lift97_float, 4, 4, 3, dst, a, b, w, coef
+%if UNIX64 == 0
+    movss       xm0, coefm
+%endif
+    shufps      xm0, xm0, 0
+%if mmsize == 32
+    vinsertf128  m0, m0, xm0, 1
+%endif
+    LIFT_PROLOGUE
+.loop:
+    movu         m1, [aq+wq-mmsize]
+    movu         m2, [bq+wq-mmsize]
+    addps        m1, m2
+    mulps        m1, m0
+    movu         m2, [dstq+wq-mmsize]
+    addps        m2, m1
+    movu [dstq+wq-mmsize], m2
+    add          wq, mmsize
+    jle .loop
+.tail:
+    sub          wq, mmsize
+    jge .end
+.tail_loop:
+    movss       xm1, [aq+wq]
+    addss       xm1, [bq+wq]
+    mulss       xm1, xm0
+    addss       xm1, [dstq+wq]
+    movss [dstq+wq], xm1
+    add          wq, 4
+    jl .tail_loop
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse
+LIFT97_FLOAT
+INIT_XMM sse2
+LIFT_INT add
+LIFT_INT sub
+INIT_XMM sse4
+LIFT97_INT add
+LIFT97_INT sub
+INIT_YMM avx
+LIFT97_FLOAT
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+LIFT_INT add
+LIFT_INT sub
+LIFT97_INT add
+LIFT97_INT sub
+%endif
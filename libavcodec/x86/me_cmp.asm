@@ -278,6 +278,76 @@ INIT_XMM ssse3
 %define ABS_SUM_8x8 ABS_SUM_8x8_64
 HADAMARD8_DIFF 9
 
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+; Differences of a 16x8 area as words in m0-m7: the left 8x8 block in the
+; low lanes and the right one in the high lanes. Advances r1 and r2 by 4 lines.
+%macro DIFF_PIXELS_16x8 0
+    pmovzxbw        m0, [r1]
+    pmovzxbw        m8, [r2]
+    psubw           m0, m8
+    pmovzxbw        m1, [r1+r3]
+    pmovzxbw        m8, [r2+r3]
+    psubw           m1, m8
+    pmovzxbw        m2, [r1+r3*2]
+    pmovzxbw        m8, [r2+r3*2]
+    psubw           m2, m8
+    pmovzxbw        m3, [r1+r0]
+    pmovzxbw        m8, [r2+r0]
+    psubw           m3, m8
+    lea             r1, [r1+r3*4]
+    lea             r2, [r2+r3*4]
+    pmovzxbw        m4, [r1]
+    pmovzxbw        m8, [r2]
+    psubw           m4, m8
+    pmovzxbw        m5, [r1+r3]
+    pmovzxbw        m8, [r2+r3]
+    psubw           m5, m8
+    pmovzxbw        m6, [r1+r3*2]
+    pmovzxbw        m8, [r2+r3*2]
+    psubw           m6, m8
+    pmovzxbw        m7, [r1+r0]
+    pmovzxbw        m8, [r2+r0]
+    psubw           m7, m8
+%endmacro
+
+; Sum of the absolute transformed differences of both 8x8 blocks into %1,
+; saturating per block exactly like the 8x8 versions above.
+%macro HADAMARD16x8_DIFF 1
+    DIFF_PIXELS_16x8
+    HADAMARD8
+    TRANSPOSE8x8W    0,  1,  2,  3,  4,  5,  6,  7,  8
+    HADAMARD8
+    ABS_SUM_8x8_64   0
+    vextracti128   xm1, m0, 1
+    punpcklqdq     xm2, xm0, xm1
+    punpckhqdq     xm0, xm1
+    paddusw        xm0, xm2
+    pshuflw        xm1, xm0, 0xE
+    pshufhw        xm1, xm1, 0xE
+    paddusw        xm0, xm1
+    pshuflw        xm1, xm0, 0x1
+    pshufhw        xm1, xm1, 0x1
+    paddusw        xm0, xm1
+    pextrw          %1, xm0, 0
+    pextrw         r6d, xm0, 4
+    add             %1, r6d
+%endmacro
+
+INIT_YMM avx2
+cglobal hadamard8_diff16, 5, 7, 10, v, pix1, pix2, stride, h
+    lea             r0, [r3*3]
+    HADAMARD16x8_DIFF r5d
+    cmp            r4d, 16
+    jne .done
+    lea             r1, [r1+r3*4]
+    lea             r2, [r2+r3*4]
+    HADAMARD16x8_DIFF eax
+    add            r5d, eax
+.done:
+    mov            eax, r5d
+    RET
+%endif
+
 ; int ff_sse*_*(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
 ;               ptrdiff_t line_size, int h)
 
@@ -356,6 +426,47 @@ SUM_SQUARED_ERRORS 16
 INIT_XMM sse2
 SUM_SQUARED_ERRORS 16
 
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+; Two lines per iteration as 16 words, %1 = 8/16
+%macro SUM_SQUARED_ERRORS_AVX2 1
+cglobal sse%1, 5,5,4, v, pix1, pix2, lsize, h
+    pxor      m0, m0
+.next2lines:
+%if %1 == 16
+    pmovzxbw  m1, [pix1q]
+    pmovzxbw  m2, [pix2q]
+    pmovzxbw  m3, [pix1q+lsizeq]
+    psubw     m1, m2
+    pmovzxbw  m2, [pix2q+lsizeq]
+    psubw     m3, m2
+    pmaddwd   m3, m3
+    paddd     m0, m3
+%else
+    movq     xm1, [pix1q]
+    movq     xm2, [pix2q]
+    movhps   xm1, [pix1q+lsizeq]
+    movhps   xm2, [pix2q+lsizeq]
+    pmovzxbw  m1, xm1
+    pmovzxbw  m2, xm2
+    psubw     m1, m2
+%endif
+    pmaddwd   m1, m1
+    paddd     m0, m1
+    lea    pix1q, [pix1q + 2*lsizeq]
+    lea    pix2q, [pix2q + 2*lsizeq]
+    sub       hd, 2
+    jg .next2lines
+
+    HADDD     m0, m1
+    movd     eax, xm0
+    RET
+%endmacro
+
+INIT_YMM avx2
+SUM_SQUARED_ERRORS_AVX2 8
+SUM_SQUARED_ERRORS_AVX2 16
+%endif
+
 ;-----------------------------------------------
 ;int ff_sum_abs_dctelem(const int16_t *block)
 ;-----------------------------------------------
@@ -520,6 +631,69 @@ SAD 16
 INIT_XMM sse2
 SAD 16
 
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+; Two lines of 16 or four lines of 8 pixels per psadbw
+cglobal sad16, 5, 5, 3, v, pix1, pix2, stride, h
+    pxor         m0, m0
+.loop:
+    movu        xm1, [pix2q]
+    movu        xm2, [pix1q]
+    vinserti128  m1, m1, [pix2q+strideq], 1
+    vinserti128  m2, m2, [pix1q+strideq], 1
+    psadbw       m1, m2
+    paddw        m0, m1
+    lea       pix1q, [pix1q+strideq*2]
+    lea       pix2q, [pix2q+strideq*2]
+    sub          hd, 2
+    jg .loop
+    vextracti128 xm1, m0, 1
+    paddw       xm0, xm1
+    movhlps     xm1, xm0
+    paddw       xm0, xm1
+    movd        eax, xm0
+    RET
+
+cglobal sad8, 5, 6, 4, v, pix1, pix2, stride, h, stride3
+    lea    stride3q, [strideq*3]
+    pxor         m0, m0
+    sub          hd, 4
+    jl .tail
+.loop:
+    movq        xm1, [pix2q]
+    movq        xm2, [pix2q+strideq*2]
+    movhps      xm1, [pix2q+strideq]
+    movhps      xm2, [pix2q+stride3q]
+    vinserti128  m1, m1, xm2, 1
+    movq        xm2, [pix1q]
+    movq        xm3, [pix1q+strideq*2]
+    movhps      xm2, [pix1q+strideq]
+    movhps      xm3, [pix1q+stride3q]
+    vinserti128  m2, m2, xm3, 1
+    psadbw       m1, m2
+    paddw        m0, m1
+    lea       pix1q, [pix1q+strideq*4]
+    lea       pix2q, [pix2q+strideq*4]
+    sub          hd, 4
+    jge .loop
+.tail:
+    add          hd, 4
+    jz .end
+    movq        xm1, [pix2q]
+    movq        xm2, [pix1q]
+    movhps      xm1, [pix2q+strideq]
+    movhps      xm2, [pix1q+strideq]
+    psadbw      xm1, xm2
+    paddw        m0, m1
+.end:
+    vextracti128 xm1, m0, 1
+    paddw       xm0, xm1
+    movhlps     xm1, xm0
+    paddw       xm0, xm1
+    movd        eax, xm0
+    RET
+%endif
+
 ;------------------------------------------------------------------------------------------
 ;int ff_sad_x2_<opt>(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2, ptrdiff_t stride, int h);
 ;------------------------------------------------------------------------------------------
@@ -38,6 +38,10 @@ int ff_sse16_mmx(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
                  ptrdiff_t stride, int h);
 int ff_sse16_sse2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
                   ptrdiff_t stride, int h);
+int ff_sse8_avx2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
+                 ptrdiff_t stride, int h);
+int ff_sse16_avx2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
+                  ptrdiff_t stride, int h);
 int ff_hf_noise8_mmx(const uint8_t *pix1, ptrdiff_t stride, int h);
 int ff_hf_noise16_mmx(const uint8_t *pix1, ptrdiff_t stride, int h);
 int ff_sad8_mmxext(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
@@ -46,6 +50,10 @@ int ff_sad16_mmxext(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
                     ptrdiff_t stride, int h);
 int ff_sad16_sse2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
                   ptrdiff_t stride, int h);
+int ff_sad8_avx2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
+                 ptrdiff_t stride, int h);
+int ff_sad16_avx2(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
+                  ptrdiff_t stride, int h);
 int ff_sad8_x2_mmxext(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
                       ptrdiff_t stride, int h);
 int ff_sad16_x2_mmxext(MpegEncContext *v, const uint8_t *pix1, const uint8_t *pix2,
@@ -86,6 +94,8 @@ int ff_vsad16_approx_sse2(MpegEncContext *v, const uint8_t *pix1, const uint8_t
 hadamard_func(mmxext)
 hadamard_func(sse2)
 hadamard_func(ssse3)
+int ff_hadamard8_diff16_avx2(MpegEncContext *s, const uint8_t *src1,
+                             const uint8_t *src2, ptrdiff_t stride, int h);
 
 #if HAVE_X86ASM
 static int nsse16_mmx(MpegEncContext *c, const uint8_t *pix1, const uint8_t *pix2,
@@ -307,4 +317,17 @@ av_cold void ff_me_cmp_init_x86(MECmpContext *c, AVCodecContext *avctx)
         c->hadamard8_diff[1] = ff_hadamard8_diff_ssse3;
 #endif
     }
+
+#if ARCH_X86_64
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        c->sse[0]            = ff_sse16_avx2;
+        c->sse[1]            = ff_sse8_avx2;
+        c->hadamard8_diff[0] = ff_hadamard8_diff16_avx2;
+
+        c->sad[0]        = ff_sad16_avx2;
+        c->sad[1]        = ff_sad8_avx2;
+        c->pix_abs[0][0] = ff_sad16_avx2;
+        c->pix_abs[1][0] = ff_sad8_avx2;
+    }
+#endif
 }
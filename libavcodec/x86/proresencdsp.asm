@@ -0,0 +1,85 @@
+;******************************************************************************
+;* SIMD-optimized ProRes encoder functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+ac_mask: dd 0, -1, -1, -1, -1, -1, -1, -1
+
+SECTION .text
+
+; Quantise 8 coefficients: %1 = byte offset in the block, %2 = dst for the
+; signed levels as dwords; adds the remainders to m9.
+; For |blocks| <= 2^15 and qmat <= 2^14 the single precision quotient never
+; rounds up to the next integer, so the truncation gives the exact result.
+%macro QUANT8 2
+    pmovsxwd     m0, [blocksq + %1]
+    pmovsxwd     m1, [qmatq + %1]
+    pabsd        m2, m0
+    cvtdq2ps     m3, m2
+    cvtdq2ps     m4, m1
+    divps        m3, m4
+    cvttps2dq    %2, m3
+    pmulld       m1, %2
+    psubd        m2, m1
+%if %1 == 0
+    pand         m2, m8
+%endif
+    paddd        m9, m2
+    psignd       %2, m0
+%endmacro
+
+%macro QUANT16 1
+    QUANT8 %1,      m5
+    QUANT8 %1 + 16, m6
+    packssdw     m5, m6
+    vpermq       m5, m5, q3120
+    movu [levelsq + %1], m5
+%endmacro
+
+;***********************************************************************
+; int ff_prores_quantize_avx2(int16_t *levels, const int16_t *blocks,
+;                             const int16_t *qmat, int nb_blocks)
+;***********************************************************************
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+cglobal prores_quantize, 4, 4, 10, levels, blocks, qmat, nb_blocks
+    mova         m8, [ac_mask]
+    pxor         m9, m9
+.loop:
+    QUANT16       0
+    QUANT16      32
+    QUANT16      64
+    QUANT16      96
+    add     levelsq, 128
+    add     blocksq, 128
+    dec   nb_blocksd
+    jg .loop
+
+    vextracti128 xm0, m9, 1
+    paddd       xm0, xm9
+    pshufd      xm1, xm0, q1032
+    paddd       xm0, xm1
+    pshufd      xm1, xm0, q2301
+    paddd       xm0, xm1
+    movd        eax, xm0
+    RET
+%endif
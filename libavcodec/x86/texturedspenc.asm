@@ -0,0 +1,352 @@
+;******************************************************************************
+;* SIMD-optimized texture block compression
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pb_cov_g:      times 2 db 2, 3, -1, -1, 2, 3, -1, -1, 10, 11, -1, -1, 10, 11, -1, -1
+pb_cov_b:      times 2 db 4, 5, -1, -1, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1
+pw_565_mul:    times 2 dw 31, 63, 31, 0
+pw_565_pack:   times 2 dw 2048, 32, 1, 0
+pw_565_exp_hi: times 2 dw 8, 4, 8, 0
+pw_565_exp_lo: times 2 dw 64, 16, 64, 0
+pw_div3:       times 8 dw 0xAAAB
+pw_7:          times 16 dw 7
+pw_128:        times 8 dw 128
+pw_pack2:      times 8 dw 1, 4
+pw_pack3:      times 8 dw 1, 8
+pd_pack2:      times 2 dd 1, 16, 256, 4096
+pd_pack3:      times 2 dd 1, 64, 4096, 262144
+
+; Channels whose endpoints are swapped, indexed by the reference (widest)
+; channel and the signs of the rg, bg and rb covariances.
+swap_lut:      dd 0, 0x00FF00, 0, 0x00FF00, 0xFF0000, 0xFFFF00, 0xFF0000, 0xFFFF00
+               dd 0, 0x0000FF, 0xFF0000, 0xFF00FF, 0, 0x0000FF, 0xFF0000, 0xFF00FF
+               dd 0, 0, 0x00FF00, 0x00FF00, 0x0000FF, 0x0000FF, 0x00FFFF, 0x00FFFF
+
+cextern pb_1
+cextern pb_15
+cextern pw_1
+cextern pw_2
+cextern pw_4
+cextern pw_m1
+
+SECTION .text
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+
+; Load the 4x4 RGBA block: m0 = rows 0 and 2, m1 = rows 1 and 3, so that
+; horizontal adds of the two leave the pixels in raster order.
+%macro LOAD_BLOCK 0
+    lea            r3, [strideq*3]
+    movu          xm0, [blockq]
+    movu          xm1, [blockq + strideq]
+    vinserti128    m0, m0, [blockq + strideq*2], 1
+    vinserti128    m1, m1, [blockq + r3], 1
+%endmacro
+
+; Convert the pixels in the low half of xm3 to rgb565: the 5/6-bit
+; components are left as words in xm4 and the packed values as dwords in xm5.
+%macro RGB565 0
+    pmovzxbw      xm4, xm3
+    pmullw        xm4, [pw_565_mul]
+    paddw         xm4, [pw_128]
+    psrlw         xm5, xm4, 8
+    paddw         xm4, xm5
+    psrlw         xm4, 8
+    pmaddwd       xm5, xm4, [pw_565_pack]
+    phaddd        xm5, xm5
+%endmacro
+
+; Accumulate the covariances of the centered row in m%1, see COMPRESS_COLOR_FAST
+%macro COV_ROW 1
+    psubw         m%1, m5
+    pshufb        m14, m%1, m12
+    pshufb        m15, m%1, m13
+    pmaddwd       m14, m%1
+    pmaddwd       m15, m%1
+    paddd         m10, m14
+    paddd         m11, m15
+%endmacro
+
+; L1 distance of the 16 pixels to palette entry %2 of m4, as words in m%1
+%macro PALETTE_DIST 2
+    pshufd        m12, m4, %2
+    pmaxub        m10, m0, m12
+    pminub        m11, m0, m12
+    psubb         m10, m11
+    pmaxub        m11, m1, m12
+    pminub        m12, m1
+    psubb         m11, m12
+    pmaddubsw     m10, m13
+    pmaddubsw     m11, m13
+    phaddw        m%1, m10, m11
+%endmacro
+
+; Bounding box color compression, bitexact with compress_color_fast();
+; writes 8 bytes at dstq + %1.
+%macro COMPRESS_COLOR_FAST 1
+    pminub         m2, m0, m1
+    pmaxub         m3, m0, m1
+    vextracti128  xm4, m2, 1
+    vextracti128  xm5, m3, 1
+    pminub        xm2, xm4
+    pmaxub        xm3, xm5
+    pshufd        xm4, xm2, q1032
+    pshufd        xm5, xm3, q1032
+    pminub        xm2, xm4
+    pmaxub        xm3, xm5
+    pshufd        xm4, xm2, q2301
+    pshufd        xm5, xm3, q2301
+    pminub        xm2, xm4
+    pmaxub        xm3, xm5
+    psubb         xm4, xm3, xm2
+    movd          r3d, xm4
+    test          r3d, 0xFFFFFF
+    jz .flat
+
+    ; rg, bg and rb covariances around the box center
+    pavgb         xm5, xm2, xm3
+    pmovzxbw       m5, xm5
+    mova          m12, [pb_cov_g]
+    mova          m13, [pb_cov_b]
+    pxor          m10, m10
+    pxor          m11, m11
+    pmovzxbw       m6, xm0
+    vextracti128  xm7, m0, 1
+    pmovzxbw       m7, xm7
+    pmovzxbw       m8, xm1
+    vextracti128  xm9, m1, 1
+    pmovzxbw       m9, xm9
+    COV_ROW        6
+    COV_ROW        7
+    COV_ROW        8
+    COV_ROW        9
+    punpcklqdq    m14, m10, m11
+    punpckhqdq    m10, m11
+    paddd         m10, m14
+    vextracti128  xm11, m10, 1
+    paddd         xm10, xm11
+
+    ; reference channel (widest extent, green first, then red), times 32
+    movzx         r4d, r3b
+    shr           r3d, 8
+    movzx         r5d, r3b
+    shr           r3d, 8
+    movzx         r3d, r3b
+    xor           r6d, r6d
+    mov           r7d, 64
+    cmp           r4d, r3d
+    cmovb         r6d, r7d
+    mov           r7d, 32
+    cmp           r5d, r4d
+    cmovb         r7d, r6d
+    cmp           r5d, r3d
+    cmovb         r7d, r6d
+    movmskps      r6d, xm10
+    lea            r4, [swap_lut]
+    add            r4, r7
+    vpbroadcastd  xm6, [r4 + r6*4]
+
+    ; inset the box by 1/16 of its extent, then pick the diagonal
+    psrlw         xm4, 4
+    pand          xm4, [pb_15]
+    paddb         xm2, xm4
+    psubb         xm3, xm4
+    pxor          xm7, xm2, xm3
+    pand          xm7, xm6
+    pxor          xm2, xm7
+    pxor          xm3, xm7
+
+    ; endpoints as rgb565, max first
+    punpckldq     xm3, xm2
+    RGB565
+    packusdw      xm5, xm5
+    movd          r3d, xm5
+
+    ; expanded palette
+    pmullw        xm5, xm4, [pw_565_exp_hi]
+    pmullw        xm4, [pw_565_exp_lo]
+    psrlw         xm4, 8
+    por           xm4, xm5
+    pshufd        xm5, xm4, q1032
+    paddw         xm5, xm4
+    paddw         xm5, xm4
+    pmulhuw       xm5, [pw_div3]
+    psrlw         xm5, 1
+    packuswb      xm4, xm5
+    vinserti128    m4, m4, xm4, 1
+
+    mova          m13, [pb_1]
+    PALETTE_DIST   6, q0000
+    PALETTE_DIST   7, q1111
+    PALETTE_DIST   8, q2222
+    PALETTE_DIST   9, q3333
+
+    ; closest entry in DXT index order
+    pcmpgtw       m10, m6, m9
+    pcmpgtw       m11, m7, m8
+    pcmpgtw       m12, m6, m8
+    pcmpgtw        m7, m9
+    pcmpgtw        m8, m9
+    pand          m11, m12
+    pand           m7, m10
+    pand           m8, m10
+    por            m7, m11
+    pand           m7, [pw_2]
+    pand           m8, [pw_1]
+    por            m7, m8
+
+    ; pack the 2-bit indices
+    pmaddwd        m7, [pw_pack2]
+    pmulld         m7, [pd_pack2]
+    phaddd         m7, m7
+    phaddd         m7, m7
+    vextracti128  xm8, m7, 1
+    pslld         xm8, 16
+    por           xm7, xm8
+    movd          r4d, xm7
+
+    ; keep the 4-color mode
+    movzx         r5d, r3w
+    mov           r6d, r3d
+    shr           r6d, 16
+    cmp           r5d, r6d
+    jae .ordered
+    rol           r3d, 16
+    xor           r4d, 0x55555555
+.ordered:
+    mov [dstq + %1],     r3d
+    mov [dstq + %1 + 4], r4d
+    jmp .done
+
+.flat:
+    RGB565
+    movd          r3d, xm5
+    imul          r3d, 0x10001
+    mov [dstq + %1],     r3d
+    mov dword [dstq + %1 + 4], 0
+.done:
+%endmacro
+
+; Alpha compression, bitexact with compress_alpha(); writes 8 bytes at dstq.
+%macro COMPRESS_ALPHA 0
+    psrld          m2, m0, 24
+    psrld          m3, m1, 24
+    packusdw       m2, m3
+    vextracti128  xm3, m2, 1
+    pminuw        xm4, xm2, xm3
+    pmaxuw        xm5, xm2, xm3
+    pxor          xm5, [pw_m1]
+    phminposuw    xm4, xm4
+    phminposuw    xm5, xm5
+    movd          r3d, xm4
+    movd          r4d, xm5
+    not           r4d
+    movzx         r3d, r3w
+    movzx         r4d, r4w
+    mov      [dstq+0], r4b
+    mov      [dstq+1], r3b
+    sub           r4d, r3d
+    jz .mono
+
+    ; bias, see compress_alpha()
+    lea           r6d, [r4 - 1]
+    mov           r5d, r4d
+    shr           r5d, 1
+    add           r5d, 2
+    cmp           r4d, 8
+    cmovl         r5d, r6d
+    imul          r3d, 7
+    sub           r5d, r3d
+    movd          xm6, r5d
+    movd          xm7, r4d
+    vpbroadcastw   m6, xm6
+    vpbroadcastw   m7, xm7
+    paddw          m8, m7, m7
+    paddw          m9, m8, m8
+
+    pmullw         m2, [pw_7]
+    paddw          m2, m6
+    pcmpgtw       m10, m9, m2
+    pandn         m11, m10, m9
+    pandn          m3, m10, [pw_4]
+    psubw          m2, m11
+    pcmpgtw       m10, m8, m2
+    pandn         m11, m10, m8
+    pandn         m10, [pw_2]
+    psubw          m2, m11
+    paddw          m3, m10
+    pcmpgtw       m10, m7, m2
+    pandn         m10, [pw_1]
+    paddw          m3, m10
+
+    ; linear scale to DXT index: -ind & 7, then swap 0 and 1
+    pxor          m10, m10
+    psubw          m3, m10, m3
+    pand           m3, [pw_7]
+    mova          m11, [pw_2]
+    pcmpgtw       m10, m11, m3
+    pand          m10, [pw_1]
+    pxor           m3, m10
+
+    ; pack the 3-bit indices, 24 bits per lane
+    pmaddwd        m3, [pw_pack3]
+    pmulld         m3, [pd_pack3]
+    phaddd         m3, m3
+    phaddd         m3, m3
+    vextracti128  xm4, m3, 1
+    movd          r3d, xm3
+    movd          r4d, xm4
+    shl            r4, 24
+    or             r3, r4
+    mov    [dstq + 2], r3d
+    shr            r3, 32
+    mov    [dstq + 6], r3w
+    jmp .color
+
+.mono:
+    mov dword [dstq + 2], 0
+    mov  word [dstq + 6], 0
+.color:
+%endmacro
+
+INIT_YMM avx2
+;-----------------------------------------------------------------------------
+; int ff_dxt1_block_fast(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+;-----------------------------------------------------------------------------
+cglobal dxt1_block_fast, 3, 8, 16, dst, stride, block
+    LOAD_BLOCK
+    COMPRESS_COLOR_FAST 0
+    mov           eax, 8
+    RET
+
+;-----------------------------------------------------------------------------
+; int ff_dxt5_block_fast(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+;-----------------------------------------------------------------------------
+cglobal dxt5_block_fast, 3, 8, 16, dst, stride, block
+    LOAD_BLOCK
+    COMPRESS_ALPHA
+    COMPRESS_COLOR_FAST 8
+    mov           eax, 16
+    RET
+
+%endif
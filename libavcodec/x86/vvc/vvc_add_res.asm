@@ -0,0 +1,155 @@
+; /*
+; * Provide SIMD residual functions for VVC decoding
+; *
+; * This file is part of FFmpeg.
+; *
+; * FFmpeg is free software; you can redistribute it and/or
+; * modify it under the terms of the GNU Lesser General Public
+; * License as published by the Free Software Foundation; either
+; * version 2.1 of the License, or (at your option) any later version.
+; *
+; * FFmpeg is distributed in the hope that it will be useful,
+; * but WITHOUT ANY WARRANTY; without even the implied warranty of
+; * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+; * Lesser General Public License for more details.
+; *
+; * You should have received a copy of the GNU Lesser General Public
+; * License along with FFmpeg; if not, write to the Free Software
+; * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+; */
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+%if ARCH_X86_64
+
+%if HAVE_AVX2_EXTERNAL
+
+; m3: pixel max, m4: c_sign, xm5: shift (joint only)
+%macro ADD_RES_JOINT 3 ; reg prefix, reg, joint
+%if %3
+    psignd          %1%+%2, %1%+4
+    psrad           %1%+%2, xm5
+%endif
+%endmacro
+
+; add 8 (m) or 4 (xm) residuals to the pixels at [dstq + xq]
+%macro ADD_RES_N 4 ; bpc, joint, reg prefix, residual count
+%if %1 == 8
+    pmovzxbd          %3%+0, [dstq + xq]
+%else
+    pmovzxwd          %3%+0, [dstq + xq * 2]
+%endif
+    movu              %3%+1, [resq]
+    ADD_RES_JOINT        %3, 1, %2
+    paddd             %3%+0, %3%+1
+%if %4 == 8
+    vextracti128        xm1, m0, 1
+%else
+    pxor                xm1, xm1
+%endif
+%if %1 == 8
+    packssdw            xm0, xm1
+    packuswb            xm0, xm0
+%if %4 == 8
+    movq        [dstq + xq], xm0
+%else
+    movd        [dstq + xq], xm0
+%endif
+%else
+    packusdw            xm0, xm1
+    pminuw              xm0, xm3
+%if %4 == 8
+    movu    [dstq + xq * 2], xm0
+%else
+    movq    [dstq + xq * 2], xm0
+%endif
+%endif
+    add                resq, %4 * 4
+%endmacro
+
+; the residuals are contiguous, width is 2, 4 or a multiple of 8
+%macro ADD_RES_FN 2 ; bpc, joint
+    cmp                  wd, 4
+    jl .w2
+    je .w4
+.w8_loop_y:
+    xor                  xd, xd
+.w8_loop_x:
+    ADD_RES_N            %1, %2, m, 8
+    add                  xd, 8
+    cmp                  xd, wd
+    jl .w8_loop_x
+    add                dstq, strideq
+    dec                  hd
+    jg .w8_loop_y
+    RET
+
+.w4:
+    xor                  xd, xd
+.w4_loop:
+    ADD_RES_N            %1, %2, xm, 4
+    add                dstq, strideq
+    dec                  hd
+    jg .w4_loop
+    RET
+
+.w2:
+    xor                  xd, xd
+.w2_loop:
+%if %1 == 8
+    pmovzxbd            xm0, [dstq]
+%else
+    pmovzxwd            xm0, [dstq]
+%endif
+    movq                xm1, [resq]
+    ADD_RES_JOINT        xm, 1, %2
+    paddd               xm0, xm1
+%if %1 == 8
+    packssdw            xm0, xm0
+    packuswb            xm0, xm0
+    pextrw           [dstq], xm0, 0
+%else
+    packusdw            xm0, xm0
+    pminuw              xm0, xm3
+    movd             [dstq], xm0
+%endif
+    add                resq, 2 * 4
+    add                dstq, strideq
+    dec                  hd
+    jg .w2_loop
+    RET
+%endmacro
+
+;void ff_vvc_add_residual_%1bpc_avx2(uint8_t *dst, const int *res, intptr_t width, intptr_t height,
+;    ptrdiff_t stride, intptr_t pixel_max);
+%macro VVC_ADD_RESIDUAL_AVX2 1 ; bpc
+cglobal vvc_add_residual_%1bpc, 5, 7, 4, dst, res, w, h, stride, max, x
+%if %1 == 16
+    movd                xm3, maxm
+    vpbroadcastw         m3, xm3
+%endif
+    ADD_RES_FN           %1, 0
+
+;void ff_vvc_add_residual_joint_%1bpc_avx2(uint8_t *dst, const int *res, intptr_t width, intptr_t height,
+;    ptrdiff_t stride, intptr_t c_sign, intptr_t shift, intptr_t pixel_max);
+cglobal vvc_add_residual_joint_%1bpc, 5, 9, 6, dst, res, w, h, stride, sign, shift, max, x
+%if %1 == 16
+    movd                xm3, maxm
+    vpbroadcastw         m3, xm3
+%endif
+    movd                xm4, signm
+    vpbroadcastd         m4, xm4
+    movd                xm5, shiftm
+    ADD_RES_FN           %1, 1
+%endmacro
+
+INIT_YMM avx2
+
+VVC_ADD_RESIDUAL_AVX2 8
+VVC_ADD_RESIDUAL_AVX2 16
+
+%endif
+
+%endif
@@ -0,0 +1,247 @@
+; /*
+; * Provide SIMD DMVR functions for VVC decoding
+; *
+; * This file is part of FFmpeg.
+; *
+; * FFmpeg is free software; you can redistribute it and/or
+; * modify it under the terms of the GNU Lesser General Public
+; * License as published by the Free Software Foundation; either
+; * version 2.1 of the License, or (at your option) any later version.
+; *
+; * FFmpeg is distributed in the hope that it will be useful,
+; * but WITHOUT ANY WARRANTY; without even the implied warranty of
+; * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+; * Lesser General Public License for more details.
+; *
+; * You should have received a copy of the GNU Lesser General Public
+; * License along with FFmpeg; if not, write to the Free Software
+; * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+; */
+
+%include "libavutil/x86/x86util.asm"
+
+%define MAX_PB_SIZE 128
+
+SECTION_RODATA 32
+
+cextern pw_1
+
+SECTION .text
+
+%if ARCH_X86_64
+
+%if HAVE_AVX2_EXTERNAL
+
+; all dmvr functions work on 16 samples per iteration, which may read up to
+; 15 samples beyond width from src and write them to dst (the dst stride is
+; MAX_PB_SIZE samples, so this stays within the row)
+
+%macro DMVR_LOAD 3 ; dst, src, bpc
+%if %3 == 8
+    pmovzxbw             %1, [%2]
+%else
+    movu                 %1, [%2]
+%endif
+%endmacro
+
+; (f0 * a + f1 * b + (1 << (shift - 1))) >> shift with f0 + f1 == 16.
+; The sum fits in an unsigned word for all supported bit depths, so round
+; with pavgw against zero instead of adding the offset, which could wrap.
+%macro DMVR_FILTER 5 ; a, b, f0, f1, shift
+    pmullw               %1, %3
+    pmullw               %2, %4
+    paddw                %1, %2
+%if %5 > 1
+    psrlw                %1, %5 - 1
+%endif
+    pavgw                %1, m5
+%endmacro
+
+%macro DMVR_FILTER_COEFFS 3 ; f0, f1, frac
+    movd                xm%2, %3d
+    vpbroadcastw         m%2, xm%2
+    vpbroadcastd         m%1, [pw_1]
+    psllw                m%1, 4
+    psubw                m%1, m%2
+%endmacro
+
+;void ff_vvc_dmvr_%1_avx2(int16_t *dst, const uint8_t *src, ptrdiff_t src_stride,
+;    int height, intptr_t mx, intptr_t my, int width);
+%macro VVC_DMVR_AVX2 1 ; bit depth
+%assign pixsz (%1 + 7) / 8
+%if %1 == 8
+    %define bpc 8
+%else
+    %define bpc 16
+%endif
+
+cglobal vvc_dmvr_%1, 4, 8, 2, dst, src, src_stride, h, mx, my, w, x
+    movifnidn            wd, wm
+    pxor                 m1, m1
+.loop_y:
+    xor                  xd, xd
+.loop_x:
+    DMVR_LOAD            m0, srcq + xq * pixsz, bpc
+%if %1 < 10
+    psllw                m0, 10 - %1
+%elif %1 > 10
+    psrlw                m0, %1 - 11
+    pavgw                m0, m1
+%endif
+    movu      [dstq + xq * 2], m0
+    add                  xd, 16
+    cmp                  xd, wd
+    jl .loop_x
+
+    add                srcq, src_strideq
+    add                dstq, 2 * MAX_PB_SIZE
+    dec                  hd
+    jg .loop_y
+    RET
+
+cglobal vvc_dmvr_h_%1, 5, 8, 6, dst, src, src_stride, h, mx, my, w, x
+    movifnidn            wd, wm
+    DMVR_FILTER_COEFFS    3, 4, mx
+    pxor                 m5, m5
+.loop_y:
+    xor                  xd, xd
+.loop_x:
+    DMVR_LOAD            m0, srcq + xq * pixsz, bpc
+    DMVR_LOAD            m1, srcq + xq * pixsz + pixsz, bpc
+    DMVR_FILTER          m0, m1, m3, m4, %1 - 6
+    movu      [dstq + xq * 2], m0
+    add                  xd, 16
+    cmp                  xd, wd
+    jl .loop_x
+
+    add                srcq, src_strideq
+    add                dstq, 2 * MAX_PB_SIZE
+    dec                  hd
+    jg .loop_y
+    RET
+
+cglobal vvc_dmvr_v_%1, 6, 8, 6, dst, src, src_stride, h, mx, my, w, x
+    movifnidn            wd, wm
+    DMVR_FILTER_COEFFS    3, 4, my
+    pxor                 m5, m5
+.loop_y:
+    xor                  xd, xd
+.loop_x:
+    DMVR_LOAD            m0, srcq + xq * pixsz, bpc
+    lea                 mxq, [srcq + src_strideq]
+    DMVR_LOAD            m1, mxq + xq * pixsz, bpc
+    DMVR_FILTER          m0, m1, m3, m4, %1 - 6
+    movu      [dstq + xq * 2], m0
+    add                  xd, 16
+    cmp                  xd, wd
+    jl .loop_x
+
+    add                srcq, src_strideq
+    add                dstq, 2 * MAX_PB_SIZE
+    dec                  hd
+    jg .loop_y
+    RET
+
+; the first pass keeps the previous row in m0, so the columns are walked in
+; the outer loop and no intermediate buffer is needed
+cglobal vvc_dmvr_hv_%1, 6, 10, 10, dst, src, src_stride, h, mx, my, w, x, tsrc, tdst
+    movifnidn            wd, wm
+    DMVR_FILTER_COEFFS    3, 4, mx
+    DMVR_FILTER_COEFFS    6, 7, my
+    pxor                 m5, m5
+    xor                  xd, xd
+.loop_x:
+    lea               tsrcq, [srcq + xq * pixsz]
+    lea               tdstq, [dstq + xq * 2]
+    mov                 myd, hd
+
+    DMVR_LOAD            m0, tsrcq, bpc
+    DMVR_LOAD            m1, tsrcq + pixsz, bpc
+    DMVR_FILTER          m0, m1, m3, m4, %1 - 6
+.loop_y:
+    add               tsrcq, src_strideq
+    DMVR_LOAD            m1, tsrcq, bpc
+    DMVR_LOAD            m2, tsrcq + pixsz, bpc
+    DMVR_FILTER          m1, m2, m3, m4, %1 - 6
+
+    pmullw               m8, m0, m6
+    pmullw               m9, m1, m7
+    paddw                m8, m9
+    psrlw                m8, 3
+    pavgw                m8, m5
+    movu            [tdstq], m8
+    mova                 m0, m1
+
+    add               tdstq, 2 * MAX_PB_SIZE
+    dec                 myd
+    jg .loop_y
+
+    add                  xd, 16
+    cmp                  xd, wd
+    jl .loop_x
+    RET
+%endmacro
+
+INIT_YMM avx2
+
+;int ff_vvc_sad_avx2(const int16_t *src0, const int16_t *src1, int dx, int dy,
+;    int block_w, int block_h);
+; block_w is 8 or 16, block_h is a multiple of 4
+cglobal vvc_sad, 6, 7, 5, src0, src1, dx, dy, w, h, off
+    movsxdifnidn        dxq, dxd
+    movsxdifnidn        dyq, dyd
+    imul               offq, dyq, MAX_PB_SIZE
+    add                offq, dxq
+    lea               src0q, [src0q + offq * 2]
+    neg                offq
+    lea               src1q, [src1q + offq * 2 + (4 * MAX_PB_SIZE + 4) * 2]
+
+    pxor                 m0, m0
+    vpbroadcastd         m4, [pw_1]
+    cmp                  wd, 16
+    je .w16
+
+.w8:
+    movu                xm1, [src0q]
+    vinserti128          m1, m1, [src0q + 4 * MAX_PB_SIZE], 1
+    movu                xm2, [src1q]
+    vinserti128          m2, m2, [src1q + 4 * MAX_PB_SIZE], 1
+    psubw                m1, m2
+    pabsw                m1, m1
+    pmaddwd              m1, m4
+    paddd                m0, m1
+    add               src0q, 8 * MAX_PB_SIZE
+    add               src1q, 8 * MAX_PB_SIZE
+    sub                  hd, 4
+    jg .w8
+    jmp .end
+
+.w16:
+    movu                 m1, [src0q]
+    movu                 m2, [src1q]
+    psubw                m1, m2
+    pabsw                m1, m1
+    pmaddwd              m1, m4
+    paddd                m0, m1
+    add               src0q, 4 * MAX_PB_SIZE
+    add               src1q, 4 * MAX_PB_SIZE
+    sub                  hd, 2
+    jg .w16
+
+.end:
+    vextracti128        xm1, m0, 1
+    paddd               xm0, xm1
+    pshufd              xm1, xm0, q1032
+    paddd               xm0, xm1
+    pshufd              xm1, xm0, q2301
+    paddd               xm0, xm1
+    movd                eax, xm0
+    RET
+
+VVC_DMVR_AVX2 8
+VVC_DMVR_AVX2 10
+VVC_DMVR_AVX2 12
+
+%endif
+
+%endif
@@ -0,0 +1,100 @@
+; /*
+; * Provide SIMD LMCS functions for VVC decoding
+; *
+; * This file is part of FFmpeg.
+; *
+; * FFmpeg is free software; you can redistribute it and/or
+; * modify it under the terms of the GNU Lesser General Public
+; * License as published by the Free Software Foundation; either
+; * version 2.1 of the License, or (at your option) any later version.
+; *
+; * FFmpeg is distributed in the hope that it will be useful,
+; * but WITHOUT ANY WARRANTY; without even the implied warranty of
+; * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+; * Lesser General Public License for more details.
+; *
+; * You should have received a copy of the GNU Lesser General Public
+; * License along with FFmpeg; if not, write to the Free Software
+; * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+; */
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+%if ARCH_X86_64
+
+%if HAVE_AVX2_EXTERNAL
+
+; look up 8 (m) or 4 (xm) pixels at [dstq + xq]. The gathers read a dword
+; at each table entry; the lut is followed by other members of VVCLMCS,
+; so the bytes past its last entry are always readable.
+%macro LMCS_N 3 ; bpc, reg prefix, pixel count
+%assign %%scale %1 / 8
+%if %1 == 8
+    pmovzxbd          %2%+0, [dstq + xq]
+%else
+    pmovzxwd          %2%+0, [dstq + xq * 2]
+%endif
+    pcmpeqd           %2%+2, %2%+2
+    vpgatherdd        %2%+1, [lutq + %2%+0 * %%scale], %2%+2
+    pand              %2%+1, %2%+3
+%if %3 == 8
+    vextracti128        xm0, m1, 1
+%else
+    pxor                xm0, xm0
+%endif
+    packusdw            xm1, xm0
+%if %1 == 8
+    packuswb            xm1, xm1
+%if %3 == 8
+    movq        [dstq + xq], xm1
+%else
+    movd        [dstq + xq], xm1
+%endif
+%else
+%if %3 == 8
+    movu    [dstq + xq * 2], xm1
+%else
+    movq    [dstq + xq * 2], xm1
+%endif
+%endif
+%endmacro
+
+;void ff_vvc_lmcs_filter_%1bpc_avx2(uint8_t *dst, ptrdiff_t dst_stride, int width, int height,
+;    const void *lut);
+; width is a multiple of 4
+%macro VVC_LMCS_FILTER_AVX2 1 ; bpc
+cglobal vvc_lmcs_filter_%1bpc, 5, 7, 4, dst, stride, w, h, lut, w8, x
+    pcmpeqd              m3, m3
+    psrld                m3, 32 - %1            ; entry mask
+    mov                w8d, wd
+    and                w8d, ~7
+.loop_y:
+    xor                  xd, xd
+    cmp                  xd, w8d
+    jge .w4
+.loop_x:
+    LMCS_N               %1, m, 8
+    add                  xd, 8
+    cmp                  xd, w8d
+    jl .loop_x
+.w4:
+    cmp                  xd, wd
+    jge .next
+    LMCS_N               %1, xm, 4
+.next:
+    add                dstq, strideq
+    dec                  hd
+    jg .loop_y
+    RET
+%endmacro
+
+INIT_YMM avx2
+
+VVC_LMCS_FILTER_AVX2 8
+VVC_LMCS_FILTER_AVX2 16
+
+%endif
+
+%endif
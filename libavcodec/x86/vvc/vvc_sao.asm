@@ -0,0 +1,62 @@
+; /*
+; * Provide SIMD SAO functions for VVC 10/12bit decoding
+; *
+; * This file is part of FFmpeg.
+; *
+; * FFmpeg is free software; you can redistribute it and/or
+; * modify it under the terms of the GNU Lesser General Public
+; * License as published by the Free Software Foundation; either
+; * version 2.1 of the License, or (at your option) any later version.
+; *
+; * FFmpeg is distributed in the hope that it will be useful,
+; * but WITHOUT ANY WARRANTY; without even the implied warranty of
+; * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+; * Lesser General Public License for more details.
+; *
+; * You should have received a copy of the GNU Lesser General Public
+; * License along with FFmpeg; if not, write to the Free Software
+; * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+; */
+
+%define MAX_PB_SIZE 128
+%include "libavcodec/x86/h26x/h2656_sao_10bit.asm"
+
+%if ARCH_X86_64
+%if HAVE_AVX2_EXTERNAL
+
+; block widths 8..128 match the entries of VVCSAODSPContext
+%macro VVC_SAO_BAND_FILTERS 1 ; depth
+INIT_XMM avx2
+H2656_SAO_BAND_FILTER vvc, %1,   8, 1
+INIT_YMM avx2
+H2656_SAO_BAND_FILTER vvc, %1,  16, 1
+H2656_SAO_BAND_FILTER vvc, %1,  32, 2
+H2656_SAO_BAND_FILTER vvc, %1,  48, 3
+H2656_SAO_BAND_FILTER vvc, %1,  64, 4
+H2656_SAO_BAND_FILTER vvc, %1,  80, 5
+H2656_SAO_BAND_FILTER vvc, %1,  96, 6
+H2656_SAO_BAND_FILTER vvc, %1, 112, 7
+H2656_SAO_BAND_FILTER vvc, %1, 128, 8
+%endmacro
+
+%macro VVC_SAO_EDGE_FILTERS 1 ; depth
+INIT_XMM avx2
+H2656_SAO_EDGE_FILTER vvc, %1,   8, 1
+INIT_YMM avx2
+H2656_SAO_EDGE_FILTER vvc, %1,  16, 1
+H2656_SAO_EDGE_FILTER vvc, %1,  32, 2
+H2656_SAO_EDGE_FILTER vvc, %1,  48, 3
+H2656_SAO_EDGE_FILTER vvc, %1,  64, 4
+H2656_SAO_EDGE_FILTER vvc, %1,  80, 5
+H2656_SAO_EDGE_FILTER vvc, %1,  96, 6
+H2656_SAO_EDGE_FILTER vvc, %1, 112, 7
+H2656_SAO_EDGE_FILTER vvc, %1, 128, 8
+%endmacro
+
+VVC_SAO_BAND_FILTERS 10
+VVC_SAO_BAND_FILTERS 12
+VVC_SAO_EDGE_FILTERS 10
+VVC_SAO_EDGE_FILTERS 12
+
+%endif
+%endif
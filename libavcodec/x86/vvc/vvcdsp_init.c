@@ -114,6 +114,70 @@ ALF_PROTOTYPES(8,  8,  avx2)
 ALF_PROTOTYPES(16, 10, avx2)
 ALF_PROTOTYPES(16, 12, avx2)
 
+#define DMVR_PROTOTYPE(name, bd, opt)                                                                \
+void bf(ff_vvc_##name, bd, opt)(int16_t *dst, const uint8_t *src, ptrdiff_t src_stride,              \
+    int height, intptr_t mx, intptr_t my, int width);
+
+#define DMVR_PROTOTYPES(bd, opt)                                                                     \
+    DMVR_PROTOTYPE(dmvr,    bd, opt)                                                                 \
+    DMVR_PROTOTYPE(dmvr_h,  bd, opt)                                                                 \
+    DMVR_PROTOTYPE(dmvr_v,  bd, opt)                                                                 \
+    DMVR_PROTOTYPE(dmvr_hv, bd, opt)
+
+DMVR_PROTOTYPES( 8, avx2)
+DMVR_PROTOTYPES(10, avx2)
+DMVR_PROTOTYPES(12, avx2)
+
+int ff_vvc_sad_avx2(const int16_t *src0, const int16_t *src1, int dx, int dy, int block_w, int block_h);
+
+#define ADD_RES_BPC_PROTOTYPES(bpc, opt)                                                             \
+void BF(ff_vvc_add_residual, bpc, opt)(uint8_t *dst, const int *res,                                 \
+    intptr_t width, intptr_t height, ptrdiff_t stride, intptr_t pixel_max);                          \
+void BF(ff_vvc_add_residual_joint, bpc, opt)(uint8_t *dst, const int *res,                           \
+    intptr_t width, intptr_t height, ptrdiff_t stride, intptr_t c_sign, intptr_t shift,              \
+    intptr_t pixel_max);
+
+#define ADD_RES_PROTOTYPES(bd, opt)                                                                  \
+void bf(ff_vvc_add_residual, bd, opt)(uint8_t *dst, const int *res,                                  \
+    int width, int height, ptrdiff_t stride);                                                        \
+void bf(ff_vvc_add_residual_joint, bd, opt)(uint8_t *dst, const int *res,                            \
+    int width, int height, ptrdiff_t stride, int c_sign, int shift);
+
+ADD_RES_BPC_PROTOTYPES( 8, avx2)
+ADD_RES_BPC_PROTOTYPES(16, avx2)
+
+ADD_RES_PROTOTYPES( 8, avx2)
+ADD_RES_PROTOTYPES(10, avx2)
+ADD_RES_PROTOTYPES(12, avx2)
+
+#define LMCS_BPC_PROTOTYPES(bpc, opt)                                                                \
+void BF(ff_vvc_lmcs_filter, bpc, opt)(uint8_t *dst, ptrdiff_t dst_stride,                            \
+    int width, int height, const void *lut);
+
+LMCS_BPC_PROTOTYPES( 8, avx2)
+LMCS_BPC_PROTOTYPES(16, avx2)
+
+#define SAO_FILTER_PROTOTYPES(w, bd, opt)                                                            \
+void ff_vvc_sao_band_filter_##w##_##bd##_##opt(uint8_t *dst, const uint8_t *src,                      \
+    ptrdiff_t dst_stride, ptrdiff_t src_stride, const int16_t *sao_offset_val,                       \
+    int sao_left_class, int width, int height);                                                      \
+void ff_vvc_sao_edge_filter_##w##_##bd##_##opt(uint8_t *dst, const uint8_t *src,                      \
+    ptrdiff_t stride_dst, const int16_t *sao_offset_val, int eo, int width, int height);
+
+#define SAO_PROTOTYPES(bd, opt)                                                                      \
+    SAO_FILTER_PROTOTYPES(  8, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 16, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 32, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 48, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 64, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 80, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES( 96, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES(112, bd, opt)                                                              \
+    SAO_FILTER_PROTOTYPES(128, bd, opt)
+
+SAO_PROTOTYPES(10, avx2)
+SAO_PROTOTYPES(12, avx2)
+
 #if ARCH_X86_64
 #if HAVE_SSE4_EXTERNAL
 #define FW_PUT(name, depth, opt) \
@@ -234,6 +298,23 @@ ALF_FUNCS(8,  8,  avx2)
 ALF_FUNCS(16, 10, avx2)
 ALF_FUNCS(16, 12, avx2)
 
+#define ADD_RES_FUNCS(bpc, bd, opt)                                                                 \
+void bf(ff_vvc_add_residual, bd, opt)(uint8_t *dst, const int *res,                                 \
+    int width, int height, ptrdiff_t stride)                                                        \
+{                                                                                                   \
+    BF(ff_vvc_add_residual, bpc, opt)(dst, res, width, height, stride, (1 << bd) - 1);              \
+}                                                                                                   \
+void bf(ff_vvc_add_residual_joint, bd, opt)(uint8_t *dst, const int *res,                           \
+    int width, int height, ptrdiff_t stride, int c_sign, int shift)                                 \
+{                                                                                                   \
+    BF(ff_vvc_add_residual_joint, bpc, opt)(dst, res, width, height, stride,                        \
+        c_sign, shift, (1 << bd) - 1);                                                              \
+}
+
+ADD_RES_FUNCS(8,  8,  avx2)
+ADD_RES_FUNCS(16, 10, avx2)
+ADD_RES_FUNCS(16, 12, avx2)
+
 #endif
 
 #define PEL_LINK(dst, C, W, idx1, idx2, name, D, opt)                              \
@@ -311,6 +392,40 @@ ALF_FUNCS(16, 12, avx2)
     c->alf.filter[CHROMA] = ff_vvc_alf_filter_chroma_##bd##_avx2;    \
     c->alf.classify       = ff_vvc_alf_classify_##bd##_avx2;         \
 } while (0)
+
+#define DMVR_INIT(bd) do {                                           \
+    c->inter.dmvr[0][0]   = ff_vvc_dmvr_##bd##_avx2;                 \
+    c->inter.dmvr[0][1]   = ff_vvc_dmvr_h_##bd##_avx2;               \
+    c->inter.dmvr[1][0]   = ff_vvc_dmvr_v_##bd##_avx2;               \
+    c->inter.dmvr[1][1]   = ff_vvc_dmvr_hv_##bd##_avx2;              \
+    c->inter.sad          = ff_vvc_sad_avx2;                         \
+} while (0)
+
+#define ADD_RES_INIT(bd) do {                                        \
+    c->itx.add_residual       = ff_vvc_add_residual_##bd##_avx2;     \
+    c->itx.add_residual_joint = ff_vvc_add_residual_joint_##bd##_avx2; \
+} while (0)
+
+#define LMCS_INIT(bpc) do {                                          \
+    c->lmcs.filter        = ff_vvc_lmcs_filter_##bpc##bpc_avx2;      \
+} while (0)
+
+#define SAO_FILTER_INIT(type, bd, opt) do {                                 \
+    c->sao.type##_filter[0] = ff_vvc_sao_##type##_filter_8_##bd##_##opt;    \
+    c->sao.type##_filter[1] = ff_vvc_sao_##type##_filter_16_##bd##_##opt;   \
+    c->sao.type##_filter[2] = ff_vvc_sao_##type##_filter_32_##bd##_##opt;   \
+    c->sao.type##_filter[3] = ff_vvc_sao_##type##_filter_48_##bd##_##opt;   \
+    c->sao.type##_filter[4] = ff_vvc_sao_##type##_filter_64_##bd##_##opt;   \
+    c->sao.type##_filter[5] = ff_vvc_sao_##type##_filter_80_##bd##_##opt;   \
+    c->sao.type##_filter[6] = ff_vvc_sao_##type##_filter_96_##bd##_##opt;   \
+    c->sao.type##_filter[7] = ff_vvc_sao_##type##_filter_112_##bd##_##opt;  \
+    c->sao.type##_filter[8] = ff_vvc_sao_##type##_filter_128_##bd##_##opt;  \
+} while (0)
+
+#define SAO_INIT(bd, opt) do {                                       \
+    SAO_FILTER_INIT(band, bd, opt);                                  \
+    SAO_FILTER_INIT(edge, bd, opt);                                  \
+} while (0)
 #endif
 
 void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
@@ -326,6 +441,9 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(8);
             AVG_INIT(8, avx2);
+            DMVR_INIT(8);
+            ADD_RES_INIT(8);
+            LMCS_INIT(8);
             MC_LINKS_AVX2(8);
         }
         break;
@@ -336,8 +454,12 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(10);
             AVG_INIT(10, avx2);
+            DMVR_INIT(10);
+            ADD_RES_INIT(10);
+            LMCS_INIT(16);
             MC_LINKS_AVX2(10);
             MC_LINKS_16BPC_AVX2(10);
+            SAO_INIT(10, avx2);
         }
         break;
     case 12:
@@ -347,8 +469,12 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(12);
             AVG_INIT(12, avx2);
+            DMVR_INIT(12);
+            ADD_RES_INIT(12);
+            LMCS_INIT(16);
             MC_LINKS_AVX2(12);
             MC_LINKS_16BPC_AVX2(12);
+            SAO_INIT(12, avx2);
         }
         break;
     default:
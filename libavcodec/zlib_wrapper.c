@@ -22,9 +22,12 @@
 #include <zlib.h>
 
 #include "config.h"
+#include "libavutil/common.h"
 #include "libavutil/error.h"
+#include "libavutil/intreadwrite.h"
 #include "libavutil/log.h"
 #include "libavutil/mem.h"
+#include "avcodec.h"
 #include "zlib_wrapper.h"
 
 static void *alloc_wrapper(void *opaque, uInt items, uInt size)
@@ -99,4 +102,180 @@ void ff_deflate_end(FFZStream *z)
         deflateEnd(&z->zstream);
     }
 }
+
+#define CHUNK_SIZE (128 * 1024)
+#define DICT_SIZE  (32 * 1024)
+/* sync flush marker and partial byte, on top of compressBound() */
+#define CHUNK_OVERHEAD 16
+
+struct FFZParallelChunk {
+    const uint8_t *src;
+    size_t size;
+    uint8_t *dst;
+    size_t dst_len;
+    uLong adler;
+    int ret;
+};
+
+int ff_deflate_parallel_init(FFZParallel *zp, int level, AVCodecContext *avctx)
+{
+    const int nb_streams = avctx->active_thread_type & FF_THREAD_SLICE ?
+                           avctx->thread_count : 1;
+
+    zp->level   = level;
+    zp->streams = av_calloc(nb_streams, sizeof(*zp->streams));
+    if (!zp->streams)
+        return AVERROR(ENOMEM);
+    zp->nb_streams = nb_streams;
+
+    for (int i = 0; i < nb_streams; i++) {
+        z_stream *const zstream = &zp->streams[i].zstream;
+        int zret;
+
+        zstream->zalloc = alloc_wrapper;
+        zstream->zfree  = free_wrapper;
+        zstream->opaque = Z_NULL;
+
+        /* raw deflate, the zlib wrapper is written around the chunks */
+        zret = deflateInit2(zstream, level, Z_DEFLATED, -MAX_WBITS,
+                            8, Z_DEFAULT_STRATEGY);
+        if (zret != Z_OK) {
+            av_log(avctx, AV_LOG_ERROR, "deflateInit2 error %d, message: %s\n",
+                   zret, zstream->msg ? zstream->msg : "");
+            return AVERROR_EXTERNAL;
+        }
+        zp->streams[i].inited = 1;
+    }
+    return 0;
+}
+
+static size_t chunk_bound(size_t size)
+{
+    return compressBound(size) + CHUNK_OVERHEAD;
+}
+
+size_t ff_deflate_parallel_bound(size_t size)
+{
+    const size_t rem = size % CHUNK_SIZE;
+    size_t bound = 2 + 4 + size / CHUNK_SIZE * chunk_bound(CHUNK_SIZE);
+
+    if (rem || !size)
+        bound += chunk_bound(rem);
+    return bound;
+}
+
+static int deflate_chunk(AVCodecContext *avctx, void *arg,
+                         int jobnr, int threadnr)
+{
+    FFZParallel *zp = arg;
+    FFZParallelChunk *c = &zp->chunks[jobnr];
+    z_stream *const zstream = &zp->streams[threadnr].zstream;
+    const int last = jobnr == zp->nb_chunks - 1;
+    int zret;
+
+    c->ret = AVERROR_EXTERNAL;
+    if (deflateReset(zstream) != Z_OK)
+        return c->ret;
+    /* every chunk but the last is CHUNK_SIZE long, so a full window
+     * of preceding input is always available */
+    if (jobnr && deflateSetDictionary(zstream, c->src - DICT_SIZE,
+                                      DICT_SIZE) != Z_OK)
+        return c->ret;
+
+    zstream->next_in   = c->src;
+    zstream->avail_in  = c->size;
+    zstream->next_out  = c->dst;
+    zstream->avail_out = c->dst_len;
+    zret = deflate(zstream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if (last ? zret != Z_STREAM_END :
+               zret != Z_OK || zstream->avail_in || !zstream->avail_out)
+        return c->ret;
+
+    c->dst_len = zstream->next_out - c->dst;
+    c->adler   = adler32(adler32(0L, Z_NULL, 0), c->src, c->size);
+    c->ret     = 0;
+    return 0;
+}
+
+int ff_deflate_parallel(FFZParallel *zp, AVCodecContext *avctx,
+                        uint8_t *dst, size_t *dst_len,
+                        const uint8_t *src, size_t size)
+{
+    const size_t chunks = FFMAX((size + CHUNK_SIZE - 1) / CHUNK_SIZE, 1);
+    const size_t dst_size = *dst_len;
+    size_t buf_size = 0, pos = 0;
+    uLong adler = adler32(0L, Z_NULL, 0);
+    int nb_chunks, level_flags;
+
+    if (chunks > INT_MAX / sizeof(*zp->chunks))
+        return AVERROR(EINVAL);
+    nb_chunks = chunks;
+    av_fast_malloc(&zp->chunks, &zp->chunks_size,
+                   nb_chunks * sizeof(*zp->chunks));
+    if (!zp->chunks)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < nb_chunks; i++) {
+        FFZParallelChunk *c = &zp->chunks[i];
+        c->src     = src + (size_t)i * CHUNK_SIZE;
+        c->size    = FFMIN(size - (size_t)i * CHUNK_SIZE, CHUNK_SIZE);
+        c->dst_len = chunk_bound(c->size);
+        buf_size  += c->dst_len;
+    }
+    if (buf_size > UINT_MAX)
+        return AVERROR(EINVAL);
+    av_fast_malloc(&zp->buf, &zp->buf_size, buf_size);
+    if (!zp->buf)
+        return AVERROR(ENOMEM);
+    for (int i = 0; i < nb_chunks; i++) {
+        zp->chunks[i].dst = zp->buf + pos;
+        pos              += zp->chunks[i].dst_len;
+    }
+    zp->nb_chunks = nb_chunks;
+
+    avctx->execute2(avctx, deflate_chunk, zp, NULL, nb_chunks);
+
+    /* zlib header: 32 KiB window, FLEVEL as deflateInit() would set it */
+    if (zp->level == Z_DEFAULT_COMPRESSION || zp->level == 6)
+        level_flags = 2;
+    else
+        level_flags = zp->level < 2 ? 0 : zp->level < 6 ? 1 : 3;
+    if (dst_size < 2)
+        return AVERROR(ENOSPC);
+    dst[0] = 0x78;
+    dst[1] = level_flags << 6;
+    dst[1] += 31 - (dst[0] << 8 | dst[1]) % 31;
+    pos = 2;
+
+    for (int i = 0; i < nb_chunks; i++) {
+        const FFZParallelChunk *c = &zp->chunks[i];
+        if (c->ret < 0) {
+            av_log(avctx, AV_LOG_ERROR, "Deflating chunk %d failed\n", i);
+            return c->ret;
+        }
+        if (dst_size - pos < c->dst_len)
+            return AVERROR(ENOSPC);
+        memcpy(dst + pos, c->dst, c->dst_len);
+        pos  += c->dst_len;
+        adler = adler32_combine(adler, c->adler, c->size);
+    }
+
+    if (dst_size - pos < 4)
+        return AVERROR(ENOSPC);
+    AV_WB32(dst + pos, adler);
+    *dst_len = pos + 4;
+    return 0;
+}
+
+void ff_deflate_parallel_end(FFZParallel *zp)
+{
+    for (int i = 0; i < zp->nb_streams; i++)
+        ff_deflate_end(&zp->streams[i]);
+    av_freep(&zp->streams);
+    zp->nb_streams = 0;
+    av_freep(&zp->chunks);
+    zp->chunks_size = 0;
+    av_freep(&zp->buf);
+    zp->buf_size = 0;
+}
 #endif
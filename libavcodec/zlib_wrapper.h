@@ -22,13 +22,39 @@
 #ifndef AVCODEC_ZLIB_WRAPPER_H
 #define AVCODEC_ZLIB_WRAPPER_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <zlib.h>
 
+struct AVCodecContext;
+
 typedef struct FFZStream {
     z_stream zstream;
     int inited;
 } FFZStream;
 
+typedef struct FFZParallelChunk FFZParallelChunk;
+
+/**
+ * State for compressing a whole buffer into a single zlib stream using the
+ * slice threads of a codec context, in the way pigz does: the input is cut
+ * into fixed-size chunks which are deflated independently, each one primed
+ * with the last 32 KiB of the preceding chunk as dictionary and terminated
+ * with a sync flush, so that their concatenation is one valid deflate stream.
+ * The chunk size does not depend on the thread count, so the output is the
+ * same for any number of threads.
+ */
+typedef struct FFZParallel {
+    FFZStream *streams;         ///< one raw deflate stream per thread
+    int nb_streams;
+    FFZParallelChunk *chunks;
+    unsigned int chunks_size;
+    int nb_chunks;
+    uint8_t *buf;               ///< compressed chunks before concatenation
+    unsigned int buf_size;
+    int level;
+} FFZParallel;
+
 /**
  * Wrapper around inflateInit(). It initializes the fields that zlib
  * requires to be initialized before inflateInit().
@@ -58,4 +84,33 @@ int ff_deflate_init(FFZStream *zstream, int level, void *logctx);
  */
 void ff_deflate_end(FFZStream *zstream);
 
+/**
+ * Allocate one deflate stream per slice thread of avctx.
+ * @return 0 on success or a negative error code on failure
+ */
+int ff_deflate_parallel_init(FFZParallel *zp, int level,
+                             struct AVCodecContext *avctx);
+
+/**
+ * Upper bound of the size of a zlib stream produced by
+ * ff_deflate_parallel() from size bytes of input.
+ */
+size_t ff_deflate_parallel_bound(size_t size);
+
+/**
+ * Compress src into a complete zlib stream (header, deflate data and
+ * Adler-32 checksum) at dst, using avctx->execute2().
+ * @param dst_len size of dst on input, length of the stream on output
+ * @return 0 on success or a negative error code on failure
+ */
+int ff_deflate_parallel(FFZParallel *zp, struct AVCodecContext *avctx,
+                        uint8_t *dst, size_t *dst_len,
+                        const uint8_t *src, size_t size);
+
+/**
+ * Free everything allocated by ff_deflate_parallel_init() and
+ * ff_deflate_parallel(). Safe to call on a zeroed FFZParallel.
+ */
+void ff_deflate_parallel_end(FFZParallel *zp);
+
 #endif /* AVCODEC_ZLIB_WRAPPER_H */
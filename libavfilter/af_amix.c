@@ -35,12 +35,12 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/common.h"
 #include "libavutil/eval.h"
-#include "libavutil/float_dsp.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/samplefmt.h"
 
+#include "af_amixdsp.h"
 #include "audio.h"
 #include "avfilter.h"
 #include "filters.h"
@@ -157,7 +157,7 @@ static int frame_list_add_frame(FrameList *frame_list, int nb_samples, int64_t p
 
 typedef struct MixContext {
     const AVClass *class;       /**< class for AVOptions */
-    AVFloatDSPContext *fdsp;
+    AudioMixDSPContext dsp;
 
     int nb_inputs;              /**< number of inputs */
     int active_inputs;          /**< number of input currently active */
@@ -170,11 +170,16 @@ typedef struct MixContext {
     int sample_rate;            /**< sample rate */
     int planar;
     AVAudioFifo **fifos;        /**< audio fifo for each input */
+    AVFrame **pending;          /**< frame bypassing the empty fifo of each input */
     uint8_t *input_state;       /**< current state of each input */
     float *input_scale;         /**< mixing scale factor for each input */
     float *weights;             /**< custom weights for every input */
     float weight_sum;           /**< sum of custom weights for every input */
     float *scale_norm;          /**< normalization factor for every input */
+    float *mix_scale_fl;        /**< scales of the inputs mixed in the current frame */
+    double *mix_scale_dbl;
+    AVFrame **mix_bufs;         /**< input frames mixed in the current frame */
+    const void **job_src;       /**< source pointers, nb_inputs per slice job */
     int64_t next_pts;           /**< calculated pts for next output frame */
     FrameList *frame_list;      /**< list of frame info for the first input */
 } MixContext;
@@ -257,8 +262,9 @@ static int config_output(AVFilterLink *outlink)
     if (!s->frame_list)
         return AVERROR(ENOMEM);
 
-    s->fifos = av_calloc(s->nb_inputs, sizeof(*s->fifos));
-    if (!s->fifos)
+    s->fifos   = av_calloc(s->nb_inputs, sizeof(*s->fifos));
+    s->pending = av_calloc(s->nb_inputs, sizeof(*s->pending));
+    if (!s->fifos || !s->pending)
         return AVERROR(ENOMEM);
 
     s->nb_channels = outlink->ch_layout.nb_channels;
@@ -274,9 +280,15 @@ static int config_output(AVFilterLink *outlink)
     memset(s->input_state, INPUT_ON, s->nb_inputs);
     s->active_inputs = s->nb_inputs;
 
-    s->input_scale = av_calloc(s->nb_inputs, sizeof(*s->input_scale));
-    s->scale_norm  = av_calloc(s->nb_inputs, sizeof(*s->scale_norm));
-    if (!s->input_scale || !s->scale_norm)
+    s->input_scale   = av_calloc(s->nb_inputs, sizeof(*s->input_scale));
+    s->scale_norm    = av_calloc(s->nb_inputs, sizeof(*s->scale_norm));
+    s->mix_scale_fl  = av_calloc(s->nb_inputs, sizeof(*s->mix_scale_fl));
+    s->mix_scale_dbl = av_calloc(s->nb_inputs, sizeof(*s->mix_scale_dbl));
+    s->mix_bufs      = av_calloc(s->nb_inputs, sizeof(*s->mix_bufs));
+    s->job_src       = av_calloc(ff_filter_get_nb_threads(ctx) * s->nb_inputs,
+                                 sizeof(*s->job_src));
+    if (!s->input_scale || !s->scale_norm || !s->mix_scale_fl ||
+        !s->mix_scale_dbl || !s->mix_bufs || !s->job_src)
         return AVERROR(ENOMEM);
     for (i = 0; i < s->nb_inputs; i++)
         s->scale_norm[i] = s->weight_sum / FFABS(s->weights[i]);
@@ -291,6 +303,106 @@ static int config_output(AVFilterLink *outlink)
     return 0;
 }
 
+/**
+ * Number of samples buffered for an input, in its FIFO or its pending frame.
+ */
+static int input_samples(MixContext *s, int i)
+{
+    return av_audio_fifo_size(s->fifos[i]) +
+           (s->pending[i] ? s->pending[i]->nb_samples : 0);
+}
+
+/**
+ * Move the pending frame of an input, if any, into its FIFO.
+ */
+static int flush_pending(MixContext *s, int i)
+{
+    AVFrame *frame = s->pending[i];
+    int ret;
+
+    if (!frame)
+        return 0;
+
+    s->pending[i] = NULL;
+    ret = av_audio_fifo_write(s->fifos[i], (void **)frame->extended_data,
+                              frame->nb_samples);
+    av_frame_free(&frame);
+    return FFMIN(ret, 0);
+}
+
+/**
+ * Check whether a pending frame can be handed to the mixing kernel as is.
+ */
+static int can_mix_directly(const AVFrame *frame, int nb_samples,
+                            int planes, int plane_size)
+{
+    int bps = av_get_bytes_per_sample(frame->format);
+
+    if (frame->nb_samples != nb_samples ||
+        frame->linesize[0] < plane_size * bps)
+        return 0;
+
+    for (int p = 0; p < planes; p++)
+        if ((uintptr_t)frame->extended_data[p] & 31)
+            return 0;
+
+    return 1;
+}
+
+typedef struct ThreadData {
+    AVFrame *out;
+    AVFrame **in;
+    int nb_src;
+    int planes;
+    int plane_size;
+} ThreadData;
+
+static int mix_channels(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    MixContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *out = td->out;
+    const void **src = s->job_src + jobnr * s->nb_inputs;
+    int bps = av_get_bytes_per_sample(out->format);
+    int start_plane, end_plane, start, end;
+
+    if (s->planar) {
+        /* planar: each job mixes a group of channels */
+        start_plane = (td->planes *  jobnr     ) / nb_jobs;
+        end_plane   = (td->planes * (jobnr + 1)) / nb_jobs;
+        start       = 0;
+        end         = td->plane_size;
+    } else {
+        /* packed: each job mixes a span of interleaved samples */
+        int blocks  = td->plane_size / 16;
+
+        start_plane = 0;
+        end_plane   = 1;
+        start       = (blocks *  jobnr     ) / nb_jobs * 16;
+        end         = (blocks * (jobnr + 1)) / nb_jobs * 16;
+    }
+
+    if (end <= start)
+        return 0;
+
+    for (int p = start_plane; p < end_plane; p++) {
+        uint8_t *dst = out->extended_data[p] + start * bps;
+
+        for (int k = 0; k < td->nb_src; k++)
+            src[k] = td->in[k]->extended_data[p] + start * bps;
+
+        if (out->format == AV_SAMPLE_FMT_FLT ||
+            out->format == AV_SAMPLE_FMT_FLTP)
+            s->dsp.mix_fl((float *)dst, (const float *const *)src,
+                          s->mix_scale_fl, td->nb_src, end - start);
+        else
+            s->dsp.mix_dbl((double *)dst, (const double *const *)src,
+                           s->mix_scale_dbl, td->nb_src, end - start);
+    }
+
+    return 0;
+}
+
 /**
  * Read samples from the input FIFOs, mix, and write to the output link.
  */
@@ -298,15 +410,16 @@ static int output_frame(AVFilterLink *outlink)
 {
     AVFilterContext *ctx = outlink->src;
     MixContext      *s = ctx->priv;
-    AVFrame *out_buf, *in_buf;
-    int nb_samples, ns, i;
+    AVFrame *out_buf;
+    ThreadData td;
+    int nb_samples, ns, i, planes, plane_size, nb_src = 0, ret = 0;
 
     if (s->input_state[0] & INPUT_ON) {
         /* first input live: use the corresponding frame size */
         nb_samples = frame_list_next_frame_size(s->frame_list);
         for (i = 1; i < s->nb_inputs; i++) {
             if (s->input_state[i] & INPUT_ON) {
-                ns = av_audio_fifo_size(s->fifos[i]);
+                ns = input_samples(s, i);
                 if (ns < nb_samples) {
                     if (!(s->input_state[i] & INPUT_EOF))
                         /* unclosed input with not enough samples */
@@ -323,7 +436,7 @@ static int output_frame(AVFilterLink *outlink)
         nb_samples = INT_MAX;
         for (i = 1; i < s->nb_inputs; i++) {
             if (s->input_state[i] & INPUT_ON) {
-                ns = av_audio_fifo_size(s->fifos[i]);
+                ns = input_samples(s, i);
                 nb_samples = FFMIN(nb_samples, ns);
             }
         }
@@ -344,40 +457,64 @@ static int output_frame(AVFilterLink *outlink)
     if (!out_buf)
         return AVERROR(ENOMEM);
 
-    in_buf = ff_get_audio_buffer(outlink, nb_samples);
-    if (!in_buf) {
-        av_frame_free(&out_buf);
-        return AVERROR(ENOMEM);
-    }
+    planes     = s->planar ? s->nb_channels : 1;
+    plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
+    plane_size = FFALIGN(plane_size, 16);
 
     for (i = 0; i < s->nb_inputs; i++) {
-        if (s->input_state[i] & INPUT_ON) {
-            int planes, plane_size, p;
+        AVFrame *in;
 
-            av_audio_fifo_read(s->fifos[i], (void **)in_buf->extended_data,
-                               nb_samples);
+        if (!(s->input_state[i] & INPUT_ON))
+            continue;
 
-            planes     = s->planar ? s->nb_channels : 1;
-            plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
-            plane_size = FFALIGN(plane_size, 16);
+        /* a pending frame covering exactly this output frame is
+         * mixed directly instead of going through the FIFO */
+        if (s->pending[i] &&
+            can_mix_directly(s->pending[i], nb_samples, planes, plane_size)) {
+            in = s->pending[i];
+            s->pending[i] = NULL;
+        } else {
+            ret = flush_pending(s, i);
+            if (ret < 0)
+                goto fail;
 
-            if (out_buf->format == AV_SAMPLE_FMT_FLT ||
-                out_buf->format == AV_SAMPLE_FMT_FLTP) {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_fmac_scalar((float *)out_buf->extended_data[p],
-                                                (float *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
-                }
-            } else {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_dmac_scalar((double *)out_buf->extended_data[p],
-                                                (double *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
-                }
+            in = ff_get_audio_buffer(outlink, nb_samples);
+            if (!in) {
+                ret = AVERROR(ENOMEM);
+                goto fail;
             }
+            av_audio_fifo_read(s->fifos[i], (void **)in->extended_data,
+                               nb_samples);
         }
+
+        s->mix_scale_fl[nb_src]  = s->input_scale[i];
+        s->mix_scale_dbl[nb_src] = s->input_scale[i];
+        s->mix_bufs[nb_src++]    = in;
+    }
+
+    if (nb_src) {
+        int nb_jobs = ff_filter_get_nb_threads(ctx);
+
+        if (s->planar)
+            nb_jobs = FFMIN(nb_jobs, planes);
+        else
+            nb_jobs = av_clip(plane_size / 256, 1, nb_jobs);
+
+        td.out        = out_buf;
+        td.in         = s->mix_bufs;
+        td.nb_src     = nb_src;
+        td.planes     = planes;
+        td.plane_size = plane_size;
+        ff_filter_execute(ctx, mix_channels, &td, NULL, nb_jobs);
+    }
+
+fail:
+    for (i = 0; i < nb_src; i++)
+        av_frame_free(&s->mix_bufs[i]);
+    if (ret < 0) {
+        av_frame_free(&out_buf);
+        return ret;
     }
-    av_frame_free(&in_buf);
 
     out_buf->pts = s->next_pts;
     out_buf->duration = av_rescale_q(out_buf->nb_samples, av_make_q(1, outlink->sample_rate),
@@ -399,13 +536,13 @@ static int request_samples(AVFilterContext *ctx, int min_samples)
 
     av_assert0(s->nb_inputs > 1);
     if (min_samples == 1 && s->duration_mode == DURATION_FIRST)
-        min_samples = av_audio_fifo_size(s->fifos[0]);
+        min_samples = input_samples(s, 0);
 
     for (i = 1; i < s->nb_inputs; i++) {
         if (!(s->input_state[i] & INPUT_ON) ||
              (s->input_state[i] & INPUT_EOF))
             continue;
-        if (av_audio_fifo_size(s->fifos[i]) >= min_samples)
+        if (input_samples(s, i) >= min_samples)
             continue;
         ff_inlink_request_frame(ctx->inputs[i]);
         return 0;
@@ -457,15 +594,19 @@ static int activate(AVFilterContext *ctx)
                 }
             }
 
-            ret = av_audio_fifo_write(s->fifos[i], (void **)buf->extended_data,
-                                      buf->nb_samples);
-            if (ret < 0) {
+            if (!s->pending[i] && !av_audio_fifo_size(s->fifos[i])) {
+                /* keep the frame around, it may be mixed without a copy */
+                s->pending[i] = buf;
+            } else {
+                ret = flush_pending(s, i);
+                if (ret >= 0)
+                    ret = av_audio_fifo_write(s->fifos[i], (void **)buf->extended_data,
+                                              buf->nb_samples);
                 av_frame_free(&buf);
-                return ret;
+                if (ret < 0)
+                    return ret;
             }
 
-            av_frame_free(&buf);
-
             ret = output_frame(outlink);
             if (ret < 0)
                 return ret;
@@ -479,7 +620,7 @@ static int activate(AVFilterContext *ctx)
         if (ff_inlink_acknowledge_status(ctx->inputs[i], &status, &pts)) {
             if (status == AVERROR_EOF) {
                 s->input_state[i] |= INPUT_EOF;
-                if (av_audio_fifo_size(s->fifos[i]) == 0) {
+                if (input_samples(s, i) == 0) {
                     s->input_state[i] &= ~INPUT_ON;
                     if (s->nb_inputs == 1) {
                         ff_outlink_set_status(outlink, status, pts);
@@ -559,9 +700,7 @@ static av_cold int init(AVFilterContext *ctx)
             return ret;
     }
 
-    s->fdsp = avpriv_float_dsp_alloc(0);
-    if (!s->fdsp)
-        return AVERROR(ENOMEM);
+    ff_amix_init(&s->dsp);
 
     s->weights = av_calloc(s->nb_inputs, sizeof(*s->weights));
     if (!s->weights)
@@ -582,13 +721,21 @@ static av_cold void uninit(AVFilterContext *ctx)
             av_audio_fifo_free(s->fifos[i]);
         av_freep(&s->fifos);
     }
+    if (s->pending) {
+        for (i = 0; i < s->nb_inputs; i++)
+            av_frame_free(&s->pending[i]);
+        av_freep(&s->pending);
+    }
     frame_list_clear(s->frame_list);
     av_freep(&s->frame_list);
     av_freep(&s->input_state);
     av_freep(&s->input_scale);
     av_freep(&s->scale_norm);
+    av_freep(&s->mix_scale_fl);
+    av_freep(&s->mix_scale_dbl);
+    av_freep(&s->mix_bufs);
+    av_freep(&s->job_src);
     av_freep(&s->weights);
-    av_freep(&s->fdsp);
 }
 
 static int process_command(AVFilterContext *ctx, const char *cmd, const char *args,
@@ -630,5 +777,6 @@ const AVFilter ff_af_amix = {
     FILTER_SAMPLEFMTS(AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_FLTP,
                       AV_SAMPLE_FMT_DBL, AV_SAMPLE_FMT_DBLP),
     .process_command = process_command,
-    .flags          = AVFILTER_FLAG_DYNAMIC_INPUTS,
+    .flags          = AVFILTER_FLAG_DYNAMIC_INPUTS |
+                      AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -0,0 +1,78 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_AMIXDSP_H
+#define AVFILTER_AMIXDSP_H
+
+#include <stddef.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+
+typedef struct AudioMixDSPContext {
+    /**
+     * Overwrite dst with the weighted sum of nb_src source buffers,
+     * dst[n] = src[0][n] * scale[0] + ... + src[nb_src - 1][n] * scale[nb_src - 1],
+     * accumulated in source order.
+     *
+     * @param len number of elements, must be a multiple of 16;
+     *            all buffers must be 32-byte aligned
+     */
+    void (*mix_fl)(float *dst, const float *const *src, const float *scale,
+                   int nb_src, ptrdiff_t len);
+    void (*mix_dbl)(double *dst, const double *const *src, const double *scale,
+                    int nb_src, ptrdiff_t len);
+} AudioMixDSPContext;
+
+void ff_amix_init_x86(AudioMixDSPContext *s);
+
+static void mix_fl_c(float *dst, const float *const *src, const float *scale,
+                     int nb_src, ptrdiff_t len)
+{
+    for (ptrdiff_t n = 0; n < len; n++) {
+        float sum = 0.f;
+
+        for (int k = 0; k < nb_src; k++)
+            sum += src[k][n] * scale[k];
+        dst[n] = sum;
+    }
+}
+
+static void mix_dbl_c(double *dst, const double *const *src, const double *scale,
+                      int nb_src, ptrdiff_t len)
+{
+    for (ptrdiff_t n = 0; n < len; n++) {
+        double sum = 0.;
+
+        for (int k = 0; k < nb_src; k++)
+            sum += src[k][n] * scale[k];
+        dst[n] = sum;
+    }
+}
+
+static av_unused void ff_amix_init(AudioMixDSPContext *dsp)
+{
+    dsp->mix_fl  = mix_fl_c;
+    dsp->mix_dbl = mix_dbl_c;
+
+#if ARCH_X86
+    ff_amix_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_AMIXDSP_H */
@@ -64,6 +64,7 @@ typedef struct LoudNormContext {
     double offset;
     int linear;
     int dual_mono;
+    int measure_only;
     enum PrintFormat print_format;
 
     double *buf;
@@ -122,6 +123,7 @@ static const AVOption loudnorm_options[] = {
     {     "none",         0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  NONE},     0,         0,  FLAGS, .unit = "print_format" },
     {     "json",         0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  JSON},     0,         0,  FLAGS, .unit = "print_format" },
     {     "summary",      0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  SUMMARY},  0,         0,  FLAGS, .unit = "print_format" },
+    { "measure_only",     "only measure the input, output no audio", OFFSET(measure_only), AV_OPT_TYPE_BOOL,  {.i64 =  0},        0,         1,  FLAGS },
     { NULL }
 };
 
@@ -687,6 +689,24 @@ static int activate(AVFilterContext *ctx)
 
     FF_FILTER_FORWARD_STATUS_BACK(outlink, inlink);
 
+    if (s->measure_only) {
+        ret = ff_inlink_consume_frame(inlink, &in);
+        if (ret < 0)
+            return ret;
+        if (ret > 0) {
+            ff_ebur128_add_frames_double(s->r128_in, (const double *)in->data[0],
+                                         in->nb_samples);
+            av_frame_free(&in);
+            ff_filter_set_ready(ctx, 10);
+            return 0;
+        }
+
+        FF_FILTER_FORWARD_STATUS(inlink, outlink);
+        FF_FILTER_FORWARD_WANTED(outlink, inlink);
+
+        return FFERROR_NOT_READY;
+    }
+
     if (s->frame_type != LINEAR_MODE) {
         int nb_samples;
 
@@ -745,7 +765,7 @@ static int query_formats(AVFilterContext *ctx)
     if (ret < 0)
         return ret;
 
-    if (s->frame_type == LINEAR_MODE) {
+    if (s->frame_type == LINEAR_MODE || s->measure_only) {
         return ff_set_common_all_samplerates(ctx);
     } else {
         return ff_set_common_samplerates_from_list(ctx, input_srate);
@@ -757,6 +777,18 @@ static int config_input(AVFilterLink *inlink)
     AVFilterContext *ctx = inlink->dst;
     LoudNormContext *s = ctx->priv;
 
+    if (s->measure_only) {
+        /* no resampling to 192 kHz, the true peak is interpolated instead */
+        s->r128_in = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, FF_EBUR128_MODE_I | FF_EBUR128_MODE_LRA | FF_EBUR128_MODE_TRUE_PEAK);
+        if (!s->r128_in)
+            return AVERROR(ENOMEM);
+        ff_ebur128_set_filter_context(s->r128_in, ctx);
+        if (inlink->ch_layout.nb_channels == 1 && s->dual_mono)
+            ff_ebur128_set_channel(s->r128_in, 0, FF_EBUR128_DUAL_MONO);
+        s->channels = inlink->ch_layout.nb_channels;
+        return 0;
+    }
+
     s->r128_in = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, FF_EBUR128_MODE_I | FF_EBUR128_MODE_S | FF_EBUR128_MODE_LRA | FF_EBUR128_MODE_SAMPLE_PEAK);
     if (!s->r128_in)
         return AVERROR(ENOMEM);
@@ -765,6 +797,9 @@ static int config_input(AVFilterLink *inlink)
     if (!s->r128_out)
         return AVERROR(ENOMEM);
 
+    ff_ebur128_set_filter_context(s->r128_in,  ctx);
+    ff_ebur128_set_filter_context(s->r128_out, ctx);
+
     if (inlink->ch_layout.nb_channels == 1 && s->dual_mono) {
         ff_ebur128_set_channel(s->r128_in,  0, FF_EBUR128_DUAL_MONO);
         ff_ebur128_set_channel(s->r128_out, 0, FF_EBUR128_DUAL_MONO);
@@ -827,7 +862,7 @@ static av_cold void uninit(AVFilterContext *ctx)
     double i_in, i_out, lra_in, lra_out, thresh_in, thresh_out, tp_in, tp_out;
     int c;
 
-    if (!s->r128_in || !s->r128_out)
+    if (!s->r128_in || (!s->r128_out && !s->measure_only))
         goto end;
 
     ff_ebur128_loudness_range(s->r128_in, &lra_in);
@@ -835,11 +870,70 @@ static av_cold void uninit(AVFilterContext *ctx)
     ff_ebur128_relative_threshold(s->r128_in, &thresh_in);
     for (c = 0; c < s->channels; c++) {
         double tmp;
-        ff_ebur128_sample_peak(s->r128_in, c, &tmp);
+        if (s->measure_only)
+            ff_ebur128_true_peak(s->r128_in, c, &tmp);
+        else
+            ff_ebur128_sample_peak(s->r128_in, c, &tmp);
         if ((c == 0) || (tmp > tp_in))
             tp_in = tmp;
     }
 
+    if (s->measure_only) {
+        /* the mode a second pass given these measurements uses, following
+         * the linear mode checks in config_input(). Only a linear pass
+         * applies the full gain, and it ignores the offset option; a dynamic
+         * pass would apply the offset on top of its own gain, and there is
+         * no output to derive a residual correction from, so print 0 */
+        const double gain   = s->target_i - i_in;
+        const int linear    = s->linear && lra_in <= s->target_lra &&
+                              20. * log10(tp_in) + gain <= s->target_tp;
+        const double offset = linear ? gain : 0.;
+
+        switch(s->print_format) {
+        case NONE:
+            break;
+
+        case JSON:
+            av_log(ctx, AV_LOG_INFO,
+                "\n{\n"
+                "\t\"input_i\" : \"%.2f\",\n"
+                "\t\"input_tp\" : \"%.2f\",\n"
+                "\t\"input_lra\" : \"%.2f\",\n"
+                "\t\"input_thresh\" : \"%.2f\",\n"
+                "\t\"normalization_type\" : \"%s\",\n"
+                "\t\"target_offset\" : \"%.2f\"\n"
+                "}\n",
+                i_in,
+                20. * log10(tp_in),
+                lra_in,
+                thresh_in,
+                linear ? "linear" : "dynamic",
+                offset
+            );
+            break;
+
+        case SUMMARY:
+            av_log(ctx, AV_LOG_INFO,
+                "\n"
+                "Input Integrated:   %+6.1f LUFS\n"
+                "Input True Peak:    %+6.1f dBTP\n"
+                "Input LRA:          %6.1f LU\n"
+                "Input Threshold:    %+6.1f LUFS\n"
+                "\n"
+                "Normalization Type:   %s\n"
+                "Target Offset:      %+6.1f LU\n",
+                i_in,
+                20. * log10(tp_in),
+                lra_in,
+                thresh_in,
+                linear ? "Linear" : "Dynamic",
+                offset
+            );
+            break;
+        }
+        goto end;
+    }
+
     ff_ebur128_loudness_range(s->r128_out, &lra_out);
     ff_ebur128_loudness_global(s->r128_out, &i_out);
     ff_ebur128_relative_threshold(s->r128_out, &thresh_out);
@@ -939,4 +1033,5 @@ const AVFilter ff_af_loudnorm = {
     FILTER_INPUTS(avfilter_af_loudnorm_inputs),
     FILTER_OUTPUTS(ff_audio_default_filterpad),
     FILTER_QUERY_FUNC(query_formats),
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
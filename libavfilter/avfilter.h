@@ -860,6 +860,19 @@ typedef struct AVFilterGraph {
     avfilter_execute_func *execute;
 
     char *aresample_swr_opts; ///< swr options to use for the auto-inserted aresample filters, Access ONLY through AVOptions
+
+    /**
+     * Thread pool to run the slice threading jobs of the filters in this
+     * graph on, see av_thread_pool_alloc(). May be set by the caller before
+     * adding any filters to the filtergraph. If NULL, the process-wide pool
+     * set up with av_thread_pool_init() is used if there is one, otherwise
+     * the graph spawns threads of its own. nb_threads then limits how many
+     * pool threads may work on the graph at the same time.
+     *
+     * The pool is also passed on to the scaling contexts of the scale
+     * filters. It is kept alive as long as the graph uses it.
+     */
+    struct AVThreadPool *thread_pool;
 } AVFilterGraph;
 
 /**
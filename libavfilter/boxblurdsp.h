@@ -0,0 +1,95 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVFILTER_BOXBLURDSP_H
+#define AVFILTER_BOXBLURDSP_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+
+/*
+ * Running sums are kept premultiplied by the reciprocal of the box length
+ * and offset by 1 << 15, so that every output sample is simply sum >> 16.
+ * They wrap modulo 2^32 for 16 bit input, which does not affect the bits
+ * that are stored.
+ */
+typedef struct BoxBlurDSPContext {
+    /**
+     * Advance the running sums of w columns by one row:
+     * sums[i] += (add[i] - sub[i]) * inv, dst[i] = sums[i] >> 16.
+     * w must be a multiple of 16.
+     */
+    void (*vstep8)(uint8_t *dst, uint32_t *sums, const uint8_t *add,
+                   const uint8_t *sub, int inv, int w);
+    void (*vstep16)(uint16_t *dst, uint32_t *sums, const uint16_t *add,
+                    const uint16_t *sub, int inv, int w);
+
+    /**
+     * Slide the running sum of a row over len samples:
+     * sum += (add[i] - sub[i]) * inv, dst[i] = sum >> 16.
+     * len must be a multiple of 4. Return the final sum.
+     */
+    unsigned (*hstep8)(uint8_t *dst, const uint8_t *add, const uint8_t *sub,
+                       int inv, unsigned sum, int len);
+    unsigned (*hstep16)(uint16_t *dst, const uint16_t *add, const uint16_t *sub,
+                        int inv, unsigned sum, int len);
+} BoxBlurDSPContext;
+
+void ff_boxblur_init_x86(BoxBlurDSPContext *dsp);
+
+#define BOXBLUR_STEP(type, depth)                                           \
+static void vstep ## depth ## _c(type *dst, uint32_t *sums, const type *add,\
+                                 const type *sub, int inv, int w)           \
+{                                                                           \
+    for (int i = 0; i < w; i++) {                                           \
+        sums[i] += (add[i] - sub[i]) * inv;                                 \
+        dst[i] = sums[i] >> 16;                                             \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+static unsigned hstep ## depth ## _c(type *dst, const type *add,            \
+                                     const type *sub, int inv,              \
+                                     unsigned sum, int len)                 \
+{                                                                           \
+    for (int i = 0; i < len; i++) {                                         \
+        sum += (add[i] - sub[i]) * inv;                                     \
+        dst[i] = sum >> 16;                                                 \
+    }                                                                       \
+    return sum;                                                             \
+}
+
+BOXBLUR_STEP(uint8_t,   8)
+BOXBLUR_STEP(uint16_t, 16)
+
+#undef BOXBLUR_STEP
+
+static av_unused void ff_boxblur_init(BoxBlurDSPContext *dsp)
+{
+    dsp->vstep8  = vstep8_c;
+    dsp->vstep16 = vstep16_c;
+    dsp->hstep8  = hstep8_c;
+    dsp->hstep16 = hstep16_c;
+
+#if ARCH_X86
+    ff_boxblur_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_BOXBLURDSP_H */
@@ -0,0 +1,64 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_DECIMATEDSP_H
+#define AVFILTER_DECIMATEDSP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+
+typedef struct DecimateDSPContext {
+    /**
+     * Add the sum of absolute differences of each group of 8 samples of a
+     * row to acc: acc[i] += sum(abs(a[8 * i + j] - b[8 * i + j])).
+     * len must be a multiple of 32.
+     */
+    void (*sad_groups8)(uint32_t *acc, const uint8_t *a, const uint8_t *b, int len);
+    void (*sad_groups16)(uint32_t *acc, const uint16_t *a, const uint16_t *b, int len);
+} DecimateDSPContext;
+
+void ff_decimate_init_x86(DecimateDSPContext *dsp);
+
+#define SAD_GROUPS(type, depth)                                               \
+static av_unused void sad_groups ## depth ## _c(uint32_t *acc,                \
+                                                const type *a, const type *b, \
+                                                int len)                      \
+{                                                                             \
+    for (int i = 0; i < len; i++)                                             \
+        acc[i >> 3] += abs(a[i] - b[i]);                                      \
+}
+
+SAD_GROUPS(uint8_t,   8)
+SAD_GROUPS(uint16_t, 16)
+
+#undef SAD_GROUPS
+
+static av_unused void ff_decimate_init(DecimateDSPContext *dsp)
+{
+    dsp->sad_groups8  = sad_groups8_c;
+    dsp->sad_groups16 = sad_groups16_c;
+
+#if ARCH_X86
+    ff_decimate_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_DECIMATEDSP_H */
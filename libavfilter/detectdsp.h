@@ -0,0 +1,98 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_DETECTDSP_H
+#define AVFILTER_DETECTDSP_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+
+/*
+ * Row statistics shared by blackdetect and cropdetect. len must be a
+ * multiple of 32 for the 8 bit functions and of 16 for the 16 bit ones,
+ * callers handle the remainder with the C versions.
+ */
+typedef struct DetectDSPContext {
+    /**
+     * Return the sum of len samples.
+     */
+    unsigned (*sum8)(const uint8_t *src, int len);
+    unsigned (*sum16)(const uint16_t *src, int len);
+
+    /**
+     * Add a row of len samples to len column sums: acc[i] += src[i].
+     */
+    void (*colsum8)(uint32_t *acc, const uint8_t *src, int len);
+    void (*colsum16)(uint32_t *acc, const uint16_t *src, int len);
+
+    /**
+     * Return the number of samples that are less than or equal to threshold.
+     */
+    unsigned (*count_le8)(const uint8_t *src, int len, unsigned threshold);
+    unsigned (*count_le16)(const uint16_t *src, int len, unsigned threshold);
+} DetectDSPContext;
+
+void ff_detectdsp_init_x86(DetectDSPContext *dsp);
+
+#define DETECT_FUNCS(type, depth)                                           \
+static av_unused unsigned sum ## depth ## _c(const type *src, int len)      \
+{                                                                           \
+    unsigned sum = 0;                                                       \
+    for (int i = 0; i < len; i++)                                           \
+        sum += src[i];                                                      \
+    return sum;                                                             \
+}                                                                           \
+                                                                            \
+static av_unused void colsum ## depth ## _c(uint32_t *acc, const type *src, \
+                                            int len)                        \
+{                                                                           \
+    for (int i = 0; i < len; i++)                                           \
+        acc[i] += src[i];                                                   \
+}                                                                           \
+                                                                            \
+static av_unused unsigned count_le ## depth ## _c(const type *src, int len, \
+                                                  unsigned threshold)       \
+{                                                                           \
+    unsigned count = 0;                                                     \
+    for (int i = 0; i < len; i++)                                           \
+        count += src[i] <= threshold;                                       \
+    return count;                                                           \
+}
+
+DETECT_FUNCS(uint8_t,   8)
+DETECT_FUNCS(uint16_t, 16)
+
+#undef DETECT_FUNCS
+
+static av_unused void ff_detectdsp_init(DetectDSPContext *dsp)
+{
+    dsp->sum8       = sum8_c;
+    dsp->sum16      = sum16_c;
+    dsp->colsum8    = colsum8_c;
+    dsp->colsum16   = colsum16_c;
+    dsp->count_le8  = count_le8_c;
+    dsp->count_le16 = count_le16_c;
+
+#if ARCH_X86
+    ff_detectdsp_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_DETECTDSP_H */
@@ -21,6 +21,8 @@
 
 #include <string.h>
 
+#include "config.h"
+
 #include "libavutil/avassert.h"
 #include "libavutil/avutil.h"
 #include "libavutil/csp.h"
@@ -77,6 +79,15 @@ int ff_fill_rgba_map(uint8_t *rgba_map, enum AVPixelFormat pix_fmt)
     return 0;
 }
 
+static void blend_row8_c(uint8_t *dst, const uint8_t *mask, int w,
+                         unsigned src, unsigned alpha)
+{
+    for (int x = 0; x < w; x++) {
+        unsigned a = mask[x] * alpha;
+        dst[x] = ((0x1010101 - a) * dst[x] + a * src) >> 24;
+    }
+}
+
 int ff_draw_init2(FFDrawContext *draw, enum AVPixelFormat format, enum AVColorSpace csp,
                   enum AVColorRange range, unsigned flags)
 {
@@ -145,6 +156,10 @@ int ff_draw_init2(FFDrawContext *draw, enum AVPixelFormat format, enum AVColorSp
     memcpy(draw->pixelstep, pixelstep, sizeof(draw->pixelstep));
     draw->hsub[1] = draw->hsub[2] = draw->hsub_max = desc->log2_chroma_w;
     draw->vsub[1] = draw->vsub[2] = draw->vsub_max = desc->log2_chroma_h;
+    draw->blend_row8 = blend_row8_c;
+#if ARCH_X86
+    ff_draw_init_x86(draw);
+#endif
     return 0;
 }
 
@@ -575,6 +590,16 @@ void ff_blend_mask(FFDrawContext *draw, FFDrawColor *color,
                 continue;
             p = p0 + offset;
             m = mask;
+            if (depth <= 8 && l2depth == 3 && draw->pixelstep[plane] == 1 &&
+                !draw->hsub[plane] && !draw->vsub[plane]) {
+                for (y = 0; y < h_sub; y++) {
+                    draw->blend_row8(p, m + xm0, w_sub,
+                                     color->comp[plane].u8[index], alpha);
+                    p += dst_linesize[plane];
+                    m += mask_linesize;
+                }
+                continue;
+            }
             if (top) {
                 if (depth <= 8) {
                     blend_line_hv(p, draw->pixelstep[plane],
@@ -45,6 +45,16 @@ typedef struct FFDrawContext {
     unsigned flags;
     enum AVColorSpace csp;
     double rgb2yuv[3][3];
+
+    /**
+     * Blend an 8-bit coverage mask row with an uniform color onto
+     * contiguous 8-bit samples:
+     * dst[x] = ((0x1010101 - mask[x] * alpha) * dst[x] + mask[x] * alpha * src) >> 24
+     *
+     * @param alpha  color alpha in the [ 0 ; 0x10203 ] range
+     */
+    void (*blend_row8)(uint8_t *dst, const uint8_t *mask, int w,
+                       unsigned src, unsigned alpha);
 } FFDrawContext;
 
 typedef struct FFDrawColor {
@@ -84,6 +94,7 @@ int ff_draw_init2(FFDrawContext *draw, enum AVPixelFormat format, enum AVColorSp
  */
 int ff_draw_init(FFDrawContext *draw, enum AVPixelFormat format, unsigned flags);
 
+void ff_draw_init_x86(FFDrawContext *draw);
 
 
 /**
@@ -46,12 +46,16 @@
 #include <float.h>
 #include <limits.h>
 #include <math.h>               /* You may have to define _USE_MATH_DEFINES if you use MSVC */
+#include <string.h>
 
+#include "config.h"
+#include "libavutil/attributes.h"
 #include "libavutil/error.h"
 #include "libavutil/macros.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
 #include "libavutil/thread.h"
+#include "internal.h"
 
 #define CHECK_ERROR(condition, errorcode, goto_point)                          \
     if ((condition)) {                                                         \
@@ -65,6 +69,9 @@
 #define RELATIVE_GATE_FACTOR  pow(10.0, RELATIVE_GATE / 10.0)
 #define MINUS_20DB            pow(10.0, -20.0 / 10.0)
 
+/** Length of the interpolation filter used for true peak measurement. */
+#define TP_TAPS               49
+
 struct FFEBUR128StateInternal {
     /** Filtered audio data (used as ring buffer). */
     double *audio_data;
@@ -84,8 +91,22 @@ struct FFEBUR128StateInternal {
     double b[5];
     /** BS.1770 filter coefficients (denominator). */
     double a[5];
-    /** BS.1770 filter state. */
-    double v[5][5];
+    /** b[0..4] and a[1..4], each one duplicated for two channel filtering. */
+    DECLARE_ALIGNED(16, double, coeffs)[18];
+    /** BS.1770 filter state, v1..v4 of each channel pair. */
+    double *v;
+    /** Interpolation filter phases, without the trivial phase 0. */
+    double tp_coeffs[TP_TAPS];
+    /** Number of taps of each interpolation filter phase. */
+    int tp_taps;
+    /** Number of interpolation filter phases in tp_coeffs. */
+    int tp_phases;
+    /** Planar input history for the interpolation filter. */
+    double *tp_buf;
+    /** Size of the tp_buf area of one channel. */
+    size_t tp_buf_size;
+    /** Maximum true peak, one per channel */
+    double *true_peak;
     /** Histograms, used to calculate LRA. */
     unsigned long *block_energy_histogram;
     unsigned long *short_term_block_energy_histogram;
@@ -97,6 +118,12 @@ struct FFEBUR128StateInternal {
     unsigned long window;
     /** Data pointer array for interleaved data */
     void **data_ptrs;
+    /** Short-term energy of the current audio_data, if short_term_valid. */
+    double short_term_energy;
+    int short_term_valid;
+    /** Filter whose slice threads run the per-channel processing. */
+    AVFilterContext *ctx;
+    FFEBUR128DSPContext dsp;
 };
 
 static AVOnce histogram_init = AV_ONCE_INIT;
@@ -105,7 +132,7 @@ static DECLARE_ALIGNED(32, double, histogram_energy_boundaries)[1001];
 
 static void ebur128_init_filter(FFEBUR128State * st)
 {
-    int i, j;
+    int i;
 
     double f0 = 1681.974450955533;
     double G = 3.999843853973347;
@@ -147,8 +174,44 @@ static void ebur128_init_filter(FFEBUR128State * st)
     st->d->a[4] = pa[2] * ra[2];
 
     for (i = 0; i < 5; ++i) {
-        for (j = 0; j < 5; ++j) {
-            st->d->v[i][j] = 0.0;
+        st->d->coeffs[2 * i]     =
+        st->d->coeffs[2 * i + 1] = st->d->b[i];
+    }
+    for (i = 1; i < 5; ++i) {
+        st->d->coeffs[8 + 2 * i]     =
+        st->d->coeffs[8 + 2 * i + 1] = st->d->a[i];
+    }
+}
+
+static void ebur128_init_true_peak(FFEBUR128State * st)
+{
+    int factor, j;
+
+    if (st->samplerate < 96000)
+        factor = 4;
+    else if (st->samplerate < 192000)
+        factor = 2;
+    else
+        factor = 1;
+
+    /* Phase 0 only has its center tap set (to 1.0), so it reproduces the
+     * input samples and is covered by the sample peak. */
+    st->d->tp_taps   = (TP_TAPS + factor - 1) / factor;
+    st->d->tp_phases = factor - 1;
+    memset(st->d->tp_coeffs, 0, sizeof(st->d->tp_coeffs));
+
+    for (j = 0; j < TP_TAPS; ++j) {
+        double m = (double) j - (double) (TP_TAPS - 1) / 2.0;
+        double c = 1.0;
+        int phase = j % factor;
+        if (fabs(m) > ALMOST_ZERO) {
+            c = sin(m * M_PI / factor) / (m * M_PI / factor);
+        }
+        /* Hann window */
+        c *= 0.5 * (1 - cos(2 * M_PI * j / (TP_TAPS - 1)));
+        if (phase && fabs(c) > ALMOST_ZERO) {
+            st->d->tp_coeffs[(phase - 1) * st->d->tp_taps +
+                             st->d->tp_taps - 1 - j / factor] = c;
         }
     }
 }
@@ -235,6 +298,11 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
     st->d->sample_peak =
         (double *) av_calloc(channels, sizeof(*st->d->sample_peak));
     CHECK_ERROR(!st->d->sample_peak, 0, free_channel_map)
+    st->d->true_peak =
+        (double *) av_calloc(channels, sizeof(*st->d->true_peak));
+    CHECK_ERROR(!st->d->true_peak, 0, free_sample_peak)
+    st->d->ctx = NULL;
+    st->d->short_term_valid = 0;
 
     st->samplerate = samplerate;
     st->d->samples_in_100ms = (st->samplerate + 5) / 10;
@@ -244,7 +312,7 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
     } else if ((mode & FF_EBUR128_MODE_M) == FF_EBUR128_MODE_M) {
         st->d->window = FFMAX(window, 400);
     } else {
-        goto free_sample_peak;
+        goto free_true_peak;
     }
     st->d->audio_data_frames = st->samplerate * st->d->window / 1000;
     if (st->d->audio_data_frames % st->d->samples_in_100ms) {
@@ -256,13 +324,27 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
     st->d->audio_data =
         (double *) av_calloc(st->d->audio_data_frames,
                              st->channels * sizeof(*st->d->audio_data));
-    CHECK_ERROR(!st->d->audio_data, 0, free_sample_peak)
+    CHECK_ERROR(!st->d->audio_data, 0, free_true_peak)
 
     ebur128_init_filter(st);
+    st->d->v = av_calloc((channels + 1) / 2, 8 * sizeof(*st->d->v));
+    CHECK_ERROR(!st->d->v, 0, free_audio_data)
+
+    ebur128_init_true_peak(st);
+    st->d->tp_buf = NULL;
+    if ((mode & FF_EBUR128_MODE_TRUE_PEAK) == FF_EBUR128_MODE_TRUE_PEAK) {
+        /* history plus the largest block handed to the filter */
+        st->d->tp_buf_size = st->d->tp_taps - 1 + st->d->samples_in_100ms * 4;
+        st->d->tp_buf = av_calloc(channels,
+                                  st->d->tp_buf_size * sizeof(*st->d->tp_buf));
+        CHECK_ERROR(!st->d->tp_buf, 0, free_filter_state)
+    }
+
+    ff_ebur128_dsp_init(&st->d->dsp);
 
     st->d->block_energy_histogram =
         av_mallocz(1000 * sizeof(*st->d->block_energy_histogram));
-    CHECK_ERROR(!st->d->block_energy_histogram, 0, free_audio_data)
+    CHECK_ERROR(!st->d->block_energy_histogram, 0, free_tp_buf)
     st->d->short_term_block_energy_histogram =
         av_mallocz(1000 * sizeof(*st->d->short_term_block_energy_histogram));
     CHECK_ERROR(!st->d->short_term_block_energy_histogram, 0,
@@ -287,8 +369,14 @@ free_short_term_block_energy_histogram:
     av_free(st->d->short_term_block_energy_histogram);
 free_block_energy_histogram:
     av_free(st->d->block_energy_histogram);
+free_tp_buf:
+    av_free(st->d->tp_buf);
+free_filter_state:
+    av_free(st->d->v);
 free_audio_data:
     av_free(st->d->audio_data);
+free_true_peak:
+    av_free(st->d->true_peak);
 free_sample_peak:
     av_free(st->d->sample_peak);
 free_channel_map:
@@ -308,62 +396,207 @@ void ff_ebur128_destroy(FFEBUR128State ** st)
     av_free((*st)->d->audio_data);
     av_free((*st)->d->channel_map);
     av_free((*st)->d->sample_peak);
+    av_free((*st)->d->true_peak);
+    av_free((*st)->d->v);
+    av_free((*st)->d->tp_buf);
     av_free((*st)->d->data_ptrs);
     av_free((*st)->d);
     av_free(*st);
     *st = NULL;
 }
 
-#define EBUR128_FILTER(type, scaling_factor)                                       \
-static void ebur128_filter_##type(FFEBUR128State* st, const type** srcs,           \
-                                  size_t src_index, size_t frames,                 \
-                                  int stride) {                                    \
-    double* audio_data = st->d->audio_data + st->d->audio_data_index;              \
-    size_t i, c;                                                                   \
-                                                                                   \
-    if ((st->mode & FF_EBUR128_MODE_SAMPLE_PEAK) == FF_EBUR128_MODE_SAMPLE_PEAK) { \
-        for (c = 0; c < st->channels; ++c) {                                       \
-            double max = 0.0;                                                      \
-            for (i = 0; i < frames; ++i) {                                         \
-                type v = srcs[c][src_index + i * stride];                          \
-                if (v > max) {                                                     \
-                    max =        v;                                                \
-                } else if (-v > max) {                                             \
-                    max = -1.0 * v;                                                \
-                }                                                                  \
-            }                                                                      \
-            max /= scaling_factor;                                                 \
-            if (max > st->d->sample_peak[c]) st->d->sample_peak[c] = max;          \
-        }                                                                          \
-    }                                                                              \
-    for (c = 0; c < st->channels; ++c) {                                           \
-        int ci = st->d->channel_map[c] - 1;                                        \
-        if (ci < 0) continue;                                                      \
-        else if (ci == FF_EBUR128_DUAL_MONO - 1) ci = 0; /*dual mono */            \
-        for (i = 0; i < frames; ++i) {                                             \
-            st->d->v[ci][0] = (double) (srcs[c][src_index + i * stride] / scaling_factor) \
-                         - st->d->a[1] * st->d->v[ci][1]                           \
-                         - st->d->a[2] * st->d->v[ci][2]                           \
-                         - st->d->a[3] * st->d->v[ci][3]                           \
-                         - st->d->a[4] * st->d->v[ci][4];                          \
-            audio_data[i * st->channels + c] =                                     \
-                           st->d->b[0] * st->d->v[ci][0]                           \
-                         + st->d->b[1] * st->d->v[ci][1]                           \
-                         + st->d->b[2] * st->d->v[ci][2]                           \
-                         + st->d->b[3] * st->d->v[ci][3]                           \
-                         + st->d->b[4] * st->d->v[ci][4];                          \
-            st->d->v[ci][4] = st->d->v[ci][3];                                     \
-            st->d->v[ci][3] = st->d->v[ci][2];                                     \
-            st->d->v[ci][2] = st->d->v[ci][1];                                     \
-            st->d->v[ci][1] = st->d->v[ci][0];                                     \
-        }                                                                          \
-        st->d->v[ci][4] = fabs(st->d->v[ci][4]) < DBL_MIN ? 0.0 : st->d->v[ci][4]; \
-        st->d->v[ci][3] = fabs(st->d->v[ci][3]) < DBL_MIN ? 0.0 : st->d->v[ci][3]; \
-        st->d->v[ci][2] = fabs(st->d->v[ci][2]) < DBL_MIN ? 0.0 : st->d->v[ci][2]; \
-        st->d->v[ci][1] = fabs(st->d->v[ci][1]) < DBL_MIN ? 0.0 : st->d->v[ci][1]; \
-    }                                                                              \
-}
-EBUR128_FILTER(double, 1.0)
+/* Filter one channel, coefficients and state are stored with a stride of
+ * two as in FFEBUR128DSPContext.filter_2ch(). */
+static void ebur128_filter_1ch(double *dst, const double *src,
+                               ptrdiff_t dst_stride, ptrdiff_t src_stride,
+                               int frames, const double *coeffs, double *v)
+{
+    int i;
+
+    for (i = 0; i < frames; ++i) {
+        double v0 = src[i * src_stride]
+                  - coeffs[10] * v[0]
+                  - coeffs[12] * v[2]
+                  - coeffs[14] * v[4]
+                  - coeffs[16] * v[6];
+        dst[i * dst_stride] = coeffs[0] * v0
+                            + coeffs[2] * v[0]
+                            + coeffs[4] * v[2]
+                            + coeffs[6] * v[4]
+                            + coeffs[8] * v[6];
+        v[6] = v[4];
+        v[4] = v[2];
+        v[2] = v[0];
+        v[0] = v0;
+    }
+}
+
+static void ebur128_filter_2ch_c(double *dst, const double *src,
+                                 ptrdiff_t dst_stride, ptrdiff_t src_stride,
+                                 int frames, const double *coeffs, double *state)
+{
+    ebur128_filter_1ch(dst,     src,     dst_stride, src_stride, frames,
+                       coeffs,     state);
+    ebur128_filter_1ch(dst + 1, src + 1, dst_stride, src_stride, frames,
+                       coeffs + 1, state + 1);
+}
+
+static double ebur128_true_peak_c(const double *src, const double *coeffs,
+                                  int ntaps, int nb_phases, int len)
+{
+    double peak = 0.0;
+    int i, p, k;
+
+    src -= ntaps - 1;
+    for (i = 0; i < len; ++i) {
+        for (p = 0; p < nb_phases; ++p) {
+            const double *c = coeffs + p * ntaps;
+            double y = 0.0;
+            for (k = 0; k < ntaps; ++k)
+                y += c[k] * src[i + k];
+            peak = FFMAX(peak, fabs(y));
+        }
+    }
+    return peak;
+}
+
+av_cold void ff_ebur128_dsp_init(FFEBUR128DSPContext *dsp)
+{
+    dsp->filter_2ch = ebur128_filter_2ch_c;
+    dsp->true_peak  = ebur128_true_peak_c;
+
+#if ARCH_X86
+    ff_ebur128_dsp_init_x86(dsp);
+#endif
+}
+
+typedef struct ThreadData {
+    FFEBUR128State *st;
+    const double **srcs;
+    size_t src_index;
+    size_t frames;
+    int stride;
+} ThreadData;
+
+static void ebur128_channel_peaks(FFEBUR128State *st, const double *src,
+                                  int c, size_t frames, int stride)
+{
+    double max = 0.0;
+    size_t i;
+
+    for (i = 0; i < frames; ++i) {
+        double v = src[i * stride];
+        if (v > max) {
+            max =        v;
+        } else if (-v > max) {
+            max = -1.0 * v;
+        }
+    }
+    if (max > st->d->sample_peak[c]) st->d->sample_peak[c] = max;
+
+    if ((st->mode & FF_EBUR128_MODE_TRUE_PEAK) == FF_EBUR128_MODE_TRUE_PEAK &&
+        st->d->tp_phases) {
+        const int history = st->d->tp_taps - 1;
+        const int simd_frames = frames & ~3;
+        double *buf = st->d->tp_buf + c * st->d->tp_buf_size;
+        double peak;
+
+        for (i = 0; i < frames; ++i)
+            buf[history + i] = src[i * stride];
+
+        peak = st->d->dsp.true_peak(buf + history, st->d->tp_coeffs,
+                                    st->d->tp_taps, st->d->tp_phases,
+                                    simd_frames);
+        peak = FFMAX(peak, ebur128_true_peak_c(buf + history + simd_frames,
+                                               st->d->tp_coeffs,
+                                               st->d->tp_taps,
+                                               st->d->tp_phases,
+                                               frames - simd_frames));
+        if (peak > st->d->true_peak[c]) st->d->true_peak[c] = peak;
+
+        memmove(buf, buf + frames, history * sizeof(*buf));
+    }
+}
+
+static void ebur128_flush_denormals(double *v)
+{
+    int k;
+
+    for (k = 0; k < 4; ++k)
+        v[2 * k] = fabs(v[2 * k]) < DBL_MIN ? 0.0 : v[2 * k];
+}
+
+static int ebur128_filter_channels(AVFilterContext *ctx, void *arg,
+                                   int jobnr, int nb_jobs)
+{
+    ThreadData *td = arg;
+    FFEBUR128State *st = td->st;
+    const double **srcs = td->srcs;
+    const int frames = td->frames;
+    const int stride = td->stride;
+    double *audio_data = st->d->audio_data + st->d->audio_data_index;
+    const int start = (st->channels *  jobnr     ) / nb_jobs;
+    const int end   = (st->channels * (jobnr + 1)) / nb_jobs;
+    int c;
+
+    if ((st->mode & FF_EBUR128_MODE_SAMPLE_PEAK) == FF_EBUR128_MODE_SAMPLE_PEAK) {
+        for (c = start; c < end; ++c)
+            ebur128_channel_peaks(st, srcs[c] + td->src_index, c,
+                                  frames, stride);
+    }
+
+    for (c = start; c < end; ++c) {
+        double *v = st->d->v + (c >> 1) * 8 + (c & 1);
+
+        /* two adjacent interleaved channels share one SIMD filter run */
+        if (!(c & 1) && c + 1 < end && srcs[c + 1] == srcs[c] + 1) {
+            if (st->d->channel_map[c]     == FF_EBUR128_UNUSED &&
+                st->d->channel_map[c + 1] == FF_EBUR128_UNUSED) {
+                ++c;
+                continue;
+            }
+            st->d->dsp.filter_2ch(audio_data + c, srcs[c] + td->src_index,
+                                  st->channels, stride, frames,
+                                  st->d->coeffs, v);
+            ebur128_flush_denormals(v);
+            ebur128_flush_denormals(v + 1);
+            ++c;
+            continue;
+        }
+
+        if (st->d->channel_map[c] == FF_EBUR128_UNUSED)
+            continue;
+        ebur128_filter_1ch(audio_data + c, srcs[c] + td->src_index,
+                           st->channels, stride, frames,
+                           st->d->coeffs + (c & 1), v);
+        ebur128_flush_denormals(v);
+    }
+
+    return 0;
+}
+
+static void ebur128_filter_double(FFEBUR128State* st, const double** srcs,
+                                  size_t src_index, size_t frames,
+                                  int stride)
+{
+    ThreadData td = {
+        .st        = st,
+        .srcs      = srcs,
+        .src_index = src_index,
+        .frames    = frames,
+        .stride    = stride,
+    };
+
+    st->d->short_term_valid = 0;
+    if (st->d->ctx) {
+        const int nb_jobs = FFMIN(st->channels,
+                                  ff_filter_get_nb_threads(st->d->ctx));
+        ff_filter_execute(st->d->ctx, ebur128_filter_channels, &td,
+                          NULL, nb_jobs);
+    } else {
+        ebur128_filter_channels(NULL, &td, 0, 1);
+    }
+}
 
 static double ebur128_energy_to_loudness(double energy)
 {
@@ -442,6 +675,11 @@ static void ebur128_calc_gating_block(FFEBUR128State * st,
     }
 }
 
+void ff_ebur128_set_filter_context(FFEBUR128State * st, AVFilterContext *ctx)
+{
+    st->d->ctx = ctx;
+}
+
 int ff_ebur128_set_channel(FFEBUR128State * st,
                            unsigned int channel_number, int value)
 {
@@ -610,8 +848,19 @@ static int ebur128_energy_in_interval(FFEBUR128State * st,
 
 static int ebur128_energy_shortterm(FFEBUR128State * st, double *out)
 {
-    return ebur128_energy_in_interval(st, st->d->samples_in_100ms * 30,
-                                      out);
+    int ret;
+
+    /* the LRA gating and the caller often ask for the same block */
+    if (st->d->short_term_valid) {
+        *out = st->d->short_term_energy;
+        return 0;
+    }
+    ret = ebur128_energy_in_interval(st, st->d->samples_in_100ms * 30, out);
+    if (!ret) {
+        st->d->short_term_energy = *out;
+        st->d->short_term_valid  = 1;
+    }
+    return ret;
 }
 
 int ff_ebur128_loudness_shortterm(FFEBUR128State * st, double *out)
@@ -723,3 +972,17 @@ int ff_ebur128_sample_peak(FFEBUR128State * st,
     *out = st->d->sample_peak[channel_number];
     return 0;
 }
+
+int ff_ebur128_true_peak(FFEBUR128State * st,
+                         unsigned int channel_number, double *out)
+{
+    if ((st->mode & FF_EBUR128_MODE_TRUE_PEAK) !=
+        FF_EBUR128_MODE_TRUE_PEAK) {
+        return AVERROR(EINVAL);
+    } else if (channel_number >= st->channels) {
+        return AVERROR(EINVAL);
+    }
+    *out = FFMAX(st->d->true_peak[channel_number],
+                 st->d->sample_peak[channel_number]);
+    return 0;
+}
@@ -32,6 +32,8 @@
 
 #include <stddef.h>             /* for size_t */
 
+struct AVFilterContext;
+
 /** \enum channel
  *  Use these values when setting the channel map with ebur128_set_channel().
  *  See definitions in ITU R-REC-BS 1770-4
@@ -91,8 +93,48 @@ enum mode {
     FF_EBUR128_MODE_LRA = (1 << 3) | FF_EBUR128_MODE_S,
   /** can call ff_ebur128_sample_peak */
     FF_EBUR128_MODE_SAMPLE_PEAK = (1 << 4) | FF_EBUR128_MODE_M,
+  /** can call ff_ebur128_true_peak */
+    FF_EBUR128_MODE_TRUE_PEAK = (1 << 5) | FF_EBUR128_MODE_M
+                                         | FF_EBUR128_MODE_SAMPLE_PEAK,
 };
 
+/** \brief DSP functions used by the measurement, exposed for checkasm.
+ */
+typedef struct FFEBUR128DSPContext {
+    /** \brief Run the K-weighting filter over two interleaved channels.
+     *
+     *  @param dst output, two doubles per frame, dst_stride doubles apart.
+     *  @param src input, two doubles per frame, src_stride doubles apart.
+     *  @param dst_stride distance between output frames in doubles.
+     *  @param src_stride distance between input frames in doubles.
+     *  @param frames number of frames.
+     *  @param coeffs b0..b4 followed by a1..a4, each one stored twice,
+     *                16 byte aligned.
+     *  @param state filter history v1..v4, two doubles each (one per
+     *               channel), 16 byte aligned.
+     */
+    void (*filter_2ch)(double *dst, const double *src,
+                       ptrdiff_t dst_stride, ptrdiff_t src_stride,
+                       int frames, const double *coeffs, double *state);
+
+    /** \brief Get the maximum absolute value of an oversampled signal.
+     *
+     *  Every input sample is interpolated by nb_phases polyphase filters of
+     *  ntaps taps each.
+     *
+     *  @param src first sample to interpolate; the ntaps - 1 samples before
+     *             it must be readable.
+     *  @param coeffs nb_phases * ntaps coefficients, oldest tap first.
+     *  @param len number of samples, a multiple of 4 for SIMD versions.
+     *  @return the absolute peak of all interpolated values.
+     */
+    double (*true_peak)(const double *src, const double *coeffs,
+                        int ntaps, int nb_phases, int len);
+} FFEBUR128DSPContext;
+
+void ff_ebur128_dsp_init(FFEBUR128DSPContext *dsp);
+void ff_ebur128_dsp_init_x86(FFEBUR128DSPContext *dsp);
+
 /** forward declaration of FFEBUR128StateInternal */
 struct FFEBUR128StateInternal;
 
@@ -125,6 +167,16 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
  */
 void ff_ebur128_destroy(FFEBUR128State ** st);
 
+/** \brief Run the per-channel processing on the slice threads of a filter.
+ *
+ *  @param st library state.
+ *  @param ctx filter whose threads are used, it must have
+ *             AVFILTER_FLAG_SLICE_THREADS set. NULL to process in the
+ *             calling thread.
+ */
+void ff_ebur128_set_filter_context(FFEBUR128State * st,
+                                   struct AVFilterContext *ctx);
+
 /** \brief Set channel type.
  *
  *  The default is:
@@ -216,6 +268,22 @@ int ff_ebur128_loudness_range_multiple(FFEBUR128State ** sts,
 int ff_ebur128_sample_peak(FFEBUR128State * st,
                            unsigned int channel_number, double *out);
 
+/** \brief Get maximum true peak of selected channel in float format.
+ *
+ *  Uses an oversampling factor of 4 below 96 kHz, 2 below 192 kHz and the
+ *  sample peak above.
+ *
+ *  @param st library state
+ *  @param channel_number channel to analyse
+ *  @param out maximum true peak in float format (1.0 is 0 dBFS)
+ *  @return
+ *    - 0 on success.
+ *    - AVERROR(EINVAL) if mode "FF_EBUR128_MODE_TRUE_PEAK" has not been set.
+ *    - AVERROR(EINVAL) if invalid channel index.
+ */
+int ff_ebur128_true_peak(FFEBUR128State * st,
+                         unsigned int channel_number, double *out);
+
 /** \brief Get relative threshold in LUFS.
  *
  *  @param st library state
@@ -626,59 +626,58 @@ static int gate_update(struct integrator *integ, double power,
     return gate_hist_pos;
 }
 
-static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
+typedef struct ThreadData {
+    const double *samples;
+    int nb_samples;
+} ThreadData;
+
+static int true_peaks_channels(AVFilterContext *ctx, void *arg,
+                               int jobnr, int nb_jobs)
 {
-    int i, ch, idx_insample, ret;
-    AVFilterContext *ctx = inlink->dst;
     EBUR128Context *ebur128 = ctx->priv;
+    ThreadData *td = arg;
     const int nb_channels = ebur128->nb_channels;
-    const int nb_samples  = insamples->nb_samples;
-    const double *samples = (double *)insamples->data[0];
-    AVFrame *pic;
+    const int start = (nb_channels *  jobnr     ) / nb_jobs;
+    const int end   = (nb_channels * (jobnr + 1)) / nb_jobs;
 
-#if CONFIG_SWRESAMPLE
-    if (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS && ebur128->idx_insample == 0) {
-        const double *swr_samples = ebur128->swr_buf;
-        int ret = swr_convert(ebur128->swr_ctx, (uint8_t**)&ebur128->swr_buf, 19200,
-                              (const uint8_t **)insamples->data, nb_samples);
-        if (ret < 0)
-            return ret;
-        for (ch = 0; ch < nb_channels; ch++)
-            ebur128->true_peaks_per_frame[ch] = 0.0;
-        for (idx_insample = 0; idx_insample < ret; idx_insample++) {
-            for (ch = 0; ch < nb_channels; ch++) {
-                ebur128->true_peaks[ch] = FFMAX(ebur128->true_peaks[ch], fabs(*swr_samples));
-                ebur128->true_peaks_per_frame[ch] = FFMAX(ebur128->true_peaks_per_frame[ch],
-                                                          fabs(*swr_samples));
-                swr_samples++;
-            }
+    for (int ch = start; ch < end; ch++) {
+        const double *swr_samples = td->samples + ch;
+        double peak = 0.0;
+
+        for (int n = 0; n < td->nb_samples; n++) {
+            peak = FFMAX(peak, fabs(*swr_samples));
+            swr_samples += nb_channels;
         }
+        ebur128->true_peaks[ch] = FFMAX(ebur128->true_peaks[ch], peak);
+        ebur128->true_peaks_per_frame[ch] = peak;
     }
-#endif
 
-    for (idx_insample = ebur128->idx_insample; idx_insample < nb_samples; idx_insample++) {
-        const int bin_id_400  = ebur128->i400.cache_pos;
-        const int bin_id_3000 = ebur128->i3000.cache_pos;
-
-#define MOVE_TO_NEXT_CACHED_ENTRY(time) do {                \
-    ebur128->i##time.cache_pos++;                           \
-    if (ebur128->i##time.cache_pos ==                       \
-        ebur128->i##time.cache_size) {                      \
-        ebur128->i##time.filled    = 1;                     \
-        ebur128->i##time.cache_pos = 0;                     \
-    }                                                       \
-} while (0)
+    return 0;
+}
 
-        MOVE_TO_NEXT_CACHED_ENTRY(400);
-        MOVE_TO_NEXT_CACHED_ENTRY(3000);
+/* Filter and integrate td->nb_samples samples of the channels of this job,
+ * none of them may cross a 100ms refresh boundary. */
+static int filter_channels(AVFilterContext *ctx, void *arg,
+                           int jobnr, int nb_jobs)
+{
+    EBUR128Context *ebur128 = ctx->priv;
+    ThreadData *td = arg;
+    const int nb_channels = ebur128->nb_channels;
+    const int start = (nb_channels *  jobnr     ) / nb_jobs;
+    const int end   = (nb_channels * (jobnr + 1)) / nb_jobs;
+
+    for (int ch = start; ch < end; ch++) {
+        const double *samples = td->samples + ch;
+        int bin_id_400  = ebur128->i400.cache_pos;
+        int bin_id_3000 = ebur128->i3000.cache_pos;
 
-        for (ch = 0; ch < nb_channels; ch++) {
+        for (int n = 0; n < td->nb_samples; n++, samples += nb_channels) {
             double bin;
 
             if (ebur128->peak_mode & PEAK_MODE_SAMPLES_PEAKS)
-                ebur128->sample_peaks[ch] = FFMAX(ebur128->sample_peaks[ch], fabs(samples[idx_insample * nb_channels + ch]));
+                ebur128->sample_peaks[ch] = FFMAX(ebur128->sample_peaks[ch], fabs(*samples));
 
-            ebur128->x[ch * 3] = samples[idx_insample * nb_channels + ch]; // set X[i]
+            ebur128->x[ch * 3] = *samples; // set X[i]
 
             if (!ebur128->ch_weighting[ch])
                 continue;
@@ -709,7 +708,64 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
             /* override old cache entry with the new value */
             ebur128->i400.cache [ch][bin_id_400 ] = bin;
             ebur128->i3000.cache[ch][bin_id_3000] = bin;
+
+            if (++bin_id_400 == ebur128->i400.cache_size)
+                bin_id_400 = 0;
+            if (++bin_id_3000 == ebur128->i3000.cache_size)
+                bin_id_3000 = 0;
         }
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
+{
+    int i, ch, idx_insample, ret;
+    AVFilterContext *ctx = inlink->dst;
+    EBUR128Context *ebur128 = ctx->priv;
+    const int nb_channels = ebur128->nb_channels;
+    const int nb_samples  = insamples->nb_samples;
+    const double *samples = (double *)insamples->data[0];
+    const int nb_jobs = FFMIN(nb_channels, ff_filter_get_nb_threads(ctx));
+    AVFrame *pic;
+
+#if CONFIG_SWRESAMPLE
+    if (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS && ebur128->idx_insample == 0) {
+        ThreadData td;
+        int ret = swr_convert(ebur128->swr_ctx, (uint8_t**)&ebur128->swr_buf, 19200,
+                              (const uint8_t **)insamples->data, nb_samples);
+        if (ret < 0)
+            return ret;
+        td.samples    = ebur128->swr_buf;
+        td.nb_samples = ret;
+        ff_filter_execute(ctx, true_peaks_channels, &td, NULL, nb_jobs);
+    }
+#endif
+
+    for (idx_insample = ebur128->idx_insample; idx_insample < nb_samples; idx_insample++) {
+        const int to_refresh = inlink->sample_rate / 10 - ebur128->sample_count;
+        ThreadData td;
+
+        /* the channels are independent up to the next refresh */
+        td.samples    = samples + idx_insample * nb_channels;
+        td.nb_samples = nb_samples - idx_insample;
+        if (to_refresh > 0)
+            td.nb_samples = FFMIN(td.nb_samples, to_refresh);
+        ff_filter_execute(ctx, filter_channels, &td, NULL, nb_jobs);
+
+#define MOVE_CACHE_POS(time) do {                                   \
+    ebur128->i##time.cache_pos += td.nb_samples;                    \
+    if (ebur128->i##time.cache_pos >= ebur128->i##time.cache_size) {\
+        ebur128->i##time.filled     = 1;                            \
+        ebur128->i##time.cache_pos -= ebur128->i##time.cache_size;  \
+    }                                                               \
+} while (0)
+
+        MOVE_CACHE_POS(400);
+        MOVE_CACHE_POS(3000);
+        idx_insample += td.nb_samples - 1;
+        ebur128->sample_count += td.nb_samples - 1;
 
 #define FIND_PEAK(global, sp, ptype) do {                        \
     int ch;                                                      \
@@ -1130,5 +1186,5 @@ const AVFilter ff_af_ebur128 = {
     .outputs       = NULL,
     FILTER_QUERY_FUNC(query_formats),
     .priv_class    = &ebur128_class,
-    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS,
+    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS | AVFILTER_FLAG_SLICE_THREADS,
 };
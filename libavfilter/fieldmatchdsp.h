@@ -0,0 +1,183 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_FIELDMATCHDSP_H
+#define AVFILTER_FIELDMATCHDSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+
+enum {
+    FM_MATCH_PC,
+    FM_MATCH_PM,
+    FM_MATCH_PML,
+    FM_MATCH_NC,
+    FM_MATCH_NM,
+    FM_MATCH_NML,
+    FM_MATCH_NB
+};
+
+enum {
+    FM_ROW_SRCPF,
+    FM_ROW_SRCF,
+    FM_ROW_SRCNF,
+    FM_ROW_PRVPF,
+    FM_ROW_PRVNF,
+    FM_ROW_NXTPF,
+    FM_ROW_NXTNF,
+    FM_ROW_MAP0,
+    FM_ROW_MAP1,
+    FM_ROW_NB
+};
+
+typedef struct FieldMatchDSPContext {
+    /**
+     * Compute a row of the comb mask: dst[x] is 0xff where c[x] differs from
+     * both m1[x] and p1[x] by more than cthresh and the [1 -3 4 -3 1]
+     * vertical filter over m2, m1, c, p1, p2 exceeds 6 * cthresh, 0 elsewhere.
+     * width must be a multiple of 32, cthresh must be in [0,255].
+     */
+    void (*comb_row)(uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+                     const uint8_t *c, const uint8_t *p1, const uint8_t *p2,
+                     int width, int cthresh);
+
+    /**
+     * Count, for each column, the pixels that are combed on their own row and
+     * on the rows above and below: acc[x] += cmk[x - stride] == 0xff &&
+     * cmk[x] == 0xff && cmk[x + stride] == 0xff.
+     * width must be a multiple of 16.
+     */
+    void (*comb_count)(uint16_t *acc, const uint8_t *cmk, ptrdiff_t stride,
+                       int width);
+
+    /**
+     * dst[x] = abs(a[x] - b[x]). width must be a multiple of 32.
+     */
+    void (*abs_diff)(uint8_t *dst, const uint8_t *a, const uint8_t *b, int width);
+
+    /**
+     * Return the sum of abs(a[x] - b[x]). width must be a multiple of 32.
+     */
+    unsigned (*sad)(const uint8_t *a, const uint8_t *b, int width);
+
+    /**
+     * Add the field matching metrics of a row to sums, indexed by FM_MATCH_*,
+     * from the rows indexed by FM_ROW_*. width must be a multiple of 16.
+     */
+    void (*match_row)(uint32_t *sums, const uint8_t *const *rows, int width);
+} FieldMatchDSPContext;
+
+void ff_fieldmatch_init_x86(FieldMatchDSPContext *dsp);
+
+static av_unused void comb_row_c(uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+                                 const uint8_t *c, const uint8_t *p1, const uint8_t *p2,
+                                 int width, int cthresh)
+{
+    const int cthresh6 = cthresh * 6;
+
+    for (int x = 0; x < width; x++) {
+        const int s1 = abs(c[x] - m1[x]);
+        const int s2 = abs(c[x] - p1[x]);
+
+        dst[x] = s1 > cthresh && s2 > cthresh &&
+                 abs(4 * c[x] - 3 * (m1[x] + p1[x]) + (m2[x] + p2[x])) > cthresh6 ? 0xff : 0;
+    }
+}
+
+static av_unused void comb_count_c(uint16_t *acc, const uint8_t *cmk,
+                                   ptrdiff_t stride, int width)
+{
+    for (int x = 0; x < width; x++)
+        acc[x] += cmk[x - stride] == 0xff &&
+                  cmk[x         ] == 0xff &&
+                  cmk[x + stride] == 0xff;
+}
+
+static av_unused void abs_diff_c(uint8_t *dst, const uint8_t *a,
+                                 const uint8_t *b, int width)
+{
+    for (int x = 0; x < width; x++)
+        dst[x] = abs(a[x] - b[x]);
+}
+
+static av_unused unsigned sad_c(const uint8_t *a, const uint8_t *b, int width)
+{
+    unsigned sum = 0;
+
+    for (int x = 0; x < width; x++)
+        sum += abs(a[x] - b[x]);
+    return sum;
+}
+
+static av_unused void match_row_c(uint32_t *sums, const uint8_t *const *rows,
+                                  int width)
+{
+    const uint8_t *srcpf = rows[FM_ROW_SRCPF], *srcf  = rows[FM_ROW_SRCF];
+    const uint8_t *srcnf = rows[FM_ROW_SRCNF];
+    const uint8_t *prvpf = rows[FM_ROW_PRVPF], *prvnf = rows[FM_ROW_PRVNF];
+    const uint8_t *nxtpf = rows[FM_ROW_NXTPF], *nxtnf = rows[FM_ROW_NXTNF];
+    const uint8_t *map0  = rows[FM_ROW_MAP0],  *map1  = rows[FM_ROW_MAP1];
+
+    for (int x = 0; x < width; x++) {
+        const int map  = map0[x] | map1[x];
+        const int temp = srcpf[x] + (srcf[x] << 2) + srcnf[x]; // [1 4 1]
+        int diff;
+
+        if (!map)
+            continue;
+
+        diff = abs(3 * (prvpf[x] + prvnf[x]) - temp);
+        if (diff > 23 && (map & 1))
+            sums[FM_MATCH_PC] += diff;
+        if (diff > 42) {
+            if (map & 2)
+                sums[FM_MATCH_PM] += diff;
+            if (map & 4)
+                sums[FM_MATCH_PML] += diff;
+        }
+
+        diff = abs(3 * (nxtpf[x] + nxtnf[x]) - temp);
+        if (diff > 23 && (map & 1))
+            sums[FM_MATCH_NC] += diff;
+        if (diff > 42) {
+            if (map & 2)
+                sums[FM_MATCH_NM] += diff;
+            if (map & 4)
+                sums[FM_MATCH_NML] += diff;
+        }
+    }
+}
+
+static av_unused void ff_fieldmatch_init(FieldMatchDSPContext *dsp)
+{
+    dsp->comb_row   = comb_row_c;
+    dsp->comb_count = comb_count_c;
+    dsp->abs_diff   = abs_diff_c;
+    dsp->sad        = sad_c;
+    dsp->match_row  = match_row_c;
+
+#if ARCH_X86
+    ff_fieldmatch_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_FIELDMATCHDSP_H */
@@ -18,6 +18,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "config.h"
 #include "libavutil/common.h"
 #include "motion_estimation.h"
 
@@ -43,6 +44,29 @@ do {\
 if (x >= x_min && x <= x_max && y >= y_min && y <= y_max)\
     COST_MV(x, y);
 
+#define ME_SAD_C(w)                                                           \
+static int me_sad##w##_c(const uint8_t *src1, ptrdiff_t stride1,             \
+                         const uint8_t *src2, ptrdiff_t stride2, int h)      \
+{                                                                             \
+    int sad = 0;                                                              \
+                                                                              \
+    for (int y = 0; y < h; y++) {                                             \
+        for (int x = 0; x < w; x++)                                           \
+            sad += FFABS(src1[x] - src2[x]);                                  \
+        src1 += stride1;                                                      \
+        src2 += stride2;                                                      \
+    }                                                                         \
+                                                                              \
+    return sad;                                                               \
+}
+
+ME_SAD_C(1)
+ME_SAD_C(2)
+ME_SAD_C(4)
+ME_SAD_C(8)
+ME_SAD_C(16)
+ME_SAD_C(32)
+
 void ff_me_init_context(AVMotionEstContext *me_ctx, int mb_size, int search_param,
                         int width, int height, int x_min, int x_max, int y_min, int y_max)
 {
@@ -55,26 +79,46 @@ void ff_me_init_context(AVMotionEstContext *me_ctx, int mb_size, int search_para
     me_ctx->x_max = x_max;
     me_ctx->y_min = y_min;
     me_ctx->y_max = y_max;
+
+    me_ctx->sad[0] = me_sad1_c;
+    me_ctx->sad[1] = me_sad2_c;
+    me_ctx->sad[2] = me_sad4_c;
+    me_ctx->sad[3] = me_sad8_c;
+    me_ctx->sad[4] = me_sad16_c;
+    me_ctx->sad[5] = me_sad32_c;
+
+#if ARCH_X86
+    ff_me_init_x86(me_ctx);
+#endif
 }
 
-uint64_t ff_me_cmp_sad(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int x_mv, int y_mv)
+uint64_t ff_me_block_sad(AVMotionEstContext *me_ctx, const uint8_t *src1,
+                         const uint8_t *src2, int size)
 {
     const int linesize = me_ctx->linesize;
-    uint8_t *data_ref = me_ctx->data_ref;
-    uint8_t *data_cur = me_ctx->data_cur;
+    const int log2_size = av_log2(size);
     uint64_t sad = 0;
     int i, j;
 
-    data_ref += y_mv * linesize;
-    data_cur += y_mb * linesize;
+    if (log2_size <= ME_SAD_MAX_LOG2)
+        return me_ctx->sad[log2_size](src1, linesize, src2, linesize, size);
 
-    for (j = 0; j < me_ctx->mb_size; j++)
-        for (i = 0; i < me_ctx->mb_size; i++)
-            sad += FFABS(data_ref[x_mv + i + j * linesize] - data_cur[x_mb + i + j * linesize]);
+    for (j = 0; j < size; j++)
+        for (i = 0; i < size; i++)
+            sad += FFABS(src1[i + j * linesize] - src2[i + j * linesize]);
 
     return sad;
 }
 
+uint64_t ff_me_cmp_sad(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int x_mv, int y_mv)
+{
+    const int linesize = me_ctx->linesize;
+
+    return ff_me_block_sad(me_ctx, me_ctx->data_ref + x_mv + y_mv * linesize,
+                           me_ctx->data_cur + x_mb + y_mb * linesize,
+                           me_ctx->mb_size);
+}
+
 uint64_t ff_me_search_esa(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int *mv)
 {
     int x, y;
@@ -21,6 +21,7 @@
 #ifndef AVFILTER_MOTION_ESTIMATION_H
 #define AVFILTER_MOTION_ESTIMATION_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define AV_ME_METHOD_ESA        1
@@ -38,6 +39,15 @@ typedef struct AVMotionEstPredictor {
     int nb;
 } AVMotionEstPredictor;
 
+/**
+ * Sum of absolute differences of two blocks of h rows, the block width
+ * being fixed by the function.
+ */
+typedef int (*ff_me_sad_fn)(const uint8_t *src1, ptrdiff_t stride1,
+                            const uint8_t *src2, ptrdiff_t stride2, int h);
+
+#define ME_SAD_MAX_LOG2 5
+
 typedef struct AVMotionEstContext {
     uint8_t *data_cur, *data_ref;
     int linesize;
@@ -57,6 +67,12 @@ typedef struct AVMotionEstContext {
     int pred_y;     ///< median predictor y
     AVMotionEstPredictor preds[2];
 
+    /**
+     * Block SAD functions indexed by log2 of the block width,
+     * for widths 1 to 1 << ME_SAD_MAX_LOG2.
+     */
+    ff_me_sad_fn sad[ME_SAD_MAX_LOG2 + 1];
+
     uint64_t (*get_cost)(struct AVMotionEstContext *me_ctx, int x_mb, int y_mb,
                          int mv_x, int mv_y);
 } AVMotionEstContext;
@@ -64,6 +80,15 @@ typedef struct AVMotionEstContext {
 void ff_me_init_context(AVMotionEstContext *me_ctx, int mb_size, int search_param,
                         int width, int height, int x_min, int x_max, int y_min, int y_max);
 
+void ff_me_init_x86(AVMotionEstContext *me_ctx);
+
+/**
+ * Compute the SAD of two size x size blocks sharing the same linesize.
+ * size must be a power of 2.
+ */
+uint64_t ff_me_block_sad(AVMotionEstContext *me_ctx, const uint8_t *src1,
+                         const uint8_t *src2, int size);
+
 uint64_t ff_me_cmp_sad(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int x_mv, int y_mv);
 
 uint64_t ff_me_search_esa(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int *mv);
@@ -0,0 +1,42 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_PALETTEUSEDSP_H
+#define AVFILTER_PALETTEUSEDSP_H
+
+#include <stdint.h>
+
+typedef struct PaletteUseDSPContext {
+    /**
+     * Brute force nearest colour search.
+     *
+     * @param L, a, b    OkLab components of the candidate colours, 32-byte
+     *                   aligned, nb_colors entries each
+     * @param nb_colors  number of candidates, a non-zero multiple of 8
+     * @param target     OkLab components of the colour to look up
+     * @return the index of the candidate at the smallest squared euclidean
+     *         distance, or -1 if that distance is shared by several
+     *         candidates or is not below INT32_MAX - 1
+     */
+    int (*color_search)(const int32_t *L, const int32_t *a, const int32_t *b,
+                        int nb_colors, const int32_t *target);
+} PaletteUseDSPContext;
+
+void ff_paletteuse_init_x86(PaletteUseDSPContext *dsp);
+
+#endif /* AVFILTER_PALETTEUSEDSP_H */
@@ -32,12 +32,21 @@
 #include "libavutil/timestamp.h"
 #include "avfilter.h"
 #include "internal.h"
+#include "signaturedsp.h"
 
 #define ELEMENT_COUNT 10
 #define SIGELEM_SIZE 380
 #define DIFFELEM_SIZE 348 /* SIGELEM_SIZE - elem_a1 - elem_a2 */
 #define COARSE_SIZE 90
 
+/* reference index layout, all records are multiples of 16 bytes */
+#define INDEX_MAGIC "FFSIGIDX"
+#define INDEX_VERSION 1
+#define INDEX_HEADER_SIZE 16
+#define INDEX_RECORD_HEADER_SIZE 32
+#define INDEX_COARSE_SIZE (16 + COARSE_WORDS * COARSE_WORD_SIZE)
+#define INDEX_FINE_SIZE (16 + L1PLANES_SIZE)
+
 enum lookup_mode {
     MODE_OFF,
     MODE_FULL,
@@ -48,6 +57,7 @@ enum lookup_mode {
 enum formats {
     FORMAT_BINARY,
     FORMAT_XML,
+    FORMAT_INDEX,
     NB_FORMATS
 };
 
@@ -77,10 +87,11 @@ typedef struct FineSignature {
     uint8_t confidence;
     uint8_t words[5];
     uint8_t framesig[SIGELEM_SIZE/5];
+    uint8_t l1planes[L1PLANES_SIZE]; /* framesig as bit planes for the l1 distance */
 } FineSignature;
 
 typedef struct CoarseSignature {
-    uint8_t data[5][31]; /* 5 words with min. 243 bit */
+    uint8_t data[COARSE_WORDS][COARSE_WORD_SIZE]; /* 5 words with min. 243 bit */
     struct FineSignature* first; /* associated Finesignatures */
     struct FineSignature* last;
     struct CoarseSignature* next;
@@ -122,8 +133,30 @@ typedef struct StreamContext {
     uint32_t lastindex; /* helper to store amount of frames */
 
     int exported; /* boolean whether stream already exported */
+
+    /* index lookup */
+    CoarseSignature* indexlast; /* last coarsesignature looked up in the index */
+    uint32_t* indexuntil; /* per reference, end of the last reported match */
 } StreamContext;
 
+/* reference signature in a memory mapped index */
+typedef struct IndexReference {
+    const uint8_t* coarse;
+    const uint8_t* fine;
+    uint32_t nb_coarse;
+    uint32_t nb_frames;
+    AVRational time_base;
+} IndexReference;
+
+/* best match of a coarsesignature against one reference */
+typedef struct IndexMatch {
+    int score; /* 0 if there is no match */
+    int matchframes;
+    uint32_t index; /* frame index in the reference */
+    uint64_t pts;   /* pts in the reference */
+    FineSignature* first;
+} IndexMatch;
+
 typedef struct SignatureContext {
     const AVClass *class;
     /* input parameters */
@@ -131,6 +164,7 @@ typedef struct SignatureContext {
     int nb_inputs;
     char *filename;
     int format;
+    char *index_filename;
     int thworddist;
     int thcomposdist;
     int thl1;
@@ -138,8 +172,17 @@ typedef struct SignatureContext {
     int thit;
     /* end input parameters */
 
-    uint8_t l1distlut[243*242/2]; /* 243 + 242 + 241 ... */
+    SignatureDSPContext dsp;
     StreamContext* streamcontexts;
+
+    /* memory mapped reference index */
+    uint8_t* index_buf;
+    size_t index_size;
+    IndexReference* refs;
+    int nb_refs;
+    uint32_t max_ref_frames;
+    FineSignature* ref_fine; /* one materialized reference per job */
+    IndexMatch* ref_matches;
 } SignatureContext;
 
 
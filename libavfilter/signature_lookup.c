@@ -48,75 +48,9 @@ static void sll_free(MatchingInfo **sll)
     }
 }
 
-static void fill_l1distlut(uint8_t lut[])
+static unsigned int get_l1dist(AVFilterContext *ctx, SignatureContext *sc, const FineSignature *first, const FineSignature *second)
 {
-    int i, j, tmp_i, tmp_j,count;
-    uint8_t dist;
-
-    for (i = 0, count = 0; i < 242; i++) {
-        for (j = i + 1; j < 243; j++, count++) {
-            /* ternary distance between i and j */
-            dist = 0;
-            tmp_i = i; tmp_j = j;
-            do {
-                dist += FFABS((tmp_j % 3) - (tmp_i % 3));
-                tmp_j /= 3;
-                tmp_i /= 3;
-            } while (tmp_i > 0 || tmp_j > 0);
-            lut[count] = dist;
-        }
-    }
-}
-
-static unsigned int intersection_word(const uint8_t *first, const uint8_t *second)
-{
-    unsigned int val=0,i;
-    for (i = 0; i < 28; i += 4) {
-        val += av_popcount( (first[i]   & second[i]  ) << 24 |
-                            (first[i+1] & second[i+1]) << 16 |
-                            (first[i+2] & second[i+2]) << 8  |
-                            (first[i+3] & second[i+3]) );
-    }
-    val += av_popcount( (first[28] & second[28]) << 16 |
-                        (first[29] & second[29]) << 8  |
-                        (first[30] & second[30]) );
-    return val;
-}
-
-static unsigned int union_word(const uint8_t *first, const uint8_t *second)
-{
-    unsigned int val=0,i;
-    for (i = 0; i < 28; i += 4) {
-        val += av_popcount( (first[i]   | second[i]  ) << 24 |
-                            (first[i+1] | second[i+1]) << 16 |
-                            (first[i+2] | second[i+2]) << 8  |
-                            (first[i+3] | second[i+3]) );
-    }
-    val += av_popcount( (first[28] | second[28]) << 16 |
-                        (first[29] | second[29]) << 8  |
-                        (first[30] | second[30]) );
-    return val;
-}
-
-static unsigned int get_l1dist(AVFilterContext *ctx, SignatureContext *sc, const uint8_t *first, const uint8_t *second)
-{
-    unsigned int i;
-    unsigned int dist = 0;
-    uint8_t f, s;
-
-    for (i = 0; i < SIGELEM_SIZE/5; i++) {
-        if (first[i] != second[i]) {
-            f = first[i];
-            s = second[i];
-            if (f > s) {
-                /* little variation of gauss sum formula */
-                dist += sc->l1distlut[243*242/2 - (243-s)*(242-s)/2 + f - s - 1];
-            } else {
-                dist += sc->l1distlut[243*242/2 - (243-f)*(242-f)/2 + s - f - 1];
-            }
-        }
-    }
-    return dist;
+    return sc->dsp.l1dist(first->l1planes, second->l1planes);
 }
 
 /**
@@ -126,9 +60,12 @@ static unsigned int get_l1dist(AVFilterContext *ctx, SignatureContext *sc, const
 static int get_jaccarddist(SignatureContext *sc, CoarseSignature *first, CoarseSignature *second)
 {
     int jaccarddist, i, composdist = 0, cwthcount = 0;
+    int inter[COARSE_WORDS], uni[COARSE_WORDS];
+
+    sc->dsp.coarse_popcount(first->data[0], second->data[0], inter, uni);
     for (i = 0; i < 5; i++) {
-        if ((jaccarddist = intersection_word(first->data[i], second->data[i])) > 0) {
-            jaccarddist /= union_word(first->data[i], second->data[i]);
+        if ((jaccarddist = inter[i]) > 0) {
+            jaccarddist /= uni[i];
         }
         if (jaccarddist >= sc->thworddist) {
             if (++cwthcount > 2) {
@@ -230,7 +167,7 @@ static MatchingInfo* get_matching_parameters(AVFilterContext *ctx, SignatureCont
         pairs[i].a = f;
         for (j = 0, s = second; j < COARSE_SIZE && s->next; j++, s = s->next) {
             /* l1 distance of finesignature */
-            l1dist = get_l1dist(ctx, sc, f->framesig, s->framesig);
+            l1dist = get_l1dist(ctx, sc, f, s);
             if (l1dist < sc->thl1) {
                 if (l1dist < pairs[i].dist) {
                     pairs[i].size = 1;
@@ -439,7 +376,7 @@ static MatchingInfo evaluate_parameters(AVFilterContext *ctx, SignatureContext *
         a = infos->first;
         b = infos->second;
         while (1) {
-            dist = get_l1dist(ctx, sc, a->framesig, b->framesig);
+            dist = get_l1dist(ctx, sc, a, b);
 
             if (dist > sc->thl1) {
                 if (a->confidence >= 1 || b->confidence >= 1) {
@@ -546,8 +483,6 @@ static MatchingInfo lookup_signatures(AVFilterContext *ctx, SignatureContext *sc
     bestmatch.meandist = 99999;
     bestmatch.whole = 0;
 
-    fill_l1distlut(sc->l1distlut);
-
     /* stage 1: coarsesignature matching */
     if (find_next_coarsecandidate(sc, second->coarsesiglist, &cs, &cs2, 1) == 0)
         return bestmatch; /* no candidate found */
@@ -579,3 +514,110 @@ static MatchingInfo lookup_signatures(AVFilterContext *ctx, SignatureContext *sc
     return bestmatch;
 
 }
+
+/**
+ * calculates the jaccard distances scaled to 0 - 10000 and evaluates a pair
+ * of coarse signatures as good, used for the index lookup
+ * @return 0 if pair is bad, 1 otherwise
+ */
+static int get_scaled_jaccarddist(SignatureContext *sc, const uint8_t *first, const uint8_t *second)
+{
+    int jaccarddist, i, composdist = 0, cwthcount = 0;
+    int inter[COARSE_WORDS], uni[COARSE_WORDS];
+
+    sc->dsp.coarse_popcount(first, second, inter, uni);
+    for (i = 0; i < COARSE_WORDS; i++) {
+        jaccarddist = uni[i] ? 10000 - 10000 * inter[i] / uni[i] : 0;
+        if (jaccarddist >= sc->thworddist) {
+            if (++cwthcount > 2)
+                return 0;
+        }
+        composdist += jaccarddist;
+        if (composdist > sc->thcomposdist)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * builds the finesignature list of a reference from the index
+ */
+static void load_index_reference(const IndexReference *ref, FineSignature *fine)
+{
+    uint32_t i;
+
+    for (i = 0; i < ref->nb_frames; i++) {
+        const uint8_t *p = ref->fine + (size_t)i * INDEX_FINE_SIZE;
+
+        fine[i].prev = i > 0 ? &fine[i - 1] : NULL;
+        fine[i].next = i + 1 < ref->nb_frames ? &fine[i + 1] : NULL;
+        fine[i].pts = AV_RL64(p);
+        fine[i].index = i;
+        fine[i].confidence = p[8];
+        memcpy(fine[i].l1planes, p + 16, L1PLANES_SIZE);
+    }
+}
+
+/**
+ * matches one coarsesignature of a stream against all coarsesignatures of
+ * a reference, the finesignatures of the reference are only loaded if there
+ * is at least one candidate
+ *
+ * On repetitive content, many coarsesignatures of a reference pass stage 1
+ * and the first one reaching both ends of the sequence is not necessarily
+ * the right one. So every candidate is evaluated on its own on the
+ * finesignatures and the one with the lowest mean l1 distance wins.
+ */
+static IndexMatch lookup_index_reference(AVFilterContext *ctx, SignatureContext *sc, CoarseSignature *cs,
+                                         const IndexReference *ref, FineSignature *fine, int mode)
+{
+    MatchingInfo *infos, *info, *next;
+    MatchingInfo nomatch, bestmatch, m;
+    IndexMatch match = { 0 };
+    int loaded = 0;
+    uint32_t i;
+
+    nomatch.score = 0;
+    nomatch.meandist = 99999;
+    nomatch.whole = 0;
+    bestmatch = nomatch;
+
+    for (i = 0; i < ref->nb_coarse; i++) {
+        const uint8_t *rcs = ref->coarse + (size_t)i * INDEX_COARSE_SIZE;
+
+        /* stage 1: coarsesignature matching */
+        if (!get_scaled_jaccarddist(sc, cs->data[0], rcs + 16))
+            continue;
+
+        if (!loaded) {
+            load_index_reference(ref, fine);
+            loaded = 1;
+        }
+
+        /* stage 2: l1-distance and hough-transform */
+        infos = get_matching_parameters(ctx, sc, cs->first, &fine[AV_RL32(rcs)]);
+
+        /* stage 3: evaluation, one matching parameter set at a time */
+        for (info = infos; info; info = next) {
+            next = info->next;
+            info->next = NULL;
+            m = evaluate_parameters(ctx, sc, info, nomatch, mode);
+            info->next = next;
+
+            if (m.score != 0 &&
+                (m.meandist < bestmatch.meandist ||
+                 (m.meandist == bestmatch.meandist && m.matchframes > bestmatch.matchframes)))
+                bestmatch = m;
+        }
+        sll_free(&infos);
+    }
+
+    if (bestmatch.score != 0) {
+        match.score = bestmatch.score;
+        match.matchframes = bestmatch.matchframes;
+        match.index = bestmatch.second->index;
+        match.pts = bestmatch.second->pts;
+        match.first = bestmatch.first;
+    }
+    return match;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVFILTER_SIGNATUREDSP_H
+#define AVFILTER_SIGNATUREDSP_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+
+#define COARSE_WORDS      5
+#define COARSE_WORD_SIZE  32 /* 243 bits, zero padded */
+#define L1PLANES_SIZE     96 /* 2 bit planes of 380 ternary elements, zero padded */
+
+typedef struct SignatureDSPContext {
+    /**
+     * Count the bits of the intersection and the union of each of the
+     * COARSE_WORDS bag-of-words sets of two coarse signatures.
+     */
+    void (*coarse_popcount)(const uint8_t *a, const uint8_t *b,
+                            int *inter, int *uni);
+
+    /**
+     * L1 distance of two frame signatures stored as thermometer coded
+     * bit planes, where a ternary value t sets bit i of the first plane
+     * if t >= 1 and bit i of the second plane if t == 2, so that
+     * |ta - tb| is the number of differing bits.
+     */
+    int (*l1dist)(const uint8_t *a, const uint8_t *b);
+} SignatureDSPContext;
+
+void ff_signature_init_x86(SignatureDSPContext *s);
+
+static void coarse_popcount_c(const uint8_t *a, const uint8_t *b,
+                              int *inter, int *uni)
+{
+    for (int w = 0; w < COARSE_WORDS; w++) {
+        int i = 0, u = 0;
+
+        for (int k = 0; k < COARSE_WORD_SIZE; k += 8) {
+            uint64_t x = AV_RN64(a + k), y = AV_RN64(b + k);
+
+            i += av_popcount64(x & y);
+            u += av_popcount64(x | y);
+        }
+        inter[w] = i;
+        uni[w]   = u;
+        a += COARSE_WORD_SIZE;
+        b += COARSE_WORD_SIZE;
+    }
+}
+
+static int l1dist_c(const uint8_t *a, const uint8_t *b)
+{
+    int dist = 0;
+
+    for (int k = 0; k < L1PLANES_SIZE; k += 8)
+        dist += av_popcount64(AV_RN64(a + k) ^ AV_RN64(b + k));
+
+    return dist;
+}
+
+static av_unused void ff_signature_init(SignatureDSPContext *dsp)
+{
+    dsp->coarse_popcount = coarse_popcount_c;
+    dsp->l1dist          = l1dist_c;
+
+#if ARCH_X86
+    ff_signature_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_SIGNATUREDSP_H */
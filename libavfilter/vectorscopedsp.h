@@ -0,0 +1,88 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_VECTORSCOPEDSP_H
+#define AVFILTER_VECTORSCOPEDSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+
+typedef struct VectorscopeDSPContext {
+    /**
+     * Merge a row of nb_src per slice accumulation planes, spaced
+     * src_stride elements apart. A source value of 0 means the position
+     * was not hit, any other value v stands for an accumulated v - 1.
+     * The result uses the same coding, with the sum saturated to 65534.
+     * dst may alias src, len must be a multiple of 16.
+     */
+    void (*reduce_sum)(uint16_t *dst, const uint16_t *src, ptrdiff_t src_stride,
+                       int nb_src, int len);
+
+    /**
+     * Per element maximum of nb_src rows spaced src_stride elements apart.
+     * dst may alias src, len must be a multiple of 16.
+     */
+    void (*reduce_max)(uint16_t *dst, const uint16_t *src, ptrdiff_t src_stride,
+                       int nb_src, int len);
+} VectorscopeDSPContext;
+
+void ff_vectorscope_init_x86(VectorscopeDSPContext *dsp);
+
+static void reduce_sum_c(uint16_t *dst, const uint16_t *src, ptrdiff_t src_stride,
+                         int nb_src, int len)
+{
+    for (int i = 0; i < len; i++) {
+        unsigned sum = 0, hit = 0;
+
+        for (int n = 0; n < nb_src; n++) {
+            const unsigned v = src[n * src_stride + i];
+
+            sum += v - !!v;
+            hit |= v;
+        }
+        dst[i] = hit ? FFMIN(sum, 65534) + 1 : 0;
+    }
+}
+
+static void reduce_max_c(uint16_t *dst, const uint16_t *src, ptrdiff_t src_stride,
+                         int nb_src, int len)
+{
+    for (int i = 0; i < len; i++) {
+        unsigned m = 0;
+
+        for (int n = 0; n < nb_src; n++)
+            m = FFMAX(m, src[n * src_stride + i]);
+        dst[i] = m;
+    }
+}
+
+static av_unused void ff_vectorscope_init(VectorscopeDSPContext *dsp)
+{
+    dsp->reduce_sum = reduce_sum_c;
+    dsp->reduce_max = reduce_max_c;
+
+#if ARCH_X86
+    ff_vectorscope_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_VECTORSCOPEDSP_H */
@@ -30,6 +30,7 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/timestamp.h"
 #include "avfilter.h"
+#include "detectdsp.h"
 #include "internal.h"
 #include "video.h"
 
@@ -45,12 +46,15 @@ typedef struct BlackDetectContext {
     double       picture_black_ratio_th;
     double       pixel_black_th;
     unsigned int pixel_black_th_i;
+    int          sample;            ///< count only one row out of this many first
+    int          refine;            ///< counting the rows skipped by the first pass
 
     unsigned int nb_black_pixels;   ///< number of black pixels counted so far
     AVRational   time_base;
     int          depth;
     int          nb_threads;
     unsigned int *counter;
+    DetectDSPContext dsp;
 } BlackDetectContext;
 
 #define OFFSET(x) offsetof(BlackDetectContext, x)
@@ -63,6 +67,7 @@ static const AVOption blackdetect_options[] = {
     { "pic_th",                 "set the picture black ratio threshold", OFFSET(picture_black_ratio_th), AV_OPT_TYPE_DOUBLE, {.dbl=.98}, 0, 1, FLAGS },
     { "pixel_black_th", "set the pixel black threshold", OFFSET(pixel_black_th), AV_OPT_TYPE_DOUBLE, {.dbl=.10}, 0, 1, FLAGS },
     { "pix_th",         "set the pixel black threshold", OFFSET(pixel_black_th), AV_OPT_TYPE_DOUBLE, {.dbl=.10}, 0, 1, FLAGS },
+    { "sample",         "set the row sampling step",     OFFSET(sample),         AV_OPT_TYPE_INT,    {.i64=1},   1, INT_MAX, FLAGS },
     { NULL }
 };
 
@@ -113,6 +118,8 @@ static int config_input(AVFilterLink *inlink)
     if (!s->counter)
         return AVERROR(ENOMEM);
 
+    ff_detectdsp_init(&s->dsp);
+
     av_log(s, AV_LOG_VERBOSE,
            "black_min_duration:%s pixel_black_th:%f picture_black_ratio_th:%f\n",
            av_ts2timestr(s->black_min_duration, &s->time_base),
@@ -137,6 +144,7 @@ static int black_counter(AVFilterContext *ctx, void *arg,
                          int jobnr, int nb_jobs)
 {
     BlackDetectContext *s = ctx->priv;
+    const DetectDSPContext *dsp = &s->dsp;
     const unsigned int threshold = s->pixel_black_th_i;
     unsigned int *counterp = &s->counter[jobnr];
     AVFrame *in = arg;
@@ -145,24 +153,27 @@ static int black_counter(AVFilterContext *ctx, void *arg,
     const int h = in->height;
     const int start = (h * jobnr) / nb_jobs;
     const int end = (h * (jobnr+1)) / nb_jobs;
-    const int size = end - start;
     unsigned int counter = 0;
 
-    if (s->depth == 8) {
-        const uint8_t *p = in->data[0] + start * linesize;
-
-        for (int i = 0; i < size; i++) {
-            for (int x = 0; x < w; x++)
-                counter += p[x] <= threshold;
-            p += linesize;
-        }
-    } else {
-        const uint16_t *p = (const uint16_t *)(in->data[0] + start * linesize);
-
-        for (int i = 0; i < size; i++) {
-            for (int x = 0; x < w; x++)
-                counter += p[x] <= threshold;
-            p += linesize / 2;
+    for (int y = start; y < end; y++) {
+        // the first pass takes every sample-th row, the second one the rest
+        if ((y % s->sample == 0) == s->refine)
+            continue;
+
+        if (s->depth == 8) {
+            const uint8_t *p = in->data[0] + y * linesize;
+            const int n = w & ~31;
+
+            if (n)
+                counter += dsp->count_le8(p, n, threshold);
+            counter += count_le8_c(p + n, w - n, threshold);
+        } else {
+            const uint16_t *p = (const uint16_t *)(in->data[0] + y * linesize);
+            const int n = w & ~15;
+
+            if (n)
+                counter += dsp->count_le16(p, n, threshold);
+            counter += count_le16_c(p + n, w - n, threshold);
         }
     }
 
@@ -176,6 +187,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
     AVFilterContext *ctx = inlink->dst;
     BlackDetectContext *s = ctx->priv;
     double picture_black_ratio = 0;
+    int64_t nb_counted = inlink->w * inlink->h;
     const int max = (1 << s->depth) - 1;
     const int factor = (1 << (s->depth - 8));
     const int full = picref->color_range == AVCOL_RANGE_JPEG ||
@@ -185,13 +197,34 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
         // luminance_minimum_value + pixel_black_th * luminance_range_size
         16 * factor + s->pixel_black_th * (235 - 16) * factor;
 
+    s->refine = 0;
     ff_filter_execute(ctx, black_counter, picref, NULL,
                       FFMIN(inlink->h, s->nb_threads));
 
     for (int i = 0; i < s->nb_threads; i++)
         s->nb_black_pixels += s->counter[i];
 
-    picture_black_ratio = (double)s->nb_black_pixels / (inlink->w * inlink->h);
+    if (s->sample > 1) {
+        const int nb_rows = (picref->height - 1) / s->sample + 1;
+        const int64_t nb_sampled = (int64_t)nb_rows * picref->width;
+        const int64_t non_black = nb_sampled - s->nb_black_pixels;
+
+        /* The sampled rows alone may hold too many non-black pixels for the
+         * picture to reach the ratio threshold; if they do not, count the
+         * remaining rows too, so that the outcome stays exact. */
+        if (non_black > (1. - s->picture_black_ratio_th) * nb_counted + 1) {
+            nb_counted = nb_sampled;
+        } else {
+            s->refine = 1;
+            ff_filter_execute(ctx, black_counter, picref, NULL,
+                              FFMIN(inlink->h, s->nb_threads));
+
+            for (int i = 0; i < s->nb_threads; i++)
+                s->nb_black_pixels += s->counter[i];
+        }
+    }
+
+    picture_black_ratio = (double)s->nb_black_pixels / nb_counted;
 
     av_log(ctx, AV_LOG_DEBUG,
            "frame:%"PRId64" picture_black_ratio:%f pts:%s t:%s type:%c\n",
@@ -26,6 +26,7 @@
  */
 
 #include "libavutil/common.h"
+#include "libavutil/imgutils.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "avfilter.h"
@@ -33,6 +34,7 @@
 #include "internal.h"
 #include "video.h"
 #include "boxblur.h"
+#include "boxblurdsp.h"
 
 
 typedef struct BoxBlurContext {
@@ -44,15 +46,30 @@ typedef struct BoxBlurContext {
     int hsub, vsub;
     int radius[4];
     int power[4];
-    uint8_t *temp[2]; ///< temporary buffer used in blur_power()
+    int pixsize;
+    int nb_threads;
+
+    BoxBlurDSPContext dsp;
+    uint8_t *temp[2];        ///< planes holding the horizontal and intermediate vertical passes
+    ptrdiff_t temp_linesize;
+    uint8_t *row_temp;       ///< one row per job for repeated horizontal passes
+    int row_temp_size;
+    uint32_t *sums;          ///< running sums of the vertical passes, one per column
 } BoxBlurContext;
 
+typedef struct ThreadData {
+    AVFrame *in, *out;
+    int plane, w, h;
+} ThreadData;
+
 static av_cold void uninit(AVFilterContext *ctx)
 {
     BoxBlurContext *s = ctx->priv;
 
     av_freep(&s->temp[0]);
     av_freep(&s->temp[1]);
+    av_freep(&s->row_temp);
+    av_freep(&s->sums);
 }
 
 static int query_formats(AVFilterContext *ctx)
@@ -80,10 +97,20 @@ static int config_input(AVFilterLink *inlink)
     int w = inlink->w, h = inlink->h;
     int ret;
 
-    if (!(s->temp[0] = av_malloc(2*FFMAX(w, h))) ||
-        !(s->temp[1] = av_malloc(2*FFMAX(w, h))))
+    s->pixsize = (desc->comp[0].depth + 7) / 8;
+    s->nb_threads = ff_filter_get_nb_threads(ctx);
+    s->temp_linesize = FFALIGN(w * s->pixsize, 64);
+    s->row_temp_size = FFALIGN(w * s->pixsize, 64);
+
+    uninit(ctx);
+    if (!(s->temp[0]  = av_calloc(h, s->temp_linesize)) ||
+        !(s->temp[1]  = av_calloc(h, s->temp_linesize)) ||
+        !(s->row_temp = av_calloc(s->nb_threads, s->row_temp_size)) ||
+        !(s->sums     = av_calloc(w, sizeof(*s->sums))))
         return AVERROR(ENOMEM);
 
+    ff_boxblur_init(&s->dsp);
+
     s->hsub = desc->log2_chroma_w;
     s->vsub = desc->log2_chroma_h;
 
@@ -124,31 +151,40 @@ static int config_input(AVFilterLink *inlink)
  * The following code adopts this faster variant.
  */
 #define BLUR(type, depth)                                                   \
-static inline void blur ## depth(type *dst, int dst_step, const type *src,  \
-                                 int src_step, int len, int radius)         \
+static void blur ## depth(const BoxBlurDSPContext *dsp, type *dst,          \
+                          const type *src, int len, int radius)             \
 {                                                                           \
     const int length = radius*2 + 1;                                        \
     const int inv = ((1<<16) + length/2)/length;                            \
-    int x, sum = src[radius*src_step];                                      \
+    unsigned sum = src[radius];                                             \
+    int x, n;                                                               \
                                                                             \
     for (x = 0; x < radius; x++)                                            \
-        sum += src[x*src_step]<<1;                                          \
+        sum += src[x]<<1;                                                   \
                                                                             \
     sum = sum*inv + (1<<15);                                                \
                                                                             \
+    /* with radius == len/2 the last sample added here is mirrored too */   \
     for (x = 0; x <= radius; x++) {                                         \
-        sum += (src[(radius+x)*src_step] - src[(radius-x)*src_step])*inv;   \
-        dst[x*dst_step] = sum>>16;                                          \
+        sum += (src[FFMIN(radius+x, 2*len-radius-x-1)] - src[radius-x])*inv;\
+        dst[x] = sum>>16;                                                   \
+    }                                                                       \
+                                                                            \
+    n = FFMAX(len - radius - x, 0) & ~3;                                    \
+    if (n) {                                                                \
+        sum = dsp->hstep ## depth(dst + x, src + radius + x,                \
+                                  src + x - radius - 1, inv, sum, n);       \
+        x += n;                                                             \
     }                                                                       \
                                                                             \
     for (; x < len-radius; x++) {                                           \
-        sum += (src[(radius+x)*src_step] - src[(x-radius-1)*src_step])*inv; \
-        dst[x*dst_step] = sum >>16;                                         \
+        sum += (src[radius+x] - src[x-radius-1])*inv;                       \
+        dst[x] = sum >>16;                                                  \
     }                                                                       \
                                                                             \
     for (; x < len; x++) {                                                  \
-        sum += (src[(2*len-radius-x-1)*src_step] - src[(x-radius-1)*src_step])*inv; \
-        dst[x*dst_step] = sum>>16;                                          \
+        sum += (src[2*len-radius-x-1] - src[x-radius-1])*inv;               \
+        dst[x] = sum>>16;                                                   \
     }                                                                       \
 }
 
@@ -157,71 +193,123 @@ BLUR(uint16_t, 16)
 
 #undef BLUR
 
-static inline void blur(uint8_t *dst, int dst_step, const uint8_t *src, int src_step,
+static inline void blur(const BoxBlurDSPContext *dsp, uint8_t *dst, const uint8_t *src,
                         int len, int radius, int pixsize)
 {
-    if (pixsize == 1) blur8 (dst, dst_step   , src, src_step   , len, radius);
-    else              blur16((uint16_t*)dst, dst_step>>1, (const uint16_t*)src, src_step>>1, len, radius);
+    if (pixsize == 1) blur8 (dsp, dst, src, len, radius);
+    else              blur16(dsp, (uint16_t*)dst, (const uint16_t*)src, len, radius);
 }
 
-static inline void blur_power(uint8_t *dst, int dst_step, const uint8_t *src, int src_step,
-                              int len, int radius, int power, uint8_t *temp[2], int pixsize)
-{
-    uint8_t *a = temp[0], *b = temp[1];
-
-    if (radius && power) {
-        blur(a, pixsize, src, src_step, len, radius, pixsize);
-        for (; power > 2; power--) {
-            uint8_t *c;
-            blur(b, pixsize, a, pixsize, len, radius, pixsize);
-            c = a; a = b; b = c;
-        }
-        if (power > 1) {
-            blur(dst, dst_step, a, pixsize, len, radius, pixsize);
-        } else {
-            int i;
-            if (pixsize == 1) {
-                for (i = 0; i < len; i++)
-                    dst[i*dst_step] = a[i];
-            } else
-                for (i = 0; i < len; i++)
-                    *(uint16_t*)(dst + i*dst_step) = ((uint16_t*)a)[i];
-        }
-    } else {
-        int i;
-        if (pixsize == 1) {
-            for (i = 0; i < len; i++)
-                dst[i*dst_step] = src[i*src_step];
-        } else
-            for (i = 0; i < len; i++)
-                *(uint16_t*)(dst + i*dst_step) = *(uint16_t*)(src + i*src_step);
-    }
+/* The vertical passes run the same sliding window on whole rows,
+ * keeping one running sum per column, so that they vectorize along
+ * the row instead of walking down single columns. */
+#define VBLUR(type, depth)                                                  \
+static void vblur ## depth(const BoxBlurDSPContext *dsp, type *dst,         \
+                           ptrdiff_t dst_linesize, const type *src,         \
+                           ptrdiff_t src_linesize, uint32_t *sums,          \
+                           int w, int h, int radius)                        \
+{                                                                           \
+    const int length = radius*2 + 1;                                        \
+    const int inv = ((1<<16) + length/2)/length;                            \
+    const int wa = w & ~15;                                                 \
+    int x, y;                                                               \
+                                                                            \
+    for (x = 0; x < w; x++)                                                 \
+        sums[x] = src[radius*src_linesize + x];                             \
+    for (y = 0; y < radius; y++)                                            \
+        for (x = 0; x < w; x++)                                             \
+            sums[x] += src[y*src_linesize + x]<<1;                          \
+    for (x = 0; x < w; x++)                                                 \
+        sums[x] = sums[x]*inv + (1<<15);                                    \
+                                                                            \
+    for (y = 0; y < h; y++) {                                               \
+        const type *add, *sub;                                              \
+        type *d = dst + y*dst_linesize;                                     \
+                                                                            \
+        if (y <= radius) {                                                  \
+            add = src + FFMIN(radius+y, 2*h-radius-y-1)*src_linesize;       \
+            sub = src + (radius-y)*src_linesize;                            \
+        } else if (y < h-radius) {                                          \
+            add = src + (radius+y)*src_linesize;                            \
+            sub = src + (y-radius-1)*src_linesize;                          \
+        } else {                                                            \
+            add = src + (2*h-radius-y-1)*src_linesize;                      \
+            sub = src + (y-radius-1)*src_linesize;                          \
+        }                                                                   \
+                                                                            \
+        if (wa)                                                             \
+            dsp->vstep ## depth(d, sums, add, sub, inv, wa);                \
+        vstep ## depth ## _c(d + wa, sums + wa, add + wa, sub + wa,         \
+                             inv, w - wa);                                  \
+    }                                                                       \
 }
 
-static void hblur(uint8_t *dst, int dst_linesize, const uint8_t *src, int src_linesize,
-                  int w, int h, int radius, int power, uint8_t *temp[2], int pixsize)
-{
-    int y;
+VBLUR(uint8_t,   8)
+VBLUR(uint16_t, 16)
 
-    if (radius == 0 && dst == src)
-        return;
+#undef VBLUR
 
-    for (y = 0; y < h; y++)
-        blur_power(dst + y*dst_linesize, pixsize, src + y*src_linesize, pixsize,
-                   w, radius, power, temp, pixsize);
+static inline void vblur(const BoxBlurDSPContext *dsp, uint8_t *dst, ptrdiff_t dst_linesize,
+                         const uint8_t *src, ptrdiff_t src_linesize, uint32_t *sums,
+                         int w, int h, int radius, int pixsize)
+{
+    if (pixsize == 1) vblur8 (dsp, dst, dst_linesize, src, src_linesize, sums, w, h, radius);
+    else              vblur16(dsp, (uint16_t*)dst, dst_linesize>>1, (const uint16_t*)src,
+                              src_linesize>>1, sums, w, h, radius);
 }
 
-static void vblur(uint8_t *dst, int dst_linesize, const uint8_t *src, int src_linesize,
-                  int w, int h, int radius, int power, uint8_t *temp[2], int pixsize)
+static int hblur_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
-    int x;
+    BoxBlurContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const int plane = td->plane;
+    const int radius = s->radius[plane];
+    const int power = s->power[plane];
+    const int slice_start = (td->h *  jobnr     ) / nb_jobs;
+    const int slice_end   = (td->h * (jobnr + 1)) / nb_jobs;
+    uint8_t *tmp = s->row_temp + jobnr * s->row_temp_size;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        const uint8_t *src = td->in->data[plane] + y * td->in->linesize[plane];
+        uint8_t *dst = s->temp[0] + y * s->temp_linesize;
+        /* ping-pong so that the last pass lands in dst */
+        uint8_t *a = power & 1 ? dst : tmp;
+        uint8_t *b = power & 1 ? tmp : dst;
+
+        blur(&s->dsp, a, src, td->w, radius, s->pixsize);
+        for (int p = 1; p < power; p++) {
+            blur(&s->dsp, b, a, td->w, radius, s->pixsize);
+            FFSWAP(uint8_t *, a, b);
+        }
+    }
+
+    return 0;
+}
 
-    if (radius == 0 && dst == src)
-        return;
+static int vblur_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    BoxBlurContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const int plane = td->plane;
+    const int radius = s->radius[plane];
+    const int power = s->power[plane];
+    const int blocks = td->w >> 4;
+    const int slice_start = ((blocks * jobnr) / nb_jobs) << 4;
+    const int slice_end   = jobnr == nb_jobs - 1 ? td->w : ((blocks * (jobnr + 1)) / nb_jobs) << 4;
+    const int offset = slice_start * s->pixsize;
+    const int w = slice_end - slice_start;
+    uint8_t *buf[2] = { s->temp[0] + offset, s->temp[1] + offset };
+    int cur = 0;
+
+    for (int p = 1; p < power; p++) {
+        vblur(&s->dsp, buf[!cur], s->temp_linesize, buf[cur], s->temp_linesize,
+              s->sums + slice_start, w, td->h, radius, s->pixsize);
+        cur = !cur;
+    }
+    vblur(&s->dsp, td->out->data[plane] + offset, td->out->linesize[plane],
+          buf[cur], s->temp_linesize, s->sums + slice_start, w, td->h, radius, s->pixsize);
 
-    for (x = 0; x < w; x++)
-        blur_power(dst + x*pixsize, dst_linesize, src + x*pixsize, src_linesize,
-                   h, radius, power, temp, pixsize);
+    return 0;
 }
 
 static int filter_frame(AVFilterLink *inlink, AVFrame *in)
@@ -234,9 +322,6 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     int cw = AV_CEIL_RSHIFT(inlink->w, s->hsub), ch = AV_CEIL_RSHIFT(in->height, s->vsub);
     int w[4] = { inlink->w, cw, cw, inlink->w };
     int h[4] = { in->height, ch, ch, in->height };
-    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
-    const int depth = desc->comp[0].depth;
-    const int pixsize = (depth+7)/8;
 
     out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
     if (!out) {
@@ -245,17 +330,26 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     }
     av_frame_copy_props(out, in);
 
-    for (plane = 0; plane < 4 && in->data[plane] && in->linesize[plane]; plane++)
-        hblur(out->data[plane], out->linesize[plane],
-              in ->data[plane], in ->linesize[plane],
-              w[plane], h[plane], s->radius[plane], s->power[plane],
-              s->temp, pixsize);
+    for (plane = 0; plane < 4 && in->data[plane] && in->linesize[plane]; plane++) {
+        ThreadData td;
+
+        if (!s->radius[plane] || !s->power[plane]) {
+            av_image_copy_plane(out->data[plane], out->linesize[plane],
+                                in ->data[plane], in ->linesize[plane],
+                                w[plane] * s->pixsize, h[plane]);
+            continue;
+        }
 
-    for (plane = 0; plane < 4 && in->data[plane] && in->linesize[plane]; plane++)
-        vblur(out->data[plane], out->linesize[plane],
-              out->data[plane], out->linesize[plane],
-              w[plane], h[plane], s->radius[plane], s->power[plane],
-              s->temp, pixsize);
+        td.in    = in;
+        td.out   = out;
+        td.plane = plane;
+        td.w     = w[plane];
+        td.h     = h[plane];
+        ff_filter_execute(ctx, hblur_slice, &td, NULL,
+                          FFMIN(h[plane], s->nb_threads));
+        ff_filter_execute(ctx, vblur_slice, &td, NULL,
+                          av_clip(w[plane] >> 4, 1, s->nb_threads));
+    }
 
     av_frame_free(&in);
 
@@ -304,5 +398,5 @@ const AVFilter ff_vf_boxblur = {
     FILTER_INPUTS(avfilter_vf_boxblur_inputs),
     FILTER_OUTPUTS(ff_video_default_filterpad),
     FILTER_QUERY_FUNC(query_formats),
-    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC,
+    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -31,6 +31,7 @@
 #include "libavutil/qsort.h"
 
 #include "avfilter.h"
+#include "detectdsp.h"
 #include "internal.h"
 #include "video.h"
 #include "edge_common.h"
@@ -43,6 +44,7 @@ typedef struct CropDetectContext {
     int round;
     int skip;
     int reset_count;
+    int sample;
     int frame_nb;
     int max_pixsteps[4];
     int max_outliers;
@@ -57,8 +59,18 @@ typedef struct CropDetectContext {
     uint16_t *gradients;
     char     *directions;
     int      *bboxes[4];
+    int      *row_avg;
+    int      *col_avg;
+    uint32_t *col_sums;
+    int       nb_threads;
+    DetectDSPContext dsp;
 } CropDetectContext;
 
+typedef struct ThreadData {
+    AVFrame *in;
+    int x1, y1, x2, y2;
+} ThreadData;
+
 static const enum AVPixelFormat pix_fmts[] = {
     AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUVJ420P,
     AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUVJ422P,
@@ -87,59 +99,130 @@ static int comp(const int *a,const int *b)
     return FFDIFFSIGN(*a, *b);
 }
 
-static int checkline(void *ctx, const unsigned char *src, int stride, int len, int bpp)
+static int row_average(const DetectDSPContext *dsp, const uint8_t *src,
+                       int len, int bpp)
 {
-    int total = 0;
+    unsigned total = 0;
     int div = len;
-    const uint16_t *src16 = (const uint16_t *)src;
+    int n;
 
     switch (bpp) {
     case 1:
-        while (len >= 8) {
-            total += src[       0] + src[  stride] + src[2*stride] + src[3*stride]
-                  +  src[4*stride] + src[5*stride] + src[6*stride] + src[7*stride];
-            src += 8*stride;
-            len -= 8;
-        }
-        while (--len >= 0) {
-            total += src[0];
-            src += stride;
-        }
+        n = len & ~31;
+        if (n)
+            total = dsp->sum8(src, n);
+        total += sum8_c(src + n, len - n);
         break;
     case 2:
-        stride >>= 1;
-        while (len >= 8) {
-            total += src16[       0] + src16[  stride] + src16[2*stride] + src16[3*stride]
-                  +  src16[4*stride] + src16[5*stride] + src16[6*stride] + src16[7*stride];
-            src16 += 8*stride;
-            len -= 8;
-        }
-        while (--len >= 0) {
-            total += src16[0];
-            src16 += stride;
-        }
+        n = len & ~15;
+        if (n)
+            total = dsp->sum16((const uint16_t *)src, n);
+        total += sum16_c((const uint16_t *)src + n, len - n);
         break;
     case 3:
+        n = (3 * len) & ~31;
+        if (n)
+            total = dsp->sum8(src, n);
+        total += sum8_c(src + n, 3 * len - n);
+        div *= 3;
+        break;
     case 4:
-        while (len >= 4) {
-            total += src[0]        + src[1         ] + src[2         ]
-                  +  src[  stride] + src[1+  stride] + src[2+  stride]
-                  +  src[2*stride] + src[1+2*stride] + src[2+2*stride]
-                  +  src[3*stride] + src[1+3*stride] + src[2+3*stride];
-            src += 4*stride;
-            len -= 4;
-        }
-        while (--len >= 0) {
-            total += src[0] + src[1] + src[2];
-            src += stride;
-        }
+        for (int x = 0; x < len; x++)
+            total += src[4 * x] + src[4 * x + 1] + src[4 * x + 2];
         div *= 3;
         break;
     }
-    total /= div;
 
-    av_log(ctx, AV_LOG_DEBUG, "total:%d\n", total);
-    return total;
+    return total / div;
+}
+
+static void add_columns(const DetectDSPContext *dsp, uint32_t *acc,
+                        const uint8_t *src, int start, int end, int bpp)
+{
+    if (bpp == 2) {
+        const uint16_t *src16 = (const uint16_t *)src;
+        const int n = (end - start) & ~15;
+
+        if (n)
+            dsp->colsum16(acc + start, src16 + start, n);
+        colsum16_c(acc + start + n, src16 + start + n, end - start - n);
+    } else {
+        const int n = (end - start) & ~31;
+
+        if (n)
+            dsp->colsum8(acc + start, src + start, n);
+        colsum8_c(acc + start + n, src + start + n, end - start - n);
+    }
+}
+
+/*
+ * Compute the averages of the rows and columns that lie outside of the
+ * current crop area, which are the only ones the scans below can visit.
+ * Columns are summed row by row, each job into its own accumulators.
+ */
+static int line_averages(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    CropDetectContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const AVFrame *in = td->in;
+    const int bpp = s->max_pixsteps[0];
+    const int nb_comp = bpp == 2 ? 1 : bpp;
+    const int size = in->width * nb_comp;
+    const int start = (in->height * jobnr) / nb_jobs;
+    const int end = (in->height * (jobnr+1)) / nb_jobs;
+    uint32_t *acc = s->col_sums + jobnr * size;
+    int left = td->x1 * nb_comp;
+    int right = (td->x2 + 1) * nb_comp;
+
+    if (left >= right) {
+        left  = size;
+        right = size;
+    }
+
+    memset(acc, 0, size * sizeof(*acc));
+
+    for (int y = start; y < end; y++) {
+        const uint8_t *src = in->data[0] + y * in->linesize[0];
+
+        if (y < td->y1 || y > td->y2)
+            s->row_avg[y] = row_average(&s->dsp, src, in->width, bpp);
+        add_columns(&s->dsp, acc, src, 0, left, bpp);
+        add_columns(&s->dsp, acc, src, right, size, bpp);
+    }
+
+    return 0;
+}
+
+static void scan_lines(AVFilterContext *ctx, AVFrame *frame)
+{
+    CropDetectContext *s = ctx->priv;
+    const int bpp = s->max_pixsteps[0];
+    const int nb_comp = bpp == 2 ? 1 : bpp;
+    const int size = frame->width * nb_comp;
+    const int div = frame->height * (bpp >= 3 ? 3 : 1);
+    const int nb_jobs = FFMIN(frame->height, s->nb_threads);
+    ThreadData td = { .in = frame, .x1 = s->x1, .y1 = s->y1, .x2 = s->x2, .y2 = s->y2 };
+
+    if (s->x1 <= 0 && s->y1 <= 0 &&
+        s->x2 >= frame->width - 1 && s->y2 >= frame->height - 1)
+        return;
+
+    ff_filter_execute(ctx, line_averages, &td, NULL, nb_jobs);
+
+    for (int x = 0; x < frame->width; x++) {
+        unsigned total = 0;
+
+        if (x >= s->x1 && x <= s->x2)
+            continue;
+        for (int j = 0; j < nb_jobs; j++) {
+            const uint32_t *acc = s->col_sums + j * size + x * nb_comp;
+
+            total += acc[0];
+            if (bpp >= 3)
+                total += acc[1] + acc[2];
+        }
+        s->col_avg[x] = total / div;
+    }
 }
 
 static int checkline_edge(void *ctx, const unsigned char *src, int stride, int len, int bpp)
@@ -198,6 +281,9 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_freep(&s->bboxes[1]);
     av_freep(&s->bboxes[2]);
     av_freep(&s->bboxes[3]);
+    av_freep(&s->row_avg);
+    av_freep(&s->col_avg);
+    av_freep(&s->col_sums);
 }
 
 static int config_input(AVFilterLink *inlink)
@@ -235,6 +321,16 @@ static int config_input(AVFilterLink *inlink)
         !s->bboxes[0] || !s->bboxes[1] || !s->bboxes[2] || !s->bboxes[3])
         return AVERROR(ENOMEM);
 
+    s->nb_threads = ff_filter_get_nb_threads(ctx);
+    s->row_avg    = av_malloc_array(inlink->h, sizeof(*s->row_avg));
+    s->col_avg    = av_malloc_array(inlink->w, sizeof(*s->col_avg));
+    s->col_sums   = av_malloc_array(s->nb_threads * inlink->w,
+                                    s->max_pixsteps[0] * sizeof(*s->col_sums));
+    if (!s->row_avg || !s->col_avg || !s->col_sums)
+        return AVERROR(ENOMEM);
+
+    ff_detectdsp_init(&s->dsp);
+
     return 0;
 }
 
@@ -259,7 +355,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
     uint16_t *gradients = s->gradients;
     int8_t *directions  = s->directions;
     const AVFrameSideData *sd = NULL;
-    int scan_w, scan_h, bboff;
+    int scan_w, scan_h, bboff, analyze;
 
     void (*sobel)(int w, int h, uint16_t *dst, int dst_linesize,
                   int8_t *dir, int dir_linesize,
@@ -282,10 +378,14 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
             s->frame_nb = 1;
         }
 
-#define FIND(DST, FROM, NOEND, INC, STEP0, STEP1, LEN) \
+        // only analyze one frame out of s->sample, the others keep its area
+        analyze = (s->frame_nb - 1) % s->sample == 0;
+
+#define FIND(DST, FROM, NOEND, INC, AVG) \
         outliers = 0;\
         for (last_y = y = FROM; NOEND; y = y INC) {\
-            if (checkline(ctx, frame->data[0] + STEP0 * y, STEP1, LEN, bpp) > limit_upscaled) {\
+            av_log(ctx, AV_LOG_DEBUG, "total:%d\n", AVG[y]);\
+            if (AVG[y] > limit_upscaled) {\
                 if (++outliers > s->max_outliers) { \
                     DST = last_y;\
                     break;\
@@ -294,12 +394,14 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
                 last_y = y INC;\
         }
 
-        if (s->mode == MODE_BLACK) {
-            FIND(s->y1,                 0,               y < s->y1, +1, frame->linesize[0], bpp, frame->width);
-            FIND(s->y2, frame->height - 1, y > FFMAX(s->y2, s->y1), -1, frame->linesize[0], bpp, frame->width);
-            FIND(s->x1,                 0,               y < s->x1, +1, bpp, frame->linesize[0], frame->height);
-            FIND(s->x2,  frame->width - 1, y > FFMAX(s->x2, s->x1), -1, bpp, frame->linesize[0], frame->height);
-        } else { // MODE_MV_EDGES
+        if (s->mode == MODE_BLACK && analyze) {
+            scan_lines(ctx, frame);
+
+            FIND(s->y1,                 0,               y < s->y1, +1, s->row_avg);
+            FIND(s->y2, frame->height - 1, y > FFMAX(s->y2, s->y1), -1, s->row_avg);
+            FIND(s->x1,                 0,               y < s->x1, +1, s->col_avg);
+            FIND(s->x2,  frame->width - 1, y > FFMAX(s->x2, s->x1), -1, s->col_avg);
+        } else if (s->mode == MODE_MV_EDGES && analyze) {
             sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
             s->x1 = 0;
             s->y1 = 0;
@@ -377,14 +479,14 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
                 FIND_EDGE(s->x2, s->x2, y < inw, +1, bpp, inw, scan_h);
 
                 // queue bboxes
-                bboff = (s->frame_nb - 1) % s->window_size;
+                bboff = (s->frame_nb - 1) / s->sample % s->window_size;
                 s->bboxes[0][bboff] = s->x1;
                 s->bboxes[1][bboff] = s->x2;
                 s->bboxes[2][bboff] = s->y1;
                 s->bboxes[3][bboff] = s->y2;
 
                 // sort queue
-                bboff = FFMIN(s->frame_nb, s->window_size);
+                bboff = FFMIN((s->frame_nb - 1) / s->sample + 1, s->window_size);
                 AV_QSORT(s->bboxes[0], bboff, int, comp);
                 AV_QSORT(s->bboxes[1], bboff, int, comp);
                 AV_QSORT(s->bboxes[2], bboff, int, comp);
@@ -475,6 +577,7 @@ static const AVOption cropdetect_options[] = {
     { "skip",  "Number of initial frames to skip",                    OFFSET(skip),        AV_OPT_TYPE_INT, { .i64 = 2 },  0, INT_MAX, FLAGS },
     { "reset_count", "Recalculate the crop area after this many frames",OFFSET(reset_count),AV_OPT_TYPE_INT,{ .i64 = 0 },  0, INT_MAX, FLAGS },
     { "max_outliers", "Threshold count of outliers",                  OFFSET(max_outliers),AV_OPT_TYPE_INT, { .i64 = 0 },  0, INT_MAX, FLAGS },
+    { "sample", "Analyze one frame out of this many",                 OFFSET(sample),      AV_OPT_TYPE_INT, { .i64 = 1 },  1, INT_MAX, FLAGS },
     { "mode", "set mode", OFFSET(mode), AV_OPT_TYPE_INT, {.i64=MODE_BLACK}, 0, MODE_NB-1, FLAGS, .unit = "mode" },
         { "black",    "detect black pixels surrounding the video",     0, AV_OPT_TYPE_CONST, {.i64=MODE_BLACK},    INT_MIN, INT_MAX, FLAGS, .unit = "mode" },
         { "mvedges",  "detect motion and edged surrounding the video", 0, AV_OPT_TYPE_CONST, {.i64=MODE_MV_EDGES}, INT_MIN, INT_MAX, FLAGS, .unit = "mode" },
@@ -505,6 +608,7 @@ const AVFilter ff_vf_cropdetect = {
     FILTER_INPUTS(avfilter_vf_cropdetect_inputs),
     FILTER_OUTPUTS(ff_video_default_filterpad),
     FILTER_PIXFMTS_ARRAY(pix_fmts),
-    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_METADATA_ONLY,
+    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_METADATA_ONLY |
+                     AVFILTER_FLAG_SLICE_THREADS,
     .process_command = process_command,
 };
@@ -23,6 +23,7 @@
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
 #include "avfilter.h"
+#include "decimatedsp.h"
 #include "filters.h"
 #include "internal.h"
 
@@ -52,6 +53,10 @@ typedef struct DecimateContext {
     int nxblocks, nyblocks;
     int bdiffsize;
     int64_t *bdiffs;
+    uint32_t *group_sums;   ///< per-job SADs of 8-sample groups within a block row
+    int nb_groups;
+    int nb_threads;
+    DecimateDSPContext dsp;
     AVRational in_tb;       // input time-base
     AVRational nondec_tb;   // non-decimated time-base
     AVRational dec_tb;      // decimated time-base
@@ -68,6 +73,10 @@ typedef struct DecimateContext {
     int mixed;
 } DecimateContext;
 
+typedef struct ThreadData {
+    const AVFrame *f1, *f2;
+} ThreadData;
+
 #define OFFSET(x) offsetof(DecimateContext, x)
 #define FLAGS AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_FILTERING_PARAM
 
@@ -85,35 +94,86 @@ static const AVOption decimate_options[] = {
 
 AVFILTER_DEFINE_CLASS(decimate);
 
-static void calc_diffs(const DecimateContext *dm, struct qitem *q,
-                       const AVFrame *f1, const AVFrame *f2)
+/*
+ * Each job handles a range of block rows, so that the jobs update disjoint
+ * parts of bdiffs. When the half blocks are at least 8 samples wide, the
+ * differences are first gathered per group of 8 samples over the rows of a
+ * block row, then added to the blocks.
+ */
+static int calc_diffs_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
-    int64_t maxdiff = -1;
+    const DecimateContext *dm = ctx->priv;
+    const DecimateDSPContext *dsp = &dm->dsp;
+    const ThreadData *td = arg;
+    const AVFrame *f1 = td->f1;
+    const AVFrame *f2 = td->f2;
+    const int slice_start = (dm->nyblocks * jobnr) / nb_jobs;
+    const int slice_end = (dm->nyblocks * (jobnr+1)) / nb_jobs;
+    uint32_t *group_sums = dm->group_sums + jobnr * dm->nb_groups;
     int64_t *bdiffs = dm->bdiffs;
-    int plane, i, j;
-
-    memset(bdiffs, 0, dm->bdiffsize * sizeof(*bdiffs));
+    int plane;
 
     for (plane = 0; plane < (dm->chroma && f1->data[2] ? 3 : 1); plane++) {
         int x, y, xl;
         const int linesize1 = f1->linesize[plane];
         const int linesize2 = f2->linesize[plane];
-        const uint8_t *f1p = f1->data[plane];
-        const uint8_t *f2p = f2->data[plane];
         int width    = plane ? AV_CEIL_RSHIFT(f1->width,  dm->hsub) : f1->width;
         int height   = plane ? AV_CEIL_RSHIFT(f1->height, dm->vsub) : f1->height;
         int hblockx  = dm->blockx / 2;
         int hblocky  = dm->blocky / 2;
+        const int nb_groups = (width + 7) >> 3;
+        const int main_width = width & ~31;
+        int start, end;
+        const uint8_t *f1p, *f2p;
 
         if (plane) {
             hblockx >>= dm->hsub;
             hblocky >>= dm->vsub;
         }
 
-        for (y = 0; y < height; y++) {
+        start = FFMIN(slice_start * hblocky, height);
+        end   = FFMIN(slice_end   * hblocky, height);
+        f1p   = f1->data[plane] + start * linesize1;
+        f2p   = f2->data[plane] + start * linesize2;
+
+        for (y = start; y < end; y++) {
             int ydest = y / hblocky;
             int xdest = 0;
 
+            if (hblockx >= 8) {
+                const int last_row = y == end - 1 || (y + 1) % hblocky == 0;
+
+                if (y % hblocky == 0 || y == start)
+                    memset(group_sums, 0, nb_groups * sizeof(*group_sums));
+
+                if (dm->depth == 8) {
+                    if (main_width)
+                        dsp->sad_groups8(group_sums, f1p, f2p, main_width);
+                    sad_groups8_c(group_sums + main_width / 8, f1p + main_width,
+                                  f2p + main_width, width - main_width);
+                } else {
+                    const uint16_t *f1p16 = (const uint16_t *)f1p;
+                    const uint16_t *f2p16 = (const uint16_t *)f2p;
+
+                    if (main_width)
+                        dsp->sad_groups16(group_sums, f1p16, f2p16, main_width);
+                    sad_groups16_c(group_sums + main_width / 8, f1p16 + main_width,
+                                   f2p16 + main_width, width - main_width);
+                }
+
+                if (last_row) {
+                    const int groups_per_block = hblockx >> 3;
+
+                    for (x = 0; x < nb_groups; x += groups_per_block) {
+                        int64_t acc = 0;
+                        int m = FFMIN(nb_groups, x + groups_per_block);
+                        for (xl = x; xl < m; xl++)
+                            acc += group_sums[xl];
+                        bdiffs[ydest * dm->nxblocks + xdest] += acc;
+                        xdest++;
+                    }
+                }
+            } else {
 #define CALC_DIFF(nbits) do {                               \
     for (x = 0; x < width; x += hblockx) {                  \
         int64_t acc = 0;                                    \
@@ -125,14 +185,32 @@ static void calc_diffs(const DecimateContext *dm, struct qitem *q,
         xdest++;                                            \
     }                                                       \
 } while (0)
-            if (dm->depth == 8) CALC_DIFF(8);
-            else                CALC_DIFF(16);
+                if (dm->depth == 8) CALC_DIFF(8);
+                else                CALC_DIFF(16);
+            }
 
             f1p += linesize1;
             f2p += linesize2;
         }
     }
 
+    return 0;
+}
+
+static void calc_diffs(AVFilterContext *ctx, struct qitem *q,
+                       const AVFrame *f1, const AVFrame *f2)
+{
+    const DecimateContext *dm = ctx->priv;
+    int64_t maxdiff = -1;
+    int64_t *bdiffs = dm->bdiffs;
+    ThreadData td = { .f1 = f1, .f2 = f2 };
+    int i, j;
+
+    memset(bdiffs, 0, dm->bdiffsize * sizeof(*bdiffs));
+
+    ff_filter_execute(ctx, calc_diffs_slice, &td, NULL,
+                      FFMIN(dm->nyblocks, dm->nb_threads));
+
     for (i = 0; i < dm->nyblocks - 1; i++) {
         for (j = 0; j < dm->nxblocks - 1; j++) {
             int64_t tmp = bdiffs[      i * dm->nxblocks + j    ]
@@ -181,7 +259,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
             dm->queue[dm->fid].maxbdiff = INT64_MAX;
             dm->queue[dm->fid].totdiff  = INT64_MAX;
         } else {
-            calc_diffs(dm, &dm->queue[dm->fid], prv, in);
+            calc_diffs(ctx, &dm->queue[dm->fid], prv, in);
         }
         if (++dm->fid != dm->cycle)
             return 0;
@@ -353,6 +431,7 @@ static av_cold void decimate_uninit(AVFilterContext *ctx)
 
     av_frame_free(&dm->last);
     av_freep(&dm->bdiffs);
+    av_freep(&dm->group_sums);
     if (dm->queue) {
         for (i = 0; i < dm->cycle; i++)
             av_frame_free(&dm->queue[i].frame);
@@ -400,14 +479,19 @@ static int config_output(AVFilterLink *outlink)
     dm->nyblocks  = (h + dm->blocky/2 - 1) / (dm->blocky/2);
     dm->bdiffsize = dm->nxblocks * dm->nyblocks;
     dm->bdiffs    = av_malloc_array(dm->bdiffsize, sizeof(*dm->bdiffs));
+    dm->nb_groups = (w + 7) >> 3;
+    dm->nb_threads = ff_filter_get_nb_threads(ctx);
+    dm->group_sums = av_malloc_array(dm->nb_threads * dm->nb_groups, sizeof(*dm->group_sums));
     dm->queue     = av_calloc(dm->cycle, sizeof(*dm->queue));
     dm->in_tb     = inlink->time_base;
     dm->nondec_tb = av_inv_q(fps);
     dm->dec_tb    = av_mul_q(dm->nondec_tb, (AVRational){dm->cycle, dm->cycle - 1});
 
-    if (!dm->bdiffs || !dm->queue)
+    if (!dm->bdiffs || !dm->group_sums || !dm->queue)
         return AVERROR(ENOMEM);
 
+    ff_decimate_init(&dm->dsp);
+
     if (dm->ppsrc) {
         dm->clean_src = av_calloc(dm->cycle, sizeof(*dm->clean_src));
         if (!dm->clean_src)
@@ -459,5 +543,5 @@ const AVFilter ff_vf_decimate = {
     FILTER_OUTPUTS(decimate_outputs),
     FILTER_PIXFMTS_ARRAY(pix_fmts),
     .priv_class    = &decimate_class,
-    .flags         = AVFILTER_FLAG_DYNAMIC_INPUTS,
+    .flags         = AVFILTER_FLAG_DYNAMIC_INPUTS | AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -194,6 +194,7 @@ typedef struct GlyphInfo {
     int y;                          ///< the y position of the glyph
     int shift_x64;                  ///< the horizontal shift of the glyph in 26.6 units
     int shift_y64;                  ///< the vertical shift of the glyph in 26.6 units
+    struct Glyph *glyph;            ///< the cached glyph holding the bitmaps
 } GlyphInfo;
 
 /** Information about a single line of text */
@@ -206,6 +207,8 @@ typedef struct TextLine {
     HarfbuzzData hb_data;           ///< libharfbuzz data of this text line
     GlyphInfo* glyphs;              ///< array of glyphs in this text line
     int cluster_offset;             ///< the offset at which this line begins
+    char *text;                     ///< the text this line was shaped from
+    int text_len;                   ///< the length of text
 } TextLine;
 
 /** A glyph as loaded and rendered using libfreetype */
@@ -327,6 +330,16 @@ typedef struct DrawTextContext {
     int tab_count;                  ///< the number of tab characters
     int blank_advance64;            ///< the size of the space character
     int tab_warning_printed;        ///< ensure the tab warning to be printed only once
+
+    /* layout cache, reused as long as the expanded text and style do not change */
+    char *layout_text;              ///< the expanded text the lines were built from
+    unsigned int layout_fontsize;   ///< the font size the lines were shaped with
+    int layout_tabsize;             ///< the tab size the layout was measured with
+    int layout_line_spacing;        ///< the line spacing the layout was measured with
+    int layout_y_align;             ///< the y_align the layout was measured with
+    TextMetrics layout_metrics;     ///< the metrics of the cached layout
+    int layout_positioned;          ///< tells if the glyph positions are valid
+    int layout_x64, layout_y64;     ///< the origin the glyphs were positioned at
 } DrawTextContext;
 
 #define OFFSET(x) offsetof(DrawTextContext, x)
@@ -1082,6 +1095,26 @@ static int query_formats(AVFilterContext *ctx)
     return ff_set_common_formats(ctx, ff_draw_supported_pixel_formats(0));
 }
 
+static void hb_destroy(HarfbuzzData *hb)
+{
+    hb_buffer_destroy(hb->buf);
+    hb_font_destroy(hb->font);
+    hb->buf = NULL;
+    hb->font = NULL;
+    hb->glyph_info = NULL;
+    hb->glyph_pos = NULL;
+}
+
+static void free_lines(TextLine *lines, int line_count)
+{
+    for (int l = 0; l < line_count; ++l) {
+        TextLine *line = &lines[l];
+        av_freep(&line->glyphs);
+        av_freep(&line->text);
+        hb_destroy(&line->hb_data);
+    }
+}
+
 static int glyph_enu_border_free(void *opaque, void *elem)
 {
     Glyph *glyph = elem;
@@ -1132,6 +1165,12 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_tree_destroy(s->glyphs);
     s->glyphs = NULL;
 
+    free_lines(s->lines, s->line_count);
+    av_freep(&s->lines);
+    av_freep(&s->tab_clusters);
+    av_freep(&s->layout_text);
+    s->line_count = 0;
+
     FT_Done_Face(s->face);
     FT_Stroker_Done(s->stroker);
     FT_Done_FreeType(s->library);
@@ -1226,6 +1265,9 @@ static int command(AVFilterContext *ctx, const char *cmd, const char *arg, char
         if ((ret = ff_filter_process_command(ctx, cmd, arg, res, res_len, flags)) < 0) {
             return ret;
         }
+        // Options may affect the shaping or the rendered glyphs, rebuild the layout
+        av_freep(&old->layout_text);
+        old->layout_positioned = 0;
         if (old->borderw != old_borderw) {
             FT_Stroker_Set(old->stroker, old->borderw << 6, FT_STROKER_LINECAP_ROUND,
                         FT_STROKER_LINEJOIN_ROUND, 0);
@@ -1267,15 +1309,30 @@ static void update_alpha(DrawTextContext *s)
         s->alpha = 256 * alpha;
 }
 
-static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
-                       FFDrawColor *color,
-                       TextMetrics *metrics,
-                       int x, int y, int borderw)
+typedef struct ThreadData {
+    AVFrame *frame;
+    TextMetrics *metrics;
+    FFDrawColor *fontcolor;
+    FFDrawColor *shadowcolor;
+    FFDrawColor *bordercolor;
+    FFDrawColor *boxcolor;
+    int band_start, band_end;       ///< rows touched by the box and the glyphs
+} ThreadData;
+
+/**
+ * Draw the glyphs clipped to the rows [slice_start, slice_end), data points
+ * to the frame planes offset to slice_start.
+ */
+static void draw_glyphs(DrawTextContext *s, AVFrame *frame,
+                        uint8_t *data[4], int slice_start, int slice_end,
+                        FFDrawColor *color,
+                        TextMetrics *metrics,
+                        int x, int y, int borderw)
 {
     int g, l, x1, y1, w1, h1, idx;
     int dx = 0, dy = 0, pdx = 0;
     GlyphInfo *info;
-    Glyph dummy = { 0 }, *glyph;
+    Glyph *glyph;
     FT_Bitmap bitmap;
     FT_BitmapGlyph b_glyph;
     uint8_t j_left = 0, j_right = 0, j_top = 0, j_bottom = 0;
@@ -1293,25 +1350,16 @@ static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
         offset_y = s->box_height - metrics->height;
     }
 
-    if ((!j_left || j_right) && !s->tab_warning_printed && s->tab_count > 0) {
-        s->tab_warning_printed = 1;
-        av_log(s, AV_LOG_WARNING, "Tab characters are only supported with left horizontal alignment\n");
-    }
-
     clip_x = FFMIN(metrics->rect_x + s->box_width + s->bb_right, frame->width);
     clip_y = FFMIN(metrics->rect_y + s->box_height + s->bb_bottom, frame->height);
+    clip_y = FFMIN(clip_y, slice_end);
 
     for (l = 0; l < s->line_count; ++l) {
         TextLine *line = &s->lines[l];
         line_w = POS_CEIL(line->width64, 64);
         for (g = 0; g < line->hb_data.glyph_count; ++g) {
             info = &line->glyphs[g];
-            dummy.fontsize = s->fontsize;
-            dummy.code = info->code;
-            glyph = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
-            if (!glyph) {
-                return AVERROR(EINVAL);
-            }
+            glyph = info->glyph;
 
             idx = get_subpixel_idx(info->shift_x64, info->shift_y64);
             b_glyph = borderw ? glyph->border_bglyph[idx] : glyph->bglyph[idx];
@@ -1347,10 +1395,51 @@ static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
             w1 = FFMIN(clip_x - x1, w1 - dx);
             h1 = FFMIN(clip_y - y1, h1 - dy);
 
-            ff_blend_mask(&s->dc, color, frame->data, frame->linesize, clip_x, clip_y,
-                bitmap.buffer + pdx, bitmap.pitch, w1, h1, 3, 0, x1, y1);
+            ff_blend_mask(&s->dc, color, data, frame->linesize, clip_x, clip_y - slice_start,
+                bitmap.buffer + pdx, bitmap.pitch, w1, h1, 3, 0, x1, y1 - slice_start);
         }
     }
+}
+
+static int draw_text_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    DrawTextContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *frame = td->frame;
+    TextMetrics *metrics = td->metrics;
+    const int align = (1 << s->dc.vsub_max) - 1;
+    const int rows = td->band_end - td->band_start;
+    const int slice_start = td->band_start + ((rows * jobnr) / nb_jobs & ~align);
+    const int slice_end = jobnr == nb_jobs - 1 ? td->band_end :
+                          td->band_start + ((rows * (jobnr + 1)) / nb_jobs & ~align);
+    uint8_t *data[4] = { NULL };
+
+    if (slice_start >= slice_end)
+        return 0;
+
+    // Slices start on chroma row boundaries, so blending each slice on its own
+    // gives the same result as blending the whole frame at once.
+    for (int p = 0; p < s->dc.nb_planes; p++)
+        data[p] = frame->data[p] + (slice_start >> s->dc.vsub[p]) * frame->linesize[p];
+
+    if (s->draw_box) {
+        ff_blend_rectangle(&s->dc, td->boxcolor,
+            data, frame->linesize, frame->width, slice_end - slice_start,
+            metrics->rect_x - s->bb_left, metrics->rect_y - s->bb_top - slice_start,
+            s->box_width + s->bb_right + s->bb_left,
+            s->box_height + s->bb_bottom + s->bb_top);
+    }
+
+    if (s->shadowx || s->shadowy)
+        draw_glyphs(s, frame, data, slice_start, slice_end, td->shadowcolor,
+                    metrics, s->shadowx, s->shadowy, s->borderw);
+
+    if (s->borderw)
+        draw_glyphs(s, frame, data, slice_start, slice_end, td->bordercolor,
+                    metrics, 0, 0, s->borderw);
+
+    draw_glyphs(s, frame, data, slice_start, slice_end, td->fontcolor,
+                metrics, 0, 0, 0);
 
     return 0;
 }
@@ -1379,16 +1468,6 @@ static int shape_text_hb(DrawTextContext *s, HarfbuzzData* hb, const char* text,
     return 0;
 }
 
-static void hb_destroy(HarfbuzzData *hb)
-{
-    hb_buffer_destroy(hb->buf);
-    hb_font_destroy(hb->font);
-    hb->buf = NULL;
-    hb->font = NULL;
-    hb->glyph_info = NULL;
-    hb->glyph_pos = NULL;
-}
-
 static int measure_text(AVFilterContext *ctx, TextMetrics *metrics)
 {
     DrawTextContext *s = ctx->priv;
@@ -1402,11 +1481,19 @@ static int measure_text(AVFilterContext *ctx, TextMetrics *metrics)
     int line_count = 0;
     uint32_t code = 0;
     Glyph *glyph = NULL;
+    // Lines of the previous layout, their shaping is kept if their text did not change
+    TextLine *old_lines = s->lines;
+    int old_line_count = s->line_count;
+    int reuse_lines = s->layout_fontsize == s->fontsize;
 
     int i, tab_idx = 0, last_tab_idx = 0, line_offset = 0;
     char* p;
     int ret = 0;
 
+    s->lines = NULL;
+    s->line_count = 0;
+    av_freep(&s->tab_clusters);
+
     // Count the lines and the tab characters
     s->tab_count = 0;
     for (i = 0, p = text; 1; i++) {
@@ -1433,9 +1520,13 @@ continue_on_failed:
         hb_destroy(&hb_data);
     }
 
+    s->lines = av_calloc(line_count, sizeof(TextLine));
+    s->tab_clusters = av_calloc(FFMAX(s->tab_count, 1), sizeof(uint32_t));
+    if (!s->lines || !s->tab_clusters) {
+        ret = AVERROR(ENOMEM);
+        goto done;
+    }
     s->line_count = line_count;
-    s->lines = av_mallocz(line_count * sizeof(TextLine));
-    s->tab_clusters = av_mallocz(s->tab_count * sizeof(uint32_t));
     for (i = 0; i < s->tab_count; ++i) {
         s->tab_clusters[i] = -1;
     }
@@ -1455,11 +1546,26 @@ continue_on_failed:
 continue_on_failed2:
         if (ff_is_newline(code) || code == 0) {
             TextLine *cur_line = &s->lines[line_count];
+            TextLine *old_line = line_count < old_line_count ? &old_lines[line_count] : NULL;
             HarfbuzzData *hb = &cur_line->hb_data;
             cur_line->cluster_offset = line_offset;
-            ret = shape_text_hb(s, hb, start, num_chars);
-            if (ret != 0) {
-                goto done;
+            if (reuse_lines && old_line && old_line->text &&
+                old_line->text_len == num_chars &&
+                !memcmp(old_line->text, start, num_chars)) {
+                FFSWAP(HarfbuzzData, cur_line->hb_data, old_line->hb_data);
+                FFSWAP(char *, cur_line->text, old_line->text);
+                cur_line->text_len = num_chars;
+            } else {
+                cur_line->text = av_memdup(start, num_chars);
+                if (!cur_line->text) {
+                    ret = AVERROR(ENOMEM);
+                    goto done;
+                }
+                cur_line->text_len = num_chars;
+                ret = shape_text_hb(s, hb, start, num_chars);
+                if (ret != 0) {
+                    goto done;
+                }
             }
             w64 = 0;
             cur_min_y64 = 32000;
@@ -1545,6 +1651,8 @@ continue_on_failed2:
     metrics->max_y64 = max_y64;
 
 done:
+    free_lines(old_lines, old_line_count);
+    av_free(old_lines);
     av_free(textdup);
     return ret;
 }
@@ -1569,7 +1677,6 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
 
     int width = frame->width;
     int height = frame->height;
-    int rec_x = 0, rec_y = 0, rec_width = 0, rec_height = 0;
     int is_outside = 0;
     int last_tab_idx = 0;
 
@@ -1622,8 +1729,28 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         return ret;
     }
 
-    if ((ret = measure_text(ctx, &metrics)) < 0) {
-        return ret;
+    if (s->layout_text && s->layout_fontsize == s->fontsize &&
+        s->layout_tabsize == s->tabsize &&
+        s->layout_line_spacing == s->line_spacing &&
+        s->layout_y_align == s->y_align &&
+        !strcmp(s->layout_text, s->expanded_text.str)) {
+        metrics = s->layout_metrics;
+    } else {
+        av_freep(&s->layout_text);
+        s->layout_positioned = 0;
+
+        if ((ret = measure_text(ctx, &metrics)) < 0) {
+            return ret;
+        }
+
+        s->layout_text = av_strdup(s->expanded_text.str);
+        if (!s->layout_text)
+            return AVERROR(ENOMEM);
+        s->layout_fontsize     = s->fontsize;
+        s->layout_tabsize      = s->tabsize;
+        s->layout_line_spacing = s->line_spacing;
+        s->layout_y_align      = s->y_align;
+        s->layout_metrics      = metrics;
     }
 
     s->max_glyph_h = POS_CEIL(metrics.max_y64 - metrics.min_y64, 64);
@@ -1715,45 +1842,56 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         y64 = (int)(s->y * 64. + metrics.offset_top64);
     }
 
-    for (int l = 0; l < s->line_count; ++l) {
-        TextLine *line = &s->lines[l];
-        HarfbuzzData *hb = &line->hb_data;
-        line->glyphs = av_mallocz(hb->glyph_count * sizeof(GlyphInfo));
-
-        for (int t = 0; t < hb->glyph_count; ++t) {
-            GlyphInfo *g_info = &line->glyphs[t];
-            uint8_t is_tab = last_tab_idx < s->tab_count &&
-                hb->glyph_info[t].cluster == s->tab_clusters[last_tab_idx] - line->cluster_offset;
-            int true_x, true_y;
-            if (is_tab) {
-                ++last_tab_idx;
-            }
-            true_x = x + hb->glyph_pos[t].x_offset;
-            true_y = y + hb->glyph_pos[t].y_offset;
-            shift_x64 = (((x64 + true_x) >> 4) & 0b0011) << 4;
-            shift_y64 = ((4 - (((y64 + true_y) >> 4) & 0b0011)) & 0b0011) << 4;
+    if (!s->layout_positioned || s->layout_x64 != x64 || s->layout_y64 != y64) {
+        s->layout_positioned = 0;
+        for (int l = 0; l < s->line_count; ++l) {
+            TextLine *line = &s->lines[l];
+            HarfbuzzData *hb = &line->hb_data;
+            av_freep(&line->glyphs);
+            line->glyphs = av_calloc(FFMAX(hb->glyph_count, 1), sizeof(GlyphInfo));
+            if (!line->glyphs)
+                return AVERROR(ENOMEM);
 
-            ret = load_glyph(ctx, &glyph, hb->glyph_info[t].codepoint, shift_x64, shift_y64);
-            if (ret != 0) {
-                return ret;
-            }
-            g_info->code = hb->glyph_info[t].codepoint;
-            g_info->x = (x64 + true_x) >> 6;
-            g_info->y = ((y64 + true_y) >> 6) + (shift_y64 > 0 ? 1 : 0);
-            g_info->shift_x64 = shift_x64;
-            g_info->shift_y64 = shift_y64;
-
-            if (!is_tab) {
-                x += hb->glyph_pos[t].x_advance;
-            } else {
-                int size = s->blank_advance64 * s->tabsize;
-                x = (x / size + 1) * size;
+            for (int t = 0; t < hb->glyph_count; ++t) {
+                GlyphInfo *g_info = &line->glyphs[t];
+                uint8_t is_tab = last_tab_idx < s->tab_count &&
+                    hb->glyph_info[t].cluster == s->tab_clusters[last_tab_idx] - line->cluster_offset;
+                int true_x, true_y;
+                if (is_tab) {
+                    ++last_tab_idx;
+                }
+                true_x = x + hb->glyph_pos[t].x_offset;
+                true_y = y + hb->glyph_pos[t].y_offset;
+                shift_x64 = (((x64 + true_x) >> 4) & 0b0011) << 4;
+                shift_y64 = ((4 - (((y64 + true_y) >> 4) & 0b0011)) & 0b0011) << 4;
+
+                ret = load_glyph(ctx, &glyph, hb->glyph_info[t].codepoint, shift_x64, shift_y64);
+                if (ret != 0) {
+                    return ret;
+                }
+                g_info->code = hb->glyph_info[t].codepoint;
+                g_info->x = (x64 + true_x) >> 6;
+                g_info->y = ((y64 + true_y) >> 6) + (shift_y64 > 0 ? 1 : 0);
+                g_info->shift_x64 = shift_x64;
+                g_info->shift_y64 = shift_y64;
+                g_info->glyph = glyph;
+
+                if (!is_tab) {
+                    x += hb->glyph_pos[t].x_advance;
+                } else {
+                    int size = s->blank_advance64 * s->tabsize;
+                    x = (x / size + 1) * size;
+                }
+                y += hb->glyph_pos[t].y_advance;
             }
-            y += hb->glyph_pos[t].y_advance;
+
+            y += metrics.line_height64 + s->line_spacing * 64;
+            x = 0;
         }
 
-        y += metrics.line_height64 + s->line_spacing * 64;
-        x = 0;
+        s->layout_x64 = x64;
+        s->layout_y64 = y64;
+        s->layout_positioned = 1;
     }
 
     metrics.rect_x = s->x;
@@ -1783,45 +1921,27 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
                     metrics.rect_y + s->box_height + s->bb_bottom <= 0;
 
     if (!is_outside) {
-        /* draw box */
-        if (s->draw_box) {
-            rec_x = metrics.rect_x - s->bb_left;
-            rec_y = metrics.rect_y - s->bb_top;
-            rec_width = s->box_width + s->bb_right + s->bb_left;
-            rec_height = s->box_height + s->bb_bottom + s->bb_top;
-            ff_blend_rectangle(&s->dc, &boxcolor,
-                frame->data, frame->linesize, width, height,
-                rec_x, rec_y, rec_width, rec_height);
+        ThreadData td = {
+            .frame       = frame,
+            .metrics     = &metrics,
+            .fontcolor   = &fontcolor,
+            .shadowcolor = &shadowcolor,
+            .bordercolor = &bordercolor,
+            .boxcolor    = &boxcolor,
+        };
+        int nb_jobs;
+
+        if ((!(s->text_align & TA_LEFT) || (s->text_align & TA_RIGHT)) &&
+            !s->tab_warning_printed && s->tab_count > 0) {
+            s->tab_warning_printed = 1;
+            av_log(s, AV_LOG_WARNING, "Tab characters are only supported with left horizontal alignment\n");
         }
 
-        if (s->shadowx || s->shadowy) {
-            if ((ret = draw_glyphs(s, frame, &shadowcolor, &metrics,
-                    s->shadowx, s->shadowy, s->borderw)) < 0) {
-                return ret;
-            }
-        }
-
-        if (s->borderw) {
-            if ((ret = draw_glyphs(s, frame, &bordercolor, &metrics,
-                    0, 0, s->borderw)) < 0) {
-                return ret;
-            }
-        }
-
-        if ((ret = draw_glyphs(s, frame, &fontcolor, &metrics, 0,
-                0, 0)) < 0) {
-            return ret;
-        }
-    }
-
-    // FREE data structures
-    for (int l = 0; l < s->line_count; ++l) {
-        TextLine *line = &s->lines[l];
-        av_freep(&line->glyphs);
-        hb_destroy(&line->hb_data);
+        td.band_start = FFMAX(metrics.rect_y - s->bb_top, 0) & ~((1 << s->dc.vsub_max) - 1);
+        td.band_end   = FFMIN(metrics.rect_y + s->box_height + s->bb_bottom, height);
+        nb_jobs = av_clip((td.band_end - td.band_start) / 16, 1, ff_filter_get_nb_threads(ctx));
+        ff_filter_execute(ctx, draw_text_slice, &td, NULL, nb_jobs);
     }
-    av_freep(&s->lines);
-    av_freep(&s->tab_clusters);
 
     return 0;
 }
@@ -1915,5 +2035,5 @@ const AVFilter ff_vf_drawtext = {
     FILTER_OUTPUTS(ff_video_default_filterpad),
     FILTER_QUERY_FUNC(query_formats),
     .process_command = command,
-    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC,
+    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -38,6 +38,7 @@
 #include "libavutil/opt.h"
 #include "libavutil/timestamp.h"
 #include "avfilter.h"
+#include "fieldmatchdsp.h"
 #include "filters.h"
 #include "formats.h"
 #include "internal.h"
@@ -112,6 +113,16 @@ typedef struct FieldMatchContext {
     int *c_array;
     int tpitchy, tpitchuv;
     uint8_t *tbuffer;
+
+    /* slice threading */
+    int nb_threads;
+    int c_array_size;
+    int *c_arrays;                  ///< per job comb counts of the inner block rows
+    int comb_counts_size;
+    uint16_t *comb_counts;          ///< per job column comb counts
+    uint64_t (*match_sums)[FM_MATCH_NB]; ///< per job field matching metrics
+
+    FieldMatchDSPContext dsp;
 } FieldMatchContext;
 
 #define OFFSET(x) offsetof(FieldMatchContext, x)
@@ -166,20 +177,22 @@ static int get_height(const FieldMatchContext *fm, const AVFrame *f, int plane,
     return plane ? AV_CEIL_RSHIFT(f->height, fm->vsub[input]) : f->height;
 }
 
-static int64_t luma_abs_diff(const AVFrame *f1, const AVFrame *f2)
+static int64_t luma_abs_diff(const FieldMatchContext *fm,
+                             const AVFrame *f1, const AVFrame *f2)
 {
-    int x, y;
+    int y;
     const uint8_t *srcp1 = f1->data[0];
     const uint8_t *srcp2 = f2->data[0];
     const int src1_linesize = f1->linesize[0];
     const int src2_linesize = f2->linesize[0];
     const int width  = f1->width;
     const int height = f1->height;
+    const int w32 = width & ~31;
     int64_t acc = 0;
 
     for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++)
-            acc += abs(srcp1[x] - srcp2[x]);
+        acc += fm->dsp.sad(srcp1, srcp2, w32);
+        acc += sad_c(srcp1 + w32, srcp2 + w32, width - w32);
         srcp1 += src1_linesize;
         srcp2 += src2_linesize;
     }
@@ -196,79 +209,126 @@ static void fill_buf(uint8_t *data, int w, int h, int linesize, uint8_t v)
     }
 }
 
-static int calc_combed_score(const FieldMatchContext *fm, const AVFrame *src)
+typedef struct CombThreadData {
+    const AVFrame *src;
+    int xhalf, yhalf;
+    int xblocks4;
+    int widtha;
+    int arraysize;
+    int nb_bands;
+} CombThreadData;
+
+#define C_ARRAY_ADD(v) do {                         \
+    const int box1 = (x / blockx) * 4;              \
+    const int box2 = ((x + xhalf) / blockx) * 4;    \
+    c_array[temp1 + box1    ] += v;                 \
+    c_array[temp1 + box2 + 1] += v;                 \
+    c_array[temp2 + box1 + 2] += v;                 \
+    c_array[temp2 + box2 + 3] += v;                 \
+} while (0)
+
+static int comb_mask_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
-    int x, y, plane, max_v = 0;
+    const FieldMatchContext *fm = ctx->priv;
+    const CombThreadData *td = arg;
+    const AVFrame *src = td->src;
     const int cthresh = fm->cthresh;
-    const int cthresh6 = cthresh * 6;
+    int plane;
 
     for (plane = 0; plane < (fm->chroma ? 3 : 1); plane++) {
-        const uint8_t *srcp = src->data[plane];
         const int src_linesize = src->linesize[plane];
         const int width  = get_width (fm, src, plane, INPUT_MAIN);
         const int height = get_height(fm, src, plane, INPUT_MAIN);
-        uint8_t *cmkp = fm->cmask_data[plane];
         const int cmk_linesize = fm->cmask_linesize[plane];
-
-        if (cthresh < 0) {
-            fill_buf(cmkp, width, height, cmk_linesize, 0xff);
-            continue;
-        }
-        fill_buf(cmkp, width, height, cmk_linesize, 0);
-
-        /* [1 -3 4 -3 1] vertical filter */
-#define FILTER(xm2, xm1, xp1, xp2) \
-        abs(  4 * srcp[x] \
-             -3 * (srcp[x + (xm1)*src_linesize] + srcp[x + (xp1)*src_linesize]) \
-             +    (srcp[x + (xm2)*src_linesize] + srcp[x + (xp2)*src_linesize])) > cthresh6
-
-        /* first line */
-        for (x = 0; x < width; x++) {
-            const int s1 = abs(srcp[x] - srcp[x + src_linesize]);
-            if (s1 > cthresh && FILTER(2, 1, 1, 2))
-                cmkp[x] = 0xff;
+        const int slice_start = (height *  jobnr     ) / nb_jobs;
+        const int slice_end   = (height * (jobnr + 1)) / nb_jobs;
+        const int w32 = width & ~31;
+
+        for (int y = slice_start; y < slice_end; y++) {
+            const uint8_t *srcp = src->data[plane] + y * src_linesize;
+            uint8_t *cmkp = fm->cmask_data[plane] + y * cmk_linesize;
+            /* [1 -3 4 -3 1] vertical filter, mirrored on the first and last two lines */
+            const uint8_t *m2 = srcp + (y < 2          ?  2 : -2) * src_linesize;
+            const uint8_t *m1 = srcp + (y < 1          ?  1 : -1) * src_linesize;
+            const uint8_t *p1 = srcp + (y > height - 2 ? -1 :  1) * src_linesize;
+            const uint8_t *p2 = srcp + (y > height - 3 ? -2 :  2) * src_linesize;
+
+            fm->dsp.comb_row(cmkp, m2, m1, srcp, p1, p2, w32, cthresh);
+            comb_row_c(cmkp + w32, m2 + w32, m1 + w32, srcp + w32, p1 + w32, p2 + w32,
+                       width - w32, cthresh);
         }
-        srcp += src_linesize;
-        cmkp += cmk_linesize;
-
-        /* second line */
-        for (x = 0; x < width; x++) {
-            const int s1 = abs(srcp[x] - srcp[x - src_linesize]);
-            const int s2 = abs(srcp[x] - srcp[x + src_linesize]);
-            if (s1 > cthresh && s2 > cthresh && FILTER(2, -1, 1, 2))
-                cmkp[x] = 0xff;
-        }
-        srcp += src_linesize;
-        cmkp += cmk_linesize;
-
-        /* all lines minus first two and last two */
-        for (y = 2; y < height-2; y++) {
-            for (x = 0; x < width; x++) {
-                const int s1 = abs(srcp[x] - srcp[x - src_linesize]);
-                const int s2 = abs(srcp[x] - srcp[x + src_linesize]);
-                if (s1 > cthresh && s2 > cthresh && FILTER(-2, -1, 1, 2))
-                    cmkp[x] = 0xff;
-            }
-            srcp += src_linesize;
+    }
+    return 0;
+}
+
+/**
+ * Count the combed pixels of the block rows between the first and last half
+ * block rows, each job into its own array.
+ */
+static int comb_count_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const FieldMatchContext *fm = ctx->priv;
+    const CombThreadData *td = arg;
+    const int blockx = fm->blockx;
+    const int blocky = fm->blocky;
+    const int xhalf = td->xhalf;
+    const int yhalf = td->yhalf;
+    const int xblocks4 = td->xblocks4;
+    const int widtha = td->widtha;
+    const int width  = td->src->width;
+    const int cmk_linesize = fm->cmask_linesize[0];
+    const int slice_start = (td->nb_bands *  jobnr     ) / nb_jobs;
+    const int slice_end   = (td->nb_bands * (jobnr + 1)) / nb_jobs;
+    const int w16 = width & ~15;
+    int *c_array = fm->c_arrays + jobnr * fm->c_array_size;
+    uint16_t *acc = fm->comb_counts + jobnr * fm->comb_counts_size;
+    int x, u;
+
+    memset(c_array, 0, td->arraysize * sizeof(*c_array));
+
+    for (int band = slice_start; band < slice_end; band++) {
+        const int y = (band + 1) * yhalf;
+        const int temp1 = (y / blocky) * xblocks4;
+        const int temp2 = ((y + yhalf) / blocky) * xblocks4;
+        const uint8_t *cmkp = fm->cmask_data[0] + y * cmk_linesize;
+
+        memset(acc, 0, width * sizeof(*acc));
+        for (u = 0; u < yhalf; u++) {
+            fm->dsp.comb_count(acc, cmkp, cmk_linesize, w16);
+            comb_count_c(acc + w16, cmkp + w16, cmk_linesize, width - w16);
             cmkp += cmk_linesize;
         }
 
-        /* before-last line */
-        for (x = 0; x < width; x++) {
-            const int s1 = abs(srcp[x] - srcp[x - src_linesize]);
-            const int s2 = abs(srcp[x] - srcp[x + src_linesize]);
-            if (s1 > cthresh && s2 > cthresh && FILTER(-2, -1, 1, -2))
-                cmkp[x] = 0xff;
-        }
-        srcp += src_linesize;
-        cmkp += cmk_linesize;
-
-        /* last line */
-        for (x = 0; x < width; x++) {
-            const int s1 = abs(srcp[x] - srcp[x - src_linesize]);
-            if (s1 > cthresh && FILTER(-2, -1, -1, -2))
-                cmkp[x] = 0xff;
+        for (x = 0; x < widtha; x += xhalf) {
+            int v, sum = 0;
+            for (v = 0; v < xhalf; v++)
+                sum += acc[x + v];
+            if (sum)
+                C_ARRAY_ADD(sum);
         }
+
+        for (x = widtha; x < width; x++)
+            if (acc[x])
+                C_ARRAY_ADD(acc[x]);
+    }
+    return 0;
+}
+
+static int calc_combed_score(AVFilterContext *ctx, const AVFrame *src)
+{
+    const FieldMatchContext *fm = ctx->priv;
+    CombThreadData td = { .src = src };
+    int x, y, plane, max_v = 0;
+
+    if (fm->cthresh < 0) {
+        for (plane = 0; plane < (fm->chroma ? 3 : 1); plane++)
+            fill_buf(fm->cmask_data[plane],
+                     get_width (fm, src, plane, INPUT_MAIN),
+                     get_height(fm, src, plane, INPUT_MAIN),
+                     fm->cmask_linesize[plane], 0xff);
+    } else {
+        ff_filter_execute(ctx, comb_mask_slice, &td, NULL,
+                          FFMIN(src->height, fm->nb_threads));
     }
 
     if (fm->chroma) {
@@ -320,19 +380,11 @@ static int calc_combed_score(const FieldMatchContext *fm, const AVFrame *src)
         const int arraysize = (xblocks*yblocks)<<2;
         int      heighta = (height/(blocky/2))*(blocky/2);
         const int widtha = (width /(blockx/2))*(blockx/2);
+        int nb_jobs;
         if (heighta == height)
             heighta = height - yhalf;
         memset(c_array, 0, arraysize * sizeof(*c_array));
 
-#define C_ARRAY_ADD(v) do {                         \
-    const int box1 = (x / blockx) * 4;              \
-    const int box2 = ((x + xhalf) / blockx) * 4;    \
-    c_array[temp1 + box1    ] += v;                 \
-    c_array[temp1 + box2 + 1] += v;                 \
-    c_array[temp2 + box1 + 2] += v;                 \
-    c_array[temp2 + box2 + 3] += v;                 \
-} while (0)
-
 #define VERTICAL_HALF(y_start, y_end) do {                                  \
     for (y = y_start; y < y_end; y++) {                                     \
         const int temp1 = (y / blocky) * xblocks4;                          \
@@ -348,41 +400,22 @@ static int calc_combed_score(const FieldMatchContext *fm, const AVFrame *src)
 
         VERTICAL_HALF(1, yhalf);
 
-        for (y = yhalf; y < heighta; y += yhalf) {
-            const int temp1 = (y / blocky) * xblocks4;
-            const int temp2 = ((y + yhalf) / blocky) * xblocks4;
-
-            for (x = 0; x < widtha; x += xhalf) {
-                const uint8_t *cmkp_tmp = cmkp + x;
-                int u, v, sum = 0;
-                for (u = 0; u < yhalf; u++) {
-                    for (v = 0; v < xhalf; v++)
-                        if (cmkp_tmp[v - cmk_linesize] == 0xff &&
-                            cmkp_tmp[v               ] == 0xff &&
-                            cmkp_tmp[v + cmk_linesize] == 0xff)
-                            sum++;
-                    cmkp_tmp += cmk_linesize;
-                }
-                if (sum)
-                    C_ARRAY_ADD(sum);
+        td.xhalf     = xhalf;
+        td.yhalf     = yhalf;
+        td.xblocks4  = xblocks4;
+        td.widtha    = widtha;
+        td.arraysize = arraysize;
+        td.nb_bands  = FFMAX(heighta / yhalf - 1, 0);
+        nb_jobs = FFMIN(td.nb_bands, fm->nb_threads);
+        if (nb_jobs > 0) {
+            ff_filter_execute(ctx, comb_count_slice, &td, NULL, nb_jobs);
+            for (int j = 0; j < nb_jobs; j++) {
+                const int *job_array = fm->c_arrays + j * fm->c_array_size;
+                for (x = 0; x < arraysize; x++)
+                    c_array[x] += job_array[x];
             }
-
-            for (x = widtha; x < width; x++) {
-                const uint8_t *cmkp_tmp = cmkp + x;
-                int u, sum = 0;
-                for (u = 0; u < yhalf; u++) {
-                    if (cmkp_tmp[-cmk_linesize] == 0xff &&
-                        cmkp_tmp[            0] == 0xff &&
-                        cmkp_tmp[ cmk_linesize] == 0xff)
-                        sum++;
-                    cmkp_tmp += cmk_linesize;
-                }
-                if (sum)
-                    C_ARRAY_ADD(sum);
-            }
-
-            cmkp += cmk_linesize * yhalf;
         }
+        cmkp += cmk_linesize * yhalf * td.nb_bands;
 
         VERTICAL_HALF(heighta, height - 1);
 
@@ -393,42 +426,68 @@ static int calc_combed_score(const FieldMatchContext *fm, const AVFrame *src)
     return max_v;
 }
 
+typedef struct MatchThreadData {
+    int plane;
+    int width, height;
+    const uint8_t *prvp, *nxtp;         ///< fields the diff map is built from
+    int prv_linesize, nxt_linesize;
+    uint8_t *dstp;                      ///< first line of the diff map
+    int dst_linesize;
+    const uint8_t *rows[FM_ROW_NB];     ///< first lines of the metric inputs
+    int linesizes[FM_ROW_NB];
+    int y0a, y1a;
+    int startx, stopx;
+} MatchThreadData;
+
 // the secret is that tbuffer is an interlaced, offset subset of all the lines
-static void build_abs_diff_mask(const uint8_t *prvp, int prv_linesize,
+static void build_abs_diff_mask(const FieldMatchContext *fm,
+                                const uint8_t *prvp, int prv_linesize,
                                 const uint8_t *nxtp, int nxt_linesize,
                                 uint8_t *tbuffer,    int tbuf_linesize,
-                                int width, int height)
+                                int width, int slice_start, int slice_end)
 {
-    int y, x;
+    const int w32 = width & ~31;
+    int y;
 
-    prvp -= prv_linesize;
-    nxtp -= nxt_linesize;
-    for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++)
-            tbuffer[x] = FFABS(prvp[x] - nxtp[x]);
+    prvp    += (slice_start - 1) * prv_linesize;
+    nxtp    += (slice_start - 1) * nxt_linesize;
+    tbuffer +=  slice_start      * tbuf_linesize;
+    for (y = slice_start; y < slice_end; y++) {
+        fm->dsp.abs_diff(tbuffer, prvp, nxtp, w32);
+        abs_diff_c(tbuffer + w32, prvp + w32, nxtp + w32, width - w32);
         prvp += prv_linesize;
         nxtp += nxt_linesize;
         tbuffer += tbuf_linesize;
     }
 }
 
+static int abs_diff_mask_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const FieldMatchContext *fm = ctx->priv;
+    const MatchThreadData *td = arg;
+    const int height = td->height >> 1;
+
+    build_abs_diff_mask(fm, td->prvp, td->prv_linesize, td->nxtp, td->nxt_linesize,
+                        fm->tbuffer, td->plane ? fm->tpitchuv : fm->tpitchy, td->width,
+                        (height *  jobnr     ) / nb_jobs,
+                        (height * (jobnr + 1)) / nb_jobs);
+    return 0;
+}
+
 /**
- * Build a map over which pixels differ a lot/a little
+ * Build a map over which pixels differ a lot/a little, from the lines
+ * 2 + 2 * slice_start to 2 + 2 * slice_end of the abs diff mask
  */
-static void build_diff_map(FieldMatchContext *fm,
-                           const uint8_t *prvp, int prv_linesize,
-                           const uint8_t *nxtp, int nxt_linesize,
+static void build_diff_map(const FieldMatchContext *fm,
                            uint8_t *dstp, int dst_linesize, int height,
-                           int width, int plane)
+                           int width, int plane, int slice_start, int slice_end)
 {
     int x, y, u, diff, count;
     int tpitch = plane ? fm->tpitchuv : fm->tpitchy;
-    const uint8_t *dp = fm->tbuffer + tpitch;
+    const uint8_t *dp = fm->tbuffer + tpitch * (1 + slice_start);
 
-    build_abs_diff_mask(prvp, prv_linesize, nxtp, nxt_linesize,
-                        fm->tbuffer, tpitch, width, height>>1);
-
-    for (y = 2; y < height - 2; y += 2) {
+    dstp += slice_start * dst_linesize;
+    for (y = 2 + 2 * slice_start; y < 2 + 2 * slice_end; y += 2) {
         for (x = 1; x < width - 1; x++) {
             diff = dp[x];
             if (diff > 3) {
@@ -473,6 +532,58 @@ static void build_diff_map(FieldMatchContext *fm,
     }
 }
 
+static int get_nb_match_lines(int height)
+{
+    return FFMAX((height - 3) / 2, 0);
+}
+
+static int diff_map_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const FieldMatchContext *fm = ctx->priv;
+    const MatchThreadData *td = arg;
+    const int nb_lines = get_nb_match_lines(td->height);
+
+    build_diff_map(fm, td->dstp, td->dst_linesize, td->height, td->width, td->plane,
+                   (nb_lines *  jobnr     ) / nb_jobs,
+                   (nb_lines * (jobnr + 1)) / nb_jobs);
+    return 0;
+}
+
+static int match_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    const FieldMatchContext *fm = ctx->priv;
+    const MatchThreadData *td = arg;
+    const int nb_lines = get_nb_match_lines(td->height);
+    const int slice_start = (nb_lines *  jobnr     ) / nb_jobs;
+    const int slice_end   = (nb_lines * (jobnr + 1)) / nb_jobs;
+    const int width = td->stopx - td->startx;
+    const int w16 = width & ~15;
+    uint64_t *accum = fm->match_sums[jobnr];
+
+    if (width <= 0)
+        return 0;
+
+    for (int i = slice_start; i < slice_end; i++) {
+        const int y = 2 + 2 * i;
+        const uint8_t *rows[FM_ROW_NB], *tails[FM_ROW_NB];
+        uint32_t sums[FM_MATCH_NB] = { 0 };
+
+        if (td->y0a != td->y1a && y >= td->y0a && y <= td->y1a)
+            continue;
+
+        for (int r = 0; r < FM_ROW_NB; r++) {
+            rows[r]  = td->rows[r] + i * td->linesizes[r] + td->startx;
+            tails[r] = rows[r] + w16;
+        }
+        fm->dsp.match_row(sums, rows, w16);
+        match_row_c(sums, tails, width - w16);
+
+        for (int m = 0; m < FM_MATCH_NB; m++)
+            accum[m] += sums[m];
+    }
+    return 0;
+}
+
 enum { mP, mC, mN, mB, mU };
 
 static int get_field_base(int match, int field)
@@ -487,8 +598,9 @@ static AVFrame *select_frame(FieldMatchContext *fm, int match)
     else  /* match == mC */              return fm->src;
 }
 
-static int compare_fields(FieldMatchContext *fm, int match1, int match2, int field)
+static int compare_fields(AVFilterContext *ctx, int match1, int match2, int field)
 {
+    FieldMatchContext *fm = ctx->priv;
     int plane, ret;
     uint64_t accumPc = 0, accumPm = 0, accumPml = 0;
     uint64_t accumNc = 0, accumNm = 0, accumNml = 0;
@@ -496,8 +608,10 @@ static int compare_fields(FieldMatchContext *fm, int match1, int match2, int fie
     float c1, c2, mr;
     const AVFrame *src = fm->src;
 
+    memset(fm->match_sums, 0, fm->nb_threads * sizeof(*fm->match_sums));
+
     for (plane = 0; plane < (fm->mchroma ? 3 : 1); plane++) {
-        int x, y, temp1, temp2, fbase;
+        int fbase, nb_jobs;
         const AVFrame *prev, *next;
         uint8_t *mapp    = fm->map_data[plane];
         int map_linesize = fm->map_linesize[plane];
@@ -508,26 +622,29 @@ static int compare_fields(FieldMatchContext *fm, int match1, int match2, int fie
         int prvf_linesize, nxtf_linesize;
         const int width  = get_width (fm, src, plane, INPUT_MAIN);
         const int height = get_height(fm, src, plane, INPUT_MAIN);
-        const int y0a = fm->y0 >> (plane ? fm->vsub[INPUT_MAIN] : 0);
-        const int y1a = fm->y1 >> (plane ? fm->vsub[INPUT_MAIN] : 0);
         const int startx = (plane == 0 ? 8 : 8 >> fm->hsub[INPUT_MAIN]);
-        const int stopx  = width - startx;
-        const uint8_t *srcpf, *srcf, *srcnf;
-        const uint8_t *prvpf, *prvnf, *nxtpf, *nxtnf;
+        const uint8_t *srcf;
+        const uint8_t *prvpf, *nxtpf;
+        MatchThreadData td = {
+            .plane  = plane,
+            .width  = width,
+            .height = height,
+            .y0a    = fm->y0 >> (plane ? fm->vsub[INPUT_MAIN] : 0),
+            .y1a    = fm->y1 >> (plane ? fm->vsub[INPUT_MAIN] : 0),
+            .startx = startx,
+            .stopx  = width - startx,
+        };
 
         fill_buf(mapp, width, height, map_linesize, 0);
 
         /* match1 */
         fbase = get_field_base(match1, field);
         srcf  = srcp + (fbase + 1) * src_linesize;
-        srcpf = srcf - srcf_linesize;
-        srcnf = srcf + srcf_linesize;
         mapp  = mapp + fbase * map_linesize;
         prev = select_frame(fm, match1);
         prv_linesize  = prev->linesize[plane];
         prvf_linesize = prv_linesize << 1;
         prvpf = prev->data[plane] + fbase * prv_linesize;   // previous frame, previous field
-        prvnf = prvpf + prvf_linesize;                      // previous frame, next     field
 
         /* match2 */
         fbase = get_field_base(match2, field);
@@ -535,53 +652,54 @@ static int compare_fields(FieldMatchContext *fm, int match1, int match2, int fie
         nxt_linesize  = next->linesize[plane];
         nxtf_linesize = nxt_linesize << 1;
         nxtpf = next->data[plane] + fbase * nxt_linesize;   // next frame, previous field
-        nxtnf = nxtpf + nxtf_linesize;                      // next frame, next     field
 
         map_linesize <<= 1;
-        if ((match1 >= 3 && field == 1) || (match1 < 3 && field != 1))
-            build_diff_map(fm, prvpf, prvf_linesize, nxtpf, nxtf_linesize,
-                           mapp, map_linesize, height, width, plane);
-        else
-            build_diff_map(fm, prvnf, prvf_linesize, nxtnf, nxtf_linesize,
-                           mapp + map_linesize, map_linesize, height, width, plane);
-
-        for (y = 2; y < height - 2; y += 2) {
-            if (y0a == y1a || y < y0a || y > y1a) {
-                for (x = startx; x < stopx; x++) {
-                    if (mapp[x] > 0 || mapp[x + map_linesize] > 0) {
-                        temp1 = srcpf[x] + (srcf[x] << 2) + srcnf[x]; // [1 4 1]
-
-                        temp2 = abs(3 * (prvpf[x] + prvnf[x]) - temp1);
-                        if (temp2 > 23 && ((mapp[x]&1) || (mapp[x + map_linesize]&1)))
-                            accumPc += temp2;
-                        if (temp2 > 42) {
-                            if ((mapp[x]&2) || (mapp[x + map_linesize]&2))
-                                accumPm += temp2;
-                            if ((mapp[x]&4) || (mapp[x + map_linesize]&4))
-                                accumPml += temp2;
-                        }
 
-                        temp2 = abs(3 * (nxtpf[x] + nxtnf[x]) - temp1);
-                        if (temp2 > 23 && ((mapp[x]&1) || (mapp[x + map_linesize]&1)))
-                            accumNc += temp2;
-                        if (temp2 > 42) {
-                            if ((mapp[x]&2) || (mapp[x + map_linesize]&2))
-                                accumNm += temp2;
-                            if ((mapp[x]&4) || (mapp[x + map_linesize]&4))
-                                accumNml += temp2;
-                        }
-                    }
-                }
-            }
-            prvpf += prvf_linesize;
-            prvnf += prvf_linesize;
-            srcpf += srcf_linesize;
-            srcf  += srcf_linesize;
-            srcnf += srcf_linesize;
-            nxtpf += nxtf_linesize;
-            nxtnf += nxtf_linesize;
-            mapp  += map_linesize;
+        td.rows[FM_ROW_SRCPF] = srcf - srcf_linesize;
+        td.rows[FM_ROW_SRCF]  = srcf;
+        td.rows[FM_ROW_SRCNF] = srcf + srcf_linesize;
+        td.rows[FM_ROW_PRVPF] = prvpf;
+        td.rows[FM_ROW_PRVNF] = prvpf + prvf_linesize;      // previous frame, next     field
+        td.rows[FM_ROW_NXTPF] = nxtpf;
+        td.rows[FM_ROW_NXTNF] = nxtpf + nxtf_linesize;      // next frame, next     field
+        td.rows[FM_ROW_MAP0]  = mapp;
+        td.rows[FM_ROW_MAP1]  = mapp + map_linesize;
+        td.linesizes[FM_ROW_SRCPF] = td.linesizes[FM_ROW_SRCF] =
+        td.linesizes[FM_ROW_SRCNF] = srcf_linesize;
+        td.linesizes[FM_ROW_PRVPF] = td.linesizes[FM_ROW_PRVNF] = prvf_linesize;
+        td.linesizes[FM_ROW_NXTPF] = td.linesizes[FM_ROW_NXTNF] = nxtf_linesize;
+        td.linesizes[FM_ROW_MAP0]  = td.linesizes[FM_ROW_MAP1]  = map_linesize;
+
+        td.prv_linesize = prvf_linesize;
+        td.nxt_linesize = nxtf_linesize;
+        td.dst_linesize = map_linesize;
+        if ((match1 >= 3 && field == 1) || (match1 < 3 && field != 1)) {
+            td.prvp = td.rows[FM_ROW_PRVPF];
+            td.nxtp = td.rows[FM_ROW_NXTPF];
+            td.dstp = mapp;
+        } else {
+            td.prvp = td.rows[FM_ROW_PRVNF];
+            td.nxtp = td.rows[FM_ROW_NXTNF];
+            td.dstp = mapp + map_linesize;
         }
+
+        /* build the diff map, then accumulate the metrics over it */
+        nb_jobs = FFMIN(get_nb_match_lines(height), fm->nb_threads);
+        if (nb_jobs > 0) {
+            ff_filter_execute(ctx, abs_diff_mask_slice, &td, NULL,
+                              FFMIN(height >> 1, fm->nb_threads));
+            ff_filter_execute(ctx, diff_map_slice, &td, NULL, nb_jobs);
+            ff_filter_execute(ctx, match_slice,    &td, NULL, nb_jobs);
+        }
+    }
+
+    for (int j = 0; j < fm->nb_threads; j++) {
+        accumPc  += fm->match_sums[j][FM_MATCH_PC];
+        accumPm  += fm->match_sums[j][FM_MATCH_PM];
+        accumPml += fm->match_sums[j][FM_MATCH_PML];
+        accumNc  += fm->match_sums[j][FM_MATCH_NC];
+        accumNm  += fm->match_sums[j][FM_MATCH_NM];
+        accumNml += fm->match_sums[j][FM_MATCH_NML];
     }
 
     if (accumPm < 500 && accumNm < 500 && (accumPml >= 500 || accumNml >= 500) &&
@@ -660,7 +778,7 @@ static int checkmm(AVFilterContext *ctx, int *combs, int m1, int m2,
             gen_frames[mid] = create_weave_frame(ctx, mid, field,               \
                                                  fm->prv, fm->src, fm->nxt,     \
                                                  INPUT_MAIN);                   \
-        combs[mid] = calc_combed_score(fm, gen_frames[mid]);                    \
+        combs[mid] = calc_combed_score(ctx, gen_frames[mid]);                   \
     }                                                                           \
 } while (0)
 
@@ -734,7 +852,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
                 ret = AVERROR(ENOMEM);
                 goto fail;
             }
-            combs[i] = calc_combed_score(fm, gen_frames[i]);
+            combs[i] = calc_combed_score(ctx, gen_frames[i]);
         }
         av_log(ctx, AV_LOG_INFO, "COMBS: %3d %3d %3d %3d %3d\n",
                combs[0], combs[1], combs[2], combs[3], combs[4]);
@@ -747,22 +865,22 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     }
 
     /* p/c selection and optional 3-way p/c/n matches */
-    match = compare_fields(fm, fxo[mC], fxo[mP], field);
+    match = compare_fields(ctx, fxo[mC], fxo[mP], field);
     if (fm->mode == MODE_PCN || fm->mode == MODE_PCN_UB)
-        match = compare_fields(fm, match, fxo[mN], field);
+        match = compare_fields(ctx, match, fxo[mN], field);
 
     /* scene change check */
     if (fm->combmatch == COMBMATCH_SC) {
         if (fm->lastn == outlink->frame_count_in - 1) {
             if (fm->lastscdiff > fm->scthresh)
                 sc = 1;
-        } else if (luma_abs_diff(fm->prv, fm->src) > fm->scthresh) {
+        } else if (luma_abs_diff(fm, fm->prv, fm->src) > fm->scthresh) {
             sc = 1;
         }
 
         if (!sc) {
             fm->lastn = outlink->frame_count_in;
-            fm->lastscdiff = luma_abs_diff(fm->src, fm->nxt);
+            fm->lastscdiff = luma_abs_diff(fm, fm->src, fm->nxt);
             sc = fm->lastscdiff > fm->scthresh;
         }
     }
@@ -980,13 +1098,23 @@ static int config_input(AVFilterLink *inlink)
     fm->tpitchy  = FFALIGN(w,      16);
     fm->tpitchuv = FFALIGN(w >> 1, 16);
 
+    fm->nb_threads = ff_filter_get_nb_threads(ctx);
+    fm->c_array_size = (((w + fm->blockx/2)/fm->blockx)+1) *
+                       (((h + fm->blocky/2)/fm->blocky)+1) * 4;
+    fm->comb_counts_size = FFALIGN(w, 16);
+
     fm->tbuffer = av_calloc((h/2 + 4) * fm->tpitchy, sizeof(*fm->tbuffer));
-    fm->c_array = av_malloc_array((((w + fm->blockx/2)/fm->blockx)+1) *
-                            (((h + fm->blocky/2)/fm->blocky)+1),
-                            4 * sizeof(*fm->c_array));
-    if (!fm->tbuffer || !fm->c_array)
+    fm->c_array = av_malloc_array(fm->c_array_size, sizeof(*fm->c_array));
+    fm->c_arrays = av_malloc_array(fm->nb_threads * fm->c_array_size, sizeof(*fm->c_arrays));
+    fm->comb_counts = av_malloc_array(fm->nb_threads * fm->comb_counts_size,
+                                      sizeof(*fm->comb_counts));
+    fm->match_sums = av_malloc_array(fm->nb_threads, sizeof(*fm->match_sums));
+    if (!fm->tbuffer || !fm->c_array || !fm->c_arrays ||
+        !fm->comb_counts || !fm->match_sums)
         return AVERROR(ENOMEM);
 
+    ff_fieldmatch_init(&fm->dsp);
+
     return 0;
 }
 
@@ -1042,6 +1170,9 @@ static av_cold void fieldmatch_uninit(AVFilterContext *ctx)
     av_freep(&fm->cmask_data[0]);
     av_freep(&fm->tbuffer);
     av_freep(&fm->c_array);
+    av_freep(&fm->c_arrays);
+    av_freep(&fm->comb_counts);
+    av_freep(&fm->match_sums);
 }
 
 static int config_output(AVFilterLink *outlink)
@@ -1080,5 +1211,5 @@ const AVFilter ff_vf_fieldmatch = {
     FILTER_OUTPUTS(fieldmatch_outputs),
     FILTER_QUERY_FUNC(query_formats),
     .priv_class     = &fieldmatch_class,
-    .flags          = AVFILTER_FLAG_DYNAMIC_INPUTS,
+    .flags          = AVFILTER_FLAG_DYNAMIC_INPUTS | AVFILTER_FLAG_SLICE_THREADS,
 };
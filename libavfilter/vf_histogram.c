@@ -26,6 +26,7 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
 #include "avfilter.h"
 #include "formats.h"
 #include "internal.h"
@@ -37,6 +38,9 @@ typedef struct HistogramContext {
     int            envelope;
     int            slide;
     unsigned       histogram[256*256];
+    unsigned      *job_histogram;       ///< per slice bins, merged into histogram
+    int            job_bins;            ///< stride of job_histogram, covers any 16 bit value
+    int            nb_jobs;
     int            histogram_size;
     int            width;
     int            x_pos;
@@ -63,6 +67,11 @@ typedef struct HistogramContext {
     AVFrame       *out;
 } HistogramContext;
 
+typedef struct ThreadData {
+    AVFrame *in;
+    int plane;
+} ThreadData;
+
 #define OFFSET(x) offsetof(HistogramContext, x)
 #define FLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_VIDEO_PARAM
 
@@ -365,6 +374,15 @@ static int config_input(AVFilterLink *inlink)
     s->planewidth[1]  = s->planewidth[2]  = AV_CEIL_RSHIFT(inlink->w, s->desc->log2_chroma_w);
     s->planewidth[0]  = s->planewidth[3]  = inlink->w;
 
+    s->nb_jobs = FFMIN(ff_filter_get_nb_threads(inlink->dst), s->planeheight[1]);
+    s->job_bins = s->histogram_size <= 256 ? 256 : FF_ARRAY_ELEMS(s->histogram);
+    av_freep(&s->job_histogram);
+    if (s->nb_jobs > 1) {
+        s->job_histogram = av_calloc(s->nb_jobs, s->job_bins * sizeof(*s->job_histogram));
+        if (!s->job_histogram)
+            return AVERROR(ENOMEM);
+    }
+
     return 0;
 }
 
@@ -399,6 +417,60 @@ static int config_output(AVFilterLink *outlink)
     return 0;
 }
 
+static int histogram_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    HistogramContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const AVFrame *in = td->in;
+    const int p = td->plane;
+    const int width = s->planewidth[p];
+    const int height = s->planeheight[p];
+    const int slice_start = (height *  jobnr     ) / nb_jobs;
+    const int slice_end   = (height * (jobnr + 1)) / nb_jobs;
+    unsigned *histogram = s->histogram;
+
+    if (nb_jobs > 1) {
+        histogram = s->job_histogram + jobnr * s->job_bins;
+        memset(histogram, 0, s->histogram_size * sizeof(*histogram));
+    }
+
+    if (s->histogram_size <= 256) {
+        for (int i = slice_start; i < slice_end; i++) {
+            const uint8_t *src = in->data[p] + i * in->linesize[p];
+            for (int j = 0; j < width; j++)
+                histogram[src[j]]++;
+        }
+    } else {
+        for (int i = slice_start; i < slice_end; i++) {
+            const uint16_t *src = (const uint16_t *)(in->data[p] + i * in->linesize[p]);
+            for (int j = 0; j < width; j++)
+                histogram[src[j]]++;
+        }
+    }
+
+    return 0;
+}
+
+static void compute_histogram(AVFilterContext *ctx, AVFrame *in, int plane)
+{
+    HistogramContext *s = ctx->priv;
+    const int nb_jobs = s->job_histogram ? s->nb_jobs : 1;
+    ThreadData td;
+
+    td.in = in;
+    td.plane = plane;
+    ff_filter_execute(ctx, histogram_slice, &td, NULL, nb_jobs);
+
+    if (nb_jobs > 1) {
+        for (int n = 0; n < nb_jobs; n++) {
+            const unsigned *src = s->job_histogram + n * s->job_bins;
+
+            for (int i = 0; i < s->histogram_size; i++)
+                s->histogram[i] += src[i];
+        }
+    }
+}
+
 static int filter_frame(AVFilterLink *inlink, AVFrame *in)
 {
     HistogramContext *s   = inlink->dst->priv;
@@ -440,8 +512,6 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     for (m = 0, k = 0; k < s->ncomp; k++) {
         const int p = s->desc->comp[k].plane;
         const int max_value = s->histogram_size - 1 - s->start[p];
-        const int height = s->planeheight[p];
-        const int width = s->planewidth[p];
         const int mid = s->mid;
         double max_hval_log;
         unsigned max_hval = 0;
@@ -457,19 +527,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
             starty = m++ * (s->level_height + s->scale_height) * (s->display_mode == 2);
         }
 
-        if (s->histogram_size <= 256) {
-            for (i = 0; i < height; i++) {
-                const uint8_t *src = in->data[p] + i * in->linesize[p];
-                for (j = 0; j < width; j++)
-                    s->histogram[src[j]]++;
-            }
-        } else {
-            for (i = 0; i < height; i++) {
-                const uint16_t *src = (const uint16_t *)(in->data[p] + i * in->linesize[p]);
-                for (j = 0; j < width; j++)
-                    s->histogram[src[j]]++;
-            }
-        }
+        compute_histogram(ctx, in, p);
 
         for (i = 0; i < s->histogram_size; i++)
             max_hval = FFMAX(max_hval, s->histogram[i]);
@@ -617,6 +675,15 @@ end:
     return ff_filter_frame(outlink, out);
 }
 
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    HistogramContext *s = ctx->priv;
+
+    if (s->thistogram)
+        av_frame_free(&s->out);
+    av_freep(&s->job_histogram);
+}
+
 static const AVFilterPad inputs[] = {
     {
         .name         = "default",
@@ -643,20 +710,15 @@ const AVFilter ff_vf_histogram = {
     FILTER_INPUTS(inputs),
     FILTER_OUTPUTS(outputs),
     FILTER_QUERY_FUNC(query_formats),
+    .uninit        = uninit,
     .priv_class    = &histogram_class,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
 
 #endif /* CONFIG_HISTOGRAM_FILTER */
 
 #if CONFIG_THISTOGRAM_FILTER
 
-static av_cold void uninit(AVFilterContext *ctx)
-{
-    HistogramContext *s = ctx->priv;
-
-    av_frame_free(&s->out);
-}
-
 static const AVOption thistogram_options[] = {
     { "width", "set width", OFFSET(width), AV_OPT_TYPE_INT, {.i64=0}, 0, 8192, FLAGS},
     { "w",     "set width", OFFSET(width), AV_OPT_TYPE_INT, {.i64=0}, 0, 8192, FLAGS},
@@ -687,6 +749,7 @@ const AVFilter ff_vf_thistogram = {
     FILTER_QUERY_FUNC(query_formats),
     .uninit        = uninit,
     .priv_class    = &thistogram_class,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
 
 #endif /* CONFIG_THISTOGRAM_FILTER */
@@ -24,18 +24,23 @@
  * Use a palette to downsample an input video stream.
  */
 
+#include <stdatomic.h>
+
 #include "libavutil/bprint.h"
 #include "libavutil/file_open.h"
 #include "libavutil/internal.h"
 #include "libavutil/mem.h"
+#include "libavutil/mem_internal.h"
 #include "libavutil/opt.h"
 #include "libavutil/qsort.h"
+#include "libavutil/thread.h"
 #include "avfilter.h"
 #include "filters.h"
 #include "formats.h"
 #include "framesync.h"
 #include "internal.h"
 #include "palette.h"
+#include "vf_paletteuse_init.h"
 #include "video.h"
 
 enum dithering_mode {
@@ -51,6 +56,13 @@ enum dithering_mode {
     NB_DITHERING
 };
 
+enum color_search {
+    COLOR_SEARCH_AUTO,
+    COLOR_SEARCH_KDTREE,
+    COLOR_SEARCH_BRUTEFORCE,
+    NB_COLOR_SEARCH
+};
+
 enum diff_mode {
     DIFF_MODE_NONE,
     DIFF_MODE_RECTANGLE,
@@ -71,6 +83,12 @@ struct color_node {
 
 #define CACHE_SIZE (1<<15)
 
+/* width of the row segments handed over between error diffusion rows */
+#define DIFFUSION_CHUNK 64
+/* the error diffusion kernels reach 2 pixels on each side, so a row may only
+ * work on a pixel once the row above is done with the 4 pixels to its right */
+#define DIFFUSION_LAG 4
+
 struct cached_color {
     uint32_t color;
     uint8_t pal_entry;
@@ -83,29 +101,42 @@ struct cache_node {
 
 struct PaletteUseContext;
 
-typedef int (*set_frame_func)(struct PaletteUseContext *s, AVFrame *out, AVFrame *in,
-                              int x_start, int y_start, int width, int height);
+typedef int (*set_row_func)(struct PaletteUseContext *s, struct cache_node *cache,
+                            AVFrame *out, AVFrame *in,
+                            int x_start, int y_start, int width, int height,
+                            int y, int x0, int x1);
 
 typedef struct PaletteUseContext {
     const AVClass *class;
     FFFrameSync fs;
-    struct cache_node cache[CACHE_SIZE];    /* lookup cache */
+    struct cache_node *caches;              /* lookup caches, CACHE_SIZE entries per job */
+    int nb_caches;
+    int *job_rets;
     struct color_node map[AVPALETTE_COUNT]; /* 3D-Tree (KD-Tree with K=3) for reverse colormap */
+    DECLARE_ALIGNED(32, int32_t, search_lab)[3][AVPALETTE_COUNT]; /* map colors, for the brute force search */
+    int nb_search_colors;
+    PaletteUseDSPContext dsp;
     uint32_t palette[AVPALETTE_COUNT];
     int transparency_index; /* index in the palette of transparency. -1 if there is no transparency in the palette. */
     int trans_thresh;
     int palette_loaded;
     int dither;
     int new;
-    set_frame_func set_frame;
+    set_row_func set_row;
     int bayer_scale;
     int ordered_dither[8*8];
     int diff_mode;
     AVFrame *last_in;
     AVFrame *last_out;
 
+    /* error diffusion wavefront */
+    atomic_int *row_progress;
+    AVMutex progress_lock;
+    AVCond progress_cond;
+
     /* debug options */
     char *dot_filename;
+    int color_search;
     int calc_mean_err;
     uint64_t total_mean_err;
 } PaletteUseContext;
@@ -130,6 +161,10 @@ static const AVOption paletteuse_options[] = {
 
     /* following are the debug options, not part of the official API */
     { "debug_kdtree", "save Graphviz graph of the kdtree in specified file", OFFSET(dot_filename), AV_OPT_TYPE_STRING, {.str=NULL}, 0, 0, FLAGS },
+    { "debug_search", "select the nearest color search", OFFSET(color_search), AV_OPT_TYPE_INT, {.i64=COLOR_SEARCH_AUTO}, 0, NB_COLOR_SEARCH-1, FLAGS, .unit = "color_search" },
+        { "auto",       "brute force when SIMD accelerated, kdtree otherwise", 0, AV_OPT_TYPE_CONST, {.i64=COLOR_SEARCH_AUTO},       INT_MIN, INT_MAX, FLAGS, .unit = "color_search" },
+        { "kdtree",     "search the kdtree only",                              0, AV_OPT_TYPE_CONST, {.i64=COLOR_SEARCH_KDTREE},     INT_MIN, INT_MAX, FLAGS, .unit = "color_search" },
+        { "bruteforce", "compare against every color, kdtree on ties",          0, AV_OPT_TYPE_CONST, {.i64=COLOR_SEARCH_BRUTEFORCE}, INT_MIN, INT_MAX, FLAGS, .unit = "color_search" },
     { NULL }
 };
 
@@ -222,11 +257,22 @@ static void colormap_nearest_node(const struct color_node *map,
     }
 }
 
-static av_always_inline uint8_t colormap_nearest(const struct color_node *node, const struct color_info *target, const int trans_thresh)
+static av_always_inline uint8_t colormap_nearest(const PaletteUseContext *s, const struct color_info *target)
 {
     struct nearest_color res = {.dist_sqd = INT_MAX, .node_pos = -1};
-    colormap_nearest_node(node, 0, target, trans_thresh, &res);
-    return node[res.node_pos].palette_id;
+
+    /* the map only holds opaque colors, so for an opaque target the distance
+     * is the plain OkLab one; ties are left to the kdtree so that both
+     * searches always agree */
+    if (s->nb_search_colors && target->srgb >> 24 >= s->trans_thresh) {
+        const int node_pos = s->dsp.color_search(s->search_lab[0], s->search_lab[1], s->search_lab[2],
+                                                 s->nb_search_colors, target->lab);
+        if (node_pos >= 0)
+            return s->map[node_pos].palette_id;
+    }
+
+    colormap_nearest_node(s->map, 0, target, s->trans_thresh, &res);
+    return s->map[res.node_pos].palette_id;
 }
 
 struct stack_node {
@@ -238,11 +284,12 @@ struct stack_node {
  * Check if the requested color is in the cache already. If not, find it in the
  * color tree and cache it.
  */
-static av_always_inline int color_get(PaletteUseContext *s, uint32_t color)
+static av_always_inline int color_get(PaletteUseContext *s, struct cache_node *cache,
+                                      uint32_t color)
 {
     struct color_info clrinfo;
     const uint32_t hash = ff_lowbias32(color) & (CACHE_SIZE - 1);
-    struct cache_node *node = &s->cache[hash];
+    struct cache_node *node = &cache[hash];
     struct cached_color *e;
 
     // first, check for transparency
@@ -262,16 +309,16 @@ static av_always_inline int color_get(PaletteUseContext *s, uint32_t color)
         return AVERROR(ENOMEM);
     e->color = color;
     clrinfo = get_color_from_srgb(color);
-    e->pal_entry = colormap_nearest(s->map, &clrinfo, s->trans_thresh);
+    e->pal_entry = colormap_nearest(s, &clrinfo);
 
     return e->pal_entry;
 }
 
-static av_always_inline int get_dst_color_err(PaletteUseContext *s,
+static av_always_inline int get_dst_color_err(PaletteUseContext *s, struct cache_node *cache,
                                               uint32_t c, int *er, int *eg, int *eb)
 {
     uint32_t dstc;
-    const int dstx = color_get(s, c);
+    const int dstx = color_get(s, cache, c);
     if (dstx < 0)
         return dstx;
     dstc = s->palette[dstx];
@@ -288,170 +335,172 @@ static av_always_inline int get_dst_color_err(PaletteUseContext *s,
     return dstx;
 }
 
-static av_always_inline int set_frame(PaletteUseContext *s, AVFrame *out, AVFrame *in,
-                                      int x_start, int y_start, int w, int h,
-                                      enum dithering_mode dither)
+/**
+ * Map the pixels x0 to x1 - 1 of row y, in the processing window starting at
+ * (x_start, y_start) and of size w x h.
+ */
+static av_always_inline int set_row(PaletteUseContext *s, struct cache_node *cache,
+                                    AVFrame *out, AVFrame *in,
+                                    int x_start, int y_start, int w, int h,
+                                    int y, int x0, int x1,
+                                    enum dithering_mode dither)
 {
     const int src_linesize = in ->linesize[0] >> 2;
     const int dst_linesize = out->linesize[0];
-    uint32_t *src = ((uint32_t *)in ->data[0]) + y_start*src_linesize;
-    uint8_t  *dst =              out->data[0]  + y_start*dst_linesize;
+    uint32_t *src = ((uint32_t *)in ->data[0]) + y*src_linesize;
+    uint8_t  *dst =              out->data[0]  + y*dst_linesize;
 
     w += x_start;
     h += y_start;
 
-    for (int y = y_start; y < h; y++) {
-        for (int x = x_start; x < w; x++) {
-            int er, eg, eb;
-
-            if (dither == DITHERING_BAYER) {
-                const int d = s->ordered_dither[(y & 7)<<3 | (x & 7)];
-                const uint8_t a8 = src[x] >> 24;
-                const uint8_t r8 = src[x] >> 16 & 0xff;
-                const uint8_t g8 = src[x] >>  8 & 0xff;
-                const uint8_t b8 = src[x]       & 0xff;
-                const uint8_t r = av_clip_uint8(r8 + d);
-                const uint8_t g = av_clip_uint8(g8 + d);
-                const uint8_t b = av_clip_uint8(b8 + d);
-                const uint32_t color_new = (unsigned)(a8) << 24 | r << 16 | g << 8 | b;
-                const int color = color_get(s, color_new);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-            } else if (dither == DITHERING_HECKBERT) {
-                const int right = x < w - 1, down = y < h - 1;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-                if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 3, 3);
-                if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 3, 3);
-                if (right && down) src[src_linesize + x + 1] = dither_color(src[src_linesize + x + 1], er, eg, eb, 2, 3);
-
-            } else if (dither == DITHERING_FLOYD_STEINBERG) {
-                const int right = x < w - 1, down = y < h - 1, left = x > x_start;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-                if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 7, 4);
-                if (left  && down) src[src_linesize + x - 1] = dither_color(src[src_linesize + x - 1], er, eg, eb, 3, 4);
-                if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 5, 4);
-                if (right && down) src[src_linesize + x + 1] = dither_color(src[src_linesize + x + 1], er, eg, eb, 1, 4);
-
-            } else if (dither == DITHERING_SIERRA2) {
-                const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
-                const int right2 = x < w - 2,                    left2 = x > x_start + 1;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-                if (right)          src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 4, 4);
-                if (right2)         src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 3, 4);
-
-                if (down) {
-                    if (left2)      src[  src_linesize + x - 2] = dither_color(src[  src_linesize + x - 2], er, eg, eb, 1, 4);
-                    if (left)       src[  src_linesize + x - 1] = dither_color(src[  src_linesize + x - 1], er, eg, eb, 2, 4);
-                    if (1)          src[  src_linesize + x    ] = dither_color(src[  src_linesize + x    ], er, eg, eb, 3, 4);
-                    if (right)      src[  src_linesize + x + 1] = dither_color(src[  src_linesize + x + 1], er, eg, eb, 2, 4);
-                    if (right2)     src[  src_linesize + x + 2] = dither_color(src[  src_linesize + x + 2], er, eg, eb, 1, 4);
-                }
+    for (int x = x0; x < x1; x++) {
+        int er, eg, eb;
+
+        if (dither == DITHERING_BAYER) {
+            const int d = s->ordered_dither[(y & 7)<<3 | (x & 7)];
+            const uint8_t a8 = src[x] >> 24;
+            const uint8_t r8 = src[x] >> 16 & 0xff;
+            const uint8_t g8 = src[x] >>  8 & 0xff;
+            const uint8_t b8 = src[x]       & 0xff;
+            const uint8_t r = av_clip_uint8(r8 + d);
+            const uint8_t g = av_clip_uint8(g8 + d);
+            const uint8_t b = av_clip_uint8(b8 + d);
+            const uint32_t color_new = (unsigned)(a8) << 24 | r << 16 | g << 8 | b;
+            const int color = color_get(s, cache, color_new);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+        } else if (dither == DITHERING_HECKBERT) {
+            const int right = x < w - 1, down = y < h - 1;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+            if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 3, 3);
+            if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 3, 3);
+            if (right && down) src[src_linesize + x + 1] = dither_color(src[src_linesize + x + 1], er, eg, eb, 2, 3);
+
+        } else if (dither == DITHERING_FLOYD_STEINBERG) {
+            const int right = x < w - 1, down = y < h - 1, left = x > x_start;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+            if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 7, 4);
+            if (left  && down) src[src_linesize + x - 1] = dither_color(src[src_linesize + x - 1], er, eg, eb, 3, 4);
+            if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 5, 4);
+            if (right && down) src[src_linesize + x + 1] = dither_color(src[src_linesize + x + 1], er, eg, eb, 1, 4);
+
+        } else if (dither == DITHERING_SIERRA2) {
+            const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
+            const int right2 = x < w - 2,                    left2 = x > x_start + 1;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+            if (right)          src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 4, 4);
+            if (right2)         src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 3, 4);
+
+            if (down) {
+                if (left2)      src[  src_linesize + x - 2] = dither_color(src[  src_linesize + x - 2], er, eg, eb, 1, 4);
+                if (left)       src[  src_linesize + x - 1] = dither_color(src[  src_linesize + x - 1], er, eg, eb, 2, 4);
+                if (1)          src[  src_linesize + x    ] = dither_color(src[  src_linesize + x    ], er, eg, eb, 3, 4);
+                if (right)      src[  src_linesize + x + 1] = dither_color(src[  src_linesize + x + 1], er, eg, eb, 2, 4);
+                if (right2)     src[  src_linesize + x + 2] = dither_color(src[  src_linesize + x + 2], er, eg, eb, 1, 4);
+            }
 
-            } else if (dither == DITHERING_SIERRA2_4A) {
-                const int right = x < w - 1, down = y < h - 1, left = x > x_start;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-                if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 2, 2);
-                if (left  && down) src[src_linesize + x - 1] = dither_color(src[src_linesize + x - 1], er, eg, eb, 1, 2);
-                if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 1, 2);
-
-            } else if (dither == DITHERING_SIERRA3) {
-                const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
-                const int right2 = x < w - 2, down2 = y < h - 2, left2 = x > x_start + 1;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
-
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-
-                if (right)         src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 5, 5);
-                if (right2)        src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 3, 5);
-
-                if (down) {
-                    if (left2)     src[src_linesize   + x - 2] = dither_color(src[src_linesize   + x - 2], er, eg, eb, 2, 5);
-                    if (left)      src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 4, 5);
-                    if (1)         src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 5, 5);
-                    if (right)     src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 4, 5);
-                    if (right2)    src[src_linesize   + x + 2] = dither_color(src[src_linesize   + x + 2], er, eg, eb, 2, 5);
-
-                    if (down2) {
-                        if (left)  src[src_linesize*2 + x - 1] = dither_color(src[src_linesize*2 + x - 1], er, eg, eb, 2, 5);
-                        if (1)     src[src_linesize*2 + x    ] = dither_color(src[src_linesize*2 + x    ], er, eg, eb, 3, 5);
-                        if (right) src[src_linesize*2 + x + 1] = dither_color(src[src_linesize*2 + x + 1], er, eg, eb, 2, 5);
-                    }
+        } else if (dither == DITHERING_SIERRA2_4A) {
+            const int right = x < w - 1, down = y < h - 1, left = x > x_start;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+            if (right)         src[               x + 1] = dither_color(src[               x + 1], er, eg, eb, 2, 2);
+            if (left  && down) src[src_linesize + x - 1] = dither_color(src[src_linesize + x - 1], er, eg, eb, 1, 2);
+            if (         down) src[src_linesize + x    ] = dither_color(src[src_linesize + x    ], er, eg, eb, 1, 2);
+
+        } else if (dither == DITHERING_SIERRA3) {
+            const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
+            const int right2 = x < w - 2, down2 = y < h - 2, left2 = x > x_start + 1;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
+
+            if (color < 0)
+                return color;
+            dst[x] = color;
+
+            if (right)         src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 5, 5);
+            if (right2)        src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 3, 5);
+
+            if (down) {
+                if (left2)     src[src_linesize   + x - 2] = dither_color(src[src_linesize   + x - 2], er, eg, eb, 2, 5);
+                if (left)      src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 4, 5);
+                if (1)         src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 5, 5);
+                if (right)     src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 4, 5);
+                if (right2)    src[src_linesize   + x + 2] = dither_color(src[src_linesize   + x + 2], er, eg, eb, 2, 5);
+
+                if (down2) {
+                    if (left)  src[src_linesize*2 + x - 1] = dither_color(src[src_linesize*2 + x - 1], er, eg, eb, 2, 5);
+                    if (1)     src[src_linesize*2 + x    ] = dither_color(src[src_linesize*2 + x    ], er, eg, eb, 3, 5);
+                    if (right) src[src_linesize*2 + x + 1] = dither_color(src[src_linesize*2 + x + 1], er, eg, eb, 2, 5);
                 }
+            }
 
-            } else if (dither == DITHERING_BURKES) {
-                const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
-                const int right2 = x < w - 2,                    left2 = x > x_start + 1;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
+        } else if (dither == DITHERING_BURKES) {
+            const int right  = x < w - 1, down  = y < h - 1, left  = x > x_start;
+            const int right2 = x < w - 2,                    left2 = x > x_start + 1;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
 
-                if (color < 0)
-                    return color;
-                dst[x] = color;
+            if (color < 0)
+                return color;
+            dst[x] = color;
 
-                if (right)      src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 8, 5);
-                if (right2)     src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 4, 5);
+            if (right)      src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 8, 5);
+            if (right2)     src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 4, 5);
 
-                if (down) {
-                    if (left2)  src[src_linesize   + x - 2] = dither_color(src[src_linesize   + x - 2], er, eg, eb, 2, 5);
-                    if (left)   src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 4, 5);
-                    if (1)      src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 8, 5);
-                    if (right)  src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 4, 5);
-                    if (right2) src[src_linesize   + x + 2] = dither_color(src[src_linesize   + x + 2], er, eg, eb, 2, 5);
-                }
+            if (down) {
+                if (left2)  src[src_linesize   + x - 2] = dither_color(src[src_linesize   + x - 2], er, eg, eb, 2, 5);
+                if (left)   src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 4, 5);
+                if (1)      src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 8, 5);
+                if (right)  src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 4, 5);
+                if (right2) src[src_linesize   + x + 2] = dither_color(src[src_linesize   + x + 2], er, eg, eb, 2, 5);
+            }
 
-            } else if (dither == DITHERING_ATKINSON) {
-                const int right  = x < w - 1, down  = y < h - 1, left = x > x_start;
-                const int right2 = x < w - 2, down2 = y < h - 2;
-                const int color = get_dst_color_err(s, src[x], &er, &eg, &eb);
+        } else if (dither == DITHERING_ATKINSON) {
+            const int right  = x < w - 1, down  = y < h - 1, left = x > x_start;
+            const int right2 = x < w - 2, down2 = y < h - 2;
+            const int color = get_dst_color_err(s, cache, src[x], &er, &eg, &eb);
 
-                if (color < 0)
-                    return color;
-                dst[x] = color;
+            if (color < 0)
+                return color;
+            dst[x] = color;
 
-                if (right)     src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 1, 3);
-                if (right2)    src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 1, 3);
+            if (right)     src[                 x + 1] = dither_color(src[                 x + 1], er, eg, eb, 1, 3);
+            if (right2)    src[                 x + 2] = dither_color(src[                 x + 2], er, eg, eb, 1, 3);
 
-                if (down) {
-                    if (left)  src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 1, 3);
-                    if (1)     src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 1, 3);
-                    if (right) src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 1, 3);
-                    if (down2) src[src_linesize*2 + x    ] = dither_color(src[src_linesize*2 + x    ], er, eg, eb, 1, 3);
-                }
+            if (down) {
+                if (left)  src[src_linesize   + x - 1] = dither_color(src[src_linesize   + x - 1], er, eg, eb, 1, 3);
+                if (1)     src[src_linesize   + x    ] = dither_color(src[src_linesize   + x    ], er, eg, eb, 1, 3);
+                if (right) src[src_linesize   + x + 1] = dither_color(src[src_linesize   + x + 1], er, eg, eb, 1, 3);
+                if (down2) src[src_linesize*2 + x    ] = dither_color(src[src_linesize*2 + x    ], er, eg, eb, 1, 3);
+            }
 
-            } else {
-                const int color = color_get(s, src[x]);
+        } else {
+            const int color = color_get(s, cache, src[x]);
 
-                if (color < 0)
-                    return color;
-                dst[x] = color;
-            }
+            if (color < 0)
+                return color;
+            dst[x] = color;
         }
-        src += src_linesize;
-        dst += dst_linesize;
     }
     return 0;
 }
@@ -673,6 +722,15 @@ static void load_colormap(PaletteUseContext *s)
 
     colormap_insert(s->map, color_used, &nb_used, s->palette, s->trans_thresh, &box);
 
+    s->nb_search_colors = 0;
+    if (s->color_search == COLOR_SEARCH_BRUTEFORCE && nb_used) {
+        /* pad with colors far enough to never be picked */
+        s->nb_search_colors = FFALIGN(nb_used, 8);
+        for (int i = 0; i < s->nb_search_colors; i++)
+            for (int c = 0; c < 3; c++)
+                s->search_lab[c][i] = i < nb_used ? s->map[i].c.lab[c] : 1 << 20;
+    }
+
     if (s->dot_filename)
         disp_tree(s->map, s->dot_filename);
 }
@@ -766,6 +824,113 @@ static void set_processing_window(enum diff_mode diff_mode,
     *hp = height;
 }
 
+typedef struct ThreadData {
+    AVFrame *in, *out;
+    int x_start, y_start, w, h;
+    atomic_int next_row;
+} ThreadData;
+
+static int set_frame_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    PaletteUseContext *s = ctx->priv;
+    ThreadData *td = arg;
+    struct cache_node *cache = s->caches + jobnr * CACHE_SIZE;
+    const int slice_start = td->y_start + (td->h *  jobnr     ) / nb_jobs;
+    const int slice_end   = td->y_start + (td->h * (jobnr + 1)) / nb_jobs;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        int ret = s->set_row(s, cache, td->out, td->in, td->x_start, td->y_start,
+                             td->w, td->h, y, td->x_start, td->x_start + td->w);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static void report_row_progress(PaletteUseContext *s, int y, int x)
+{
+    ff_mutex_lock(&s->progress_lock);
+    atomic_store_explicit(&s->row_progress[y], x, memory_order_release);
+    ff_cond_broadcast(&s->progress_cond);
+    ff_mutex_unlock(&s->progress_lock);
+}
+
+static void await_row_progress(PaletteUseContext *s, int y, int x)
+{
+    if (atomic_load_explicit(&s->row_progress[y], memory_order_acquire) >= x)
+        return;
+
+    ff_mutex_lock(&s->progress_lock);
+    while (atomic_load_explicit(&s->row_progress[y], memory_order_acquire) < x)
+        ff_cond_wait(&s->progress_cond, &s->progress_lock);
+    ff_mutex_unlock(&s->progress_lock);
+}
+
+/**
+ * Error diffusion runs as a wavefront: every job picks the next unprocessed
+ * row and follows the row above it. Rows are handed out in order and a job
+ * only waits on rows picked before its own, so this cannot deadlock whatever
+ * the number of jobs actually running at once.
+ */
+static int set_frame_diffusion_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    PaletteUseContext *s = ctx->priv;
+    ThreadData *td = arg;
+    struct cache_node *cache = s->caches + jobnr * CACHE_SIZE;
+    const int x_end = td->x_start + td->w;
+    const int y_end = td->y_start + td->h;
+    const int chunk = nb_jobs > 1 ? DIFFUSION_CHUNK : td->w;
+    int y, ret = 0;
+
+    while ((y = atomic_fetch_add_explicit(&td->next_row, 1, memory_order_relaxed)) < y_end) {
+        for (int x = td->x_start; x < x_end; x += chunk) {
+            const int x1 = FFMIN(x + chunk, x_end);
+
+            if (nb_jobs > 1 && y > td->y_start)
+                await_row_progress(s, y - 1, FFMIN(x1 + DIFFUSION_LAG, x_end));
+            /* keep reporting progress on failure so that no row waits forever */
+            if (ret >= 0)
+                ret = s->set_row(s, cache, td->out, td->in, td->x_start, td->y_start,
+                                 td->w, td->h, y, x, x1);
+            if (nb_jobs > 1)
+                report_row_progress(s, y, x1);
+        }
+    }
+
+    return ret;
+}
+
+static int set_frame(AVFilterContext *ctx, AVFrame *out, AVFrame *in,
+                     int x_start, int y_start, int w, int h)
+{
+    PaletteUseContext *s = ctx->priv;
+    const int nb_jobs = FFMIN(h, s->nb_caches);
+    ThreadData td;
+
+    td.in      = in;
+    td.out     = out;
+    td.x_start = x_start;
+    td.y_start = y_start;
+    td.w       = w;
+    td.h       = h;
+
+    if (s->dither == DITHERING_NONE || s->dither == DITHERING_BAYER) {
+        ff_filter_execute(ctx, set_frame_slice, &td, s->job_rets, nb_jobs);
+    } else {
+        for (int y = y_start; y < y_start + h; y++)
+            atomic_init(&s->row_progress[y], 0);
+        atomic_init(&td.next_row, y_start);
+        ff_filter_execute(ctx, set_frame_diffusion_slice, &td, s->job_rets, nb_jobs);
+    }
+
+    for (int i = 0; i < nb_jobs; i++)
+        if (s->job_rets[i] < 0)
+            return s->job_rets[i];
+
+    return 0;
+}
+
 static int apply_palette(AVFilterLink *inlink, AVFrame *in, AVFrame **outf)
 {
     int x, y, w, h, ret;
@@ -794,7 +959,7 @@ static int apply_palette(AVFilterLink *inlink, AVFrame *in, AVFrame **outf)
     ff_dlog(ctx, "%dx%d rect: (%d;%d) -> (%d,%d) [area:%dx%d]\n",
             w, h, x, y, x+w, y+h, in->width, in->height);
 
-    ret = s->set_frame(s, out, in, x, y, w, h);
+    ret = set_frame(ctx, out, in, x, y, w, h);
     if (ret < 0) {
         av_frame_free(&out);
         *outf = NULL;
@@ -821,6 +986,13 @@ static int config_output(AVFilterLink *outlink)
     outlink->w = ctx->inputs[0]->w;
     outlink->h = ctx->inputs[0]->h;
 
+    s->nb_caches = ff_filter_get_nb_threads(ctx);
+    s->caches       = av_calloc(s->nb_caches * CACHE_SIZE, sizeof(*s->caches));
+    s->job_rets     = av_calloc(s->nb_caches, sizeof(*s->job_rets));
+    s->row_progress = av_calloc(outlink->h, sizeof(*s->row_progress));
+    if (!s->caches || !s->job_rets || !s->row_progress)
+        return AVERROR(ENOMEM);
+
     outlink->time_base = ctx->inputs[0]->time_base;
     if ((ret = ff_framesync_configure(&s->fs)) < 0)
         return ret;
@@ -853,9 +1025,10 @@ static void load_palette(PaletteUseContext *s, const AVFrame *palette_frame)
     if (s->new) {
         memset(s->palette, 0, sizeof(s->palette));
         memset(s->map, 0, sizeof(s->map));
-        for (i = 0; i < CACHE_SIZE; i++)
-            av_freep(&s->cache[i].entries);
-        memset(s->cache, 0, sizeof(s->cache));
+        for (i = 0; i < s->nb_caches * CACHE_SIZE; i++) {
+            av_freep(&s->caches[i].entries);
+            s->caches[i].nb_entries = 0;
+        }
     }
 
     i = 0;
@@ -902,33 +1075,35 @@ static int load_apply_palette(FFFrameSync *fs)
     return ff_filter_frame(ctx->outputs[0], out);
 }
 
-#define DEFINE_SET_FRAME(name, value)                                           \
-static int set_frame_##name(PaletteUseContext *s, AVFrame *out, AVFrame *in,    \
-                            int x_start, int y_start, int w, int h)             \
+#define DEFINE_SET_ROW(name, value)                                             \
+static int set_row_##name(PaletteUseContext *s, struct cache_node *cache,       \
+                          AVFrame *out, AVFrame *in,                            \
+                          int x_start, int y_start, int w, int h,               \
+                          int y, int x0, int x1)                                \
 {                                                                               \
-    return set_frame(s, out, in, x_start, y_start, w, h, value);                \
-}
-
-DEFINE_SET_FRAME(none,            DITHERING_NONE)
-DEFINE_SET_FRAME(bayer,           DITHERING_BAYER)
-DEFINE_SET_FRAME(heckbert,        DITHERING_HECKBERT)
-DEFINE_SET_FRAME(floyd_steinberg, DITHERING_FLOYD_STEINBERG)
-DEFINE_SET_FRAME(sierra2,         DITHERING_SIERRA2)
-DEFINE_SET_FRAME(sierra2_4a,      DITHERING_SIERRA2_4A)
-DEFINE_SET_FRAME(sierra3,         DITHERING_SIERRA3)
-DEFINE_SET_FRAME(burkes,          DITHERING_BURKES)
-DEFINE_SET_FRAME(atkinson,        DITHERING_ATKINSON)
-
-static const set_frame_func set_frame_lut[NB_DITHERING] = {
-    [DITHERING_NONE]            = set_frame_none,
-    [DITHERING_BAYER]           = set_frame_bayer,
-    [DITHERING_HECKBERT]        = set_frame_heckbert,
-    [DITHERING_FLOYD_STEINBERG] = set_frame_floyd_steinberg,
-    [DITHERING_SIERRA2]         = set_frame_sierra2,
-    [DITHERING_SIERRA2_4A]      = set_frame_sierra2_4a,
-    [DITHERING_SIERRA3]         = set_frame_sierra3,
-    [DITHERING_BURKES]          = set_frame_burkes,
-    [DITHERING_ATKINSON]        = set_frame_atkinson,
+    return set_row(s, cache, out, in, x_start, y_start, w, h, y, x0, x1, value);\
+}
+
+DEFINE_SET_ROW(none,            DITHERING_NONE)
+DEFINE_SET_ROW(bayer,           DITHERING_BAYER)
+DEFINE_SET_ROW(heckbert,        DITHERING_HECKBERT)
+DEFINE_SET_ROW(floyd_steinberg, DITHERING_FLOYD_STEINBERG)
+DEFINE_SET_ROW(sierra2,         DITHERING_SIERRA2)
+DEFINE_SET_ROW(sierra2_4a,      DITHERING_SIERRA2_4A)
+DEFINE_SET_ROW(sierra3,         DITHERING_SIERRA3)
+DEFINE_SET_ROW(burkes,          DITHERING_BURKES)
+DEFINE_SET_ROW(atkinson,        DITHERING_ATKINSON)
+
+static const set_row_func set_row_lut[NB_DITHERING] = {
+    [DITHERING_NONE]            = set_row_none,
+    [DITHERING_BAYER]           = set_row_bayer,
+    [DITHERING_HECKBERT]        = set_row_heckbert,
+    [DITHERING_FLOYD_STEINBERG] = set_row_floyd_steinberg,
+    [DITHERING_SIERRA2]         = set_row_sierra2,
+    [DITHERING_SIERRA2_4A]      = set_row_sierra2_4a,
+    [DITHERING_SIERRA3]         = set_row_sierra3,
+    [DITHERING_BURKES]          = set_row_burkes,
+    [DITHERING_ATKINSON]        = set_row_atkinson,
 };
 
 static int dither_value(int p)
@@ -943,12 +1118,20 @@ static av_cold int init(AVFilterContext *ctx)
 {
     PaletteUseContext *s = ctx->priv;
 
+    ff_mutex_init(&s->progress_lock, NULL);
+    ff_cond_init(&s->progress_cond, NULL);
+
     s->last_in  = av_frame_alloc();
     s->last_out = av_frame_alloc();
     if (!s->last_in || !s->last_out)
         return AVERROR(ENOMEM);
 
-    s->set_frame = set_frame_lut[s->dither];
+    ff_paletteuse_init(&s->dsp);
+    if (s->color_search == COLOR_SEARCH_AUTO)
+        s->color_search = s->dsp.color_search != color_search_c ? COLOR_SEARCH_BRUTEFORCE
+                                                                : COLOR_SEARCH_KDTREE;
+
+    s->set_row = set_row_lut[s->dither];
 
     if (s->dither == DITHERING_BAYER) {
         const int delta = 1 << (5 - s->bayer_scale); // to avoid too much luma
@@ -971,8 +1154,14 @@ static av_cold void uninit(AVFilterContext *ctx)
     PaletteUseContext *s = ctx->priv;
 
     ff_framesync_uninit(&s->fs);
-    for (int i = 0; i < CACHE_SIZE; i++)
-        av_freep(&s->cache[i].entries);
+    if (s->caches)
+        for (int i = 0; i < s->nb_caches * CACHE_SIZE; i++)
+            av_freep(&s->caches[i].entries);
+    av_freep(&s->caches);
+    av_freep(&s->job_rets);
+    av_freep(&s->row_progress);
+    ff_mutex_destroy(&s->progress_lock);
+    ff_cond_destroy(&s->progress_cond);
     av_frame_free(&s->last_in);
     av_frame_free(&s->last_out);
 }
@@ -1007,4 +1196,5 @@ const AVFilter ff_vf_paletteuse = {
     FILTER_OUTPUTS(paletteuse_outputs),
     FILTER_QUERY_FUNC(query_formats),
     .priv_class    = &paletteuse_class,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
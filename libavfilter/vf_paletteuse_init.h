@@ -0,0 +1,61 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_PALETTEUSE_INIT_H
+#define AVFILTER_PALETTEUSE_INIT_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "paletteusedsp.h"
+
+static int color_search_c(const int32_t *L, const int32_t *a, const int32_t *b,
+                          int nb_colors, const int32_t *target)
+{
+    int64_t min_dist = INT64_MAX;
+    int nb_min = 0, min_id = -1;
+
+    for (int i = 0; i < nb_colors; i++) {
+        const int64_t dL = L[i] - target[0];
+        const int64_t da = a[i] - target[1];
+        const int64_t db = b[i] - target[2];
+        const int64_t dist = dL*dL + da*da + db*db;
+
+        if (dist < min_dist) {
+            min_dist = dist;
+            min_id   = i;
+            nb_min   = 1;
+        } else if (dist == min_dist) {
+            nb_min++;
+        }
+    }
+
+    return nb_min == 1 && min_dist < INT32_MAX - 1 ? min_id : -1;
+}
+
+static av_unused void ff_paletteuse_init(PaletteUseDSPContext *dsp)
+{
+    dsp->color_search = color_search_c;
+
+#if ARCH_X86
+    ff_paletteuse_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_PALETTEUSE_INIT_H */
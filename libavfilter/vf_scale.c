@@ -691,6 +691,7 @@ static int config_props(AVFilterLink *outlink)
             ret = av_opt_copy(s, scale->sws_opts);
             if (ret < 0)
                 return ret;
+            sws_set_thread_pool(s, ctx->graph->thread_pool);
 
             av_opt_set_int(s, "srcw", inlink0 ->w, 0);
             av_opt_set_int(s, "srch", inlink0 ->h >> !!i, 0);
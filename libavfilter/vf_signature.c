@@ -29,7 +29,9 @@
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/avstring.h"
+#include "libavutil/file.h"
 #include "libavutil/file_open.h"
+#include "libavutil/intreadwrite.h"
 #include "avfilter.h"
 #include "internal.h"
 #include "signature.h"
@@ -50,9 +52,12 @@ static const AVOption signature_options[] = {
     { "filename",   "filename for output files",
         OFFSET(filename),     AV_OPT_TYPE_STRING, {.str = ""},       0, NB_FORMATS-1,     FLAGS },
     { "format",     "set output format",
-        OFFSET(format),       AV_OPT_TYPE_INT,    {.i64 = FORMAT_BINARY}, 0, 1,           FLAGS , .unit = "format" },
+        OFFSET(format),       AV_OPT_TYPE_INT,    {.i64 = FORMAT_BINARY}, 0, NB_FORMATS-1, FLAGS , .unit = "format" },
         { "binary", 0, 0, AV_OPT_TYPE_CONST, {.i64=FORMAT_BINARY}, 0, 0, FLAGS, .unit = "format" },
         { "xml",    0, 0, AV_OPT_TYPE_CONST, {.i64=FORMAT_XML},    0, 0, FLAGS, .unit = "format" },
+        { "index",  0, 0, AV_OPT_TYPE_CONST, {.i64=FORMAT_INDEX},  0, 0, FLAGS, .unit = "format" },
+    { "lookup",     "reference signature index to look up",
+        OFFSET(index_filename), AV_OPT_TYPE_STRING, {.str = NULL},   0, 0,                FLAGS },
     { "th_d",       "threshold to detect one word as similar",
         OFFSET(thworddist),   AV_OPT_TYPE_INT,    {.i64 = 9000},     1, INT_MAX,          FLAGS },
     { "th_dc",      "threshold to detect all words as similar",
@@ -141,6 +146,87 @@ static void set_bit(uint8_t* data, size_t pos)
     data[pos/8] |= mask;
 }
 
+typedef struct ThreadData {
+    StreamContext *sc;
+    CoarseSignature *cs;
+} ThreadData;
+
+static int lookup_index_jobs(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    SignatureContext *sic = ctx->priv;
+    ThreadData *td = arg;
+    FineSignature *fine = sic->ref_fine + (size_t)jobnr * sic->max_ref_frames;
+    const int start = (sic->nb_refs * jobnr) / nb_jobs;
+    const int end = (sic->nb_refs * (jobnr+1)) / nb_jobs;
+    int i;
+
+    for (i = start; i < end; i++) {
+        if (td->cs->first->index < td->sc->indexuntil[i]) {
+            /* still inside the last reported match of this reference */
+            sic->ref_matches[i].score = 0;
+            continue;
+        }
+        sic->ref_matches[i] = lookup_index_reference(ctx, sic, td->cs, &sic->refs[i], fine, sic->mode);
+    }
+    return 0;
+}
+
+/**
+ * looks up all coarsesignatures of an input, which are complete before the
+ * frame with index upto, in the reference index
+ */
+static int lookup_index(AVFilterContext *ctx, int input, uint32_t upto, AVFrame *frame)
+{
+    SignatureContext *sic = ctx->priv;
+    StreamContext *sc = &(sic->streamcontexts[input]);
+    int nb_jobs = FFMIN(sic->nb_refs, ff_filter_get_nb_threads(ctx));
+    CoarseSignature *cs;
+    ThreadData td;
+    int i, best;
+
+    if (!sic->ref_fine) {
+        sic->ref_fine = av_malloc_array((size_t)nb_jobs * sic->max_ref_frames, sizeof(*sic->ref_fine));
+        if (!sic->ref_fine)
+            return AVERROR(ENOMEM);
+    }
+
+    while ((cs = sc->indexlast ? sc->indexlast->next : sc->coarsesiglist) && cs->first &&
+           (upto == UINT32_MAX || upto >= cs->first->index + COARSE_SIZE)) {
+        sc->indexlast = cs;
+
+        td.sc = sc;
+        td.cs = cs;
+        ff_filter_execute(ctx, lookup_index_jobs, &td, NULL, nb_jobs);
+
+        best = -1;
+        for (i = 0; i < sic->nb_refs; i++) {
+            IndexMatch *m = &sic->ref_matches[i];
+            IndexReference *ref = &sic->refs[i];
+
+            if (m->score == 0)
+                continue;
+            sc->indexuntil[i] = m->first->index + m->matchframes;
+            av_log(ctx, AV_LOG_INFO, "matching of video %d at %f and reference %d at %f, %d frames matching\n",
+                   input, ((double) m->first->pts * sc->time_base.num) / sc->time_base.den,
+                   i, ((double) m->pts * ref->time_base.num) / ref->time_base.den,
+                   m->matchframes);
+            if (best < 0 || m->score > sic->ref_matches[best].score)
+                best = i;
+        }
+
+        if (frame && best >= 0) {
+            IndexMatch *m = &sic->ref_matches[best];
+            IndexReference *ref = &sic->refs[best];
+            char buf[64];
+
+            av_dict_set_int(&frame->metadata, "lavfi.signature.reference", best, 0);
+            snprintf(buf, sizeof(buf), "%f", ((double) m->pts * ref->time_base.num) / ref->time_base.den);
+            av_dict_set(&frame->metadata, "lavfi.signature.reference_time", buf, 0);
+        }
+    }
+    return 0;
+}
+
 static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
 {
     AVFilterContext *ctx = inlink->dst;
@@ -174,6 +260,16 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
 
     int64_t precfactor = (sc->divide) ? 65536 : BLOCK_LCM;
 
+    /* look up the coarsesignatures completed with the previous frame; this
+     * is done before the fine signature of this frame is linked into the
+     * list, as the lookup walks the list past the coarse signature */
+    if (sic->nb_refs) {
+        int ret = lookup_index(ctx, FF_INLINK_IDX(inlink), sc->lastindex,
+                               FF_INLINK_IDX(inlink) == 0 ? picref : NULL);
+        if (ret < 0)
+            return ret;
+    }
+
     /* initialize fs */
     if (sc->curfinesig) {
         fs = av_mallocz(sizeof(FineSignature));
@@ -295,6 +391,10 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
                 ternary = 2;
             }
             fs->framesig[f/5] += ternary * pot3[f%5];
+            if (ternary >= 1)
+                set_bit(fs->l1planes, f);
+            if (ternary == 2)
+                set_bit(fs->l1planes + L1PLANES_SIZE/2, f);
 
             if (f == wordvec[w]) {
                 fs->words[s2usw[w]/5] += ternary * pot3[wordt2b[s2usw[w]/5]++];
@@ -559,6 +659,81 @@ static int binary_export(AVFilterContext *ctx, StreamContext *sc, const char* fi
     return 0;
 }
 
+static int index_export(AVFilterContext *ctx, StreamContext *sc, const char* filename)
+{
+    FILE* f;
+    FineSignature* fs;
+    CoarseSignature* cs;
+    uint32_t nb_coarse = 0;
+    uint64_t size;
+    uint8_t *buffer, *p;
+    int ret = 0;
+
+    if (!sc->lastindex)
+        return AVERROR(EINVAL); // No frames ?
+
+    for (cs = sc->coarsesiglist; cs; cs = cs->next)
+        nb_coarse++;
+    size = INDEX_RECORD_HEADER_SIZE + (uint64_t)nb_coarse * INDEX_COARSE_SIZE +
+           (uint64_t)sc->lastindex * INDEX_FINE_SIZE;
+    if (size > SIZE_MAX)
+        return AVERROR(EINVAL);
+    p = buffer = av_mallocz(size);
+    if (!buffer)
+        return AVERROR(ENOMEM);
+
+    /* record header */
+    AV_WL64(p, size);
+    AV_WL32(p + 8, sc->lastindex); /* NumOfFrames */
+    AV_WL32(p + 12, nb_coarse);
+    AV_WL32(p + 16, sc->time_base.num);
+    AV_WL32(p + 20, sc->time_base.den);
+    AV_WL16(p + 24, sc->w);
+    AV_WL16(p + 26, sc->h);
+    p += INDEX_RECORD_HEADER_SIZE;
+    /* coarsesignatures */
+    for (cs = sc->coarsesiglist; cs; cs = cs->next) {
+        AV_WL32(p, cs->first->index);
+        AV_WL32(p + 4, cs->last->index);
+        memcpy(p + 16, cs->data, COARSE_WORDS * COARSE_WORD_SIZE);
+        p += INDEX_COARSE_SIZE;
+    }
+    /* finesignatures */
+    for (fs = sc->finesiglist; fs; fs = fs->next) {
+        AV_WL64(p, fs->pts);
+        p[8] = fs->confidence;
+        memcpy(p + 9, fs->words, 5);
+        memcpy(p + 16, fs->l1planes, L1PLANES_SIZE);
+        p += INDEX_FINE_SIZE;
+    }
+
+    f = avpriv_fopen_utf8(filename, "ab");
+    if (!f) {
+        int err = AVERROR(EINVAL);
+        char buf[128];
+        av_strerror(err, buf, sizeof(buf));
+        av_log(ctx, AV_LOG_ERROR, "cannot open index file %s: %s\n", filename, buf);
+        av_freep(&buffer);
+        return err;
+    }
+    /* records are appended, the header is only written to a new index */
+    if (fseek(f, 0, SEEK_END) < 0) {
+        ret = AVERROR(EIO);
+    } else if (ftell(f) == 0) {
+        uint8_t header[INDEX_HEADER_SIZE] = INDEX_MAGIC;
+        AV_WL32(header + 8, INDEX_VERSION);
+        if (fwrite(header, 1, INDEX_HEADER_SIZE, f) != INDEX_HEADER_SIZE)
+            ret = AVERROR(EIO);
+    }
+    if (!ret && fwrite(buffer, 1, size, f) != size)
+        ret = AVERROR(EIO);
+    if (ret < 0)
+        av_log(ctx, AV_LOG_ERROR, "cannot write index file %s\n", filename);
+    fclose(f);
+    av_freep(&buffer);
+    return ret;
+}
+
 static int export(AVFilterContext *ctx, StreamContext *sc, int input)
 {
     SignatureContext* sic = ctx->priv;
@@ -573,6 +748,8 @@ static int export(AVFilterContext *ctx, StreamContext *sc, int input)
     }
     if (sic->format == FORMAT_XML) {
         return xml_export(ctx, sc, filename);
+    } else if (sic->format == FORMAT_INDEX) {
+        return index_export(ctx, sc, filename);
     } else {
         return binary_export(ctx, sc, filename);
     }
@@ -599,6 +776,12 @@ static int request_frame(AVFilterLink *outlink)
 
         /* export signature at EOF */
         if (ret == AVERROR_EOF && !sc->exported) {
+            /* look up the remaining coarsesignatures */
+            if (sic->nb_refs) {
+                int err = lookup_index(ctx, i, UINT32_MAX, NULL);
+                if (err < 0)
+                    return err;
+            }
             /* export if wanted */
             if (strlen(sic->filename) > 0) {
                 if (export(ctx, sc, i) < 0)
@@ -634,6 +817,85 @@ static int request_frame(AVFilterLink *outlink)
     return ret;
 }
 
+/**
+ * maps a reference index and validates its records
+ */
+static av_cold int load_index(AVFilterContext *ctx)
+{
+    SignatureContext *sic = ctx->priv;
+    const uint8_t *p, *end;
+    uint32_t i;
+    int n, pass, ret;
+
+    ret = av_file_map(sic->index_filename, &sic->index_buf, &sic->index_size, 0, ctx);
+    if (ret < 0)
+        return ret;
+    end = sic->index_buf + sic->index_size;
+
+    if (sic->index_size < INDEX_HEADER_SIZE ||
+        memcmp(sic->index_buf, INDEX_MAGIC, 8) ||
+        AV_RL32(sic->index_buf + 8) != INDEX_VERSION)
+        goto invalid;
+
+    /* count the records first, then fill the reference table */
+    sic->max_ref_frames = 1;
+    for (pass = 0; pass < 2; pass++) {
+        for (p = sic->index_buf + INDEX_HEADER_SIZE, n = 0; p < end; n++) {
+            uint64_t size;
+            uint32_t nb_frames, nb_coarse;
+
+            if (end - p < INDEX_RECORD_HEADER_SIZE)
+                goto invalid;
+            size      = AV_RL64(p);
+            nb_frames = AV_RL32(p + 8);
+            nb_coarse = AV_RL32(p + 12);
+            if (size > end - p || size != INDEX_RECORD_HEADER_SIZE +
+                                          (uint64_t)nb_coarse * INDEX_COARSE_SIZE +
+                                          (uint64_t)nb_frames * INDEX_FINE_SIZE)
+                goto invalid;
+
+            if (pass) {
+                IndexReference *ref = &sic->refs[n];
+
+                ref->nb_frames = nb_frames;
+                ref->nb_coarse = nb_coarse;
+                ref->time_base = (AVRational){ AV_RL32(p + 16), AV_RL32(p + 20) };
+                ref->coarse = p + INDEX_RECORD_HEADER_SIZE;
+                ref->fine = ref->coarse + (size_t)nb_coarse * INDEX_COARSE_SIZE;
+                if (ref->time_base.num <= 0 || ref->time_base.den <= 0)
+                    goto invalid;
+                for (i = 0; i < nb_coarse; i++) {
+                    if (AV_RL32(ref->coarse + (size_t)i * INDEX_COARSE_SIZE) >= nb_frames)
+                        goto invalid;
+                }
+                sic->max_ref_frames = FFMAX(sic->max_ref_frames, nb_frames);
+            }
+            p += size;
+        }
+
+        if (!pass) {
+            if (!n) {
+                av_log(ctx, AV_LOG_WARNING, "index file %s is empty\n", sic->index_filename);
+                return 0;
+            }
+            sic->nb_refs = n;
+            sic->refs = av_calloc(n, sizeof(*sic->refs));
+            sic->ref_matches = av_calloc(n, sizeof(*sic->ref_matches));
+            if (!sic->refs || !sic->ref_matches)
+                return AVERROR(ENOMEM);
+        }
+    }
+
+    av_log(ctx, AV_LOG_VERBOSE, "loaded %d reference signatures from %s\n",
+           sic->nb_refs, sic->index_filename);
+    return 0;
+
+invalid:
+    av_log(ctx, AV_LOG_ERROR, "invalid index file %s\n", sic->index_filename);
+    sic->nb_refs = 0;
+    return AVERROR_INVALIDDATA;
+}
+
 static av_cold int init(AVFilterContext *ctx)
 {
 
@@ -682,6 +944,23 @@ static av_cold int init(AVFilterContext *ctx)
         return AVERROR(EINVAL);
     }
 
+    ff_signature_init(&sic->dsp);
+
+    if (sic->index_filename) {
+        if (sic->mode == MODE_OFF) {
+            av_log(ctx, AV_LOG_ERROR, "An index lookup needs a detectmode.\n");
+            return AVERROR(EINVAL);
+        }
+        if ((ret = load_index(ctx)) < 0)
+            return ret;
+        for (i = 0; i < sic->nb_inputs && sic->nb_refs; i++) {
+            sc = &(sic->streamcontexts[i]);
+            sc->indexuntil = av_calloc(sic->nb_refs, sizeof(*sc->indexuntil));
+            if (!sc->indexuntil)
+                return AVERROR(ENOMEM);
+        }
+    }
+
     return 0;
 }
 
@@ -717,9 +996,16 @@ static av_cold void uninit(AVFilterContext *ctx)
                 av_freep(&tmp);
             }
             sc->coarsesiglist = NULL;
+            av_freep(&sc->indexuntil);
         }
         av_freep(&sic->streamcontexts);
     }
+
+    if (sic->index_buf)
+        av_file_unmap(sic->index_buf, sic->index_size);
+    av_freep(&sic->refs);
+    av_freep(&sic->ref_matches);
+    av_freep(&sic->ref_fine);
 }
 
 static int config_output(AVFilterLink *outlink)
@@ -755,5 +1041,6 @@ const AVFilter ff_vf_signature = {
     FILTER_OUTPUTS(signature_outputs),
     .inputs        = NULL,
     FILTER_PIXFMTS_ARRAY(pix_fmts),
-    .flags         = AVFILTER_FLAG_DYNAMIC_INPUTS,
+    .flags         = AVFILTER_FLAG_DYNAMIC_INPUTS |
+                     AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -27,6 +27,7 @@
 #include "avfilter.h"
 #include "formats.h"
 #include "internal.h"
+#include "vectorscopedsp.h"
 #include "video.h"
 
 enum GraticuleType {
@@ -76,13 +77,25 @@ typedef struct VectorscopeContext {
     int cs;
     uint8_t *peak_memory;
     uint8_t **peak;
+    uint16_t *slice_memory;
+    int nb_jobs;
 
-    void (*vectorscope)(struct VectorscopeContext *s,
+    VectorscopeDSPContext dsp;
+
+    void (*vectorscope)(AVFilterContext *ctx,
                         AVFrame *in, AVFrame *out, int pd);
     void (*graticulef)(struct VectorscopeContext *s, AVFrame *out,
                        int X, int Y, int D, int P);
 } VectorscopeContext;
 
+typedef struct ThreadData {
+    AVFrame *in, *out;
+    int pd;
+} ThreadData;
+
+/* upper bound for the per slice accumulation planes */
+#define MAX_SLICE_MEMORY (64 << 20)
+
 #define OFFSET(x) offsetof(VectorscopeContext, x)
 #define FLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_VIDEO_PARAM
 #define TFLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_RUNTIME_PARAM
@@ -414,8 +427,243 @@ static void envelope(VectorscopeContext *s, AVFrame *out)
     }
 }
 
-static void vectorscope16(VectorscopeContext *s, AVFrame *in, AVFrame *out, int pd)
+/*
+ * Slice threaded plotting: every job accumulates its rows into a private
+ * plane, coded as 0 for untouched positions and as 1 + the saturated
+ * intensity sum (or 1 + the maximum for color4) otherwise. The planes
+ * are then merged row by row into the output, which gives the same
+ * result as plotting all pixels in order.
+ */
+static int plot_slice8(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    VectorscopeContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const AVFrame *in = td->in;
+    const int pd = td->pd;
+    const int px = s->x, py = s->y;
+    const int color4 = s->mode == COLOR4;
+    const int h = color4 ? in->height : s->planeheight[py];
+    const int w = color4 ? in->width  : s->planewidth[px];
+    const int hsub = color4 ? s->hsub : 0;
+    const int vsub = color4 ? s->vsub : 0;
+    const int slinesizex = in->linesize[px];
+    const int slinesizey = in->linesize[py];
+    const int slinesized = in->linesize[pd];
+    const uint8_t *spx = in->data[px];
+    const uint8_t *spy = in->data[py];
+    const uint8_t *spd = in->data[pd];
+    const int limit = s->size;
+    const int intensity = s->intensity;
+    const int tmin = s->tmin;
+    const int tmax = s->tmax;
+    const int slice_start = (h *  jobnr     ) / nb_jobs;
+    const int slice_end   = (h * (jobnr + 1)) / nb_jobs;
+    uint16_t *dst = s->slice_memory + jobnr * s->size * s->size;
+
+    memset(dst, 0, s->size * s->size * sizeof(*dst));
+
+    for (int i = slice_start; i < slice_end; i++) {
+        const int iwx = (i >> vsub) * slinesizex;
+        const int iwy = (i >> vsub) * slinesizey;
+        const int iwd = i * slinesized;
+
+        for (int j = 0; j < w; j++) {
+            const int x = spx[iwx + (j >> hsub)];
+            const int y = spy[iwy + (j >> hsub)];
+            const int z = spd[iwd + j];
+            const int pos = y * 256 + x;
+
+            if (z < tmin || z > tmax)
+                continue;
+
+            if (color4)
+                dst[pos] = FFMAX(dst[pos], z + 1);
+            else if (s->mode == COLOR2)
+                dst[pos] = 1;
+            else
+                dst[pos] = FFMIN(FFMAX(dst[pos], 1) + intensity, limit);
+        }
+    }
+
+    return 0;
+}
+
+static int plot_slice16(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
+    VectorscopeContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const AVFrame *in = td->in;
+    const int pd = td->pd;
+    const int px = s->x, py = s->y;
+    const int color4 = s->mode == COLOR4;
+    const int h = color4 ? in->height : s->planeheight[py];
+    const int w = color4 ? in->width  : s->planewidth[px];
+    const int hsub = color4 ? s->hsub : 0;
+    const int vsub = color4 ? s->vsub : 0;
+    const int slinesizex = in->linesize[px] / 2;
+    const int slinesizey = in->linesize[py] / 2;
+    const int slinesized = in->linesize[pd] / 2;
+    const uint16_t *spx = (const uint16_t *)in->data[px];
+    const uint16_t *spy = (const uint16_t *)in->data[py];
+    const uint16_t *spd = (const uint16_t *)in->data[pd];
+    const int max = s->size - 1;
+    const int limit = s->size;
+    const int intensity = s->intensity;
+    const int tmin = s->tmin;
+    const int tmax = s->tmax;
+    const int slice_start = (h *  jobnr     ) / nb_jobs;
+    const int slice_end   = (h * (jobnr + 1)) / nb_jobs;
+    uint16_t *dst = s->slice_memory + jobnr * s->size * s->size;
+
+    memset(dst, 0, s->size * s->size * sizeof(*dst));
+
+    for (int i = slice_start; i < slice_end; i++) {
+        const int iwx = (i >> vsub) * slinesizex;
+        const int iwy = (i >> vsub) * slinesizey;
+        const int iwd = i * slinesized;
+
+        for (int j = 0; j < w; j++) {
+            const int x = FFMIN(spx[iwx + (j >> hsub)], max);
+            const int y = FFMIN(spy[iwy + (j >> hsub)], max);
+            const int z = spd[iwd + j];
+            const int pos = y * s->size + x;
+
+            if (z < tmin || z > tmax)
+                continue;
+
+            if (color4)
+                dst[pos] = FFMAX(dst[pos], z + 1);
+            else if (s->mode == COLOR2)
+                dst[pos] = 1;
+            else
+                dst[pos] = FFMIN(FFMAX(dst[pos], 1) + intensity, limit);
+        }
+    }
+
+    return 0;
+}
+
+static int merge_slice8(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    VectorscopeContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *out = td->out;
+    const int pd = td->pd;
+    const int dlinesize = out->linesize[0];
+    const ptrdiff_t stride = s->size * s->size;
+    uint8_t *dpx = out->data[s->x];
+    uint8_t *dpy = out->data[s->y];
+    uint8_t *dpd = out->data[pd];
+    const int slice_start = (s->size *  jobnr     ) / nb_jobs;
+    const int slice_end   = (s->size * (jobnr + 1)) / nb_jobs;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        uint16_t *row = s->slice_memory + y * s->size;
+
+        if (s->mode == COLOR2 || s->mode == COLOR4)
+            s->dsp.reduce_max(row, row, stride, nb_jobs, s->size);
+        else
+            s->dsp.reduce_sum(row, row, stride, nb_jobs, s->size);
+
+        for (int x = 0; x < s->size; x++) {
+            const int v = row[x];
+            const int pos = y * dlinesize + x;
+
+            if (!v)
+                continue;
+
+            switch (s->mode) {
+            case COLOR2:
+                if (!dpd[pos])
+                    dpd[pos] = s->is_yuv ? FFABS(128 - x) + FFABS(128 - y) : FFMIN(x + y, 255);
+                break;
+            case COLOR4:
+                dpd[pos] = FFMAX(v - 1, dpd[pos]);
+                break;
+            default:
+                dpd[pos] = FFMIN(dpd[pos] + v - 1, 255);
+            }
+
+            if (s->mode == COLOR2 || s->mode == COLOR3 || s->mode == COLOR4) {
+                dpx[pos] = x;
+                dpy[pos] = y;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int merge_slice16(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    VectorscopeContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *out = td->out;
+    const int pd = td->pd;
+    const int dlinesize = out->linesize[0] / 2;
+    const ptrdiff_t stride = s->size * s->size;
+    const int max = s->size - 1;
+    const int mid = s->size / 2;
+    uint16_t *dpx = (uint16_t *)out->data[s->x];
+    uint16_t *dpy = (uint16_t *)out->data[s->y];
+    uint16_t *dpd = (uint16_t *)out->data[pd];
+    const int slice_start = (s->size *  jobnr     ) / nb_jobs;
+    const int slice_end   = (s->size * (jobnr + 1)) / nb_jobs;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        uint16_t *row = s->slice_memory + y * s->size;
+
+        if (s->mode == COLOR2 || s->mode == COLOR4)
+            s->dsp.reduce_max(row, row, stride, nb_jobs, s->size);
+        else
+            s->dsp.reduce_sum(row, row, stride, nb_jobs, s->size);
+
+        for (int x = 0; x < s->size; x++) {
+            const int v = row[x];
+            const int pos = y * dlinesize + x;
+
+            if (!v)
+                continue;
+
+            switch (s->mode) {
+            case COLOR2:
+                if (!dpd[pos])
+                    dpd[pos] = s->is_yuv ? FFABS(mid - x) + FFABS(mid - y) : FFMIN(x + y, max);
+                break;
+            case COLOR4:
+                dpd[pos] = FFMAX(v - 1, dpd[pos]);
+                break;
+            default:
+                dpd[pos] = FFMIN(dpd[pos] + v - 1, max);
+            }
+
+            if (s->mode == COLOR2 || s->mode == COLOR3 || s->mode == COLOR4) {
+                dpx[pos] = x;
+                dpy[pos] = y;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void plot_slices(AVFilterContext *ctx, AVFrame *in, AVFrame *out, int pd)
+{
+    VectorscopeContext *s = ctx->priv;
+    ThreadData td;
+
+    td.in  = in;
+    td.out = out;
+    td.pd  = pd;
+    ff_filter_execute(ctx, s->size == 256 ? plot_slice8 : plot_slice16,
+                      &td, NULL, s->nb_jobs);
+    ff_filter_execute(ctx, s->size == 256 ? merge_slice8 : merge_slice16,
+                      &td, NULL, s->nb_jobs);
+}
+
+static void vectorscope16(AVFilterContext *ctx, AVFrame *in, AVFrame *out, int pd)
+{
+    VectorscopeContext *s = ctx->priv;
     const uint16_t * const *src = (const uint16_t * const *)in->data;
     const int slinesizex = in->linesize[s->x] / 2;
     const int slinesizey = in->linesize[s->y] / 2;
@@ -449,49 +697,74 @@ static void vectorscope16(VectorscopeContext *s, AVFrame *in, AVFrame *out, int
                         (s->mode == COLOR || s->mode == COLOR5) && k == s->pd ? 0 : s->bg_color[k]);
     }
 
-    switch (s->mode) {
-    case COLOR:
-    case COLOR5:
-    case TINT:
-        for (i = 0; i < h; i++) {
-            const int iwx = i * slinesizex;
-            const int iwy = i * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < w; j++) {
-                const int x = FFMIN(spx[iwx + j], max);
-                const int y = FFMIN(spy[iwy + j], max);
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMIN(dpd[pos] + intensity, max);
-            }
-        }
-        break;
-    case COLOR2:
-        if (s->is_yuv) {
+    if (s->nb_jobs > 1) {
+        plot_slices(ctx, in, out, pd);
+    } else {
+        switch (s->mode) {
+        case COLOR:
+        case COLOR5:
+        case TINT:
             for (i = 0; i < h; i++) {
-                const int iw1 = i * slinesizex;
-                const int iw2 = i * slinesizey;
+                const int iwx = i * slinesizex;
+                const int iwy = i * slinesizey;
                 const int iwd = i * slinesized;
                 for (j = 0; j < w; j++) {
-                    const int x = FFMIN(spx[iw1 + j], max);
-                    const int y = FFMIN(spy[iw2 + j], max);
+                    const int x = FFMIN(spx[iwx + j], max);
+                    const int y = FFMIN(spy[iwy + j], max);
                     const int z = spd[iwd + j];
                     const int pos = y * dlinesize + x;
 
                     if (z < tmin || z > tmax)
                         continue;
 
-                    if (!dpd[pos])
-                        dpd[pos] = FFABS(mid - x) + FFABS(mid - y);
-                    dpx[pos] = x;
-                    dpy[pos] = y;
+                    dpd[pos] = FFMIN(dpd[pos] + intensity, max);
+                }
+            }
+            break;
+        case COLOR2:
+            if (s->is_yuv) {
+                for (i = 0; i < h; i++) {
+                    const int iw1 = i * slinesizex;
+                    const int iw2 = i * slinesizey;
+                    const int iwd = i * slinesized;
+                    for (j = 0; j < w; j++) {
+                        const int x = FFMIN(spx[iw1 + j], max);
+                        const int y = FFMIN(spy[iw2 + j], max);
+                        const int z = spd[iwd + j];
+                        const int pos = y * dlinesize + x;
+
+                        if (z < tmin || z > tmax)
+                            continue;
+
+                        if (!dpd[pos])
+                            dpd[pos] = FFABS(mid - x) + FFABS(mid - y);
+                        dpx[pos] = x;
+                        dpy[pos] = y;
+                    }
+                }
+            } else {
+                for (i = 0; i < h; i++) {
+                    const int iw1 = i * slinesizex;
+                    const int iw2 = i * slinesizey;
+                    const int iwd = i * slinesized;
+                    for (j = 0; j < w; j++) {
+                        const int x = FFMIN(spx[iw1 + j], max);
+                        const int y = FFMIN(spy[iw2 + j], max);
+                        const int z = spd[iwd + j];
+                        const int pos = y * dlinesize + x;
+
+                        if (z < tmin || z > tmax)
+                            continue;
+
+                        if (!dpd[pos])
+                            dpd[pos] = FFMIN(x + y, max);
+                        dpx[pos] = x;
+                        dpy[pos] = y;
+                    }
                 }
             }
-        } else {
+            break;
+        case COLOR3:
             for (i = 0; i < h; i++) {
                 const int iw1 = i * slinesizex;
                 const int iw2 = i * slinesizey;
@@ -505,56 +778,35 @@ static void vectorscope16(VectorscopeContext *s, AVFrame *in, AVFrame *out, int
                     if (z < tmin || z > tmax)
                         continue;
 
-                    if (!dpd[pos])
-                        dpd[pos] = FFMIN(x + y, max);
+                    dpd[pos] = FFMIN(max, dpd[pos] + intensity);
                     dpx[pos] = x;
                     dpy[pos] = y;
                 }
             }
-        }
-        break;
-    case COLOR3:
-        for (i = 0; i < h; i++) {
-            const int iw1 = i * slinesizex;
-            const int iw2 = i * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < w; j++) {
-                const int x = FFMIN(spx[iw1 + j], max);
-                const int y = FFMIN(spy[iw2 + j], max);
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMIN(max, dpd[pos] + intensity);
-                dpx[pos] = x;
-                dpy[pos] = y;
-            }
-        }
-        break;
-    case COLOR4:
-        for (i = 0; i < in->height; i++) {
-            const int iwx = (i >> vsub) * slinesizex;
-            const int iwy = (i >> vsub) * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < in->width; j++) {
-                const int x = FFMIN(spx[iwx + (j >> hsub)], max);
-                const int y = FFMIN(spy[iwy + (j >> hsub)], max);
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMAX(z, dpd[pos]);
-                dpx[pos] = x;
-                dpy[pos] = y;
+            break;
+        case COLOR4:
+            for (i = 0; i < in->height; i++) {
+                const int iwx = (i >> vsub) * slinesizex;
+                const int iwy = (i >> vsub) * slinesizey;
+                const int iwd = i * slinesized;
+                for (j = 0; j < in->width; j++) {
+                    const int x = FFMIN(spx[iwx + (j >> hsub)], max);
+                    const int y = FFMIN(spy[iwy + (j >> hsub)], max);
+                    const int z = spd[iwd + j];
+                    const int pos = y * dlinesize + x;
+
+                    if (z < tmin || z > tmax)
+                        continue;
+
+                    dpd[pos] = FFMAX(z, dpd[pos]);
+                    dpx[pos] = x;
+                    dpy[pos] = y;
+                }
             }
+            break;
+        default:
+            av_assert0(0);
         }
-        break;
-    default:
-        av_assert0(0);
     }
 
     envelope16(s, out);
@@ -614,8 +866,9 @@ static void vectorscope16(VectorscopeContext *s, AVFrame *in, AVFrame *out, int
     }
 }
 
-static void vectorscope8(VectorscopeContext *s, AVFrame *in, AVFrame *out, int pd)
+static void vectorscope8(AVFilterContext *ctx, AVFrame *in, AVFrame *out, int pd)
 {
+    VectorscopeContext *s = ctx->priv;
     const uint8_t * const *src = (const uint8_t * const *)in->data;
     const int slinesizex = in->linesize[s->x];
     const int slinesizey = in->linesize[s->y];
@@ -645,49 +898,74 @@ static void vectorscope8(VectorscopeContext *s, AVFrame *in, AVFrame *out, int p
             memset(dst[k] + i * out->linesize[k],
                    (s->mode == COLOR || s->mode == COLOR5) && k == s->pd ? 0 : s->bg_color[k], out->width);
 
-    switch (s->mode) {
-    case COLOR5:
-    case COLOR:
-    case TINT:
-        for (i = 0; i < h; i++) {
-            const int iwx = i * slinesizex;
-            const int iwy = i * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < w; j++) {
-                const int x = spx[iwx + j];
-                const int y = spy[iwy + j];
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMIN(dpd[pos] + intensity, 255);
-            }
-        }
-        break;
-    case COLOR2:
-        if (s->is_yuv) {
+    if (s->nb_jobs > 1) {
+        plot_slices(ctx, in, out, pd);
+    } else {
+        switch (s->mode) {
+        case COLOR5:
+        case COLOR:
+        case TINT:
             for (i = 0; i < h; i++) {
-                const int iw1 = i * slinesizex;
-                const int iw2 = i * slinesizey;
+                const int iwx = i * slinesizex;
+                const int iwy = i * slinesizey;
                 const int iwd = i * slinesized;
                 for (j = 0; j < w; j++) {
-                    const int x = spx[iw1 + j];
-                    const int y = spy[iw2 + j];
+                    const int x = spx[iwx + j];
+                    const int y = spy[iwy + j];
                     const int z = spd[iwd + j];
                     const int pos = y * dlinesize + x;
 
                     if (z < tmin || z > tmax)
                         continue;
 
-                    if (!dpd[pos])
-                        dpd[pos] = FFABS(128 - x) + FFABS(128 - y);
-                    dpx[pos] = x;
-                    dpy[pos] = y;
+                    dpd[pos] = FFMIN(dpd[pos] + intensity, 255);
+                }
+            }
+            break;
+        case COLOR2:
+            if (s->is_yuv) {
+                for (i = 0; i < h; i++) {
+                    const int iw1 = i * slinesizex;
+                    const int iw2 = i * slinesizey;
+                    const int iwd = i * slinesized;
+                    for (j = 0; j < w; j++) {
+                        const int x = spx[iw1 + j];
+                        const int y = spy[iw2 + j];
+                        const int z = spd[iwd + j];
+                        const int pos = y * dlinesize + x;
+
+                        if (z < tmin || z > tmax)
+                            continue;
+
+                        if (!dpd[pos])
+                            dpd[pos] = FFABS(128 - x) + FFABS(128 - y);
+                        dpx[pos] = x;
+                        dpy[pos] = y;
+                    }
+                }
+            } else {
+                for (i = 0; i < h; i++) {
+                    const int iw1 = i * slinesizex;
+                    const int iw2 = i * slinesizey;
+                    const int iwd = i * slinesized;
+                    for (j = 0; j < w; j++) {
+                        const int x = spx[iw1 + j];
+                        const int y = spy[iw2 + j];
+                        const int z = spd[iwd + j];
+                        const int pos = y * dlinesize + x;
+
+                        if (z < tmin || z > tmax)
+                            continue;
+
+                        if (!dpd[pos])
+                            dpd[pos] = FFMIN(x + y, 255);
+                        dpx[pos] = x;
+                        dpy[pos] = y;
+                    }
                 }
             }
-        } else {
+            break;
+        case COLOR3:
             for (i = 0; i < h; i++) {
                 const int iw1 = i * slinesizex;
                 const int iw2 = i * slinesizey;
@@ -701,56 +979,35 @@ static void vectorscope8(VectorscopeContext *s, AVFrame *in, AVFrame *out, int p
                     if (z < tmin || z > tmax)
                         continue;
 
-                    if (!dpd[pos])
-                        dpd[pos] = FFMIN(x + y, 255);
+                    dpd[pos] = FFMIN(255, dpd[pos] + intensity);
                     dpx[pos] = x;
                     dpy[pos] = y;
                 }
             }
-        }
-        break;
-    case COLOR3:
-        for (i = 0; i < h; i++) {
-            const int iw1 = i * slinesizex;
-            const int iw2 = i * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < w; j++) {
-                const int x = spx[iw1 + j];
-                const int y = spy[iw2 + j];
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMIN(255, dpd[pos] + intensity);
-                dpx[pos] = x;
-                dpy[pos] = y;
-            }
-        }
-        break;
-    case COLOR4:
-        for (i = 0; i < in->height; i++) {
-            const int iwx = (i >> vsub) * slinesizex;
-            const int iwy = (i >> vsub) * slinesizey;
-            const int iwd = i * slinesized;
-            for (j = 0; j < in->width; j++) {
-                const int x = spx[iwx + (j >> hsub)];
-                const int y = spy[iwy + (j >> hsub)];
-                const int z = spd[iwd + j];
-                const int pos = y * dlinesize + x;
-
-                if (z < tmin || z > tmax)
-                    continue;
-
-                dpd[pos] = FFMAX(z, dpd[pos]);
-                dpx[pos] = x;
-                dpy[pos] = y;
+            break;
+        case COLOR4:
+            for (i = 0; i < in->height; i++) {
+                const int iwx = (i >> vsub) * slinesizex;
+                const int iwy = (i >> vsub) * slinesizey;
+                const int iwd = i * slinesized;
+                for (j = 0; j < in->width; j++) {
+                    const int x = spx[iwx + (j >> hsub)];
+                    const int y = spy[iwy + (j >> hsub)];
+                    const int z = spd[iwd + j];
+                    const int pos = y * dlinesize + x;
+
+                    if (z < tmin || z > tmax)
+                        continue;
+
+                    dpd[pos] = FFMAX(z, dpd[pos]);
+                    dpx[pos] = x;
+                    dpy[pos] = y;
+                }
             }
+            break;
+        default:
+            av_assert0(0);
         }
-        break;
-    default:
-        av_assert0(0);
     }
 
     envelope(s, out);
@@ -1470,7 +1727,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     }
     av_frame_copy_props(out, in);
 
-    s->vectorscope(s, in, out, s->pd);
+    s->vectorscope(ctx, in, out, s->pd);
     s->graticulef(s, out, s->x, s->y, s->pd, s->cs);
 
     for (plane = 0; plane < 4; plane++) {
@@ -1559,6 +1816,18 @@ static int config_input(AVFilterLink *inlink)
     s->planewidth[1]  = s->planewidth[2]  = AV_CEIL_RSHIFT(inlink->w, desc->log2_chroma_w);
     s->planewidth[0]  = s->planewidth[3]  = inlink->w;
 
+    ff_vectorscope_init(&s->dsp);
+
+    s->nb_jobs = FFMIN(ff_filter_get_nb_threads(ctx),
+                       MAX_SLICE_MEMORY / (s->size * s->size * sizeof(*s->slice_memory)));
+    s->nb_jobs = FFMIN(s->nb_jobs, s->planeheight[1]);
+    av_freep(&s->slice_memory);
+    if (s->nb_jobs > 1) {
+        s->slice_memory = av_calloc(s->nb_jobs, s->size * s->size * sizeof(*s->slice_memory));
+        if (!s->slice_memory)
+            return AVERROR(ENOMEM);
+    }
+
     return 0;
 }
 
@@ -1568,6 +1837,7 @@ static av_cold void uninit(AVFilterContext *ctx)
 
     av_freep(&s->peak);
     av_freep(&s->peak_memory);
+    av_freep(&s->slice_memory);
 }
 
 static const AVFilterPad inputs[] = {
@@ -1596,5 +1866,6 @@ const AVFilter ff_vf_vectorscope = {
     FILTER_INPUTS(inputs),
     FILTER_OUTPUTS(outputs),
     FILTER_QUERY_FUNC(query_formats),
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
     .process_command = ff_filter_process_command,
 };
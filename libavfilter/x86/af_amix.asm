@@ -0,0 +1,82 @@
+;*****************************************************************************
+;* x86-optimized functions for amix filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_amix_mix_fl(float *dst, const float *const *src, const float *scale,
+;                     int nb_src, ptrdiff_t len)
+; void ff_amix_mix_dbl(double *dst, const double *const *src, const double *scale,
+;                      int nb_src, ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+; %1 = fl/dbl, %2 = s/d, %3 = element size, %4 = log2 of it, %5 = broadcast macro
+%macro AMIX_MIX 5
+cglobal amix_mix_%1, 5, 8, 4, dst, src, scale, nb_src, len, k, ptr, off
+    movsxdifnidn nb_srcq, nb_srcd
+    shl          lenq, %4
+    xor          offq, offq
+.loop:
+    xorp%2         m0, m0
+    xorp%2         m1, m1
+    xor            kq, kq
+.src:
+    mov          ptrq, [srcq + kq * gprsize]
+    %5             m2, [scaleq + kq * %3]
+%if cpuflag(fma3)
+    fmaddp%2       m0, m2, [ptrq + offq], m0
+    fmaddp%2       m1, m2, [ptrq + offq + mmsize], m1
+%else
+    mulp%2         m3, m2, [ptrq + offq]
+    mulp%2         m2, m2, [ptrq + offq + mmsize]
+    addp%2         m0, m0, m3
+    addp%2         m1, m1, m2
+%endif
+    inc            kq
+    cmp            kq, nb_srcq
+    jl .src
+    mova   [dstq + offq], m0
+    mova   [dstq + offq + mmsize], m1
+    add          offq, 2 * mmsize
+    cmp          offq, lenq
+    jl .loop
+    RET
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM sse
+AMIX_MIX fl,  s, 4, 2, VBROADCASTSS
+INIT_XMM sse2
+AMIX_MIX dbl, d, 8, 3, VBROADCASTSD
+
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+AMIX_MIX fl,  s, 4, 2, VBROADCASTSS
+AMIX_MIX dbl, d, 8, 3, VBROADCASTSD
+%endif
+
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+AMIX_MIX fl,  s, 4, 2, VBROADCASTSS
+AMIX_MIX dbl, d, 8, 3, VBROADCASTSD
+%endif
+%endif
@@ -0,0 +1,264 @@
+;*****************************************************************************
+;* x86-optimized row statistics for blackdetect and cropdetect
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pb_1: times 32 db 1
+
+SECTION .text
+
+; reduce the qwords of %1 into its low dword, %2 is clobbered
+%macro REDUCE_Q 2
+%if mmsize == 32
+    vextracti128    xm%2, m%1, 1
+    paddq           xm%1, xm%2
+%endif
+    pshufd          xm%2, xm%1, q1032
+    paddq           xm%1, xm%2
+%endmacro
+
+; reduce the dwords of %1 into its low dword, %2 is clobbered
+%macro REDUCE_D 2
+%if mmsize == 32
+    vextracti128    xm%2, m%1, 1
+    paddd           xm%1, xm%2
+%endif
+    pshufd          xm%2, xm%1, q1032
+    paddd           xm%1, xm%2
+    pshufd          xm%2, xm%1, q2301
+    paddd           xm%1, xm%2
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_detect_sum8(const uint8_t *src, int len)
+;------------------------------------------------------------------------------
+%macro SUM8 0
+cglobal detect_sum8, 2, 2, 3, src, len
+    movsxdifnidn   lenq, lend
+    add            srcq, lenq
+    neg            lenq
+    pxor             m0, m0
+    pxor             m2, m2
+
+.loop:
+    movu             m1, [srcq + lenq]
+    psadbw           m1, m2
+    paddq            m0, m1
+    add            lenq, mmsize
+    jl .loop
+
+    REDUCE_Q          0, 1
+    movd            eax, xm0
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_detect_sum16(const uint16_t *src, int len)
+;------------------------------------------------------------------------------
+%macro SUM16 0
+cglobal detect_sum16, 2, 2, 4, src, len
+    movsxdifnidn   lenq, lend
+    lea            srcq, [srcq + 2 * lenq]
+    neg            lenq
+    pxor             m0, m0
+    pxor             m3, m3
+
+.loop:
+    movu             m1, [srcq + 2 * lenq]
+    punpckhwd        m2, m1, m3
+    punpcklwd        m1, m3
+    paddd            m0, m1
+    paddd            m0, m2
+    add            lenq, mmsize / 2
+    jl .loop
+
+    REDUCE_D          0, 1
+    movd            eax, xm0
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_detect_colsum8(uint32_t *acc, const uint8_t *src, int len)
+;------------------------------------------------------------------------------
+%macro COLSUM8 0
+cglobal detect_colsum8, 3, 3, 8, acc, src, len
+    movsxdifnidn   lenq, lend
+    add            srcq, lenq
+    lea            accq, [accq + 4 * lenq]
+    neg            lenq
+%if notcpuflag(avx2)
+    pxor             m7, m7
+%endif
+
+.loop:
+%if cpuflag(avx2)
+    pmovzxbd         m0, [srcq + lenq]
+    pmovzxbd         m1, [srcq + lenq + 8]
+    paddd            m0, [accq + 4 * lenq]
+    paddd            m1, [accq + 4 * lenq + 32]
+    movu [accq + 4 * lenq], m0
+    movu [accq + 4 * lenq + 32], m1
+%else
+    movu             m0, [srcq + lenq]
+    punpckhbw        m1, m0, m7
+    punpcklbw        m0, m7
+    punpckhwd        m2, m0, m7
+    punpcklwd        m0, m7
+    punpckhwd        m3, m1, m7
+    punpcklwd        m1, m7
+    movu             m4, [accq + 4 * lenq]
+    movu             m5, [accq + 4 * lenq + 16]
+    movu             m6, [accq + 4 * lenq + 32]
+    paddd            m0, m4
+    paddd            m2, m5
+    paddd            m1, m6
+    movu             m4, [accq + 4 * lenq + 48]
+    paddd            m3, m4
+    movu [accq + 4 * lenq], m0
+    movu [accq + 4 * lenq + 16], m2
+    movu [accq + 4 * lenq + 32], m1
+    movu [accq + 4 * lenq + 48], m3
+%endif
+    add            lenq, 16
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_detect_colsum16(uint32_t *acc, const uint16_t *src, int len)
+;------------------------------------------------------------------------------
+%macro COLSUM16 0
+cglobal detect_colsum16, 3, 3, 6, acc, src, len
+    movsxdifnidn   lenq, lend
+    lea            srcq, [srcq + 2 * lenq]
+    lea            accq, [accq + 4 * lenq]
+    neg            lenq
+%if notcpuflag(avx2)
+    pxor             m5, m5
+%endif
+
+.loop:
+%if cpuflag(avx2)
+    pmovzxwd         m0, [srcq + 2 * lenq]
+    pmovzxwd         m1, [srcq + 2 * lenq + 16]
+    paddd            m0, [accq + 4 * lenq]
+    paddd            m1, [accq + 4 * lenq + 32]
+    movu [accq + 4 * lenq], m0
+    movu [accq + 4 * lenq + 32], m1
+    add            lenq, 16
+%else
+    movu             m0, [srcq + 2 * lenq]
+    punpckhwd        m1, m0, m5
+    punpcklwd        m0, m5
+    movu             m2, [accq + 4 * lenq]
+    movu             m3, [accq + 4 * lenq + 16]
+    paddd            m0, m2
+    paddd            m1, m3
+    movu [accq + 4 * lenq], m0
+    movu [accq + 4 * lenq + 16], m1
+    add            lenq, 8
+%endif
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_detect_count_le8(const uint8_t *src, int len, unsigned threshold)
+;------------------------------------------------------------------------------
+%macro COUNT_LE8 0
+cglobal detect_count_le8, 3, 3, 5, src, len, threshold
+    movsxdifnidn   lenq, lend
+    add            srcq, lenq
+    neg            lenq
+    movd            xm2, thresholdd
+%if cpuflag(avx2)
+    vpbroadcastb     m2, xm2
+%else
+    punpcklbw        m2, m2
+    SPLATW           m2, m2
+%endif
+    mova             m3, [pb_1]
+    pxor             m4, m4
+    pxor             m0, m0
+
+.loop:
+    movu             m1, [srcq + lenq]
+    psubusb          m1, m2                 ; zero where src <= threshold
+    pcmpeqb          m1, m4
+    pand             m1, m3
+    psadbw           m1, m4
+    paddq            m0, m1
+    add            lenq, mmsize
+    jl .loop
+
+    REDUCE_Q          0, 1
+    movd            eax, xm0
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_detect_count_le16(const uint16_t *src, int len, unsigned threshold)
+;------------------------------------------------------------------------------
+%macro COUNT_LE16 0
+cglobal detect_count_le16, 3, 3, 5, src, len, threshold
+    movsxdifnidn   lenq, lend
+    lea            srcq, [srcq + 2 * lenq]
+    neg            lenq
+    movd            xm2, thresholdd
+    SPLATW           m2, xm2
+    pcmpeqw          m3, m3
+    psrlw            m3, 15                 ; pw_1
+    pxor             m4, m4
+    pxor             m0, m0
+
+.loop:
+    movu             m1, [srcq + 2 * lenq]
+    psubusw          m1, m2                 ; zero where src <= threshold
+    pcmpeqw          m1, m4
+    psrlw            m1, 15
+    pmaddwd          m1, m3
+    paddd            m0, m1
+    add            lenq, mmsize / 2
+    jl .loop
+
+    REDUCE_D          0, 1
+    movd            eax, xm0
+    RET
+%endmacro
+
+INIT_XMM sse2
+SUM8
+SUM16
+COLSUM8
+COLSUM16
+COUNT_LE8
+COUNT_LE16
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+SUM8
+SUM16
+COLSUM8
+COLSUM16
+COUNT_LE8
+COUNT_LE16
+%endif
@@ -0,0 +1,54 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/detectdsp.h"
+
+#define DETECT_FUNCS(opt)                                                               \
+unsigned ff_detect_sum8_ ## opt(const uint8_t *src, int len);                           \
+unsigned ff_detect_sum16_ ## opt(const uint16_t *src, int len);                         \
+void ff_detect_colsum8_ ## opt(uint32_t *acc, const uint8_t *src, int len);             \
+void ff_detect_colsum16_ ## opt(uint32_t *acc, const uint16_t *src, int len);           \
+unsigned ff_detect_count_le8_ ## opt(const uint8_t *src, int len, unsigned threshold);  \
+unsigned ff_detect_count_le16_ ## opt(const uint16_t *src, int len, unsigned threshold);
+
+DETECT_FUNCS(sse2)
+DETECT_FUNCS(avx2)
+
+#define SET_FUNCS(opt)                                  \
+    do {                                                \
+        dsp->sum8       = ff_detect_sum8_ ## opt;       \
+        dsp->sum16      = ff_detect_sum16_ ## opt;      \
+        dsp->colsum8    = ff_detect_colsum8_ ## opt;    \
+        dsp->colsum16   = ff_detect_colsum16_ ## opt;   \
+        dsp->count_le8  = ff_detect_count_le8_ ## opt;  \
+        dsp->count_le16 = ff_detect_count_le16_ ## opt; \
+    } while (0)
+
+av_cold void ff_detectdsp_init_x86(DetectDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags))
+        SET_FUNCS(sse2);
+    if (EXTERNAL_AVX2_FAST(cpu_flags))
+        SET_FUNCS(avx2);
+}
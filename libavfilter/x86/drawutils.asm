@@ -0,0 +1,104 @@
+;*****************************************************************************
+;* x86-optimized functions for drawutils
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pd_0x1010101: times 8 dd 0x1010101
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_blend_row8(uint8_t *dst, const uint8_t *mask, int w,
+;                    unsigned src, unsigned alpha)
+;------------------------------------------------------------------------------
+%macro BLEND_ROW8 0
+cglobal blend_row8, 5, 8, 7, dst, mask, w, src, alpha
+    movd            xm4, srcd
+    movd            xm5, alphad
+%if cpuflag(avx2)
+    vpbroadcastd     m4, xm4
+    vpbroadcastd     m5, xm5
+%else
+    pshufd           m4, m4, 0
+    pshufd           m5, m5, 0
+%endif
+    mova             m6, [pd_0x1010101]
+    movsxdifnidn     wq, wd
+    add            dstq, wq
+    add           maskq, wq
+    neg              wq
+    add              wq, mmsize / 4
+    jg .tail_start
+
+.loop:
+    pmovzxbd         m0, [maskq + wq - mmsize / 4]
+    pmovzxbd         m1, [dstq  + wq - mmsize / 4]
+    pmulld           m0, m5                 ; a = mask * alpha
+    psubd            m2, m6, m0             ; 0x1010101 - a
+    pmulld           m0, m4                 ; a * src
+    pmulld           m1, m2                 ; (0x1010101 - a) * dst
+    paddd            m0, m1
+    psrld            m0, 24
+%if cpuflag(avx2)
+    vextracti128    xm1, m0, 1
+    packusdw        xm0, xm1
+    packuswb        xm0, xm0
+    movq [dstq + wq - mmsize / 4], xm0
+%else
+    packusdw         m0, m0
+    packuswb         m0, m0
+    movd [dstq + wq - mmsize / 4], m0
+%endif
+    add              wq, mmsize / 4
+    jle .loop
+
+.tail_start:
+    sub              wq, mmsize / 4
+    jge .end
+
+.tail:
+    movzx           r5d, byte [maskq + wq]
+    movzx           r6d, byte [dstq + wq]
+    imul            r5d, alphad             ; a
+    mov             r7d, srcd
+    sub             r7d, r6d
+    imul            r7d, r5d                ; a * (src - dst)
+    imul            r6d, r6d, 0x1010101
+    add             r6d, r7d
+    shr             r6d, 24
+    mov    [dstq + wq], r6b
+    inc              wq
+    jl .tail
+
+.end:
+    RET
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM sse4
+BLEND_ROW8
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+BLEND_ROW8
+%endif
+%endif
@@ -0,0 +1,149 @@
+;*****************************************************************************
+;* x86-optimized functions for the EBU R128 loudness measurement
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pq_abs_mask: times 4 dq 0x7fffffffffffffff
+
+SECTION .text
+
+%if ARCH_X86_64
+;------------------------------------------------------------------------------
+; void ff_ebur128_filter_2ch(double *dst, const double *src,
+;                            ptrdiff_t dst_stride, ptrdiff_t src_stride,
+;                            int frames, const double *coeffs, double *state)
+;------------------------------------------------------------------------------
+INIT_XMM sse2
+cglobal ebur128_filter_2ch, 7, 7, 16, dst, src, dst_stride, src_stride, frames, coeffs, state
+    shl     dst_strideq, 3
+    shl     src_strideq, 3
+    mova             m1, [stateq +   0]     ; v1
+    mova             m2, [stateq +  16]     ; v2
+    mova             m3, [stateq +  32]     ; v3
+    mova             m4, [stateq +  48]     ; v4
+    mova             m5, [coeffsq +  80]    ; a1
+    mova             m6, [coeffsq +  96]    ; a2
+    mova             m7, [coeffsq + 112]    ; a3
+    mova             m8, [coeffsq + 128]    ; a4
+    mova             m9, [coeffsq +   0]    ; b0
+    mova            m10, [coeffsq +  16]    ; b1
+    mova            m11, [coeffsq +  32]    ; b2
+    mova            m12, [coeffsq +  48]    ; b3
+    mova            m13, [coeffsq +  64]    ; b4
+    test        framesd, framesd
+    jle .end
+
+; same operation order as the C version, so the results are bitexact
+.loop:
+    movu             m0, [srcq]
+    mova            m14, m5
+    mulpd           m14, m1
+    subpd            m0, m14
+    mova            m14, m6
+    mulpd           m14, m2
+    subpd            m0, m14
+    mova            m14, m7
+    mulpd           m14, m3
+    subpd            m0, m14
+    mova            m14, m8
+    mulpd           m14, m4
+    subpd            m0, m14                ; v0 = x - a1 v1 - a2 v2 - a3 v3 - a4 v4
+
+    mova            m14, m9
+    mulpd           m14, m0
+    mova            m15, m10
+    mulpd           m15, m1
+    addpd           m14, m15
+    mova            m15, m11
+    mulpd           m15, m2
+    addpd           m14, m15
+    mova            m15, m12
+    mulpd           m15, m3
+    addpd           m14, m15
+    mova            m15, m13
+    mulpd           m15, m4
+    addpd           m14, m15                ; y = b0 v0 + b1 v1 + b2 v2 + b3 v3 + b4 v4
+    movu         [dstq], m14
+
+    mova             m4, m3
+    mova             m3, m2
+    mova             m2, m1
+    mova             m1, m0
+    add            srcq, src_strideq
+    add            dstq, dst_strideq
+    dec         framesd
+    jg .loop
+
+    mova  [stateq +  0], m1
+    mova  [stateq + 16], m2
+    mova  [stateq + 32], m3
+    mova  [stateq + 48], m4
+.end:
+    RET
+
+%if HAVE_AVX_EXTERNAL
+;------------------------------------------------------------------------------
+; double ff_ebur128_true_peak(const double *src, const double *coeffs,
+;                             int ntaps, int nb_phases, int len)
+;------------------------------------------------------------------------------
+INIT_YMM avx
+cglobal ebur128_true_peak, 5, 8, 4, src, coeffs, ntaps, phases, len, cptr, p, k
+    movsxdifnidn ntapsq, ntapsd
+    xorpd            m3, m3
+    mova             m2, [pq_abs_mask]
+    lea              kq, [ntapsq * 8 - 8]
+    sub            srcq, kq
+    test           lend, lend
+    jle .end
+
+.loop:
+    mov           cptrq, coeffsq
+    mov              pd, phasesd
+.phase:
+    xorpd            m0, m0
+    xor              kq, kq
+.tap:
+    vbroadcastsd     m1, [cptrq + kq * 8]
+    mulpd            m1, [srcq + kq * 8]
+    addpd            m0, m1
+    inc              kq
+    cmp              kq, ntapsq
+    jl .tap
+
+    andpd            m0, m2
+    maxpd            m3, m0
+    lea           cptrq, [cptrq + ntapsq * 8]
+    dec              pd
+    jg .phase
+
+    add            srcq, mmsize
+    sub            lend, mmsize / 8
+    jg .loop
+
+.end:
+    vextractf128    xm0, m3, 1
+    maxpd           xm0, xm3
+    unpckhpd        xm1, xm0, xm0
+    maxsd           xm0, xm1
+    RET
+%endif
+%endif
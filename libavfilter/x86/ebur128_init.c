@@ -0,0 +1,45 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/ebur128.h"
+
+void ff_ebur128_filter_2ch_sse2(double *dst, const double *src,
+                                ptrdiff_t dst_stride, ptrdiff_t src_stride,
+                                int frames, const double *coeffs, double *state);
+double ff_ebur128_true_peak_avx(const double *src, const double *coeffs,
+                                int ntaps, int nb_phases, int len);
+
+av_cold void ff_ebur128_dsp_init_x86(FFEBUR128DSPContext *dsp)
+{
+#if ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags))
+        dsp->filter_2ch = ff_ebur128_filter_2ch_sse2;
+#if HAVE_AVX_EXTERNAL
+    if (EXTERNAL_AVX_FAST(cpu_flags))
+        dsp->true_peak = ff_ebur128_true_peak_avx;
+#endif
+#endif
+}
@@ -0,0 +1,105 @@
+;*****************************************************************************
+;* x86-optimized block SAD functions for motion estimation
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+; int ff_me_sad8(const uint8_t *src1, ptrdiff_t stride1,
+;                const uint8_t *src2, ptrdiff_t stride2, int h)
+; h must be even
+INIT_XMM sse2
+cglobal me_sad8, 5, 5, 3, src1, stride1, src2, stride2, h
+    pxor            m2, m2
+.loop:
+    movq            m0, [src1q]
+    movhps          m0, [src1q + stride1q]
+    movq            m1, [src2q]
+    movhps          m1, [src2q + stride2q]
+    psadbw          m0, m1
+    paddd           m2, m0
+    lea          src1q, [src1q + 2 * stride1q]
+    lea          src2q, [src2q + 2 * stride2q]
+    sub             hd, 2
+    jg .loop
+
+    movhlps         m0, m2
+    paddd           m2, m0
+    movd           eax, m2
+    RET
+
+; int ff_me_sad16(const uint8_t *src1, ptrdiff_t stride1,
+;                 const uint8_t *src2, ptrdiff_t stride2, int h)
+INIT_XMM sse2
+cglobal me_sad16, 5, 5, 3, src1, stride1, src2, stride2, h
+    pxor            m2, m2
+.loop:
+    movu            m0, [src1q]
+    movu            m1, [src2q]
+    psadbw          m0, m1
+    paddd           m2, m0
+    add          src1q, stride1q
+    add          src2q, stride2q
+    dec             hd
+    jg .loop
+
+    movhlps         m0, m2
+    paddd           m2, m0
+    movd           eax, m2
+    RET
+
+; int ff_me_sad32(const uint8_t *src1, ptrdiff_t stride1,
+;                 const uint8_t *src2, ptrdiff_t stride2, int h)
+%macro ME_SAD32 0
+cglobal me_sad32, 5, 5, 4, src1, stride1, src2, stride2, h
+    pxor            m2, m2
+.loop:
+    movu            m0, [src1q]
+    movu            m1, [src2q]
+    psadbw          m0, m1
+    paddd           m2, m0
+%if mmsize == 16
+    movu            m0, [src1q + 16]
+    movu            m3, [src2q + 16]
+    psadbw          m0, m3
+    paddd           m2, m0
+%endif
+    add          src1q, stride1q
+    add          src2q, stride2q
+    dec             hd
+    jg .loop
+
+%if mmsize == 32
+    vextracti128   xm0, m2, 1
+    paddd          xm2, xm0
+%endif
+    movhlps        xm0, xm2
+    paddd          xm2, xm0
+    movd           eax, xm2
+    RET
+%endmacro
+
+INIT_XMM sse2
+ME_SAD32
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+ME_SAD32
+%endif
@@ -0,0 +1,45 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/motion_estimation.h"
+
+#define ME_SAD_FUNC(w, opt)                                                   \
+int ff_me_sad##w##_##opt(const uint8_t *src1, ptrdiff_t stride1,             \
+                         const uint8_t *src2, ptrdiff_t stride2, int h);
+
+ME_SAD_FUNC(8,  sse2)
+ME_SAD_FUNC(16, sse2)
+ME_SAD_FUNC(32, sse2)
+ME_SAD_FUNC(32, avx2)
+
+av_cold void ff_me_init_x86(AVMotionEstContext *me_ctx)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        me_ctx->sad[3] = ff_me_sad8_sse2;
+        me_ctx->sad[4] = ff_me_sad16_sse2;
+        me_ctx->sad[5] = ff_me_sad32_sse2;
+    }
+
+    if (EXTERNAL_AVX2_FAST(cpu_flags))
+        me_ctx->sad[5] = ff_me_sad32_avx2;
+}
@@ -0,0 +1,162 @@
+;*****************************************************************************
+;* x86-optimized functions for boxblur filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 2 of the License, or
+;* (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+; bits 16..23 resp. 16..31 of each dword
+pb_sum_8:  db 2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+pb_sum_16: db 2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1
+pd_255:    times 8 dd 255
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_boxblur_vstep8(uint8_t *dst, uint32_t *sums, const uint8_t *add,
+;                        const uint8_t *sub, int inv, int w)
+; void ff_boxblur_vstep16(uint16_t *dst, uint32_t *sums, const uint16_t *add,
+;                         const uint16_t *sub, int inv, int w)
+;------------------------------------------------------------------------------
+%macro VSTEP 1 ; depth
+%if %1 == 8
+    %define PMOVZX pmovzxbd
+    %define PS 1
+%else
+    %define PMOVZX pmovzxwd
+    %define PS 2
+%endif
+cglobal boxblur_vstep%1, 6, 6, 6, dst, sums, add, sub, inv, w
+    movd            xm5, invd
+%if cpuflag(avx2)
+    vpbroadcastd     m5, xm5
+%else
+    pshufd           m5, m5, 0
+%endif
+    movsxdifnidn     wq, wd
+    lea            dstq, [dstq + PS * wq]
+    lea            addq, [addq + PS * wq]
+    lea            subq, [subq + PS * wq]
+    lea           sumsq, [sumsq + 4 * wq]
+    neg              wq
+
+.loop:
+    PMOVZX           m0, [addq + PS * wq]
+    PMOVZX           m1, [addq + PS * wq + PS * mmsize / 4]
+    PMOVZX           m2, [subq + PS * wq]
+    PMOVZX           m3, [subq + PS * wq + PS * mmsize / 4]
+    psubd            m0, m2
+    psubd            m1, m3
+    pmulld           m0, m5
+    pmulld           m1, m5
+    movu             m2, [sumsq + 4 * wq]
+    movu             m3, [sumsq + 4 * wq + mmsize]
+    paddd            m0, m2
+    paddd            m1, m3
+    movu [sumsq + 4 * wq], m0
+    movu [sumsq + 4 * wq + mmsize], m1
+    psrld            m0, 16
+    psrld            m1, 16
+%if %1 == 8
+    pand             m0, [pd_255]
+    pand             m1, [pd_255]
+%endif
+    packusdw         m0, m1
+%if cpuflag(avx2)
+    vpermq           m0, m0, q3120
+%endif
+%if %1 == 8
+%if cpuflag(avx2)
+    vextracti128    xm1, m0, 1
+    packuswb        xm0, xm1
+    movu    [dstq + wq], xm0
+%else
+    packuswb         m0, m0
+    movq    [dstq + wq], m0
+%endif
+%else
+    movu [dstq + 2 * wq], m0
+%endif
+    add              wq, mmsize / 2
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_boxblur_hstep8(uint8_t *dst, const uint8_t *add, const uint8_t *sub,
+;                            int inv, unsigned sum, int len)
+; unsigned ff_boxblur_hstep16(uint16_t *dst, const uint16_t *add, const uint16_t *sub,
+;                             int inv, unsigned sum, int len)
+;------------------------------------------------------------------------------
+%macro HSTEP 1 ; depth
+%if %1 == 8
+    %define PMOVZX pmovzxbd
+    %define PS 1
+%else
+    %define PMOVZX pmovzxwd
+    %define PS 2
+%endif
+cglobal boxblur_hstep%1, 6, 6, 7, dst, add, sub, inv, sum, len
+    movd             m5, invd
+    pshufd           m5, m5, 0
+    movd             m4, sumd
+    pshufd           m4, m4, 0
+    mova             m6, [pb_sum_%1]
+    movsxdifnidn   lenq, lend
+    lea            dstq, [dstq + PS * lenq]
+    lea            addq, [addq + PS * lenq]
+    lea            subq, [subq + PS * lenq]
+    neg            lenq
+
+.loop:
+    PMOVZX           m0, [addq + PS * lenq]
+    PMOVZX           m1, [subq + PS * lenq]
+    psubd            m0, m1
+    pmulld           m0, m5
+    pslldq           m1, m0, 4              ; inclusive prefix sum of the 4 steps
+    paddd            m0, m1
+    pslldq           m1, m0, 8
+    paddd            m0, m1
+    paddd            m0, m4
+    pshufd           m4, m0, q3333
+    pshufb           m0, m6
+%if %1 == 8
+    movd [dstq + lenq], m0
+%else
+    movq [dstq + 2 * lenq], m0
+%endif
+    add            lenq, 4
+    jl .loop
+
+    movd            eax, m4
+    RET
+%endmacro
+
+INIT_XMM sse4
+VSTEP 8
+VSTEP 16
+HSTEP 8
+HSTEP 16
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+VSTEP 8
+VSTEP 16
+%endif
@@ -0,0 +1,52 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/boxblurdsp.h"
+
+void ff_boxblur_vstep8_sse4(uint8_t *dst, uint32_t *sums, const uint8_t *add,
+                            const uint8_t *sub, int inv, int w);
+void ff_boxblur_vstep8_avx2(uint8_t *dst, uint32_t *sums, const uint8_t *add,
+                            const uint8_t *sub, int inv, int w);
+void ff_boxblur_vstep16_sse4(uint16_t *dst, uint32_t *sums, const uint16_t *add,
+                             const uint16_t *sub, int inv, int w);
+void ff_boxblur_vstep16_avx2(uint16_t *dst, uint32_t *sums, const uint16_t *add,
+                             const uint16_t *sub, int inv, int w);
+unsigned ff_boxblur_hstep8_sse4(uint8_t *dst, const uint8_t *add, const uint8_t *sub,
+                                int inv, unsigned sum, int len);
+unsigned ff_boxblur_hstep16_sse4(uint16_t *dst, const uint16_t *add, const uint16_t *sub,
+                                 int inv, unsigned sum, int len);
+
+av_cold void ff_boxblur_init_x86(BoxBlurDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE4(cpu_flags)) {
+        dsp->vstep8  = ff_boxblur_vstep8_sse4;
+        dsp->vstep16 = ff_boxblur_vstep16_sse4;
+        dsp->hstep8  = ff_boxblur_hstep8_sse4;
+        dsp->hstep16 = ff_boxblur_hstep16_sse4;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        dsp->vstep8  = ff_boxblur_vstep8_avx2;
+        dsp->vstep16 = ff_boxblur_vstep16_avx2;
+    }
+}
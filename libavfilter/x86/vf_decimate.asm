@@ -0,0 +1,140 @@
+;*****************************************************************************
+;* x86-optimized functions for decimate filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_decimate_sad_groups8(uint32_t *acc, const uint8_t *a,
+;                              const uint8_t *b, int len)
+;------------------------------------------------------------------------------
+%macro SAD_GROUPS8 0
+cglobal decimate_sad_groups8, 4, 4, 5, acc, a, b, len
+    movsxdifnidn     lenq, lend
+    add                aq, lenq
+    add                bq, lenq
+    neg              lenq
+
+.loop:
+%if cpuflag(avx2)
+    movu               m0, [aq + lenq]
+    psadbw             m0, [bq + lenq]          ; g0 g1 | g2 g3
+    pshufd             m0, m0, q2020
+    vpermq             m0, m0, q2020
+%else
+    movu               m0, [aq + lenq]
+    movu               m1, [bq + lenq]
+    movu               m2, [aq + lenq + 16]
+    movu               m3, [bq + lenq + 16]
+    psadbw             m0, m1                   ; g0 g1
+    psadbw             m2, m3                   ; g2 g3
+    pshufd             m0, m0, q2020
+    pshufd             m2, m2, q2020
+    punpcklqdq         m0, m2
+%endif
+    movu              xm4, [accq]
+    paddd             xm0, xm4
+    movu           [accq], xm0
+    add              accq, 16
+    add              lenq, 32
+    jl .loop
+    RET
+%endmacro
+
+; %1 = |%1 - %2| for unsigned words, widened and pairwise added to dwords,
+; %3 is a zero register, %2 and %4 are clobbered
+%macro ABSDIFF_W_SUM 4
+    psubusw            %4, %1, %2
+    psubusw            %2, %1
+    por                %2, %4
+    punpckhwd          %1, %2, %3
+    punpcklwd          %2, %3
+    paddd              %1, %2
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_decimate_sad_groups16(uint32_t *acc, const uint16_t *a,
+;                               const uint16_t *b, int len)
+;------------------------------------------------------------------------------
+%macro SAD_GROUPS16 0
+cglobal decimate_sad_groups16, 4, 4, 8, acc, a, b, len
+    movsxdifnidn     lenq, lend
+    lea                aq, [aq + 2 * lenq]
+    lea                bq, [bq + 2 * lenq]
+    neg              lenq
+    pxor               m7, m7
+
+.loop:
+%if cpuflag(avx2)
+    movu               m0, [aq + 2 * lenq]
+    movu               m4, [bq + 2 * lenq]
+    movu               m1, [aq + 2 * lenq + 32]
+    movu               m5, [bq + 2 * lenq + 32]
+    ABSDIFF_W_SUM      m0, m4, m7, m6           ; g0 | g1
+    ABSDIFF_W_SUM      m1, m5, m7, m6           ; g2 | g3
+    punpckhdq          m2, m0, m1
+    punpckldq          m0, m1
+    paddd              m0, m2
+    pshufd             m2, m0, q1032
+    paddd              m0, m2                   ; g0 g2 g0 g2 | g1 g3 g1 g3
+    vpermq             m0, m0, q2020
+    pshufd            xm0, xm0, q3120
+%else
+    movu               m0, [aq + 2 * lenq]
+    movu               m4, [bq + 2 * lenq]
+    movu               m1, [aq + 2 * lenq + 16]
+    movu               m5, [bq + 2 * lenq + 16]
+    ABSDIFF_W_SUM      m0, m4, m7, m6
+    ABSDIFF_W_SUM      m1, m5, m7, m6
+    movu               m2, [aq + 2 * lenq + 32]
+    movu               m4, [bq + 2 * lenq + 32]
+    movu               m3, [aq + 2 * lenq + 48]
+    movu               m5, [bq + 2 * lenq + 48]
+    ABSDIFF_W_SUM      m2, m4, m7, m6
+    ABSDIFF_W_SUM      m3, m5, m7, m6
+    punpckhdq          m4, m0, m1
+    punpckldq          m0, m1
+    paddd              m0, m4                   ; g0 g1 g0 g1
+    punpckhdq          m5, m2, m3
+    punpckldq          m2, m3
+    paddd              m2, m5                   ; g2 g3 g2 g3
+    punpckhqdq         m1, m0, m2
+    punpcklqdq         m0, m2
+    paddd              m0, m1
+%endif
+    movu              xm4, [accq]
+    paddd             xm0, xm4
+    movu           [accq], xm0
+    add              accq, 16
+    add              lenq, 32
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+SAD_GROUPS8
+SAD_GROUPS16
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+SAD_GROUPS8
+SAD_GROUPS16
+%endif
@@ -0,0 +1,42 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/decimatedsp.h"
+
+void ff_decimate_sad_groups8_sse2(uint32_t *acc, const uint8_t *a, const uint8_t *b, int len);
+void ff_decimate_sad_groups8_avx2(uint32_t *acc, const uint8_t *a, const uint8_t *b, int len);
+void ff_decimate_sad_groups16_sse2(uint32_t *acc, const uint16_t *a, const uint16_t *b, int len);
+void ff_decimate_sad_groups16_avx2(uint32_t *acc, const uint16_t *a, const uint16_t *b, int len);
+
+av_cold void ff_decimate_init_x86(DecimateDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        dsp->sad_groups8  = ff_decimate_sad_groups8_sse2;
+        dsp->sad_groups16 = ff_decimate_sad_groups16_sse2;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        dsp->sad_groups8  = ff_decimate_sad_groups8_avx2;
+        dsp->sad_groups16 = ff_decimate_sad_groups16_avx2;
+    }
+}
@@ -0,0 +1,376 @@
+;*****************************************************************************
+;* x86-optimized functions for fieldmatch filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pw_1:  times 16 dw 1
+pw_2:  times 16 dw 2
+pw_4:  times 16 dw 4
+pw_23: times 16 dw 23
+pw_42: times 16 dw 42
+
+SECTION .text
+
+; reduce the dwords of %1 into its low dword, %2 is clobbered
+%macro REDUCE_D 2
+%if mmsize == 32
+    vextracti128    xm%2, m%1, 1
+    paddd           xm%1, xm%2
+%endif
+    pshufd          xm%2, xm%1, q1032
+    paddd           xm%1, xm%2
+    pshufd          xm%2, xm%1, q2301
+    paddd           xm%1, xm%2
+%endmacro
+
+; %1 = abs(%1) for signed words, %2 is clobbered
+%macro ABS_W 2
+%if cpuflag(ssse3)
+    pabsw              %1, %1
+%else
+    pxor               %2, %2
+    psubw              %2, %1
+    pmaxsw             %1, %2
+%endif
+%endmacro
+
+; %1 = 0xffff where the [1 -3 4 -3 1] filter of the words in %1 (cur), %2 (above),
+; %3 (below), %4 (above2) and %5 (below2) exceeds m15 (6 * cthresh);
+; %2 and %4 are clobbered
+%macro COMB_FILTER 5
+    paddw              %2, %3                   ; above + below
+    paddw              %4, %5                   ; above2 + below2
+    psllw              %1, 2
+    paddw              %1, %4
+    psubw              %1, %2
+    psubw              %1, %2
+    psubw              %1, %2
+    ABS_W              %1, %4
+    pcmpgtw            %1, m15
+%endmacro
+
+; sums[%2] += sum of the dwords of m%1, m0 and r3 are clobbered
+%macro ADD_SUM 2
+    REDUCE_D          %1, 0
+    movd             r3d, xm%1
+    add [sumsq + 4 * %2], r3d
+%endmacro
+
+%if ARCH_X86_64
+;------------------------------------------------------------------------------
+; void ff_fieldmatch_comb_row(uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+;                             const uint8_t *c, const uint8_t *p1,
+;                             const uint8_t *p2, int width, int cthresh)
+;------------------------------------------------------------------------------
+%macro COMB_ROW 0
+cglobal fieldmatch_comb_row, 8, 8, 16, dst, above2, above, cur, below, below2, w, cthresh
+    movsxdifnidn       wq, wd
+    add              dstq, wq
+    add           above2q, wq
+    add            aboveq, wq
+    add              curq, wq
+    add            belowq, wq
+    add           below2q, wq
+    neg                wq
+
+    movd             xm14, cthreshd
+    imul         cthreshd, 6
+    movd             xm15, cthreshd
+%if cpuflag(avx2)
+    vpbroadcastb      m14, xm14
+    vpbroadcastw      m15, xm15
+%else
+    punpcklbw         m14, m14
+    SPLATW            m14, m14
+    SPLATW            m15, m15
+%endif
+    pxor              m13, m13
+
+.loop:
+    movu               m0, [curq    + wq]
+    movu               m1, [aboveq  + wq]
+    movu               m2, [belowq  + wq]
+    psubusb            m3, m0, m1
+    psubusb            m4, m1, m0
+    por                m3, m4
+    psubusb            m3, m14                  ; zero where abs(cur - above) <= cthresh
+    pcmpeqb            m3, m13
+    psubusb            m4, m0, m2
+    psubusb            m5, m2, m0
+    por                m4, m5
+    psubusb            m4, m14                  ; zero where abs(cur - below) <= cthresh
+    pcmpeqb            m4, m13
+    por                m3, m4
+
+    movu               m4, [above2q + wq]
+    movu               m5, [below2q + wq]
+    punpcklbw          m6, m0, m13
+    punpcklbw          m7, m1, m13
+    punpcklbw          m8, m2, m13
+    punpcklbw          m9, m4, m13
+    punpcklbw         m10, m5, m13
+    COMB_FILTER        m6, m7, m8, m9, m10
+    punpckhbw          m0, m13
+    punpckhbw          m1, m13
+    punpckhbw          m2, m13
+    punpckhbw          m4, m13
+    punpckhbw          m5, m13
+    COMB_FILTER        m0, m1, m2, m4, m5
+    packsswb           m6, m0
+    pandn              m3, m6
+    movu       [dstq + wq], m3
+    add                wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_fieldmatch_match_row(uint32_t *sums, const uint8_t *const *rows,
+;                              int width)
+;------------------------------------------------------------------------------
+%macro MATCH_ROW 0
+cglobal fieldmatch_match_row, 3, 12, 16, sums, rows, w, spf, sf, snf, ppf, pnf, npf, nnf, map0, map1
+    movsxdifnidn       wq, wd
+    mov              spfq, [rowsq + 0 * gprsize]
+    mov               sfq, [rowsq + 1 * gprsize]
+    mov              snfq, [rowsq + 2 * gprsize]
+    mov              ppfq, [rowsq + 3 * gprsize]
+    mov              pnfq, [rowsq + 4 * gprsize]
+    mov              npfq, [rowsq + 5 * gprsize]
+    mov              nnfq, [rowsq + 6 * gprsize]
+    mov             map0q, [rowsq + 7 * gprsize]
+    mov             map1q, [rowsq + 8 * gprsize]
+    add              spfq, wq
+    add               sfq, wq
+    add              snfq, wq
+    add              ppfq, wq
+    add              pnfq, wq
+    add              npfq, wq
+    add              nnfq, wq
+    add             map0q, wq
+    add             map1q, wq
+    neg                wq
+
+    mova               m5, [pw_23]
+    mova               m6, [pw_42]
+    mova               m7, [pw_1]
+    mova               m8, [pw_2]
+    mova               m9, [pw_4]
+    pxor              m10, m10
+    pxor              m11, m11
+    pxor              m12, m12
+    pxor              m13, m13
+    pxor              m14, m14
+    pxor              m15, m15
+
+.loop:
+    pmovzxbw           m0, [sfq  + wq]
+    pmovzxbw           m4, [spfq + wq]
+    psllw              m0, 2
+    paddw              m0, m4
+    pmovzxbw           m4, [snfq + wq]
+    paddw              m0, m4                   ; [1 4 1]
+
+    pmovzxbw           m1, [ppfq + wq]
+    pmovzxbw           m4, [pnfq + wq]
+    paddw              m1, m4
+    paddw              m4, m1, m1
+    paddw              m1, m4
+    psubw              m1, m0
+    pabsw              m1, m1                   ; diff against the previous field
+    pmovzxbw           m2, [npfq + wq]
+    pmovzxbw           m4, [nnfq + wq]
+    paddw              m2, m4
+    paddw              m4, m2, m2
+    paddw              m2, m4
+    psubw              m2, m0
+    pabsw              m2, m2                   ; diff against the next field
+
+    pmovzxbw           m3, [map0q + wq]
+    pmovzxbw           m4, [map1q + wq]
+    por                m3, m4
+
+    pand               m4, m3, m7
+    pcmpeqw            m4, m7                   ; map & 1
+    pcmpgtw            m0, m1, m5
+    pand               m0, m4
+    pand               m0, m1
+    pmaddwd            m0, m7
+    paddd             m10, m0
+    pcmpgtw            m0, m2, m5
+    pand               m0, m4
+    pand               m0, m2
+    pmaddwd            m0, m7
+    paddd             m13, m0
+
+    pcmpgtw            m0, m1, m6
+    pand               m1, m0
+    pcmpgtw            m0, m2, m6
+    pand               m2, m0
+    pand               m4, m3, m8
+    pcmpeqw            m4, m8                   ; map & 2
+    pand               m0, m1, m4
+    pmaddwd            m0, m7
+    paddd             m11, m0
+    pand               m0, m2, m4
+    pmaddwd            m0, m7
+    paddd             m14, m0
+    pand               m4, m3, m9
+    pcmpeqw            m4, m9                   ; map & 4
+    pand               m0, m1, m4
+    pmaddwd            m0, m7
+    paddd             m12, m0
+    pand               m0, m2, m4
+    pmaddwd            m0, m7
+    paddd             m15, m0
+
+    add                wq, mmsize / 2
+    jl .loop
+
+    ADD_SUM           10, 0
+    ADD_SUM           11, 1
+    ADD_SUM           12, 2
+    ADD_SUM           13, 3
+    ADD_SUM           14, 4
+    ADD_SUM           15, 5
+    RET
+%endmacro
+%endif ; ARCH_X86_64
+
+;------------------------------------------------------------------------------
+; void ff_fieldmatch_comb_count(uint16_t *acc, const uint8_t *cmk,
+;                               ptrdiff_t stride, int width)
+;------------------------------------------------------------------------------
+%macro COMB_COUNT 0
+cglobal fieldmatch_comb_count, 4, 5, 4, acc, cmk, stride, w, up
+    movsxdifnidn       wq, wd
+    add              cmkq, wq
+    lea              accq, [accq + 2 * wq]
+    mov               upq, cmkq
+    sub               upq, strideq
+    add           strideq, cmkq                 ; row below
+    neg                wq
+
+.loop:
+    movu              xm0, [upq + wq]
+    movu              xm1, [cmkq + wq]
+    pand              xm0, xm1
+    movu              xm1, [strideq + wq]
+    pand              xm0, xm1
+    pcmpeqb           xm1, xm1
+    pcmpeqb           xm0, xm1                  ; 0xff where all three rows are combed
+%if cpuflag(avx2)
+    pmovsxbw           m0, xm0
+    movu               m1, [accq + 2 * wq]
+    psubw              m1, m0
+    movu [accq + 2 * wq], m1
+%else
+    punpckhbw          m1, m0, m0
+    punpcklbw          m0, m0
+    movu               m2, [accq + 2 * wq]
+    movu               m3, [accq + 2 * wq + 16]
+    psubw              m2, m0
+    psubw              m3, m1
+    movu [accq + 2 * wq], m2
+    movu [accq + 2 * wq + 16], m3
+%endif
+    add                wq, 16
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_fieldmatch_abs_diff(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+;                             int width)
+;------------------------------------------------------------------------------
+%macro ABS_DIFF 0
+cglobal fieldmatch_abs_diff, 4, 4, 3, dst, a, b, w
+    movsxdifnidn       wq, wd
+    add              dstq, wq
+    add                aq, wq
+    add                bq, wq
+    neg                wq
+
+.loop:
+    movu               m0, [aq + wq]
+    movu               m1, [bq + wq]
+    psubusb            m2, m0, m1
+    psubusb            m1, m0
+    por                m1, m2
+    movu       [dstq + wq], m1
+    add                wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; unsigned ff_fieldmatch_sad(const uint8_t *a, const uint8_t *b, int width)
+;------------------------------------------------------------------------------
+%macro SAD 0
+cglobal fieldmatch_sad, 3, 3, 3, a, b, w
+    movsxdifnidn       wq, wd
+    add                aq, wq
+    add                bq, wq
+    neg                wq
+    pxor               m0, m0
+
+.loop:
+    movu               m1, [aq + wq]
+    movu               m2, [bq + wq]
+    psadbw             m1, m2
+    paddq              m0, m1
+    add                wq, mmsize
+    jl .loop
+
+%if mmsize == 32
+    vextracti128      xm1, m0, 1
+    paddq             xm0, xm1
+%endif
+    pshufd            xm1, xm0, q1032
+    paddq             xm0, xm1
+    movd              eax, xm0
+    RET
+%endmacro
+
+INIT_XMM sse2
+COMB_COUNT
+ABS_DIFF
+SAD
+%if ARCH_X86_64
+COMB_ROW
+%endif
+
+INIT_XMM sse4
+%if ARCH_X86_64
+MATCH_ROW
+%endif
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+COMB_COUNT
+ABS_DIFF
+SAD
+%if ARCH_X86_64
+COMB_ROW
+MATCH_ROW
+%endif
+%endif
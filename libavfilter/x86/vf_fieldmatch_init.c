@@ -0,0 +1,64 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/fieldmatchdsp.h"
+
+void ff_fieldmatch_comb_row_sse2(uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+                                 const uint8_t *c, const uint8_t *p1, const uint8_t *p2,
+                                 int width, int cthresh);
+void ff_fieldmatch_comb_row_avx2(uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+                                 const uint8_t *c, const uint8_t *p1, const uint8_t *p2,
+                                 int width, int cthresh);
+void ff_fieldmatch_comb_count_sse2(uint16_t *acc, const uint8_t *cmk, ptrdiff_t stride, int width);
+void ff_fieldmatch_comb_count_avx2(uint16_t *acc, const uint8_t *cmk, ptrdiff_t stride, int width);
+void ff_fieldmatch_abs_diff_sse2(uint8_t *dst, const uint8_t *a, const uint8_t *b, int width);
+void ff_fieldmatch_abs_diff_avx2(uint8_t *dst, const uint8_t *a, const uint8_t *b, int width);
+unsigned ff_fieldmatch_sad_sse2(const uint8_t *a, const uint8_t *b, int width);
+unsigned ff_fieldmatch_sad_avx2(const uint8_t *a, const uint8_t *b, int width);
+void ff_fieldmatch_match_row_sse4(uint32_t *sums, const uint8_t *const *rows, int width);
+void ff_fieldmatch_match_row_avx2(uint32_t *sums, const uint8_t *const *rows, int width);
+
+av_cold void ff_fieldmatch_init_x86(FieldMatchDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        dsp->comb_count = ff_fieldmatch_comb_count_sse2;
+        dsp->abs_diff   = ff_fieldmatch_abs_diff_sse2;
+        dsp->sad        = ff_fieldmatch_sad_sse2;
+#if ARCH_X86_64
+        dsp->comb_row   = ff_fieldmatch_comb_row_sse2;
+#endif
+    }
+#if ARCH_X86_64
+    if (EXTERNAL_SSE4(cpu_flags))
+        dsp->match_row  = ff_fieldmatch_match_row_sse4;
+#endif
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        dsp->comb_count = ff_fieldmatch_comb_count_avx2;
+        dsp->abs_diff   = ff_fieldmatch_abs_diff_avx2;
+        dsp->sad        = ff_fieldmatch_sad_avx2;
+#if ARCH_X86_64
+        dsp->comb_row   = ff_fieldmatch_comb_row_avx2;
+        dsp->match_row  = ff_fieldmatch_match_row_avx2;
+#endif
+    }
+}
@@ -0,0 +1,139 @@
+;*****************************************************************************
+;* x86-optimized functions for paletteuse filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+
+SECTION_RODATA 32
+
+pq_idx_even: dq 0, 2, 4, 6
+pq_idx_odd:  dq 1, 3, 5, 7
+pq_8:        dq 8
+pq_max:      dq 0x7fffffffffffffff
+
+SECTION .text
+
+; squared distances of the 8 colors at offset i to the target in m13-m15,
+; returned as 64-bit values for the even colors in %1 and the odd ones in %2
+%macro DIST 2
+    movu            m2, [plq + iq]
+    movu            m3, [paq + iq]
+    movu            m4, [pbq + iq]
+    psubd           m2, m13
+    psubd           m3, m14
+    psubd           m4, m15
+    psrlq           %2, m2, 32
+    psrlq           m5, m3, 32
+    pmuldq          m2, m2
+    pmuldq          m3, m3
+    pmuldq          %2, %2
+    pmuldq          m5, m5
+    paddq           m2, m3
+    paddq           %2, m5
+    psrlq           m3, m4, 32
+    pmuldq          m4, m4
+    pmuldq          m3, m3
+    paddq           %1, m2, m4
+    paddq           %2, m3
+%endmacro
+
+; 64-bit signed minimum of %1 and %2 into %1, using %3 as temporary
+%macro PMINSQ 3
+    pcmpgtq         %3, %1, %2
+    pblendvb        %1, %1, %2, %3
+%endmacro
+
+; int ff_color_search(const int32_t *L, const int32_t *a, const int32_t *b,
+;                     int nb_colors, const int32_t *target)
+INIT_YMM avx2
+cglobal color_search, 5, 6, 16, pl, pa, pb, nb, target, i
+    vpbroadcastd   m13, [targetq]
+    vpbroadcastd   m14, [targetq + 4]
+    vpbroadcastd   m15, [targetq + 8]
+    movsxdifnidn   nbq, nbd
+    shl            nbq, 2
+    vpbroadcastq    m6, [pq_max]
+    mova            m7, m6
+    xor             iq, iq
+
+.min_loop:
+    DIST            m0, m1
+    PMINSQ          m6, m0, m2
+    PMINSQ          m7, m1, m2
+    add             iq, mmsize
+    cmp             iq, nbq
+    jl .min_loop
+
+    PMINSQ          m6, m7, m2
+    vextracti128   xm7, m6, 1
+    PMINSQ         xm6, xm7, xm2
+    pshufd         xm7, xm6, q1032
+    PMINSQ         xm6, xm7, xm2
+    movq           rax, xm6
+    cmp            rax, 0x7ffffffe
+    jge .fail
+    vpbroadcastq    m6, xm6
+
+    ; count the colors at the minimum distance and sum their indices,
+    ; which gives the index of the closest color when it is unique
+    pxor            m8, m8
+    pxor            m9, m9
+    mova           m10, [pq_idx_even]
+    mova           m11, [pq_idx_odd]
+    vpbroadcastq   m12, [pq_8]
+    xor             iq, iq
+
+.count_loop:
+    DIST            m0, m1
+    pcmpeqq         m0, m6
+    pcmpeqq         m1, m6
+    psubq           m8, m0
+    psubq           m8, m1
+    pand            m0, m10
+    pand            m1, m11
+    paddq           m9, m0
+    paddq           m9, m1
+    paddq          m10, m12
+    paddq          m11, m12
+    add             iq, mmsize
+    cmp             iq, nbq
+    jl .count_loop
+
+    vextracti128   xm0, m8, 1
+    paddq          xm8, xm0
+    pshufd         xm0, xm8, q1032
+    paddq          xm8, xm0
+    movq           rax, xm8
+    cmp            rax, 1
+    jne .fail
+
+    vextracti128   xm0, m9, 1
+    paddq          xm9, xm0
+    pshufd         xm0, xm9, q1032
+    paddq          xm9, xm0
+    movd           eax, xm9
+    RET
+
+.fail:
+    mov            eax, -1
+    RET
+
+%endif
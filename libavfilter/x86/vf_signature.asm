@@ -0,0 +1,119 @@
+;*****************************************************************************
+;* x86-optimized functions for signature filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 2 of the License, or
+;* (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pb_popcnt: times 2 db 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+pb_15:     times 32 db 15
+
+%define COARSE_WORDS     5
+%define COARSE_WORD_SIZE 32
+%define L1PLANES_SIZE    96
+
+SECTION .text
+
+; per byte popcount of m%1 using the nibble table in m6 and the mask in m7
+; %2, %3 = temporaries
+%macro POPCNT_BYTES 3
+    psrlw      m%2, m%1, 4
+    pand       m%3, m%1, m7
+    pand       m%2, m7
+    pshufb     m%1, m6, m%3
+    pshufb     m%3, m6, m%2
+    paddb      m%1, m%3
+%endmacro
+
+; sum the qwords of m%1 into its low dword, %2 = temporary
+%macro HSUMQ 2
+%if mmsize == 32
+    vextracti128 xm%2, m%1, 1
+    paddq      xm%1, xm%2
+%endif
+    punpckhqdq xm%2, xm%1, xm%1
+    paddq      xm%1, xm%2
+%endmacro
+
+%macro SIGNATURE_FUNCS 0
+;------------------------------------------------------------------------------
+; int ff_signature_l1dist(const uint8_t *a, const uint8_t *b)
+;------------------------------------------------------------------------------
+cglobal signature_l1dist, 2, 2, 8, a, b
+    mova       m6, [pb_popcnt]
+    mova       m7, [pb_15]
+    pxor       m5, m5
+%assign i 0
+%rep L1PLANES_SIZE / mmsize
+    movu       m0, [aq + i]
+    movu       m1, [bq + i]
+    pxor       m0, m1
+    POPCNT_BYTES 0, 1, 2
+    paddb      m5, m0
+%assign i i + mmsize
+%endrep
+    pxor       m0, m0
+    psadbw     m5, m0
+    HSUMQ      5, 0
+    movd      eax, xm5
+    RET
+
+;------------------------------------------------------------------------------
+; void ff_signature_coarse_popcount(const uint8_t *a, const uint8_t *b,
+;                                   int *inter, int *uni)
+;------------------------------------------------------------------------------
+cglobal signature_coarse_popcount, 4, 4, 8, a, b, inter, uni
+    mova       m6, [pb_popcnt]
+    mova       m7, [pb_15]
+%assign w 0
+%rep COARSE_WORDS
+    pxor       m4, m4
+    pxor       m5, m5
+%assign i 0
+%rep COARSE_WORD_SIZE / mmsize
+    movu       m0, [aq + w * COARSE_WORD_SIZE + i]
+    movu       m2, [bq + w * COARSE_WORD_SIZE + i]
+    pand       m1, m0, m2
+    por        m0, m2
+    POPCNT_BYTES 1, 2, 3
+    POPCNT_BYTES 0, 2, 3
+    paddb      m4, m1
+    paddb      m5, m0
+%assign i i + mmsize
+%endrep
+    pxor       m0, m0
+    psadbw     m4, m0
+    psadbw     m5, m0
+    HSUMQ      4, 0
+    HSUMQ      5, 0
+    movd       [interq + w * 4], xm4
+    movd       [uniq + w * 4], xm5
+%assign w w + 1
+%endrep
+    RET
+%endmacro
+
+INIT_XMM ssse3
+SIGNATURE_FUNCS
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+SIGNATURE_FUNCS
+%endif
@@ -0,0 +1,44 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/signaturedsp.h"
+
+void ff_signature_coarse_popcount_ssse3(const uint8_t *a, const uint8_t *b,
+                                        int *inter, int *uni);
+void ff_signature_coarse_popcount_avx2(const uint8_t *a, const uint8_t *b,
+                                       int *inter, int *uni);
+int ff_signature_l1dist_ssse3(const uint8_t *a, const uint8_t *b);
+int ff_signature_l1dist_avx2(const uint8_t *a, const uint8_t *b);
+
+av_cold void ff_signature_init_x86(SignatureDSPContext *s)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSSE3(cpu_flags)) {
+        s->coarse_popcount = ff_signature_coarse_popcount_ssse3;
+        s->l1dist          = ff_signature_l1dist_ssse3;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        s->coarse_popcount = ff_signature_coarse_popcount_avx2;
+        s->l1dist          = ff_signature_l1dist_avx2;
+    }
+}
@@ -0,0 +1,111 @@
+;*****************************************************************************
+;* x86-optimized functions for vectorscope filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_vectorscope_reduce_sum(uint16_t *dst, const uint16_t *src,
+;                                ptrdiff_t src_stride, int nb_src, int len)
+;------------------------------------------------------------------------------
+%macro REDUCE_SUM 0
+cglobal vectorscope_reduce_sum, 5, 7, 5, dst, src, stride, nb, len, ptr, n
+    add         strideq, strideq
+    movsxdifnidn   lenq, lend
+    add            lenq, lenq
+    pcmpeqw          m3, m3
+    psrlw            m3, 15                 ; pw_1
+    pxor             m4, m4
+
+.loop:
+    mov            ptrq, srcq
+    mov              nd, nbd
+    pxor             m0, m0                 ; saturated sum of v - 1
+    pxor             m1, m1                 ; hit mask
+
+.inner:
+    movu             m2, [ptrq]
+    por              m1, m2
+    psubusw          m2, m3
+    paddusw          m0, m2
+    add            ptrq, strideq
+    dec              nd
+    jg .inner
+
+    pcmpeqw          m1, m4
+    pand             m1, m3                 ; 1 where nothing was hit
+    paddusw          m0, m3
+    psubusw          m0, m1
+    movu         [dstq], m0
+    add            srcq, mmsize
+    add            dstq, mmsize
+    sub            lenq, mmsize
+    jg .loop
+    RET
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_vectorscope_reduce_max(uint16_t *dst, const uint16_t *src,
+;                                ptrdiff_t src_stride, int nb_src, int len)
+;------------------------------------------------------------------------------
+%macro REDUCE_MAX 0
+cglobal vectorscope_reduce_max, 5, 7, 2, dst, src, stride, nb, len, ptr, n
+    add         strideq, strideq
+    movsxdifnidn   lenq, lend
+    add            lenq, lenq
+
+.loop:
+    mov            ptrq, srcq
+    mov              nd, nbd
+    pxor             m0, m0
+
+.inner:
+    movu             m1, [ptrq]
+%if cpuflag(sse4)
+    pmaxuw           m0, m1
+%else
+    psubusw          m1, m0
+    paddw            m0, m1                 ; max(a, b) = a + sat(b - a)
+%endif
+    add            ptrq, strideq
+    dec              nd
+    jg .inner
+
+    movu         [dstq], m0
+    add            srcq, mmsize
+    add            dstq, mmsize
+    sub            lenq, mmsize
+    jg .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+REDUCE_SUM
+REDUCE_MAX
+
+INIT_XMM sse4
+REDUCE_MAX
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+REDUCE_SUM
+REDUCE_MAX
+%endif
@@ -0,0 +1,50 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/vectorscopedsp.h"
+
+void ff_vectorscope_reduce_sum_sse2(uint16_t *dst, const uint16_t *src,
+                                    ptrdiff_t src_stride, int nb_src, int len);
+void ff_vectorscope_reduce_sum_avx2(uint16_t *dst, const uint16_t *src,
+                                    ptrdiff_t src_stride, int nb_src, int len);
+void ff_vectorscope_reduce_max_sse2(uint16_t *dst, const uint16_t *src,
+                                    ptrdiff_t src_stride, int nb_src, int len);
+void ff_vectorscope_reduce_max_sse4(uint16_t *dst, const uint16_t *src,
+                                    ptrdiff_t src_stride, int nb_src, int len);
+void ff_vectorscope_reduce_max_avx2(uint16_t *dst, const uint16_t *src,
+                                    ptrdiff_t src_stride, int nb_src, int len);
+
+av_cold void ff_vectorscope_init_x86(VectorscopeDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        dsp->reduce_sum = ff_vectorscope_reduce_sum_sse2;
+        dsp->reduce_max = ff_vectorscope_reduce_max_sse2;
+    }
+    if (EXTERNAL_SSE4(cpu_flags))
+        dsp->reduce_max = ff_vectorscope_reduce_max_sse4;
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        dsp->reduce_sum = ff_vectorscope_reduce_sum_avx2;
+        dsp->reduce_max = ff_vectorscope_reduce_max_avx2;
+    }
+}
@@ -28,6 +28,7 @@
 #include "bswap.h"
 #include "error.h"
 #include "sha.h"
+#include "sha_internal.h"
 #include "intreadwrite.h"
 #include "mem.h"
 
@@ -38,7 +39,7 @@ typedef struct AVSHA {
     uint8_t  buffer[64];  ///< 512-bit buffer of input values used in hash updating
     uint32_t state[8];    ///< current hash value
     /** function used to update hash for 512-bit input block */
-    void     (*transform)(uint32_t *state, const uint8_t buffer[64]);
+    ff_sha_transform_fn transform;
 } AVSHA;
 
 const int av_sha_size = sizeof(AVSHA);
@@ -271,6 +272,14 @@ static void sha256_transform(uint32_t *state, const uint8_t buffer[64])
 }
 
 
+av_cold void ff_sha_init_transform(ff_sha_transform_fn *transform, int bits)
+{
+    *transform = bits == 160 ? sha1_transform : sha256_transform;
+#if ARCH_X86
+    ff_sha_init_x86(transform, bits);
+#endif
+}
+
 av_cold int av_sha_init(AVSHA *ctx, int bits)
 {
     ctx->digest_len = bits >> 5;
@@ -281,7 +290,6 @@ av_cold int av_sha_init(AVSHA *ctx, int bits)
         ctx->state[2] = 0x98BADCFE;
         ctx->state[3] = 0x10325476;
         ctx->state[4] = 0xC3D2E1F0;
-        ctx->transform = sha1_transform;
         break;
     case 224: // SHA-224
         ctx->state[0] = 0xC1059ED8;
@@ -292,7 +300,6 @@ av_cold int av_sha_init(AVSHA *ctx, int bits)
         ctx->state[5] = 0x68581511;
         ctx->state[6] = 0x64F98FA7;
         ctx->state[7] = 0xBEFA4FA4;
-        ctx->transform = sha256_transform;
         break;
     case 256: // SHA-256
         ctx->state[0] = 0x6A09E667;
@@ -303,11 +310,11 @@ av_cold int av_sha_init(AVSHA *ctx, int bits)
         ctx->state[5] = 0x9B05688C;
         ctx->state[6] = 0x1F83D9AB;
         ctx->state[7] = 0x5BE0CD19;
-        ctx->transform = sha256_transform;
         break;
     default:
         return AVERROR(EINVAL);
     }
+    ff_sha_init_transform(&ctx->transform, bits);
     ctx->count = 0;
     return 0;
 }
@@ -22,12 +22,29 @@
 #include "slicethread.h"
 #include "mem.h"
 #include "thread.h"
+#include "threadpool.h"
 #include "avassert.h"
 
 #define MAX_AUTO_THREADS 16
 
 #if HAVE_PTHREADS || HAVE_W32THREADS || HAVE_OS2THREADS
 
+struct AVThreadPool {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    pthread_t       *threads;
+    int             nb_threads;
+    int             refcount;       ///< protected by pool_lock
+    int             finished;
+
+    /* contexts with jobs waiting for a pool thread, served round-robin */
+    AVSliceThread   *queue_head;
+    AVSliceThread   *queue_tail;
+};
+
+static AVMutex pool_lock = AV_MUTEX_INITIALIZER;
+static AVThreadPool *global_pool;
+
 typedef struct WorkerContext {
     AVSliceThread   *ctx;
     pthread_mutex_t mutex;
@@ -52,8 +69,230 @@ struct AVSliceThread {
     void            *priv;
     void            (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads);
     void            (*main_func)(void *priv);
+
+    /* shared pool mode, everything below is protected by pool->mutex */
+    AVThreadPool    *pool;
+    AVSliceThread   *queue_next;
+    int             queued;
+    int             next_job;
+    int             nb_jobs_done;
+    int             nb_helpers;
+    int             max_helpers;
+    uint8_t         *threadnr_busy;
 };
 
+static void pool_enqueue(AVThreadPool *pool, AVSliceThread *ctx)
+{
+    ctx->queue_next = NULL;
+    if (pool->queue_tail)
+        pool->queue_tail->queue_next = ctx;
+    else
+        pool->queue_head = ctx;
+    pool->queue_tail = ctx;
+    ctx->queued = 1;
+}
+
+static AVSliceThread *pool_dequeue(AVThreadPool *pool)
+{
+    AVSliceThread *ctx = pool->queue_head;
+
+    pool->queue_head = ctx->queue_next;
+    if (!pool->queue_head)
+        pool->queue_tail = NULL;
+    ctx->queued = 0;
+    return ctx;
+}
+
+static void pool_remove(AVThreadPool *pool, AVSliceThread *ctx)
+{
+    AVSliceThread **p = &pool->queue_head, *prev = NULL;
+
+    while (*p != ctx) {
+        prev = *p;
+        p    = &prev->queue_next;
+    }
+    *p = ctx->queue_next;
+    if (pool->queue_tail == ctx)
+        pool->queue_tail = prev;
+    ctx->queued = 0;
+}
+
+static int pool_can_help(const AVSliceThread *ctx)
+{
+    return ctx->next_job < ctx->nb_jobs && ctx->nb_helpers < ctx->max_helpers;
+}
+
+static int acquire_threadnr(AVSliceThread *ctx, int jobnr)
+{
+    /* like with private threads, job n < nb_active_threads runs as thread n;
+     * some callers rely on job 0 being run as thread 0 */
+    int threadnr = jobnr;
+
+    if (threadnr >= ctx->nb_active_threads)
+        for (threadnr = 0; ctx->threadnr_busy[threadnr]; threadnr++);
+    ctx->threadnr_busy[threadnr] = 1;
+    return threadnr;
+}
+
+static void *attribute_align_arg pool_worker(void *v)
+{
+    AVThreadPool *pool = v;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (1) {
+        AVSliceThread *ctx;
+        int jobnr, threadnr;
+
+        while (!pool->queue_head && !pool->finished)
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        if (pool->finished)
+            break;
+
+        ctx = pool_dequeue(pool);
+        if (!pool_can_help(ctx))
+            continue;
+
+        jobnr    = ctx->next_job++;
+        threadnr = acquire_threadnr(ctx, jobnr);
+        ctx->nb_helpers++;
+        /* run a single job, then go to the back of the queue, so that
+         * contexts sharing the pool get their turn */
+        if (pool_can_help(ctx))
+            pool_enqueue(pool, ctx);
+        pthread_mutex_unlock(&pool->mutex);
+
+        ctx->worker_func(ctx->priv, jobnr, threadnr, ctx->nb_jobs, ctx->nb_active_threads);
+
+        pthread_mutex_lock(&pool->mutex);
+        ctx->threadnr_busy[threadnr] = 0;
+        ctx->nb_helpers--;
+        if (++ctx->nb_jobs_done == ctx->nb_jobs)
+            pthread_cond_signal(&ctx->done_cond);
+        else if (!ctx->queued && pool_can_help(ctx))
+            pool_enqueue(pool, ctx);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+static void pool_free(AVThreadPool *pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->finished = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->nb_threads; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+    av_freep(&pool->threads);
+    av_free(pool);
+}
+
+static void pool_unref(AVThreadPool *pool)
+{
+    int last;
+
+    ff_mutex_lock(&pool_lock);
+    last = !--pool->refcount;
+    ff_mutex_unlock(&pool_lock);
+
+    if (last)
+        pool_free(pool);
+}
+
+static void pool_ref(AVThreadPool *pool)
+{
+    ff_mutex_lock(&pool_lock);
+    pool->refcount++;
+    ff_mutex_unlock(&pool_lock);
+}
+
+/* whether the calling thread is one of the pool threads */
+static int pool_is_worker(const AVThreadPool *pool)
+{
+    pthread_t self = pthread_self();
+
+    for (int i = 0; i < pool->nb_threads; i++)
+        if (pthread_equal(self, pool->threads[i]))
+            return 1;
+    return 0;
+}
+
+static int pool_alloc(AVThreadPool **ppool, int nb_threads)
+{
+    AVThreadPool *pool;
+
+    if (nb_threads < 0)
+        return AVERROR(EINVAL);
+    if (!nb_threads)
+        nb_threads = av_cpu_count();
+
+    pool = av_mallocz(sizeof(*pool));
+    if (!pool)
+        return AVERROR(ENOMEM);
+    pool->threads = av_calloc(nb_threads, sizeof(*pool->threads));
+    if (!pool->threads) {
+        av_free(pool);
+        return AVERROR(ENOMEM);
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    pool->refcount = 1;
+
+    for (; pool->nb_threads < nb_threads; pool->nb_threads++) {
+        int ret = pthread_create(&pool->threads[pool->nb_threads], NULL,
+                                 pool_worker, pool);
+        if (ret) {
+            pool_free(pool);
+            return AVERROR(ret);
+        }
+    }
+
+    *ppool = pool;
+    return nb_threads;
+}
+
+int av_thread_pool_alloc(AVThreadPool **ppool, int nb_threads)
+{
+    *ppool = NULL;
+    return pool_alloc(ppool, nb_threads);
+}
+
+void av_thread_pool_free(AVThreadPool **ppool)
+{
+    if (*ppool)
+        pool_unref(*ppool);
+    *ppool = NULL;
+}
+
+int av_thread_pool_init(int nb_threads)
+{
+    int ret;
+
+    ff_mutex_lock(&pool_lock);
+    ret = global_pool ? AVERROR(EEXIST) : pool_alloc(&global_pool, nb_threads);
+    ff_mutex_unlock(&pool_lock);
+
+    return ret;
+}
+
+void av_thread_pool_uninit(void)
+{
+    AVThreadPool *pool;
+
+    ff_mutex_lock(&pool_lock);
+    pool        = global_pool;
+    global_pool = NULL;
+    ff_mutex_unlock(&pool_lock);
+
+    if (pool)
+        pool_unref(pool);
+}
+
 static int run_jobs(AVSliceThread *ctx)
 {
     unsigned nb_jobs    = ctx->nb_jobs;
@@ -95,10 +334,10 @@ static void *attribute_align_arg thread_worker(void *v)
     }
 }
 
-int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
-                              void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
-                              void (*main_func)(void *priv),
-                              int nb_threads)
+int avpriv_slicethread_create_pool(AVSliceThread **pctx, void *priv,
+                                   void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                                   void (*main_func)(void *priv),
+                                   int nb_threads, AVThreadPool *pool)
 {
     AVSliceThread *ctx;
     int nb_workers, i;
@@ -120,6 +359,29 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     if (!ctx)
         return AVERROR(ENOMEM);
 
+    if (pool) {
+        ctx->pool = pool;
+        pool_ref(pool);
+    } else {
+        ff_mutex_lock(&pool_lock);
+        if (global_pool) {
+            ctx->pool = global_pool;
+            ctx->pool->refcount++;
+        }
+        ff_mutex_unlock(&pool_lock);
+    }
+
+    if (ctx->pool) {
+        /* the pool threads do the work, nb_threads only caps how many of
+         * them may work on this context at once */
+        nb_workers = 0;
+        if (!(ctx->threadnr_busy = av_mallocz(nb_threads))) {
+            pool_unref(ctx->pool);
+            av_freep(pctx);
+            return AVERROR(ENOMEM);
+        }
+    }
+
     if (nb_workers && !(ctx->workers = av_calloc(nb_workers, sizeof(*ctx->workers)))) {
         av_freep(pctx);
         return AVERROR(ENOMEM);
@@ -165,11 +427,77 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     return nb_threads;
 }
 
+int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
+                              void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                              void (*main_func)(void *priv),
+                              int nb_threads)
+{
+    return avpriv_slicethread_create_pool(pctx, priv, worker_func, main_func,
+                                          nb_threads, NULL);
+}
+
+static void shared_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
+{
+    AVThreadPool *pool = ctx->pool;
+    int run_main = ctx->main_func && execute_main;
+
+    /* Called from a job running on the same pool, e.g. by a filter using
+     * a slice threaded scaler. Waiting for the other pool threads could
+     * deadlock once all of them do so, so run everything right here, in
+     * order, as a single thread. main_func goes last, as it may wait for
+     * the jobs. */
+    if (pool_is_worker(pool)) {
+        for (int i = 0; i < nb_jobs; i++)
+            ctx->worker_func(ctx->priv, i, 0, nb_jobs, 1);
+        if (run_main)
+            ctx->main_func(ctx->priv);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    ctx->nb_jobs           = nb_jobs;
+    ctx->nb_active_threads = FFMIN(nb_jobs, ctx->nb_threads);
+    ctx->next_job          = 0;
+    ctx->nb_jobs_done      = 0;
+    ctx->max_helpers       = ctx->nb_active_threads - !run_main;
+    if (ctx->max_helpers > 0) {
+        pool_enqueue(pool, ctx);
+        for (int i = 0; i < ctx->max_helpers; i++)
+            pthread_cond_signal(&pool->cond);
+    }
+
+    if (run_main) {
+        pthread_mutex_unlock(&pool->mutex);
+        ctx->main_func(ctx->priv);
+        pthread_mutex_lock(&pool->mutex);
+    } else {
+        while (ctx->next_job < nb_jobs) {
+            int jobnr    = ctx->next_job++;
+            int threadnr = acquire_threadnr(ctx, jobnr);
+            pthread_mutex_unlock(&pool->mutex);
+            ctx->worker_func(ctx->priv, jobnr, threadnr, nb_jobs, ctx->nb_active_threads);
+            pthread_mutex_lock(&pool->mutex);
+            ctx->threadnr_busy[threadnr] = 0;
+            ctx->nb_jobs_done++;
+        }
+    }
+
+    while (ctx->nb_jobs_done < nb_jobs)
+        pthread_cond_wait(&ctx->done_cond, &pool->mutex);
+    if (ctx->queued)
+        pool_remove(pool, ctx);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
 {
     int nb_workers, i, is_last = 0;
 
     av_assert0(nb_jobs > 0);
+    if (ctx->pool) {
+        shared_execute(ctx, nb_jobs, execute_main);
+        return;
+    }
     ctx->nb_jobs           = nb_jobs;
     ctx->nb_active_threads = FFMIN(nb_jobs, ctx->nb_threads);
     atomic_store_explicit(&ctx->first_job, 0, memory_order_relaxed);
@@ -209,8 +537,8 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
         return;
 
     ctx = *pctx;
-    nb_workers = ctx->nb_threads;
-    if (!ctx->main_func)
+    nb_workers = ctx->pool ? 0 : ctx->nb_threads;
+    if (nb_workers && !ctx->main_func)
         nb_workers--;
 
     ctx->finished = 1;
@@ -229,8 +557,12 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
         pthread_mutex_destroy(&w->mutex);
     }
 
+    if (ctx->pool)
+        pool_unref(ctx->pool);
+
     pthread_cond_destroy(&ctx->done_cond);
     pthread_mutex_destroy(&ctx->done_mutex);
+    av_freep(&ctx->threadnr_busy);
     av_freep(&ctx->workers);
     av_freep(pctx);
 }
@@ -256,4 +588,33 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
     av_assert0(!pctx || !*pctx);
 }
 
+int avpriv_slicethread_create_pool(AVSliceThread **pctx, void *priv,
+                                   void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                                   void (*main_func)(void *priv),
+                                   int nb_threads, AVThreadPool *pool)
+{
+    *pctx = NULL;
+    return AVERROR(ENOSYS);
+}
+
+int av_thread_pool_alloc(AVThreadPool **ppool, int nb_threads)
+{
+    *ppool = NULL;
+    return AVERROR(ENOSYS);
+}
+
+void av_thread_pool_free(AVThreadPool **ppool)
+{
+    av_assert0(!*ppool);
+}
+
+int av_thread_pool_init(int nb_threads)
+{
+    return AVERROR(ENOSYS);
+}
+
+void av_thread_pool_uninit(void)
+{
+}
+
 #endif /* HAVE_PTHREADS || HAVE_W32THREADS || HAVE_OS32THREADS */
@@ -0,0 +1,191 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * This test program runs several slice threading contexts concurrently on
+ * the process-wide thread pool and checks that every job runs exactly once,
+ * with a unique thread number and within the per-context thread limit.
+ * It then starts the jobs of a context from within the jobs of another one
+ * on a caller-supplied pool, which must not wait for the busy pool threads.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/error.h"
+#include "libavutil/slicethread.h"
+#include "libavutil/thread.h"
+#include "libavutil/threadpool.h"
+#include "libavutil/time.h"
+
+#define NB_CONTEXTS 4
+#define NB_JOBS     37
+#define NB_RUNS     50
+#define MAX_THREADS 8
+
+typedef struct TestContext {
+    AVSliceThread *slicethread;
+    int nb_threads;
+    atomic_int running;
+    atomic_int busy[MAX_THREADS];
+    atomic_int jobs[NB_JOBS];
+    atomic_int error;
+    pthread_t caller;
+} TestContext;
+
+static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    TestContext *t = priv;
+    volatile unsigned sum = 0;
+
+    if (atomic_fetch_add(&t->running, 1) >= t->nb_threads ||
+        threadnr < 0 || threadnr >= nb_threads || nb_threads > t->nb_threads ||
+        atomic_exchange(&t->busy[threadnr], 1))
+        atomic_store(&t->error, 1);
+
+    for (int i = 0; i < 1000 * (jobnr + 1); i++)
+        sum += i;
+    atomic_fetch_add(&t->jobs[jobnr], 1);
+
+    atomic_store(&t->busy[threadnr], 0);
+    atomic_fetch_sub(&t->running, 1);
+}
+
+typedef struct NestedContext {
+    AVSliceThread *outer, *inner[2];
+    atomic_int jobs[2];
+    atomic_int total;
+} NestedContext;
+
+typedef struct InnerArg {
+    NestedContext *n;
+    int idx;
+} InnerArg;
+
+static void inner_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    InnerArg *a = priv;
+
+    atomic_fetch_add(&a->n->jobs[a->idx], 1);
+    atomic_fetch_add(&a->n->total, 1);
+}
+
+/* waits for the jobs, like the VP9 loop filter does for the tiles */
+static void inner_main(void *priv)
+{
+    InnerArg *a = priv;
+
+    while (atomic_load(&a->n->jobs[a->idx]) < NB_JOBS)
+        av_usleep(10);
+}
+
+static void outer_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    NestedContext *n = priv;
+
+    atomic_store(&n->jobs[jobnr], 0);
+    avpriv_slicethread_execute(n->inner[jobnr], NB_JOBS, 1);
+}
+
+static int test_nested(void)
+{
+    static InnerArg args[2];
+    AVThreadPool *pool;
+    NestedContext n = { 0 };
+
+    /* a single pool thread, which runs one of the outer jobs and has
+     * nobody to hand the inner jobs to while inner_main() waits */
+    if (av_thread_pool_alloc(&pool, 1) != 1)
+        return 7;
+    if (avpriv_slicethread_create_pool(&n.outer, &n, outer_func, NULL, 2, pool) != 2)
+        return 8;
+    for (int i = 0; i < 2; i++) {
+        args[i].n   = &n;
+        args[i].idx = i;
+        if (avpriv_slicethread_create_pool(&n.inner[i], &args[i], inner_func,
+                                           inner_main, 2, pool) != 2)
+            return 8;
+    }
+    av_thread_pool_free(&pool);
+
+    atomic_init(&n.total, 0);
+    for (int i = 0; i < NB_RUNS; i++)
+        avpriv_slicethread_execute(n.outer, 2, 0);
+
+    avpriv_slicethread_free(&n.outer);
+    for (int i = 0; i < 2; i++)
+        avpriv_slicethread_free(&n.inner[i]);
+    return atomic_load(&n.total) != NB_RUNS * 2 * NB_JOBS ? 9 : 0;
+}
+
+static void *caller_main(void *arg)
+{
+    TestContext *t = arg;
+
+    for (int i = 0; i < NB_RUNS; i++)
+        avpriv_slicethread_execute(t->slicethread, NB_JOBS, 0);
+    return NULL;
+}
+
+int main(void)
+{
+    static TestContext ctx[NB_CONTEXTS];
+    int ret;
+
+    if ((ret = av_thread_pool_init(3)) != 3) {
+        fprintf(stderr, "av_thread_pool_init failed: %s.\n", av_err2str(ret));
+        return 1;
+    }
+    if (av_thread_pool_init(3) != AVERROR(EEXIST))
+        return 2;
+
+    for (int i = 0; i < NB_CONTEXTS; i++) {
+        ctx[i].nb_threads = 1 + i * (MAX_THREADS - 1) / (NB_CONTEXTS - 1);
+        ret = avpriv_slicethread_create(&ctx[i].slicethread, &ctx[i], worker_func,
+                                        NULL, ctx[i].nb_threads);
+        if (ret != ctx[i].nb_threads)
+            return 3;
+    }
+    /* the pool stays alive as long as contexts use it */
+    av_thread_pool_uninit();
+
+    for (int i = 0; i < NB_CONTEXTS; i++) {
+        if ((ret = pthread_create(&ctx[i].caller, NULL, caller_main, &ctx[i]))) {
+            fprintf(stderr, "pthread_create failed: %s.\n", strerror(ret));
+            return 1;
+        }
+    }
+    for (int i = 0; i < NB_CONTEXTS; i++)
+        pthread_join(ctx[i].caller, NULL);
+
+    for (int i = 0; i < NB_CONTEXTS; i++) {
+        avpriv_slicethread_free(&ctx[i].slicethread);
+        if (atomic_load(&ctx[i].error))
+            return 4;
+        for (int j = 0; j < NB_JOBS; j++)
+            if (atomic_load(&ctx[i].jobs[j]) != NB_RUNS)
+                return 5;
+    }
+
+    if (av_thread_pool_init(0) <= 0)
+        return 6;
+    av_thread_pool_uninit();
+
+    return test_nested();
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_THREADPOOL_H
+#define AVUTIL_THREADPOOL_H
+
+/**
+ * @file
+ * Pools of slice threads shared between contexts.
+ *
+ * By default every slice threaded context (codecs using slice threading,
+ * filter graphs, scaling contexts) spawns threads of its own. A pool can
+ * instead be allocated with av_thread_pool_alloc() and passed to the
+ * contexts through AVCodecContext.thread_pool, AVFilterGraph.thread_pool or
+ * sws_set_thread_pool(). Once a process-wide pool is set up with
+ * av_thread_pool_init(), it is used by all contexts created afterwards that
+ * were not given a pool of their own.
+ *
+ * Contexts using a pool run their jobs on it. The thread count requested for
+ * such a context then only limits how many pool threads may work on it at
+ * the same time, and the pool threads serve all contexts with pending jobs
+ * in turn, one job at a time.
+ *
+ * A context whose jobs are started from a job running on its own pool, such
+ * as a slice threaded scaler used inside a slice threaded filter, runs them
+ * on the calling thread, one after the other.
+ *
+ * Frame threading in libavcodec is not affected.
+ */
+
+typedef struct AVThreadPool AVThreadPool;
+
+/**
+ * Allocate a thread pool.
+ *
+ * @param pool       the pool is returned here, NULL on failure
+ * @param nb_threads number of pool threads, 0 for one per logical CPU
+ * @return the number of pool threads on success, a negative AVERROR code on
+ *         failure, in particular AVERROR(ENOSYS) if lavu was built without
+ *         thread support
+ */
+int av_thread_pool_alloc(AVThreadPool **pool, int nb_threads);
+
+/**
+ * Release a thread pool allocated with av_thread_pool_alloc() and set
+ * the pointer to it to NULL.
+ *
+ * Contexts already using the pool keep doing so, its threads exit once the
+ * last of them is freed.
+ */
+void av_thread_pool_free(AVThreadPool **pool);
+
+/**
+ * Set up the process-wide thread pool.
+ *
+ * @param nb_threads number of pool threads, 0 for one per logical CPU
+ * @return the number of pool threads on success, AVERROR(EEXIST) if a pool
+ *         is already set up, another negative AVERROR code on failure, in
+ *         particular AVERROR(ENOSYS) if lavu was built without thread support
+ */
+int av_thread_pool_init(int nb_threads);
+
+/**
+ * Release the process-wide thread pool.
+ *
+ * Contexts already using the pool keep doing so, its threads exit once the
+ * last of them is freed. Contexts created afterwards spawn their own threads
+ * again, unless a new pool is set up.
+ */
+void av_thread_pool_uninit(void);
+
+#endif /* AVUTIL_THREADPOOL_H */
@@ -160,6 +160,8 @@ int ff_get_cpu_flags_x86(void)
         }
 #endif /* HAVE_AVX512 */
 #endif /* HAVE_AVX2 */
+        if (ebx & 0x20000000)
+            rval |= AV_CPU_FLAG_SHANI;
         /* BMI1/2 don't need OS support */
         if (ebx & 0x00000008) {
             rval |= AV_CPU_FLAG_BMI1;
@@ -268,6 +270,7 @@ size_t ff_get_cpu_max_align_x86(void)
                  AV_CPU_FLAG_AVXSLOW))
         return 32;
     if (flags & (AV_CPU_FLAG_AESNI     |
+                 AV_CPU_FLAG_SHANI     |
                  AV_CPU_FLAG_SSE42     |
                  AV_CPU_FLAG_SSE4      |
                  AV_CPU_FLAG_SSSE3     |
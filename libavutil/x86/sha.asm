@@ -0,0 +1,282 @@
+;******************************************************************************
+;* SHA-1 and SHA-256 block transforms using the Intel SHA extensions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+sha1_shuf:   db 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0
+sha256_shuf: db  3,  2,  1,  0,  7,  6,  5,  4, 11, 10,  9,  8, 15, 14, 13, 12
+
+k256: dd 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5
+      dd 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5
+      dd 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3
+      dd 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174
+      dd 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc
+      dd 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da
+      dd 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7
+      dd 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967
+      dd 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13
+      dd 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85
+      dd 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3
+      dd 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070
+      dd 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5
+      dd 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3
+      dd 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208
+      dd 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+
+SECTION .text
+
+; The SHA instructions have no cpuflag of their own in x86inc, so the
+; functions are built as SSE4 code and only the name suffix is overridden.
+%if ARCH_X86_64 && HAVE_SHANI_EXTERNAL
+INIT_XMM sse4
+%xdefine SUFFIX _shani
+
+;------------------------------------------------------------------------------
+; void ff_sha1_transform_shani(uint32_t *state, const uint8_t buffer[64]);
+;------------------------------------------------------------------------------
+
+; m0: ABCD, m1/m2: E (alternating), m3-m6: message, m7: shuffle mask,
+; m8/m9: state saved for the final addition
+cglobal sha1_transform, 2, 2, 10, state, data
+    movu            m0, [stateq]
+    movd            m1, [stateq+16]
+    pshufd          m0, m0, q0123
+    pslldq          m1, 12
+    mova            m7, [sha1_shuf]
+    mova            m8, m0
+    mova            m9, m1
+
+    ; rounds 0-3
+    movu           m3, [dataq+0]
+    pshufb         m3, m7
+    paddd          m1, m3
+    mova           m2, m0
+    sha1rnds4      m0, m1, 0
+    ; rounds 4-7
+    movu           m4, [dataq+16]
+    pshufb         m4, m7
+    sha1nexte      m2, m4
+    mova           m1, m0
+    sha1rnds4      m0, m2, 0
+    sha1msg1       m3, m4
+    ; rounds 8-11
+    movu           m5, [dataq+32]
+    pshufb         m5, m7
+    sha1nexte      m1, m5
+    mova           m2, m0
+    sha1rnds4      m0, m1, 0
+    sha1msg1       m4, m5
+    pxor           m3, m5
+    ; rounds 12-15
+    movu           m6, [dataq+48]
+    pshufb         m6, m7
+    sha1nexte      m2, m6
+    mova           m1, m0
+    sha1msg2       m3, m6
+    sha1rnds4      m0, m2, 0
+    sha1msg1       m5, m6
+    pxor           m4, m6
+    ; rounds 16-19
+    sha1nexte      m1, m3
+    mova           m2, m0
+    sha1msg2       m4, m3
+    sha1rnds4      m0, m1, 0
+    sha1msg1       m6, m3
+    pxor           m5, m3
+    ; rounds 20-23
+    sha1nexte      m2, m4
+    mova           m1, m0
+    sha1msg2       m5, m4
+    sha1rnds4      m0, m2, 1
+    sha1msg1       m3, m4
+    pxor           m6, m4
+    ; rounds 24-27
+    sha1nexte      m1, m5
+    mova           m2, m0
+    sha1msg2       m6, m5
+    sha1rnds4      m0, m1, 1
+    sha1msg1       m4, m5
+    pxor           m3, m5
+    ; rounds 28-31
+    sha1nexte      m2, m6
+    mova           m1, m0
+    sha1msg2       m3, m6
+    sha1rnds4      m0, m2, 1
+    sha1msg1       m5, m6
+    pxor           m4, m6
+    ; rounds 32-35
+    sha1nexte      m1, m3
+    mova           m2, m0
+    sha1msg2       m4, m3
+    sha1rnds4      m0, m1, 1
+    sha1msg1       m6, m3
+    pxor           m5, m3
+    ; rounds 36-39
+    sha1nexte      m2, m4
+    mova           m1, m0
+    sha1msg2       m5, m4
+    sha1rnds4      m0, m2, 1
+    sha1msg1       m3, m4
+    pxor           m6, m4
+    ; rounds 40-43
+    sha1nexte      m1, m5
+    mova           m2, m0
+    sha1msg2       m6, m5
+    sha1rnds4      m0, m1, 2
+    sha1msg1       m4, m5
+    pxor           m3, m5
+    ; rounds 44-47
+    sha1nexte      m2, m6
+    mova           m1, m0
+    sha1msg2       m3, m6
+    sha1rnds4      m0, m2, 2
+    sha1msg1       m5, m6
+    pxor           m4, m6
+    ; rounds 48-51
+    sha1nexte      m1, m3
+    mova           m2, m0
+    sha1msg2       m4, m3
+    sha1rnds4      m0, m1, 2
+    sha1msg1       m6, m3
+    pxor           m5, m3
+    ; rounds 52-55
+    sha1nexte      m2, m4
+    mova           m1, m0
+    sha1msg2       m5, m4
+    sha1rnds4      m0, m2, 2
+    sha1msg1       m3, m4
+    pxor           m6, m4
+    ; rounds 56-59
+    sha1nexte      m1, m5
+    mova           m2, m0
+    sha1msg2       m6, m5
+    sha1rnds4      m0, m1, 2
+    sha1msg1       m4, m5
+    pxor           m3, m5
+    ; rounds 60-63
+    sha1nexte      m2, m6
+    mova           m1, m0
+    sha1msg2       m3, m6
+    sha1rnds4      m0, m2, 3
+    sha1msg1       m5, m6
+    pxor           m4, m6
+    ; rounds 64-67
+    sha1nexte      m1, m3
+    mova           m2, m0
+    sha1msg2       m4, m3
+    sha1rnds4      m0, m1, 3
+    sha1msg1       m6, m3
+    pxor           m5, m3
+    ; rounds 68-71
+    sha1nexte      m2, m4
+    mova           m1, m0
+    sha1msg2       m5, m4
+    sha1rnds4      m0, m2, 3
+    pxor           m6, m4
+    ; rounds 72-75
+    sha1nexte      m1, m5
+    mova           m2, m0
+    sha1msg2       m6, m5
+    sha1rnds4      m0, m1, 3
+    ; rounds 76-79
+    sha1nexte      m2, m6
+    mova           m1, m0
+    sha1rnds4      m0, m2, 3
+
+    sha1nexte       m1, m9
+    paddd           m0, m8
+    pshufd          m0, m0, q0123
+    psrldq          m1, 12
+    movu      [stateq], m0
+    movd   [stateq+16], m1
+    RET
+
+;------------------------------------------------------------------------------
+; void ff_sha256_transform_shani(uint32_t *state, const uint8_t buffer[64]);
+;------------------------------------------------------------------------------
+
+; Four rounds i..i+3, with m%2 holding the message words of these rounds and
+; m%3-m%5 the following ones, which are updated for the rounds i+16..i+19.
+; sha256rnds2 implicitly takes the message + constant words from xmm0 (m0).
+%macro SHA256_4ROUNDS 5 ; i, msg0, msg1, msg2, msg3
+%if %1 < 16
+    movu           m%2, [dataq+%1*4]
+    pshufb         m%2, m8
+%endif
+    mova            m0, [k256+%1*4]
+    paddd           m0, m%2
+    sha256rnds2     m2, m1
+%if %1 >= 12 && %1 < 60
+    mova            m7, m%2
+    palignr         m7, m%5, 4
+    paddd          m%3, m7
+    sha256msg2     m%3, m%2
+%endif
+    punpckhqdq      m0, m0
+    sha256rnds2     m1, m2
+%if %1 >= 4 && %1 < 52
+    sha256msg1     m%5, m%2
+%endif
+%endmacro
+
+; m1: ABEF, m2: CDGH, m3-m6: message, m7: temporary, m8: shuffle mask,
+; m9/m10: state saved for the final addition
+cglobal sha256_transform, 2, 2, 11, state, data
+    movu            m1, [stateq]
+    movu            m2, [stateq+16]
+    pshufd          m1, m1, q2301 ; CDAB
+    pshufd          m2, m2, q0123 ; EFGH
+    mova            m7, m1
+    palignr         m1, m2, 8     ; ABEF
+    pblendw         m2, m7, 0xF0  ; CDGH
+    mova            m8, [sha256_shuf]
+    mova            m9, m1
+    mova           m10, m2
+
+    SHA256_4ROUNDS  0, 3, 4, 5, 6
+    SHA256_4ROUNDS  4, 4, 5, 6, 3
+    SHA256_4ROUNDS  8, 5, 6, 3, 4
+    SHA256_4ROUNDS 12, 6, 3, 4, 5
+    SHA256_4ROUNDS 16, 3, 4, 5, 6
+    SHA256_4ROUNDS 20, 4, 5, 6, 3
+    SHA256_4ROUNDS 24, 5, 6, 3, 4
+    SHA256_4ROUNDS 28, 6, 3, 4, 5
+    SHA256_4ROUNDS 32, 3, 4, 5, 6
+    SHA256_4ROUNDS 36, 4, 5, 6, 3
+    SHA256_4ROUNDS 40, 5, 6, 3, 4
+    SHA256_4ROUNDS 44, 6, 3, 4, 5
+    SHA256_4ROUNDS 48, 3, 4, 5, 6
+    SHA256_4ROUNDS 52, 4, 5, 6, 3
+    SHA256_4ROUNDS 56, 5, 6, 3, 4
+    SHA256_4ROUNDS 60, 6, 3, 4, 5
+
+    paddd           m1, m9
+    paddd           m2, m10
+    pshufd          m1, m1, q0123 ; FEBA
+    pshufd          m2, m2, q2301 ; DCHG
+    mova            m7, m1
+    pblendw         m1, m2, 0xF0  ; DCBA
+    palignr         m2, m7, 8     ; HGFE
+    movu      [stateq], m1
+    movu   [stateq+16], m2
+    RET
+%endif ; ARCH_X86_64 && HAVE_SHANI_EXTERNAL
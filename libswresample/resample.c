@@ -241,7 +241,8 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
         c->linear        = linear;
         c->factor        = factor;
         c->filter_length = filter_length;
-        c->filter_alloc  = FFALIGN(c->filter_length, 8);
+        /* keep a whole number of 32-byte vectors per phase for the SIMD code */
+        c->filter_alloc  = FFALIGN(c->filter_length, FFMAX(8, 32 / c->felem_size));
         c->filter_bank   = av_calloc(c->filter_alloc, (phase_count+1)*c->felem_size);
         c->filter_type   = filter_type;
         c->kaiser_beta   = kaiser_beta;
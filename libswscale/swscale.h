@@ -163,6 +163,19 @@ struct SwsContext *sws_alloc_context(void);
 av_warn_unused_result
 int sws_init_context(struct SwsContext *sws_context, SwsFilter *srcFilter, SwsFilter *dstFilter);
 
+struct AVThreadPool;
+
+/**
+ * Set the thread pool to run the slice threads of the context on, see
+ * av_thread_pool_alloc(). Must be called before sws_init_context(). By
+ * default, the process-wide pool set up with av_thread_pool_init() is used
+ * if there is one, otherwise the context spawns threads of its own. The
+ * "threads" option then limits how many pool threads may work on the
+ * context at the same time. The pool is kept alive as long as the context
+ * uses it.
+ */
+void sws_set_thread_pool(struct SwsContext *sws_context, struct AVThreadPool *pool);
+
 /**
  * Free the swscaler context swsContext.
  * If swsContext is NULL, then does nothing.
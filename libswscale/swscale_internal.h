@@ -684,6 +684,8 @@ typedef struct SwsContext {
     atomic_int   data_unaligned_warned;
 
     Half2FloatTables *h2f_tables;
+
+    AVThreadPool *thread_pool;    ///< Thread pool to run the slice threads on, may be NULL
 } SwsContext;
 //FIXME check init (where 0)
 
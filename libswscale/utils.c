@@ -1226,6 +1226,11 @@ SwsContext *sws_alloc_context(void)
     return c;
 }
 
+void sws_set_thread_pool(SwsContext *c, AVThreadPool *pool)
+{
+    c->thread_pool = pool;
+}
+
 static uint16_t * alloc_gamma_tbl(double e)
 {
     int i = 0;
@@ -2022,8 +2027,9 @@ static int context_init_threaded(SwsContext *c,
 {
     int ret;
 
-    ret = avpriv_slicethread_create(&c->slicethread, (void*)c,
-                                    ff_sws_slice_worker, NULL, c->nb_threads);
+    ret = avpriv_slicethread_create_pool(&c->slicethread, (void*)c,
+                                         ff_sws_slice_worker, NULL, c->nb_threads,
+                                         c->thread_pool);
     if (ret == AVERROR(ENOSYS)) {
         c->nb_threads = 1;
         return 0;
@@ -0,0 +1,94 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include "config.h"
+
+#include <float.h>
+#include <stdint.h>
+
+#include "libavfilter/af_amixdsp.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem_internal.h"
+#include "checkasm.h"
+
+#define LEN    256
+#define NB_SRC 6
+
+#define randomize_buffer(buf, size)           \
+do {                                          \
+    int i;                                    \
+    double bmg[2], stddev = 1.0, mean = 0.0;  \
+                                              \
+    for (i = 0; i < size; i += 2) {           \
+        av_bmg_get(&checkasm_lfg, bmg);       \
+        buf[i]     = bmg[0] * stddev + mean;  \
+        buf[i + 1] = bmg[1] * stddev + mean;  \
+    }                                         \
+} while(0);
+
+#define TEST_MIX(type, near, func, name)                                        \
+do {                                                                            \
+    LOCAL_ALIGNED_32(type, src, [NB_SRC * LEN]);                                \
+    LOCAL_ALIGNED_32(type, cdst, [LEN]);                                        \
+    LOCAL_ALIGNED_32(type, odst, [LEN]);                                        \
+    const type *srcp[NB_SRC];                                                   \
+    type scale[NB_SRC];                                                         \
+                                                                                \
+    declare_func(void, type *dst, const type *const *src, const type *scale,    \
+                 int nb_src, ptrdiff_t len);                                    \
+                                                                                \
+    for (int k = 0; k < NB_SRC; k++) {                                          \
+        srcp[k] = src + k * LEN;                                                \
+        randomize_buffer((src + k * LEN), LEN);                                 \
+    }                                                                           \
+    randomize_buffer(scale, NB_SRC);                                            \
+                                                                                \
+    if (check_func(func, name)) {                                               \
+        for (int nb_src = 1; nb_src <= NB_SRC; nb_src++) {                      \
+            for (int len = 16; len <= LEN; len += 16 * 5) {                     \
+                memset(cdst, 0, LEN * sizeof(type));                            \
+                memset(odst, 0, LEN * sizeof(type));                            \
+                call_ref(cdst, srcp, scale, nb_src, len);                       \
+                call_new(odst, srcp, scale, nb_src, len);                       \
+                for (int n = 0; n < LEN; n++) {                                 \
+                    double t = fabs(cdst[n]) + 1.0;                             \
+                                                                                \
+                    for (int k = 0; k < nb_src; k++)                            \
+                        t += fabs(srcp[k][n] * scale[k]);                      \
+                    if (!near(cdst[n], odst[n], t * nb_src * FLT_EPSILON)) {    \
+                        fprintf(stderr, "%d/%d/%d: %- .12f - %- .12f = % .12g\n", \
+                                nb_src, len, n, cdst[n], odst[n],               \
+                                cdst[n] - odst[n]);                             \
+                        fail();                                                 \
+                        break;                                                  \
+                    }                                                           \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+        bench_new(odst, srcp, scale, NB_SRC, LEN);                              \
+    }                                                                           \
+    report(name);                                                               \
+} while (0)
+
+void checkasm_check_amix(void)
+{
+    AudioMixDSPContext dsp = { 0 };
+
+    ff_amix_init(&dsp);
+    TEST_MIX(float,  float_near_abs_eps,  dsp.mix_fl,  "mix_fl");
+    TEST_MIX(double, double_near_abs_eps, dsp.mix_dbl, "mix_dbl");
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/dpxdsp.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 1024
+
+static void check_unpack_rgb10(const DPXDSPContext *c)
+{
+    LOCAL_ALIGNED_32(uint8_t,  src,     [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint16_t, dst_ref, [WIDTH * 3]);
+    LOCAL_ALIGNED_32(uint16_t, dst_new, [WIDTH * 3]);
+    static const int shifts[] = { 22, 20 };
+
+    declare_func(void, uint16_t *dst0, uint16_t *dst1, uint16_t *dst2,
+                 const uint8_t *src, int width, int shift);
+
+    for (int endian = 0; endian < 2; endian++) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(shifts); i++) {
+            if (check_func(c->unpack_rgb10[endian], "dpx_unpack_rgb10_%s_%d",
+                           endian ? "be" : "le", shifts[i])) {
+                for (int x = 0; x < WIDTH * 4; x += 4)
+                    AV_WN32A(src + x, rnd());
+                for (int width = 0; width <= WIDTH; width += 8 * (1 + rnd() % 31)) {
+                    memset(dst_ref, 0, WIDTH * 3 * sizeof(*dst_ref));
+                    memset(dst_new, 0, WIDTH * 3 * sizeof(*dst_new));
+                    call_ref(dst_ref, dst_ref + WIDTH, dst_ref + 2 * WIDTH, src, width, shifts[i]);
+                    call_new(dst_new, dst_new + WIDTH, dst_new + 2 * WIDTH, src, width, shifts[i]);
+                    if (memcmp(dst_ref, dst_new, WIDTH * 3 * sizeof(*dst_ref)))
+                        fail();
+                }
+                bench_new(dst_new, dst_new + WIDTH, dst_new + 2 * WIDTH, src, WIDTH, shifts[i]);
+            }
+        }
+    }
+}
+
+void checkasm_check_dpxdsp(void)
+{
+    DPXDSPContext c;
+
+    ff_dpxdsp_init(&c);
+
+    check_unpack_rgb10(&c);
+    report("unpack_rgb10");
+}
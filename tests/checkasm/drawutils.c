@@ -0,0 +1,71 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/drawutils.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 256
+
+static void check_blend_row8(void)
+{
+    static const int widths[] = { 1, 7, 16, 37, WIDTH };
+    LOCAL_ALIGNED_32(uint8_t, mask,     [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, dst_ref,  [WIDTH + 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new,  [WIDTH + 8]);
+    FFDrawContext draw;
+
+    declare_func(void, uint8_t *dst, const uint8_t *mask, int w,
+                 unsigned src, unsigned alpha);
+
+    if (ff_draw_init(&draw, AV_PIX_FMT_GRAY8, 0) < 0)
+        return;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+        const int w = widths[i];
+
+        if (check_func(draw.blend_row8, "blend_row8_%d", w)) {
+            /* full coverage and opaque color are the boundary cases */
+            const unsigned a8    = i & 1 ? 255 : rnd() & 0xff;
+            const unsigned alpha = (0x10307 * a8 + 0x3) >> 8;
+            const unsigned src   = rnd() & 0xff;
+
+            for (int x = 0; x < WIDTH; x++)
+                mask[x] = i & 2 ? 255 : rnd();
+            for (int x = 0; x < WIDTH + 8; x += 4)
+                AV_WN32A(dst_ref + x, rnd());
+            memcpy(dst_new, dst_ref, WIDTH + 8);
+
+            call_ref(dst_ref, mask, w, src, alpha);
+            call_new(dst_new, mask, w, src, alpha);
+            if (memcmp(dst_ref, dst_new, WIDTH + 8))
+                fail();
+
+            bench_new(dst_new, mask, w, src, alpha);
+        }
+    }
+
+    report("blend_row8");
+}
+
+void checkasm_check_drawutils(void)
+{
+    check_blend_row8();
+}
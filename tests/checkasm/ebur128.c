@@ -0,0 +1,113 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/ebur128.h"
+#include "libavutil/mem_internal.h"
+
+#define FRAMES   480
+#define CHANNELS 3
+#define HISTORY  24
+
+#define randomize_buffer(buf, size)                       \
+    do {                                                  \
+        for (int i = 0; i < size; i++)                    \
+            buf[i] = (int)(rnd() % 2001 - 1000) / 1000.0; \
+    } while (0)
+
+static void check_filter_2ch(const FFEBUR128DSPContext *dsp)
+{
+    /* two stable biquads in series, (1 - 0.9 z^-1)^2 (1 - 0.5 z^-1)^2 */
+    static const double a[5] = { 1.0, -2.8, 2.86, -1.26, 0.2025 };
+    LOCAL_ALIGNED_16(double, coeffs,    [18]);
+    LOCAL_ALIGNED_16(double, state_ref, [8]);
+    LOCAL_ALIGNED_16(double, state_new, [8]);
+    LOCAL_ALIGNED_16(double, src,       [FRAMES * CHANNELS]);
+    LOCAL_ALIGNED_16(double, dst_ref,   [FRAMES * CHANNELS]);
+    LOCAL_ALIGNED_16(double, dst_new,   [FRAMES * CHANNELS]);
+
+    declare_func(void, double *dst, const double *src,
+                 ptrdiff_t dst_stride, ptrdiff_t src_stride,
+                 int frames, const double *coeffs, double *state);
+
+    for (int i = 0; i < 5; i++)
+        coeffs[2 * i] = coeffs[2 * i + 1] = (int)(rnd() % 2001 - 1000) / 1000.0;
+    for (int i = 1; i < 5; i++)
+        coeffs[8 + 2 * i] = coeffs[8 + 2 * i + 1] = a[i];
+
+    if (check_func(dsp->filter_2ch, "ebur128_filter_2ch")) {
+        randomize_buffer(src, FRAMES * CHANNELS);
+        randomize_buffer(state_ref, 8);
+        memcpy(state_new, state_ref, 8 * sizeof(*state_ref));
+        randomize_buffer(dst_ref, FRAMES * CHANNELS);
+        memcpy(dst_new, dst_ref, FRAMES * CHANNELS * sizeof(*dst_ref));
+
+        call_ref(dst_ref + 1, src + 1, CHANNELS, CHANNELS, FRAMES, coeffs, state_ref);
+        call_new(dst_new + 1, src + 1, CHANNELS, CHANNELS, FRAMES, coeffs, state_new);
+        if (memcmp(dst_ref, dst_new, FRAMES * CHANNELS * sizeof(*dst_ref)) ||
+            memcmp(state_ref, state_new, 8 * sizeof(*state_ref)))
+            fail();
+
+        bench_new(dst_new + 1, src + 1, CHANNELS, CHANNELS, FRAMES, coeffs, state_new);
+    }
+
+    report("filter_2ch");
+}
+
+static void check_true_peak(const FFEBUR128DSPContext *dsp)
+{
+    static const struct {
+        int ntaps, nb_phases;
+    } phases[] = { { 13, 3 }, { 25, 1 } };
+    LOCAL_ALIGNED_16(double, src,    [HISTORY + FRAMES]);
+    LOCAL_ALIGNED_16(double, coeffs, [HISTORY * 2]);
+
+    declare_func(double, const double *src, const double *coeffs,
+                 int ntaps, int nb_phases, int len);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(phases); i++) {
+        const int ntaps     = phases[i].ntaps;
+        const int nb_phases = phases[i].nb_phases;
+
+        if (check_func(dsp->true_peak, "ebur128_true_peak_%dx", nb_phases + 1)) {
+            double peak_ref, peak_new;
+
+            randomize_buffer(src, HISTORY + FRAMES);
+            randomize_buffer(coeffs, ntaps * nb_phases);
+
+            peak_ref = call_ref(src + HISTORY, coeffs, ntaps, nb_phases, FRAMES);
+            peak_new = call_new(src + HISTORY, coeffs, ntaps, nb_phases, FRAMES);
+            if (peak_ref != peak_new)
+                fail();
+
+            bench_new(src + HISTORY, coeffs, ntaps, nb_phases, FRAMES);
+        }
+    }
+
+    report("true_peak");
+}
+
+void checkasm_check_ebur128(void)
+{
+    FFEBUR128DSPContext dsp;
+
+    ff_ebur128_dsp_init(&dsp);
+    check_filter_2ch(&dsp);
+    check_true_peak(&dsp);
+}
@@ -0,0 +1,127 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/h274.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 1920
+
+#define randomize_buffers(buf, size)            \
+    do {                                        \
+        for (int j = 0; j < size; j++)          \
+            buf[j] = rnd();                     \
+    } while (0)
+
+static void check_avg_8x8(const H274FilmGrainDSPContext *c)
+{
+    LOCAL_ALIGNED_16(uint8_t, src, [8 * 32]);
+    declare_func(uint16_t, const uint8_t *in, ptrdiff_t in_stride);
+
+    if (check_func(c->avg_8x8, "h274_avg_8x8")) {
+        for (int i = 0; i < 4; i++) {
+            uint16_t ref, new;
+
+            if (i == 3)
+                memset(src, 0xFF, 8 * 32);
+            else
+                randomize_buffers(src, 8 * 32);
+            ref = call_ref(src, 32);
+            new = call_new(src, 32);
+            if (ref != new)
+                fail();
+        }
+        bench_new(src, 32);
+    }
+    report("avg_8x8");
+}
+
+static void check_synth_grain_8x8(const H274FilmGrainDSPContext *c)
+{
+    LOCAL_ALIGNED_16(int8_t, db, [64 * 64]);
+    LOCAL_ALIGNED_16(int8_t, dst0, [8 * 16]);
+    LOCAL_ALIGNED_16(int8_t, dst1, [8 * 16]);
+    declare_func(void, int8_t *out, ptrdiff_t out_stride,
+                 int scale, int shift, const int8_t *db);
+
+    randomize_buffers(db, 64 * 64);
+
+    if (check_func(c->synth_grain_8x8, "h274_synth_grain_8x8")) {
+        for (int i = 0; i < 8; i++) {
+            const int scale = (int16_t) rnd();
+            const int shift = 6 + (rnd() & 15);
+            const int x = (rnd() % 52) & ~3, y = (rnd() % 56) & ~7;
+            memset(dst0, 0, 8 * 16);
+            memset(dst1, 0, 8 * 16);
+            call_ref(dst0, 16, scale, shift, &db[y * 64 + x]);
+            call_new(dst1, 16, scale, shift, &db[y * 64 + x]);
+            if (memcmp(dst0, dst1, 8 * 16))
+                fail();
+        }
+        bench_new(dst1, 16, 255, 6, db);
+    }
+    report("synth_grain_8x8");
+}
+
+static void check_blend_row(const H274FilmGrainDSPContext *c)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(int8_t, grain, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [BUF_SIZE]);
+    declare_func(void, uint8_t *out, const uint8_t *in, const int8_t *grain,
+                 ptrdiff_t n);
+
+    randomize_buffers(src, BUF_SIZE);
+    randomize_buffers(grain, BUF_SIZE);
+
+    if (check_func(c->blend_row, "h274_blend_row")) {
+        for (int n = 32; n <= BUF_SIZE; n += 32 * 15) {
+            memset(dst0, 0, BUF_SIZE);
+            memset(dst1, 0, BUF_SIZE);
+            call_ref(dst0, src, grain, n);
+            call_new(dst1, src, grain, n);
+            if (memcmp(dst0, dst1, BUF_SIZE))
+                fail();
+        }
+        /* in-place operation, as done by the decoders */
+        memcpy(dst0, grain, BUF_SIZE);
+        memcpy(dst1, grain, BUF_SIZE);
+        call_ref(dst0, src, (int8_t *) dst0, BUF_SIZE);
+        call_new(dst1, src, (int8_t *) dst1, BUF_SIZE);
+        if (memcmp(dst0, dst1, BUF_SIZE))
+            fail();
+        bench_new(dst1, src, grain, BUF_SIZE);
+    }
+    report("blend_row");
+}
+
+void checkasm_check_h274dsp(void)
+{
+    H274FilmGrainDSPContext c;
+
+    ff_h274_film_grain_dsp_init(&c);
+
+    check_avg_8x8(&c);
+    check_synth_grain_8x8(&c);
+    check_blend_row(&c);
+}
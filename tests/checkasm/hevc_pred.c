@@ -0,0 +1,162 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/hevcdec.h"
+#include "libavcodec/hevcpred.h"
+
+#include "checkasm.h"
+
+static const uint32_t pixel_mask[] = {
+    0xffffffff, 0x01ff01ff, 0x03ff03ff, 0x07ff07ff, 0x0fff0fff
+};
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define STRIDE       (MAX_TB_SIZE + 16) // in pixels
+#define BUF_SIZE     (STRIDE * MAX_TB_SIZE * 2)
+#define REF_SIZE     (4 * MAX_TB_SIZE * 2)
+
+#define randomize_buffers(buf0, buf1, size)                 \
+    do {                                                    \
+        uint32_t mask = pixel_mask[bit_depth - 8];          \
+        int k;                                              \
+        for (k = 0; k < size; k += 4) {                     \
+            uint32_t r = rnd() & mask;                      \
+            AV_WN32A(buf0 + k, r);                          \
+            AV_WN32A(buf1 + k, r);                          \
+        }                                                   \
+    } while (0)
+
+static void randomize_ref(uint8_t *buf, int bit_depth)
+{
+    uint32_t mask = pixel_mask[bit_depth - 8];
+
+    for (int k = 0; k < REF_SIZE; k += 4)
+        AV_WN32A(buf + k, rnd() & mask);
+}
+
+static void check_pred_planar(const HEVCPredContext *h,
+                              uint8_t *dst0, uint8_t *dst1,
+                              const uint8_t *top, const uint8_t *left,
+                              int bit_depth)
+{
+    declare_func(void, uint8_t *src, const uint8_t *top,
+                 const uint8_t *left, ptrdiff_t stride);
+
+    for (int i = 0; i < 4; i++) {
+        int size = 4 << i;
+        if (check_func(h->pred_planar[i], "hevc_pred_planar_%dx%d_%d",
+                       size, size, bit_depth)) {
+            randomize_buffers(dst0, dst1, BUF_SIZE);
+            call_ref(dst0, top, left, STRIDE);
+            call_new(dst1, top, left, STRIDE);
+            if (memcmp(dst0, dst1, BUF_SIZE))
+                fail();
+            bench_new(dst1, top, left, STRIDE);
+        }
+    }
+}
+
+static void check_pred_dc(const HEVCPredContext *h,
+                          uint8_t *dst0, uint8_t *dst1,
+                          const uint8_t *top, const uint8_t *left,
+                          int bit_depth)
+{
+    declare_func(void, uint8_t *src, const uint8_t *top, const uint8_t *left,
+                 ptrdiff_t stride, int log2_size, int c_idx);
+
+    for (int log2_size = 2; log2_size <= 5; log2_size++) {
+        int size = 1 << log2_size;
+        if (check_func(h->pred_dc, "hevc_pred_dc_%dx%d_%d",
+                       size, size, bit_depth)) {
+            for (int c_idx = 0; c_idx < 2; c_idx++) {
+                randomize_buffers(dst0, dst1, BUF_SIZE);
+                call_ref(dst0, top, left, STRIDE, log2_size, c_idx);
+                call_new(dst1, top, left, STRIDE, log2_size, c_idx);
+                if (memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(dst1, top, left, STRIDE, log2_size, 0);
+        }
+    }
+}
+
+static void check_pred_angular(const HEVCPredContext *h,
+                               uint8_t *dst0, uint8_t *dst1,
+                               const uint8_t *top, const uint8_t *left,
+                               int bit_depth)
+{
+    declare_func(void, uint8_t *src, const uint8_t *top, const uint8_t *left,
+                 ptrdiff_t stride, int c_idx, int mode);
+
+    for (int i = 0; i < 4; i++) {
+        int size = 4 << i;
+        if (check_func(h->pred_angular[i], "hevc_pred_angular_%dx%d_%d",
+                       size, size, bit_depth)) {
+            for (int mode = 2; mode <= 34; mode++) {
+                for (int c_idx = 0; c_idx < 2; c_idx++) {
+                    randomize_buffers(dst0, dst1, BUF_SIZE);
+                    call_ref(dst0, top, left, STRIDE, c_idx, mode);
+                    call_new(dst1, top, left, STRIDE, c_idx, mode);
+                    if (memcmp(dst0, dst1, BUF_SIZE)) {
+                        fail();
+                        break;
+                    }
+                }
+            }
+            bench_new(dst1, top, left, STRIDE, 0, 22);
+        }
+    }
+}
+
+void checkasm_check_hevc_pred(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, dst0,     [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1,     [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, top_buf,  [REF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, left_buf, [REF_SIZE]);
+    static const int bit_depths[] = { 8, 9, 10, 12 };
+    static const char *const report_names[] = { "planar", "dc", "angular" };
+    HEVCPredContext h;
+
+    for (int t = 0; t < FF_ARRAY_ELEMS(report_names); t++) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(bit_depths); i++) {
+            int bit_depth = bit_depths[i];
+            /* top[-1] and left[-1] are the top-left sample */
+            const uint8_t *top  = top_buf  + 4 * SIZEOF_PIXEL;
+            const uint8_t *left = left_buf + 4 * SIZEOF_PIXEL;
+
+            randomize_ref(top_buf,  bit_depth);
+            randomize_ref(left_buf, bit_depth);
+            memcpy(left_buf + 3 * SIZEOF_PIXEL, top_buf + 3 * SIZEOF_PIXEL,
+                   SIZEOF_PIXEL);
+
+            ff_hevc_pred_init(&h, bit_depth);
+            switch (t) {
+            case 0: check_pred_planar (&h, dst0, dst1, top, left, bit_depth); break;
+            case 1: check_pred_dc     (&h, dst0, dst1, top, left, bit_depth); break;
+            case 2: check_pred_angular(&h, dst0, dst1, top, left, bit_depth); break;
+            }
+        }
+        report("%s", report_names[t]);
+    }
+}
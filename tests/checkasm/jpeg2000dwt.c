@@ -0,0 +1,131 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/jpeg2000dwt.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 512
+/* not a multiple of the vector size, to exercise the tail handling */
+#define WIDTH    (BUF_SIZE - 3)
+
+#define randomize_buffers(range)                        \
+    do {                                                \
+        int i;                                          \
+        for (i = 0; i < BUF_SIZE * 3; i++)              \
+            src[i] = (int32_t)(rnd() % (2 * range)) - range; \
+    } while (0)
+
+static void check_lift_int(void (*lift)(int32_t *dst, const int32_t *a,
+                                        const int32_t *b, int w, int rnd, int shift),
+                           int rnd_val, int shift)
+{
+    LOCAL_ALIGNED_32(int32_t, src, [BUF_SIZE * 3]);
+    LOCAL_ALIGNED_32(int32_t, ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(int32_t, new, [BUF_SIZE]);
+    const int32_t *a = src + BUF_SIZE, *b = src + BUF_SIZE * 2;
+
+    declare_func(void, int32_t *dst, const int32_t *a, const int32_t *b,
+                 int w, int rnd, int shift);
+
+    randomize_buffers(1 << 24);
+    memcpy(ref, src, BUF_SIZE * sizeof(*src));
+    memcpy(new, src, BUF_SIZE * sizeof(*src));
+    call_ref(ref, a, b, WIDTH, rnd_val, shift);
+    call_new(new, a, b, WIDTH, rnd_val, shift);
+    if (memcmp(ref, new, BUF_SIZE * sizeof(*ref)))
+        fail();
+    bench_new(new, a, b, BUF_SIZE, rnd_val, shift);
+}
+
+static void check_lift97_int(void (*lift)(int32_t *dst, const int32_t *a,
+                                          const int32_t *b, int w, int coef),
+                             int coef)
+{
+    LOCAL_ALIGNED_32(int32_t, src, [BUF_SIZE * 3]);
+    LOCAL_ALIGNED_32(int32_t, ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(int32_t, new, [BUF_SIZE]);
+    const int32_t *a = src + BUF_SIZE, *b = src + BUF_SIZE * 2;
+
+    declare_func(void, int32_t *dst, const int32_t *a, const int32_t *b,
+                 int w, int coef);
+
+    randomize_buffers(1 << 20);
+    memcpy(ref, src, BUF_SIZE * sizeof(*src));
+    memcpy(new, src, BUF_SIZE * sizeof(*src));
+    call_ref(ref, a, b, WIDTH, coef);
+    call_new(new, a, b, WIDTH, coef);
+    if (memcmp(ref, new, BUF_SIZE * sizeof(*ref)))
+        fail();
+    bench_new(new, a, b, BUF_SIZE, coef);
+}
+
+static void check_lift97_float(void (*lift)(float *dst, const float *a,
+                                            const float *b, int w, float coef),
+                               float coef)
+{
+    LOCAL_ALIGNED_32(float, src, [BUF_SIZE * 3]);
+    LOCAL_ALIGNED_32(float, ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, new, [BUF_SIZE]);
+    const float *a = src + BUF_SIZE, *b = src + BUF_SIZE * 2;
+    int i;
+
+    declare_func(void, float *dst, const float *a, const float *b,
+                 int w, float coef);
+
+    for (i = 0; i < BUF_SIZE * 3; i++)
+        src[i] = (float)rnd() / (UINT_MAX >> 12) - 2048.0f;
+    memcpy(ref, src, BUF_SIZE * sizeof(*src));
+    memcpy(new, src, BUF_SIZE * sizeof(*src));
+    call_ref(ref, a, b, WIDTH, coef);
+    call_new(new, a, b, WIDTH, coef);
+    if (!float_near_ulp_array(ref, new, 1, BUF_SIZE))
+        fail();
+    bench_new(new, a, b, BUF_SIZE, coef);
+}
+
+void checkasm_check_jpeg2000dwt(void)
+{
+    static const char *const op[2] = { "add", "sub" };
+    int border[2][2] = { { 0, BUF_SIZE }, { 0, 2 } };
+    DWTContext s = { 0 };
+    int i;
+
+    if (ff_jpeg2000_dwt_init(&s, border, 1, FF_DWT53) < 0)
+        return;
+
+    for (i = 0; i < 2; i++) {
+        if (check_func(s.lift_int[i], "jpeg2000_lift_int_%s", op[i]))
+            check_lift_int(s.lift_int[i], i ? 0 : 2, i ? 1 : 2);
+    }
+    report("lift_int");
+
+    for (i = 0; i < 2; i++) {
+        if (check_func(s.lift97_int[i], "jpeg2000_lift97_int_%s", op[i]))
+            check_lift97_int(s.lift97_int[i], i ? 103949 : 57862);
+    }
+    report("lift97_int");
+
+    if (check_func(s.lift97_float, "jpeg2000_lift97_float"))
+        check_lift97_float(s.lift97_float, -0.882911075530934f);
+    report("lift97_float");
+
+    ff_dwt_destroy(&s);
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/proresencdsp.h"
+#include "libavutil/mem_internal.h"
+
+#define NB_BLOCKS 32
+
+static void check_quantize(ProresEncDSPContext *c)
+{
+    LOCAL_ALIGNED_32(int16_t, blocks, [64 * NB_BLOCKS]);
+    LOCAL_ALIGNED_32(int16_t, levels_ref, [64 * NB_BLOCKS]);
+    LOCAL_ALIGNED_32(int16_t, levels_new, [64 * NB_BLOCKS]);
+    int16_t qmat[64];
+    int i, q, err_ref, err_new;
+
+    declare_func(int, int16_t *levels, const int16_t *blocks,
+                 const int16_t *qmat, int nb_blocks);
+
+    for (q = 1; q < 128; q = q * 2 + 1) {
+        for (i = 0; i < 64; i++)
+            qmat[i] = (4 + rnd() % 80) * q;
+        for (i = 0; i < 64 * NB_BLOCKS; i++)
+            blocks[i] = rnd();
+        blocks[0]  = INT16_MIN;
+        blocks[65] = INT16_MAX;
+
+        memset(levels_ref, 0, 64 * NB_BLOCKS * sizeof(*levels_ref));
+        memset(levels_new, 0, 64 * NB_BLOCKS * sizeof(*levels_new));
+        err_ref = call_ref(levels_ref, blocks, qmat, NB_BLOCKS);
+        err_new = call_new(levels_new, blocks, qmat, NB_BLOCKS);
+        if (err_ref != err_new ||
+            memcmp(levels_ref, levels_new, 64 * NB_BLOCKS * sizeof(*levels_ref)))
+            fail();
+    }
+    bench_new(levels_new, blocks, qmat, NB_BLOCKS);
+}
+
+void checkasm_check_proresencdsp(void)
+{
+    ProresEncDSPContext c;
+
+    ff_proresencdsp_init(&c);
+
+    if (check_func(c.quantize, "prores_quantize"))
+        check_quantize(&c);
+    report("quantize");
+}
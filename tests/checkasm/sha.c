@@ -0,0 +1,63 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/sha_internal.h"
+
+#define randomize_buffers()                     \
+    do {                                        \
+        for (int i = 0; i < 8; i++)             \
+            state[i] = rnd();                   \
+        for (int i = 0; i < 64; i += 4)         \
+            AV_WN32A(block + i, rnd());         \
+    } while (0)
+
+static void check_transform(int bits)
+{
+    LOCAL_ALIGNED_16(uint8_t, block, [64]);
+    uint32_t state[8], state_ref[8], state_new[8];
+    ff_sha_transform_fn transform;
+
+    declare_func(void, uint32_t *state, const uint8_t buffer[64]);
+
+    ff_sha_init_transform(&transform, bits);
+
+    if (check_func(transform, "sha%d_transform", bits)) {
+        for (int i = 0; i < 4; i++) {
+            randomize_buffers();
+            memcpy(state_ref, state, sizeof(state));
+            memcpy(state_new, state, sizeof(state));
+            call_ref(state_ref, block);
+            call_new(state_new, block);
+            if (memcmp(state_ref, state_new, sizeof(state)))
+                fail();
+        }
+        bench_new(state_new, block);
+    }
+}
+
+void checkasm_check_sha(void)
+{
+    check_transform(160);
+    check_transform(256);
+    report("transform");
+}
@@ -0,0 +1,156 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/samplefmt.h"
+
+#include "libswresample/resample.h"
+
+#include "checkasm.h"
+
+#define SRC_LEN 1024
+#define DST_LEN 256
+
+/* filter lengths are scaled up when downsampling: 36 and 66 for the
+ * 32 tap downsampling cases, 20 for the short upsampling one */
+static const struct {
+    int in_rate, out_rate, filter_size;
+} rates[] = {
+    { 44100, 48000, 32 },
+    { 48000, 96000, 32 },
+    { 44100, 48000, 20 },
+    { 48000, 44100, 32 },
+    { 96000, 48000, 32 },
+};
+
+static void randomize_src(uint8_t *buf, enum AVSampleFormat fmt, int full_scale)
+{
+    for (int i = 0; i < SRC_LEN; i++) {
+        /* full scale noise makes the filter overshoot, so the integer
+         * versions have to saturate */
+        const int neg = rnd() & 1;
+
+        switch (fmt) {
+        case AV_SAMPLE_FMT_S16P:
+            ((int16_t *)buf)[i] = !full_scale ? (int16_t)rnd() >> 1 :
+                                  neg ? INT16_MIN + (rnd() & 0xff) : INT16_MAX - (rnd() & 0xff);
+            break;
+        case AV_SAMPLE_FMT_S32P:
+            ((int32_t *)buf)[i] = !full_scale ? (int32_t)rnd() >> 1 :
+                                  neg ? INT32_MIN + (rnd() & 0xffff) : INT32_MAX - (rnd() & 0xffff);
+            break;
+        case AV_SAMPLE_FMT_FLTP:
+            ((float *)buf)[i] = (int32_t)rnd() / (float)INT32_MAX;
+            break;
+        case AV_SAMPLE_FMT_DBLP:
+            ((double *)buf)[i] = (int32_t)rnd() / (double)INT32_MAX;
+            break;
+        }
+    }
+}
+
+static int compare_dst(const uint8_t *dst0, const uint8_t *dst1, int n,
+                       enum AVSampleFormat fmt)
+{
+    switch (fmt) {
+    case AV_SAMPLE_FMT_FLTP:
+        return !float_near_abs_eps_array((const float *)dst0,
+                                         (const float *)dst1, 1e-5, n);
+    case AV_SAMPLE_FMT_DBLP:
+        return !double_near_abs_eps_array((const double *)dst0,
+                                          (const double *)dst1, 1e-12, n);
+    default:
+        return memcmp(dst0, dst1, n * av_get_bytes_per_sample(fmt));
+    }
+}
+
+static void check_resample(enum AVSampleFormat fmt, const char *name, int linear,
+                           int full_scale)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [SRC_LEN * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_LEN * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_LEN * 8]);
+
+    declare_func(int, ResampleContext *c, void *dst, const void *src,
+                 int n, int update_ctx);
+
+    for (int r = 0; r < FF_ARRAY_ELEMS(rates); r++) {
+        ResampleContext *c = swri_resampler.init(NULL, rates[r].out_rate,
+                                                 rates[r].in_rate, rates[r].filter_size, 10,
+                                                 linear, 0, fmt,
+                                                 SWR_FILTER_TYPE_KAISER,
+                                                 9, 20, 0, 1);
+        if (!c)
+            return;
+
+        if (check_func(linear ? c->dsp.resample_linear : c->dsp.resample_common,
+                       "resample_%s_%s%s_%d_%d_%d", linear ? "linear" : "common",
+                       name, full_scale ? "_fullscale" : "", rates[r].in_rate,
+                       rates[r].out_rate, c->filter_length)) {
+            int index = rnd() % c->phase_count;
+            int frac  = rnd() % c->src_incr;
+            int ret0, ret1, index0, frac0;
+
+            randomize_src(src, fmt, full_scale);
+            memset(dst0, 0, DST_LEN * 8);
+            memset(dst1, 0, DST_LEN * 8);
+
+            c->index = index;
+            c->frac  = frac;
+            ret0   = call_ref(c, dst0, src, DST_LEN, 1);
+            index0 = c->index;
+            frac0  = c->frac;
+            c->index = index;
+            c->frac  = frac;
+            ret1   = call_new(c, dst1, src, DST_LEN, 1);
+
+            if (ret0 != ret1 || index0 != c->index || frac0 != c->frac ||
+                compare_dst(dst0, dst1, DST_LEN, fmt))
+                fail();
+
+            bench_new(c, dst1, src, DST_LEN, 0);
+        }
+
+        swri_resampler.free(&c);
+    }
+}
+
+void checkasm_check_sw_resample(void)
+{
+    static const struct {
+        enum AVSampleFormat fmt;
+        const char *name;
+    } fmts[] = {
+        { AV_SAMPLE_FMT_S16P, "int16"  },
+        { AV_SAMPLE_FMT_S32P, "int32"  },
+        { AV_SAMPLE_FMT_FLTP, "float"  },
+        { AV_SAMPLE_FMT_DBLP, "double" },
+    };
+
+    for (int linear = 0; linear < 2; linear++) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(fmts); i++) {
+            check_resample(fmts[i].fmt, fmts[i].name, linear, 0);
+            if (fmts[i].fmt == AV_SAMPLE_FMT_S16P || fmts[i].fmt == AV_SAMPLE_FMT_S32P)
+                check_resample(fmts[i].fmt, fmts[i].name, linear, 1);
+        }
+        report(linear ? "resample_linear" : "resample_common");
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/texturedsp.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define STRIDE (4 * 4 * 2)
+
+static void fill_block(uint8_t *block, int type)
+{
+    int x, y;
+
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 4 * 4; x++) {
+            uint8_t *p = block + y * STRIDE + x;
+            switch (type) {
+            case 0: /* constant */
+                *p = x & 3 ? 0x5A : 0xC3;
+                break;
+            case 1: /* narrow range, exercises the small alpha bias */
+                *p = 100 + rnd() % 6;
+                break;
+            case 2: /* gradient */
+                *p = (x / 4 + y) * 40 + (x & 3) * 7;
+                break;
+            default:
+                *p = rnd();
+            }
+        }
+    }
+}
+
+static void check_block(int (*func)(uint8_t *, ptrdiff_t, const uint8_t *),
+                        const char *name, int out_size)
+{
+    LOCAL_ALIGNED_32(uint8_t, block, [4 * STRIDE]);
+    uint8_t dst_ref[16], dst_new[16];
+    int i, ret_ref, ret_new;
+
+    declare_func(int, uint8_t *dst, ptrdiff_t stride, const uint8_t *block);
+
+    if (check_func(func, "%s", name)) {
+        for (i = 0; i < 16; i++) {
+            fill_block(block, i);
+            memset(dst_ref, 0xAA, sizeof(dst_ref));
+            memset(dst_new, 0xAA, sizeof(dst_new));
+            ret_ref = call_ref(dst_ref, STRIDE, block);
+            ret_new = call_new(dst_new, STRIDE, block);
+            if (ret_ref != out_size || ret_ref != ret_new ||
+                memcmp(dst_ref, dst_new, sizeof(dst_ref)))
+                fail();
+        }
+        bench_new(dst_new, STRIDE, block);
+    }
+}
+
+void checkasm_check_texturedspenc(void)
+{
+    static const char *const modes[2] = { "high", "fast" };
+    TextureDSPEncContext c;
+    char name[32];
+    int fast;
+
+    for (fast = 0; fast < 2; fast++) {
+        ff_texturedspenc_init(&c, fast);
+
+        snprintf(name, sizeof(name), "dxt1_block_%s", modes[fast]);
+        check_block(c.dxt1_block, name, 8);
+        snprintf(name, sizeof(name), "dxt5_block_%s", modes[fast]);
+        check_block(c.dxt5_block, name, 16);
+        snprintf(name, sizeof(name), "dxt5ys_block_%s", modes[fast]);
+        check_block(c.dxt5ys_block, name, 16);
+    }
+    report("compress");
+}
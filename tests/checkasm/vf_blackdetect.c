@@ -0,0 +1,141 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/detectdsp.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 512
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        for (int j = 0; j < size; j++)          \
+            buf[j] = rnd() & mask;              \
+    } while (0)
+
+static void check_sum(const DetectDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [WIDTH + 32]);
+    const int mask = (1 << depth) - 1;
+    const int ps = (depth + 7) / 8;
+    const int step = depth == 8 ? 32 : 16;
+
+    declare_func(unsigned, const uint8_t *src, int len);
+
+    if (check_func(depth == 8 ? (void *)dsp->sum8 : (void *)dsp->sum16,
+                   "detect_sum%d", depth)) {
+        for (int len = step; len <= WIDTH; len += 3 * step) {
+            const uint8_t *p = (const uint8_t *)src + (rnd() % 16) * ps;
+            unsigned sum_ref, sum_new;
+
+            if (depth == 8)
+                randomize_buffers(((uint8_t *)src), 2 * (WIDTH + 32), mask);
+            else
+                randomize_buffers(src, WIDTH + 32, mask);
+
+            sum_ref = call_ref(p, len);
+            sum_new = call_new(p, len);
+            if (sum_ref != sum_new)
+                fail();
+        }
+        bench_new((const uint8_t *)src, WIDTH);
+    }
+}
+
+static void check_colsum(const DetectDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [WIDTH + 32]);
+    LOCAL_ALIGNED_32(uint32_t, acc_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint32_t, acc_new, [WIDTH]);
+    const int mask = (1 << depth) - 1;
+    const int ps = (depth + 7) / 8;
+    const int step = depth == 8 ? 32 : 16;
+
+    declare_func(void, uint32_t *acc, const uint8_t *src, int len);
+
+    if (check_func(depth == 8 ? (void *)dsp->colsum8 : (void *)dsp->colsum16,
+                   "detect_colsum%d", depth)) {
+        for (int len = step; len <= WIDTH; len += 3 * step) {
+            const uint8_t *p = (const uint8_t *)src + (rnd() % 16) * ps;
+
+            if (depth == 8)
+                randomize_buffers(((uint8_t *)src), 2 * (WIDTH + 32), mask);
+            else
+                randomize_buffers(src, WIDTH + 32, mask);
+            randomize_buffers(acc_ref, WIDTH, 0x7FFFFFFF);
+            memcpy(acc_new, acc_ref, sizeof(*acc_ref) * WIDTH);
+
+            call_ref(acc_ref, p, len);
+            call_new(acc_new, p, len);
+            if (memcmp(acc_ref, acc_new, sizeof(*acc_ref) * WIDTH))
+                fail();
+        }
+        bench_new(acc_new, (const uint8_t *)src, WIDTH);
+    }
+}
+
+static void check_count_le(const DetectDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [WIDTH + 32]);
+    const int mask = (1 << depth) - 1;
+    const int ps = (depth + 7) / 8;
+    const int step = depth == 8 ? 32 : 16;
+
+    declare_func(unsigned, const uint8_t *src, int len, unsigned threshold);
+
+    if (check_func(depth == 8 ? (void *)dsp->count_le8 : (void *)dsp->count_le16,
+                   "detect_count_le%d", depth)) {
+        for (int len = step; len <= WIDTH; len += 3 * step) {
+            const uint8_t *p = (const uint8_t *)src + (rnd() % 16) * ps;
+            const unsigned threshold = rnd() & mask;
+            unsigned count_ref, count_new;
+
+            if (depth == 8)
+                randomize_buffers(((uint8_t *)src), 2 * (WIDTH + 32), mask);
+            else
+                randomize_buffers(src, WIDTH + 32, mask);
+
+            count_ref = call_ref(p, len, threshold);
+            count_new = call_new(p, len, threshold);
+            if (count_ref != count_new)
+                fail();
+        }
+        bench_new((const uint8_t *)src, WIDTH, mask / 8);
+    }
+}
+
+void checkasm_check_vf_blackdetect(void)
+{
+    DetectDSPContext dsp;
+
+    ff_detectdsp_init(&dsp);
+
+    check_sum(&dsp, 8);
+    check_sum(&dsp, 16);
+    report("sum");
+
+    check_colsum(&dsp, 8);
+    check_colsum(&dsp, 16);
+    report("colsum");
+
+    check_count_le(&dsp, 8);
+    check_count_le(&dsp, 10);
+    check_count_le(&dsp, 16);
+    report("count_le");
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/boxblurdsp.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 256
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        for (int j = 0; j < size; j++)          \
+            buf[j] = rnd() & mask;              \
+    } while (0)
+
+static int random_inv(void)
+{
+    const int length = 2 * (1 + rnd() % 200) + 1;
+
+    return ((1 << 16) + length / 2) / length;
+}
+
+static void check_vstep(const BoxBlurDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, add, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, sub, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst_new, [WIDTH]);
+    LOCAL_ALIGNED_32(uint32_t, sums_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint32_t, sums_new, [WIDTH]);
+    const int mask = (1 << depth) - 1;
+
+    declare_func(void, uint8_t *dst, uint32_t *sums, const uint8_t *add,
+                 const uint8_t *sub, int inv, int w);
+
+    if (check_func(depth == 8 ? (void *)dsp->vstep8 : (void *)dsp->vstep16,
+                   "boxblur_vstep%d", depth)) {
+        for (int w = 16; w <= WIDTH; w += 48) {
+            const int inv = random_inv();
+
+            if (depth == 8) {
+                randomize_buffers(((uint8_t *)add), WIDTH, mask);
+                randomize_buffers(((uint8_t *)sub), WIDTH, mask);
+            } else {
+                randomize_buffers(add, WIDTH, mask);
+                randomize_buffers(sub, WIDTH, mask);
+            }
+            randomize_buffers(sums_ref, WIDTH, 0xFFFFFFFF);
+            memcpy(sums_new, sums_ref, sizeof(*sums_ref) * WIDTH);
+            memset(dst_ref, 0, sizeof(*dst_ref) * WIDTH);
+            memset(dst_new, 0, sizeof(*dst_new) * WIDTH);
+
+            call_ref((uint8_t *)dst_ref, sums_ref, (const uint8_t *)add,
+                     (const uint8_t *)sub, inv, w);
+            call_new((uint8_t *)dst_new, sums_new, (const uint8_t *)add,
+                     (const uint8_t *)sub, inv, w);
+            if (memcmp(dst_ref, dst_new, sizeof(*dst_ref) * WIDTH) ||
+                memcmp(sums_ref, sums_new, sizeof(*sums_ref) * WIDTH))
+                fail();
+        }
+        bench_new((uint8_t *)dst_new, sums_new, (const uint8_t *)add,
+                  (const uint8_t *)sub, random_inv(), WIDTH);
+    }
+}
+
+static void check_hstep(const BoxBlurDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [WIDTH + 8]);
+    LOCAL_ALIGNED_32(uint16_t, dst_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst_new, [WIDTH]);
+    const int mask = (1 << depth) - 1;
+    const int ps = (depth + 7) / 8;
+
+    declare_func(unsigned, uint8_t *dst, const uint8_t *add, const uint8_t *sub,
+                 int inv, unsigned sum, int len);
+
+    if (check_func(depth == 8 ? (void *)dsp->hstep8 : (void *)dsp->hstep16,
+                   "boxblur_hstep%d", depth)) {
+        for (int len = 4; len <= WIDTH; len += 28) {
+            /* unaligned, overlapping windows as in the filter */
+            const uint8_t *add = (const uint8_t *)src + (1 + rnd() % 7) * ps;
+            const uint8_t *sub = (const uint8_t *)src;
+            const int inv = random_inv();
+            const unsigned sum = rnd();
+            unsigned sum_ref, sum_new;
+
+            if (depth == 8)
+                randomize_buffers(((uint8_t *)src), 2 * (WIDTH + 8), mask);
+            else
+                randomize_buffers(src, WIDTH + 8, mask);
+            memset(dst_ref, 0, sizeof(*dst_ref) * WIDTH);
+            memset(dst_new, 0, sizeof(*dst_new) * WIDTH);
+
+            sum_ref = call_ref((uint8_t *)dst_ref, add, sub, inv, sum, len);
+            sum_new = call_new((uint8_t *)dst_new, add, sub, inv, sum, len);
+            if (sum_ref != sum_new ||
+                memcmp(dst_ref, dst_new, sizeof(*dst_ref) * WIDTH))
+                fail();
+        }
+        bench_new((uint8_t *)dst_new, (const uint8_t *)src + ps, (const uint8_t *)src,
+                  random_inv(), 0, WIDTH);
+    }
+}
+
+void checkasm_check_vf_boxblur(void)
+{
+    BoxBlurDSPContext dsp;
+
+    ff_boxblur_init(&dsp);
+
+    check_vstep(&dsp, 8);
+    check_vstep(&dsp, 16);
+    report("vstep");
+
+    check_hstep(&dsp, 8);
+    check_hstep(&dsp, 16);
+    report("hstep");
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/decimatedsp.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 512
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        for (int j = 0; j < size; j++)          \
+            buf[j] = rnd() & mask;              \
+    } while (0)
+
+static void check_sad_groups(const DecimateDSPContext *dsp, int depth)
+{
+    LOCAL_ALIGNED_32(uint16_t, a, [WIDTH + 32]);
+    LOCAL_ALIGNED_32(uint16_t, b, [WIDTH + 32]);
+    LOCAL_ALIGNED_32(uint32_t, acc_ref, [WIDTH / 8]);
+    LOCAL_ALIGNED_32(uint32_t, acc_new, [WIDTH / 8]);
+    const int mask = (1 << depth) - 1;
+    const int ps = (depth + 7) / 8;
+
+    declare_func(void, uint32_t *acc, const uint8_t *a, const uint8_t *b, int len);
+
+    if (check_func(depth == 8 ? (void *)dsp->sad_groups8 : (void *)dsp->sad_groups16,
+                   "decimate_sad_groups%d", depth)) {
+        for (int len = 32; len <= WIDTH; len += 96) {
+            const uint8_t *pa = (const uint8_t *)a + (rnd() % 16) * ps;
+            const uint8_t *pb = (const uint8_t *)b + (rnd() % 16) * ps;
+
+            if (depth == 8) {
+                randomize_buffers(((uint8_t *)a), 2 * (WIDTH + 32), mask);
+                randomize_buffers(((uint8_t *)b), 2 * (WIDTH + 32), mask);
+            } else {
+                randomize_buffers(a, WIDTH + 32, mask);
+                randomize_buffers(b, WIDTH + 32, mask);
+            }
+            randomize_buffers(acc_ref, WIDTH / 8, 0xFFFFFF);
+            memcpy(acc_new, acc_ref, sizeof(*acc_ref) * WIDTH / 8);
+
+            call_ref(acc_ref, pa, pb, len);
+            call_new(acc_new, pa, pb, len);
+            if (memcmp(acc_ref, acc_new, sizeof(*acc_ref) * WIDTH / 8))
+                fail();
+        }
+        bench_new(acc_new, (const uint8_t *)a, (const uint8_t *)b, WIDTH);
+    }
+}
+
+void checkasm_check_vf_decimate(void)
+{
+    DecimateDSPContext dsp;
+
+    ff_decimate_init(&dsp);
+
+    check_sad_groups(&dsp, 8);
+    check_sad_groups(&dsp, 16);
+    report("sad_groups");
+}
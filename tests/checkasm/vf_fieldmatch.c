@@ -0,0 +1,205 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/fieldmatchdsp.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH  512
+#define STRIDE (WIDTH + 32)
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        for (int j = 0; j < size; j++)          \
+            buf[j] = rnd() & mask;              \
+    } while (0)
+
+static void check_comb_row(const FieldMatchDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [5 * STRIDE]);
+    LOCAL_ALIGNED_32(uint8_t, dst_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new, [WIDTH]);
+
+    declare_func(void, uint8_t *dst, const uint8_t *m2, const uint8_t *m1,
+                 const uint8_t *c, const uint8_t *p1, const uint8_t *p2,
+                 int width, int cthresh);
+
+    if (check_func(dsp->comb_row, "fieldmatch_comb_row")) {
+        for (int width = 32; width <= WIDTH; width += 96) {
+            const uint8_t *c = src + 2 * STRIDE + rnd() % 16;
+            const int cthresh = rnd() & 0x3f;
+
+            /* alternate the line brightness so that some pixels are combed */
+            for (int i = 0; i < 5 * STRIDE; i++)
+                src[i] = (i / STRIDE & 1) * 0x80 + (rnd() & 0x7f);
+            memset(dst_ref, 0, WIDTH);
+            memset(dst_new, 0, WIDTH);
+
+            call_ref(dst_ref, c - 2 * STRIDE, c - STRIDE, c, c + STRIDE, c + 2 * STRIDE,
+                     width, cthresh);
+            call_new(dst_new, c - 2 * STRIDE, c - STRIDE, c, c + STRIDE, c + 2 * STRIDE,
+                     width, cthresh);
+            if (memcmp(dst_ref, dst_new, WIDTH))
+                fail();
+
+            /* the first and last lines alias their neighbours */
+            call_ref(dst_ref, c + 2 * STRIDE, c + STRIDE, c, c + STRIDE, c + 2 * STRIDE,
+                     width, cthresh);
+            call_new(dst_new, c + 2 * STRIDE, c + STRIDE, c, c + STRIDE, c + 2 * STRIDE,
+                     width, cthresh);
+            if (memcmp(dst_ref, dst_new, WIDTH))
+                fail();
+        }
+        bench_new(dst_new, src, src + STRIDE, src + 2 * STRIDE, src + 3 * STRIDE,
+                  src + 4 * STRIDE, WIDTH, 9);
+    }
+}
+
+static void check_comb_count(const FieldMatchDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, cmk, [3 * STRIDE]);
+    LOCAL_ALIGNED_32(uint16_t, acc_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, acc_new, [WIDTH]);
+
+    declare_func(void, uint16_t *acc, const uint8_t *cmk, ptrdiff_t stride, int width);
+
+    if (check_func(dsp->comb_count, "fieldmatch_comb_count")) {
+        for (int width = 16; width <= WIDTH; width += 48) {
+            const uint8_t *p = cmk + STRIDE + rnd() % 16;
+
+            for (int i = 0; i < 3 * STRIDE; i++)
+                cmk[i] = rnd() & 3 ? 0xff : 0;
+            randomize_buffers(acc_ref, WIDTH, 0xff);
+            memcpy(acc_new, acc_ref, sizeof(*acc_ref) * WIDTH);
+
+            call_ref(acc_ref, p, STRIDE, width);
+            call_new(acc_new, p, STRIDE, width);
+            if (memcmp(acc_ref, acc_new, sizeof(*acc_ref) * WIDTH))
+                fail();
+        }
+        bench_new(acc_new, cmk + STRIDE, STRIDE, WIDTH);
+    }
+}
+
+static void check_abs_diff(const FieldMatchDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, a, [STRIDE]);
+    LOCAL_ALIGNED_32(uint8_t, b, [STRIDE]);
+    LOCAL_ALIGNED_32(uint8_t, dst_ref, [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new, [WIDTH]);
+
+    declare_func(void, uint8_t *dst, const uint8_t *a, const uint8_t *b, int width);
+
+    if (check_func(dsp->abs_diff, "fieldmatch_abs_diff")) {
+        for (int width = 32; width <= WIDTH; width += 96) {
+            const uint8_t *pa = a + rnd() % 16;
+            const uint8_t *pb = b + rnd() % 16;
+
+            randomize_buffers(a, STRIDE, 0xff);
+            randomize_buffers(b, STRIDE, 0xff);
+            memset(dst_ref, 0, WIDTH);
+            memset(dst_new, 0, WIDTH);
+
+            call_ref(dst_ref, pa, pb, width);
+            call_new(dst_new, pa, pb, width);
+            if (memcmp(dst_ref, dst_new, WIDTH))
+                fail();
+        }
+        bench_new(dst_new, a, b, WIDTH);
+    }
+}
+
+static void check_sad(const FieldMatchDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, a, [STRIDE]);
+    LOCAL_ALIGNED_32(uint8_t, b, [STRIDE]);
+
+    declare_func(unsigned, const uint8_t *a, const uint8_t *b, int width);
+
+    if (check_func(dsp->sad, "fieldmatch_sad")) {
+        for (int width = 32; width <= WIDTH; width += 96) {
+            const uint8_t *pa = a + rnd() % 16;
+            const uint8_t *pb = b + rnd() % 16;
+            unsigned sad_ref, sad_new;
+
+            randomize_buffers(a, STRIDE, 0xff);
+            randomize_buffers(b, STRIDE, 0xff);
+
+            sad_ref = call_ref(pa, pb, width);
+            sad_new = call_new(pa, pb, width);
+            if (sad_ref != sad_new)
+                fail();
+        }
+        bench_new(a, b, WIDTH);
+    }
+}
+
+static void check_match_row(const FieldMatchDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf, [FM_ROW_NB * STRIDE]);
+    uint32_t sums_ref[FM_MATCH_NB], sums_new[FM_MATCH_NB];
+    const uint8_t *rows[FM_ROW_NB];
+
+    declare_func(void, uint32_t *sums, const uint8_t *const *rows, int width);
+
+    if (check_func(dsp->match_row, "fieldmatch_match_row")) {
+        for (int width = 16; width <= WIDTH; width += 48) {
+            for (int r = 0; r < FM_ROW_NB; r++) {
+                uint8_t *row = buf + r * STRIDE;
+                if (r >= FM_ROW_MAP0) {
+                    for (int i = 0; i < STRIDE; i++)
+                        row[i] = rnd() & 1 ? 0 : rnd() & 7;
+                } else {
+                    randomize_buffers(row, STRIDE, 0xff);
+                }
+                rows[r] = row + rnd() % 16;
+            }
+            for (int m = 0; m < FM_MATCH_NB; m++)
+                sums_ref[m] = sums_new[m] = rnd() & 0xffffff;
+
+            call_ref(sums_ref, rows, width);
+            call_new(sums_new, rows, width);
+            if (memcmp(sums_ref, sums_new, sizeof(sums_ref)))
+                fail();
+        }
+        bench_new(sums_new, rows, WIDTH);
+    }
+}
+
+void checkasm_check_vf_fieldmatch(void)
+{
+    FieldMatchDSPContext dsp;
+
+    ff_fieldmatch_init(&dsp);
+
+    check_comb_row(&dsp);
+    report("comb_row");
+
+    check_comb_count(&dsp);
+    report("comb_count");
+
+    check_abs_diff(&dsp);
+    report("abs_diff");
+
+    check_sad(&dsp);
+    report("sad");
+
+    check_match_row(&dsp);
+    report("match_row");
+}
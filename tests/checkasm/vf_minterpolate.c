@@ -0,0 +1,76 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/motion_estimation.h"
+#include "libavutil/mem_internal.h"
+
+#define STRIDE 64
+
+#define randomize_buffers(buf, size)     \
+    do {                                 \
+       int j;                            \
+       for (j = 0; j < size; j++)        \
+           buf[j] = rnd() & 0xFF;        \
+    } while (0)
+
+static void check_sad(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, src1, [STRIDE * 33]);
+    LOCAL_ALIGNED_32(uint8_t, src2, [STRIDE * 33]);
+    AVMotionEstContext me_ctx;
+    int log2_size;
+
+    declare_func(int, const uint8_t *src1, ptrdiff_t stride1,
+                 const uint8_t *src2, ptrdiff_t stride2, int h);
+
+    ff_me_init_context(&me_ctx, 16, 7, 1920, 1080, 0, 1904, 0, 1064);
+
+    for (log2_size = 0; log2_size <= ME_SAD_MAX_LOG2; log2_size++) {
+        const int size = 1 << log2_size;
+
+        if (check_func(me_ctx.sad[log2_size], "me_sad%d", size)) {
+            int ref, new;
+
+            /* unaligned blocks, as searched by the motion estimation */
+            randomize_buffers(src1, STRIDE * 33);
+            randomize_buffers(src2, STRIDE * 33);
+            ref = call_ref(src1 + 1, STRIDE, src2 + STRIDE + 3, STRIDE, size);
+            new = call_new(src1 + 1, STRIDE, src2 + STRIDE + 3, STRIDE, size);
+            if (ref != new)
+                fail();
+
+            /* worst case accumulation */
+            memset(src1, 0x00, STRIDE * 33);
+            memset(src2, 0xFF, STRIDE * 33);
+            ref = call_ref(src1, STRIDE, src2, STRIDE, size);
+            new = call_new(src1, STRIDE, src2, STRIDE, size);
+            if (ref != new)
+                fail();
+
+            bench_new(src1 + 1, STRIDE, src2 + 3, STRIDE, size);
+        }
+    }
+}
+
+void checkasm_check_vf_minterpolate(void)
+{
+    check_sad();
+    report("me_sad");
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "checkasm.h"
+#include "libavfilter/vf_paletteuse_init.h"
+#include "libavutil/mem_internal.h"
+
+#define MAX_COLORS 256
+
+static void randomize_lab(int32_t *L, int32_t *a, int32_t *b, int nb)
+{
+    for (int i = 0; i < nb; i++) {
+        L[i] =  rnd() & 0xffff;
+        a[i] = (rnd() & 0xffff) - 0x8000;
+        b[i] = (rnd() & 0xffff) - 0x8000;
+    }
+}
+
+static void check_color_search(void)
+{
+    static const int nb_colors[] = { 8, 16, 64, 256 };
+    LOCAL_ALIGNED_32(int32_t, L, [MAX_COLORS]);
+    LOCAL_ALIGNED_32(int32_t, a, [MAX_COLORS]);
+    LOCAL_ALIGNED_32(int32_t, b, [MAX_COLORS]);
+    PaletteUseDSPContext dsp;
+
+    declare_func(int, const int32_t *L, const int32_t *a, const int32_t *b,
+                 int nb_colors, const int32_t *target);
+
+    ff_paletteuse_init(&dsp);
+
+    for (int n = 0; n < FF_ARRAY_ELEMS(nb_colors); n++) {
+        const int nb = nb_colors[n];
+
+        if (check_func(dsp.color_search, "color_search_%d", nb)) {
+            int32_t target[3];
+            int ref, new;
+
+            for (int i = 0; i < 16; i++) {
+                randomize_lab(L, a, b, nb);
+                randomize_lab(&target[0], &target[1], &target[2], 1);
+
+                /* exact match, then the same color twice */
+                if (i & 1) {
+                    const int j = rnd() % nb;
+                    target[0] = L[j];
+                    target[1] = a[j];
+                    target[2] = b[j];
+                    if (i & 2) {
+                        const int k = (j + 1 + rnd() % (nb - 1)) % nb;
+                        L[k] = L[j];
+                        a[k] = a[j];
+                        b[k] = b[j];
+                    }
+                }
+
+                ref = call_ref(L, a, b, nb, target);
+                new = call_new(L, a, b, nb, target);
+                if (ref != new) {
+                    fprintf(stderr, "color_search_%d: %d != %d\n", nb, ref, new);
+                    fail();
+                    break;
+                }
+            }
+
+            bench_new(L, a, b, nb, target);
+        }
+    }
+
+    report("color_search");
+}
+
+void checkasm_check_vf_paletteuse(void)
+{
+    check_color_search();
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/signaturedsp.h"
+#include "libavutil/mem_internal.h"
+
+#define randomize_buffer(buf, size, density)     \
+    do {                                         \
+        for (int j = 0; j < size; j++) {         \
+            uint8_t r = 0;                       \
+            for (int b = 0; b < 8; b++)          \
+                r |= (rnd() % density == 0) << b; \
+            buf[j] = r;                          \
+        }                                        \
+    } while (0)
+
+static void check_coarse_popcount(const SignatureDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, a, [COARSE_WORDS * COARSE_WORD_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, b, [COARSE_WORDS * COARSE_WORD_SIZE]);
+    int inter_ref[COARSE_WORDS], uni_ref[COARSE_WORDS];
+    int inter_new[COARSE_WORDS], uni_new[COARSE_WORDS];
+
+    declare_func(void, const uint8_t *a, const uint8_t *b, int *inter, int *uni);
+
+    if (check_func(dsp->coarse_popcount, "coarse_popcount")) {
+        for (int density = 1; density <= 8; density *= 2) {
+            randomize_buffer(a, COARSE_WORDS * COARSE_WORD_SIZE, density);
+            randomize_buffer(b, COARSE_WORDS * COARSE_WORD_SIZE, density);
+            call_ref(a, b, inter_ref, uni_ref);
+            call_new(a, b, inter_new, uni_new);
+            if (memcmp(inter_ref, inter_new, sizeof(inter_ref)) ||
+                memcmp(uni_ref, uni_new, sizeof(uni_ref)))
+                fail();
+        }
+        bench_new(a, b, inter_new, uni_new);
+    }
+    report("coarse_popcount");
+}
+
+static void check_l1dist(const SignatureDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(uint8_t, a, [L1PLANES_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, b, [L1PLANES_SIZE]);
+
+    declare_func(int, const uint8_t *a, const uint8_t *b);
+
+    if (check_func(dsp->l1dist, "l1dist")) {
+        for (int density = 1; density <= 8; density *= 2) {
+            int dist_ref, dist_new;
+
+            randomize_buffer(a, L1PLANES_SIZE, density);
+            randomize_buffer(b, L1PLANES_SIZE, density);
+            dist_ref = call_ref(a, b);
+            dist_new = call_new(a, b);
+            if (dist_ref != dist_new)
+                fail();
+        }
+        bench_new(a, b);
+    }
+    report("l1dist");
+}
+
+void checkasm_check_vf_signature(void)
+{
+    SignatureDSPContext dsp;
+
+    ff_signature_init(&dsp);
+    check_coarse_popcount(&dsp);
+    check_l1dist(&dsp);
+}
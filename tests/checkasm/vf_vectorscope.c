@@ -0,0 +1,70 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavfilter/vectorscopedsp.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH     256
+#define NB_PLANES 5
+
+static void randomize_planes(uint16_t *buf, int sparse, int maxval)
+{
+    for (int i = 0; i < WIDTH * NB_PLANES; i++)
+        buf[i] = rnd() % sparse ? 0 : rnd() % maxval;
+}
+
+static void check_reduce(const VectorscopeDSPContext *dsp, int max)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [WIDTH * NB_PLANES]);
+    LOCAL_ALIGNED_32(uint16_t, dst_ref, [WIDTH * NB_PLANES]);
+    LOCAL_ALIGNED_32(uint16_t, dst_new, [WIDTH * NB_PLANES]);
+
+    declare_func(void, uint16_t *dst, const uint16_t *src, ptrdiff_t src_stride,
+                 int nb_src, int len);
+
+    if (check_func(max ? dsp->reduce_max : dsp->reduce_sum,
+                   max ? "reduce_max" : "reduce_sum")) {
+        for (int nb_src = 1; nb_src <= NB_PLANES; nb_src++) {
+            for (int sparse = 1; sparse <= 4; sparse++) {
+                randomize_planes(src, sparse, sparse & 1 ? 65536 : 4097);
+                /* in place, as used by the filter */
+                memcpy(dst_ref, src, sizeof(*src) * WIDTH * NB_PLANES);
+                memcpy(dst_new, src, sizeof(*src) * WIDTH * NB_PLANES);
+                call_ref(dst_ref, dst_ref, WIDTH, nb_src, WIDTH);
+                call_new(dst_new, dst_new, WIDTH, nb_src, WIDTH);
+                if (memcmp(dst_ref, dst_new, sizeof(*src) * WIDTH * NB_PLANES))
+                    fail();
+            }
+        }
+        bench_new(dst_new, src, WIDTH, NB_PLANES, WIDTH);
+    }
+}
+
+void checkasm_check_vf_vectorscope(void)
+{
+    VectorscopeDSPContext dsp;
+
+    ff_vectorscope_init(&dsp);
+    check_reduce(&dsp, 0);
+    report("reduce_sum");
+    check_reduce(&dsp, 1);
+    report("reduce_max");
+}
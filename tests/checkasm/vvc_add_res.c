@@ -0,0 +1,110 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/vvc/ctu.h"
+#include "libavcodec/vvc/dsp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define PIXEL_STRIDE (MAX_TB_SIZE + 16)
+#define DST_BUF_SIZE (PIXEL_STRIDE * MAX_TB_SIZE * 2)
+#define RES_BUF_SIZE (MAX_TB_SIZE * MAX_TB_SIZE)
+
+#define randomize_buffers(buf0, buf1, size)                 \
+    do {                                                    \
+        uint32_t mask = pixel_mask[(bit_depth - 8) >> 1];   \
+        int k;                                              \
+        for (k = 0; k < size; k += 4) {                     \
+            uint32_t r = rnd() & mask;                      \
+            AV_WN32A(buf0 + k, r);                          \
+            AV_WN32A(buf1 + k, r);                          \
+        }                                                   \
+    } while (0)
+
+static void randomize_residuals(int *res, const int bit_depth)
+{
+    // exceed the pixel range in both directions
+    const int range = 1 << (bit_depth + 1);
+
+    for (int i = 0; i < RES_BUF_SIZE; i++)
+        res[i] = (int)(rnd() % (2 * range)) - range;
+}
+
+static void check_add_residual(const VVCDSPContext *c, const int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(int, res, [RES_BUF_SIZE]);
+    const ptrdiff_t stride = PIXEL_STRIDE * SIZEOF_PIXEL;
+
+    randomize_residuals(res, bit_depth);
+    for (int h = 2; h <= MAX_TB_SIZE; h *= 2) {
+        for (int w = 2; w <= MAX_TB_SIZE; w *= 2) {
+            {
+                declare_func(void, uint8_t *dst, const int *res, int width, int height, ptrdiff_t stride);
+
+                if (check_func(c->itx.add_residual, "add_residual_%d_%dx%d", bit_depth, w, h)) {
+                    randomize_buffers(dst0, dst1, DST_BUF_SIZE);
+                    call_ref(dst0, res, w, h, stride);
+                    call_new(dst1, res, w, h, stride);
+                    if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                        fail();
+                    if (w == h)
+                        bench_new(dst1, res, w, h, stride);
+                }
+            }
+            {
+                declare_func(void, uint8_t *dst, const int *res, int width, int height, ptrdiff_t stride,
+                    int c_sign, int shift);
+
+                if (check_func(c->itx.add_residual_joint, "add_residual_joint_%d_%dx%d", bit_depth, w, h)) {
+                    for (int c_sign = -1; c_sign <= 1; c_sign += 2) {
+                        for (int shift = 0; shift <= 1; shift++) {
+                            randomize_buffers(dst0, dst1, DST_BUF_SIZE);
+                            call_ref(dst0, res, w, h, stride, c_sign, shift);
+                            call_new(dst1, res, w, h, stride, c_sign, shift);
+                            if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                                fail();
+                        }
+                    }
+                    if (w == h)
+                        bench_new(dst1, res, w, h, stride, -1, 1);
+                }
+            }
+        }
+    }
+}
+
+void checkasm_check_vvc_add_res(void)
+{
+    VVCDSPContext c;
+
+    for (int bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_vvc_dsp_init(&c, bit_depth);
+        check_add_residual(&c, bit_depth);
+    }
+    report("add_residual");
+}
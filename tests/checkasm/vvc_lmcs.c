@@ -0,0 +1,86 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/vvc/ctu.h"
+#include "libavcodec/vvc/dsp.h"
+#include "libavcodec/vvc/ps.h"
+
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define PIXEL_STRIDE (MAX_CTU_SIZE + 16)
+#define BUF_SIZE     (PIXEL_STRIDE * MAX_CTU_SIZE * 2)
+/* VVCLMCS stores other members after the lut, so reading a little past its
+ * end is allowed */
+#define LUT_SIZE     (LMCS_MAX_LUT_SIZE * 2 + 16)
+
+#define randomize_buffers(buf0, buf1, size)                 \
+    do {                                                    \
+        uint32_t mask = pixel_mask[(bit_depth - 8) >> 1];   \
+        int k;                                              \
+        for (k = 0; k < size; k += 4) {                     \
+            uint32_t r = rnd() & mask;                      \
+            AV_WN32A(buf0 + k, r);                          \
+            AV_WN32A(buf1 + k, r);                          \
+        }                                                   \
+    } while (0)
+
+static void check_lmcs_filter(const VVCDSPContext *c, const int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, lut,  [LUT_SIZE]);
+    const ptrdiff_t stride = PIXEL_STRIDE * SIZEOF_PIXEL;
+
+    declare_func(void, uint8_t *dst, ptrdiff_t dst_stride, int width, int height, const void *lut);
+
+    randomize_buffers(lut, lut, LUT_SIZE);
+    for (int h = 4; h <= MAX_CTU_SIZE; h *= 2) {
+        for (int w = 4; w <= MAX_CTU_SIZE; w *= 2) {
+            // also cover widths that are not a multiple of 8
+            const int width = w == 16 ? 12 : w;
+            if (check_func(c->lmcs.filter, "lmcs_filter_%d_%dx%d", bit_depth, width, h)) {
+                randomize_buffers(dst0, dst1, BUF_SIZE);
+                call_ref(dst0, stride, width, h, lut);
+                call_new(dst1, stride, width, h, lut);
+                if (memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+                if (width == h)
+                    bench_new(dst1, stride, width, h, lut);
+            }
+        }
+    }
+}
+
+void checkasm_check_vvc_lmcs(void)
+{
+    VVCDSPContext c;
+
+    for (int bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_vvc_dsp_init(&c, bit_depth);
+        check_lmcs_filter(&c, bit_depth);
+    }
+    report("lmcs_filter");
+}
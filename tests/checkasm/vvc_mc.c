@@ -324,6 +324,88 @@ static void check_avg(void)
     report("avg");
 }
 
+static int cmp_dmvr(const int16_t *dst0, const int16_t *dst1, const int w, const int h)
+{
+    for (int y = 0; y < h; y++) {
+        if (memcmp(dst0, dst1, w * sizeof(*dst0)))
+            return 1;
+        dst0 += MAX_PB_SIZE;
+        dst1 += MAX_PB_SIZE;
+    }
+    return 0;
+}
+
+static void check_dmvr(void)
+{
+    LOCAL_ALIGNED_32(int16_t, dst0, [DST_BUF_SIZE / 2]);
+    LOCAL_ALIGNED_32(int16_t, dst1, [DST_BUF_SIZE / 2]);
+    LOCAL_ALIGNED_32(uint8_t, src0, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, src1, [SRC_BUF_SIZE]);
+    static const char *const types[2][2] = { { "dmvr", "dmvr_h" }, { "dmvr_v", "dmvr_hv" } };
+    VVCDSPContext c;
+
+    declare_func(void, int16_t *dst, const uint8_t *src, ptrdiff_t src_stride,
+        int height, intptr_t mx, intptr_t my, int width);
+
+    for (int bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        randomize_pixels(src0, src1, SRC_BUF_SIZE);
+        ff_vvc_dsp_init(&c, bit_depth);
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) {
+                // dmvr runs on 8x8 or 16x16 blocks padded by the 2 sample search range
+                for (int size = 12; size <= 20; size += 8) {
+                    const int mx = i ? rnd() % 15 + 1 : 0;
+                    const int my = j ? rnd() % 15 + 1 : 0;
+                    if (check_func(c.inter.dmvr[j][i], "%s_%d_%dx%d", types[j][i], bit_depth, size, size)) {
+                        memset(dst0, 0, DST_BUF_SIZE);
+                        memset(dst1, 0, DST_BUF_SIZE);
+                        call_ref(dst0, src0 + SRC_OFFSET, PIXEL_STRIDE, size, mx, my, size);
+                        call_new(dst1, src1 + SRC_OFFSET, PIXEL_STRIDE, size, mx, my, size);
+                        if (cmp_dmvr(dst0, dst1, size, size))
+                            fail();
+                        bench_new(dst1, src1 + SRC_OFFSET, PIXEL_STRIDE, size, mx, my, size);
+                    }
+                }
+            }
+        }
+    }
+    report("dmvr");
+}
+
+static void check_vvc_sad(void)
+{
+    LOCAL_ALIGNED_32(int16_t, src0, [MAX_CTU_SIZE * MAX_CTU_SIZE]);
+    LOCAL_ALIGNED_32(int16_t, src1, [MAX_CTU_SIZE * MAX_CTU_SIZE]);
+    VVCDSPContext c;
+
+    declare_func(int, const int16_t *src0, const int16_t *src1, int dx, int dy, int block_w, int block_h);
+
+    ff_vvc_dsp_init(&c, 10);
+    // dmvr output is 10-bit for all bit depths
+    for (int i = 0; i < MAX_CTU_SIZE * MAX_CTU_SIZE; i++) {
+        src0[i] = rnd() & 0x3ff;
+        src1[i] = rnd() & 0x3ff;
+    }
+    for (int h = 8; h <= 16; h *= 2) {
+        for (int w = 8; w <= 16; w *= 2) {
+            if (check_func(c.inter.sad, "sad_%dx%d", w, h)) {
+                for (int dy = 0; dy <= 4; dy++) {
+                    for (int dx = 0; dx <= 4; dx++) {
+                        int result0, result1;
+
+                        result0 = call_ref(src0, src1, dx, dy, w, h);
+                        result1 = call_new(src0, src1, dx, dy, w, h);
+                        if (result0 != result1)
+                            fail();
+                    }
+                }
+                bench_new(src0, src1, 2, 2, w, h);
+            }
+        }
+    }
+    report("sad");
+}
+
 void checkasm_check_vvc_mc(void)
 {
     check_put_vvc_luma();
@@ -331,4 +413,6 @@ void checkasm_check_vvc_mc(void)
     check_put_vvc_chroma();
     check_put_vvc_chroma_uni();
     check_avg();
+    check_dmvr();
+    check_vvc_sad();
 }
@@ -210,6 +210,13 @@ FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER SCALE_FILTER) +=         \
                                                     $(HEVC_TESTS_422_10BIN) \
                                                     $(HEVC_TESTS_444_12BIT) \
 
+# decode the tile streams with one slice thread job per tile, the output must
+# match the single-threaded references
+HEVC_TILES_SLICE_THREADS = $(addprefix fate-hevc-tiles-slice-threads-, TILES_A_Cisco_2 TILES_B_Cisco_1)
+$(HEVC_TILES_SLICE_THREADS): CMD = threads=4 thread_type=slice framecrc -i $(TARGET_SAMPLES)/hevc-conformance/$(subst fate-hevc-tiles-slice-threads-,,$(@)).bit -pix_fmt yuv420p
+$(HEVC_TILES_SLICE_THREADS): REF = $(SRC_PATH)/tests/ref/fate/hevc-conformance-$(subst fate-hevc-tiles-slice-threads-,,$(@))
+FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER) += $(HEVC_TILES_SLICE_THREADS)
+
 fate-hevc-paramchange-yuv420p-yuv420p10: CMD = framecrc -i $(TARGET_SAMPLES)/hevc/paramchange_yuv420p_yuv420p10.hevc -fps_mode passthrough -sws_flags area+accurate_rnd+bitexact
 FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER SCALE_FILTER LARGE_TESTS) += fate-hevc-paramchange-yuv420p-yuv420p10
 
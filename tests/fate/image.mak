@@ -412,6 +412,10 @@ fate-png-side-data: CMD = run ffprobe$(PROGSSUF)$(EXESUF) -show_frames \
 FATE_PNG_TRANSCODE-$(call TRANSCODE, PNG, IMAGE2 IMAGE_PNG_PIPE) += fate-png-icc
 fate-png-icc: CMD = transcode png_pipe $(TARGET_SAMPLES)/png1/lena-int_rgb24.png image2 "-c png" "" "-show_frames"
 
+# slice threaded deflate, decoded back to compare with the source frames
+FATE_PNG_ENC-$(call TRANSCODE, PNG, MOV, TESTSRC_FILTER LAVFI_INDEV) += fate-png-enc-slice
+fate-png-enc-slice: CMD = transcode "lavfi -graph testsrc=s=352x288:r=5:d=1" "foo" mov "-c:v png -threads 4 -thread_type slice" ""
+
 FATE_PNG_PROBE-$(call ALLYES, LCMS2) += fate-png-icc-parse
 fate-png-icc-parse: CMD = run ffprobe$(PROGSSUF)$(EXESUF) -show_frames \
     -flags2 icc_profiles $(TARGET_SAMPLES)/png1/lena-int_rgb24.png
@@ -421,7 +425,8 @@ FATE_PNG_PROBE-$(call DEMDEC, IMAGE2, PNG) += $(FATE_PNG_PROBE)
 FATE_IMAGE_FRAMECRC += $(FATE_PNG-yes)
 FATE_IMAGE_PROBE += $(FATE_PNG_PROBE-yes)
 FATE_IMAGE_TRANSCODE += $(FATE_PNG_TRANSCODE-yes)
-fate-png: $(FATE_PNG-yes) $(FATE_PNG_PROBE-yes) $(FATE_PNG_TRANSCODE-yes)
+FATE_FFMPEG += $(FATE_PNG_ENC-yes)
+fate-png: $(FATE_PNG-yes) $(FATE_PNG_PROBE-yes) $(FATE_PNG_TRANSCODE-yes) $(FATE_PNG_ENC-yes)
 
 FATE_IMAGE_FRAMECRC-$(call DEMDEC, IMAGE2, PTX, SCALE_FILTER) += fate-ptx
 fate-ptx: CMD = framecrc -i $(TARGET_SAMPLES)/ptx/_113kw_pic.ptx -pix_fmt rgb24 -vf scale
@@ -542,8 +547,13 @@ fate-tiff-zip-rgbaf32le: CMD = framecrc -i $(TARGET_SAMPLES)/tiff/zip_rgbaf32le.
 FATE_TIFF-$(call FRAMECRC, IMAGE2, TIFF, ZLIB) += $(FATE_TIFF_ZIP)
 FATE_TIFF-$(call FRAMECRC, IMAGE2, TIFF) += $(FATE_TIFF)
 
+# slice threaded deflate, decoded back to compare with the source frames
+FATE_TIFF_ENC-$(call TRANSCODE, TIFF, MOV, TESTSRC_FILTER LAVFI_INDEV ZLIB) += fate-tiff-enc-deflate-slice
+fate-tiff-enc-deflate-slice: CMD = transcode "lavfi -graph testsrc=s=352x288:r=5:d=1" "foo" mov "-c:v tiff -compression_algo deflate -threads 4 -thread_type slice" ""
+
 FATE_IMAGE_FRAMECRC += $(FATE_TIFF-yes)
-fate-tiff: $(FATE_TIFF-yes)
+FATE_FFMPEG += $(FATE_TIFF_ENC-yes)
+fate-tiff: $(FATE_TIFF-yes) $(FATE_TIFF_ENC-yes)
 
 FATE_WEBP += fate-webp-rgb-lossless
 fate-webp-rgb-lossless: CMD = framecrc -i $(TARGET_SAMPLES)/webp/rgb_lossless.webp